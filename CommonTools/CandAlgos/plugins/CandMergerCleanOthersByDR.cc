@@ -26,7 +26,10 @@
 #include "DataFormats/Candidate/interface/Candidate.h"
 #include "DataFormats/Common/interface/View.h"
 #include "DataFormats/Common/interface/Ptr.h"
-#include "DataFormats/Math/interface/deltaR.h"
+#include "CommonTools/Utils/interface/DeltaRMatcher.h"
+
+#include <cmath>
+#include <limits>
 
 class CandMergerCleanOthersByDR : public edm::global::EDProducer<> {
 public:
@@ -66,18 +69,6 @@ namespace {
     iEvent.getByToken(token,handle);
     return handle;
   }
-  
-  bool hasDRMatch(const reco::Candidate& cand,const std::vector<std::pair<float,float> >& etaPhisToMatch,const float maxDR2)
-  {
-    const float candEta = cand.eta();
-    const float candPhi = cand.phi();
-    for(const auto& etaPhi : etaPhisToMatch){
-      if(reco::deltaR2(candEta,candPhi,etaPhi.first,etaPhi.second)<=maxDR2){
-	return true;
-      }
-    }
-    return false;
-  }
 }
 
 // ------------ method called to produce the data  ------------
@@ -89,15 +80,19 @@ CandMergerCleanOthersByDR::produce(edm::StreamID streamID, edm::Event& iEvent, c
   auto coll1Handle = getHandle(iEvent,coll1Token_); 
   auto coll2Handle = getHandle(iEvent,coll2Token_); 
   
-  std::vector<std::pair<float,float> > coll1EtaPhis;
+  reco::EtaPhiPtSoA<float> coll1EtaPhis; //just to speed up the DR match
+  coll1EtaPhis.reserve(coll1Handle->size());
   for(size_t objNr=0;objNr<coll1Handle->size();objNr++){
     edm::Ptr<reco::Candidate> objPtr(coll1Handle,objNr);
-    coll1EtaPhis.push_back({objPtr->eta(),objPtr->phi()}); //just to speed up the DR match
+    coll1EtaPhis.push_back(*objPtr);
     outColl->push_back(objPtr);
   }
+  //cleaned if deltaR2<=maxDR2ToClean_
+  const reco::DeltaRMatcher<float> coll1Matcher(std::nextafter(maxDR2ToClean_,std::numeric_limits<float>::infinity()),
+						std::move(coll1EtaPhis));
   for(size_t objNr=0;objNr<coll2Handle->size();objNr++){
     edm::Ptr<reco::Candidate> objPtr(coll2Handle,objNr);
-    if(!hasDRMatch(*objPtr,coll1EtaPhis,maxDR2ToClean_)){
+    if(!coll1Matcher.hasMatch(objPtr->eta(),objPtr->phi())){
       outColl->push_back(objPtr);
     }
   }
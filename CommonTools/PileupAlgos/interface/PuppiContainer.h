@@ -4,6 +4,7 @@
 #include "CommonTools/PileupAlgos/interface/PuppiAlgo.h"
 #include "CommonTools/PileupAlgos/interface/RecoObj.h"
 #include "CommonTools/PileupAlgos/interface/PuppiCandidate.h"
+#include "CommonTools/PileupAlgos/interface/PuppiGrid.h"
 
 class PuppiContainer{
 public:
@@ -25,12 +26,12 @@ public:
     std::vector<PuppiCandidate> const & puppiParticles() const { return fPupParticles;}
 
 protected:
-    double  goodVar      (PuppiCandidate const &iPart,std::vector<PuppiCandidate> const &iParts, int iOpt,const double iRCone);
-    void    getRMSAvg    (int iOpt,std::vector<PuppiCandidate> const &iConstits,std::vector<PuppiCandidate> const &iParticles,std::vector<PuppiCandidate> const &iChargeParticles);
-    void    getRawAlphas    (int iOpt,std::vector<PuppiCandidate> const &iConstits,std::vector<PuppiCandidate> const &iParticles,std::vector<PuppiCandidate> const &iChargeParticles);
+    double  goodVar      (PuppiCandidate const &iPart,PuppiGrid const &iParts, int iOpt,const double iRCone);
+    void    getRMSAvg    (int iOpt,std::vector<PuppiCandidate> const &iConstits,PuppiGrid const &iParticles,PuppiGrid const &iChargeParticles);
+    void    getRawAlphas    (int iOpt,std::vector<PuppiCandidate> const &iConstits,PuppiGrid const &iParticles,PuppiGrid const &iChargeParticles);
     double  getChi2FromdZ(double iDZ);
     int     getPuppiId   ( float iPt, float iEta);
-    double  var_within_R (int iId, const std::vector<PuppiCandidate> & particles, const PuppiCandidate& centre, const double R);
+    double  var_within_R (int iId, const PuppiGrid & particles, const PuppiCandidate& centre, const double R);
     
     bool      fPuppiDiagnostics;
     std::vector<RecoObj>   fRecoParticles;
@@ -42,6 +43,11 @@ protected:
     std::vector<double>    fRawAlphas;
     std::vector<double>    fAlphaMed;
     std::vector<double>    fAlphaRMS;
+    //neighbour search in the cones, shared by all the algos
+    PuppiGrid fPFGrid;
+    PuppiGrid fChargedPVGrid;
+    double    fMaxCone;
+    std::vector<unsigned int> fNeighbours;
 
     bool   fApplyCHS;
     bool   fInvert;
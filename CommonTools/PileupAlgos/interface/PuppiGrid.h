@@ -0,0 +1,40 @@
+#ifndef CommonTools_PileupAlgos_PuppiGrid
+#define CommonTools_PileupAlgos_PuppiGrid
+
+#include "CommonTools/PileupAlgos/interface/PuppiCandidate.h"
+
+#include <vector>
+
+// Rapidity-phi grid of a particle collection, built once per event, to find the
+// particles within a cone without looping over the whole collection.
+// The cells are at least as large as the largest cone, so the cone of a particle is
+// contained in its cell and the eight around it; the rapidities beyond the range
+// of the grid go to the first and last rows.
+class PuppiGrid {
+    public:
+        PuppiGrid() : fParticles(nullptr), fRapCell(0), fPhiCell(0), fNRap(0), fNPhi(0) {}
+
+        void build(std::vector<PuppiCandidate> const &iParticles, double iCellSize);
+
+        std::vector<PuppiCandidate> const &particles() const { return *fParticles; }
+
+        // indices of the particles with squared_distance to the centre below iR2 (iR2 <= iCellSize^2),
+        // in increasing order, as a loop over the collection would find them
+        void neighbours(PuppiCandidate const &iCentre, double iR2, std::vector<unsigned int> &oIndices) const;
+
+    private:
+        int rapBin(double iRap) const;
+        int phiBin(double iPhi) const;
+
+        static constexpr double kMaxRap = 5.;
+
+        std::vector<PuppiCandidate> const *fParticles;
+        double fRapCell;
+        double fPhiCell;
+        int fNRap;
+        int fNPhi;
+        std::vector<unsigned int> fCellStart;      // first entry of each cell in fCellParticles, nRap*nPhi+1
+        std::vector<unsigned int> fCellParticles;  // particle indices, by cell, increasing within a cell
+};
+
+#endif
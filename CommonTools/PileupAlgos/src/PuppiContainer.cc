@@ -18,10 +18,14 @@ PuppiContainer::PuppiContainer(const edm::ParameterSet &iConfig) {
     fPtMax           = iConfig.getParameter<double>("PtMaxNeutrals");
     std::vector<edm::ParameterSet> lAlgos = iConfig.getParameter<std::vector<edm::ParameterSet> >("algos");
     fNAlgos = lAlgos.size();
+    fMaxCone = 0;
     for(unsigned int i0 = 0; i0 < lAlgos.size(); i0++) {
         PuppiAlgo pPuppiConfig(lAlgos[i0]);
         fPuppiAlgo.push_back(pPuppiConfig);
+        for(int i1 = 0; i1 < pPuppiConfig.numAlgos(); i1++) fMaxCone = std::max(fMaxCone, pPuppiConfig.coneSize(i1));
     }
+    //the grid cells are at least as large as the largest cone
+    if(fMaxCone <= 0) fMaxCone = 0.4;
 }
 
 void PuppiContainer::initialize(const std::vector<RecoObj> &iRecoObjects) {
@@ -72,11 +76,11 @@ void PuppiContainer::initialize(const std::vector<RecoObj> &iRecoObjects) {
 }
 PuppiContainer::~PuppiContainer(){}
 
-double PuppiContainer::goodVar(PuppiCandidate const &iPart,std::vector<PuppiCandidate> const &iParts, int iOpt,const double iRCone) {
+double PuppiContainer::goodVar(PuppiCandidate const &iPart,PuppiGrid const &iParts, int iOpt,const double iRCone) {
     return var_within_R(iOpt,iParts,iPart,iRCone);
 }
 
-double PuppiContainer::var_within_R(int iId, const vector<PuppiCandidate> & particles, const PuppiCandidate& centre, const double R){
+double PuppiContainer::var_within_R(int iId, const PuppiGrid & particles, const PuppiCandidate& centre, const double R){
     if(iId == -1) return 1;
 
     //this is a circle in rapidity-phi
@@ -86,14 +90,15 @@ double PuppiContainer::var_within_R(int iId, const vector<PuppiCandidate> & part
     //the original code used Selector infrastructure: it is too heavy here
     //logic of SelectorCircle is preserved below
 
-    vector<double > near_dR2s;     near_dR2s.reserve(std::min(50UL, particles.size()));
-    vector<double > near_pts;      near_pts.reserve(std::min(50UL, particles.size()));
-    const double r2 = R*R;
-    for (auto const& part : particles){
-      if ( part.squared_distance(centre) < r2 ){
+    //the grid only visits the cells around the centre, and returns the particles
+    //in the order of the collection, so the sums are unchanged
+    particles.neighbours(centre, R*R, fNeighbours);
+    vector<double > near_dR2s;     near_dR2s.reserve(fNeighbours.size());
+    vector<double > near_pts;      near_pts.reserve(fNeighbours.size());
+    for (auto i : fNeighbours){
+        auto const& part = particles.particles()[i];
         near_dR2s.push_back(reco::deltaR2(part, centre));
         near_pts.push_back(part.pt());
-      }
     }
     double var = 0;
     //double lSumPt = 0;
@@ -117,7 +122,7 @@ double PuppiContainer::var_within_R(int iId, const vector<PuppiCandidate> & part
     return var;
 }
 //In fact takes the median not the average
-void PuppiContainer::getRMSAvg(int iOpt,std::vector<PuppiCandidate> const &iConstits,std::vector<PuppiCandidate> const &iParticles,std::vector<PuppiCandidate> const &iChargedParticles) {
+void PuppiContainer::getRMSAvg(int iOpt,std::vector<PuppiCandidate> const &iConstits,PuppiGrid const &iParticles,PuppiGrid const &iChargedParticles) {
     for(unsigned int i0 = 0; i0 < iConstits.size(); i0++ ) {
         double pVal = -1;
         //Calculate the Puppi Algo to use
@@ -157,7 +162,7 @@ void PuppiContainer::getRMSAvg(int iOpt,std::vector<PuppiCandidate> const &iCons
     for(int i0 = 0; i0 < fNAlgos; i0++) fPuppiAlgo[i0].computeMedRMS(iOpt,fPVFrac);
 }
 //In fact takes the median not the average
-void PuppiContainer::getRawAlphas(int iOpt,std::vector<PuppiCandidate> const &iConstits,std::vector<PuppiCandidate> const &iParticles,std::vector<PuppiCandidate> const &iChargedParticles) {
+void PuppiContainer::getRawAlphas(int iOpt,std::vector<PuppiCandidate> const &iConstits,PuppiGrid const &iParticles,PuppiGrid const &iChargedParticles) {
     for(int j0 = 0; j0 < fNAlgos; j0++){
         for(unsigned int i0 = 0; i0 < iConstits.size(); i0++ ) {
             double pVal = -1;
@@ -216,10 +221,12 @@ std::vector<double> const & PuppiContainer::puppiWeights() {
     for(int i0 = 0; i0 < fNAlgos; i0++) lNMaxAlgo = std::max(fPuppiAlgo[i0].numAlgos(),lNMaxAlgo);
     //Run through all compute mean and RMS
     int lNParticles    = fRecoParticles.size();
+    fPFGrid.build(fPFParticles, fMaxCone);
+    fChargedPVGrid.build(fChargedPV, fMaxCone);
     for(int i0 = 0; i0 < lNMaxAlgo; i0++) {
-        getRMSAvg(i0,fPFParticles,fPFParticles,fChargedPV);
+        getRMSAvg(i0,fPFParticles,fPFGrid,fChargedPVGrid);
     }
-    if (fPuppiDiagnostics) getRawAlphas(0,fPFParticles,fPFParticles,fChargedPV);
+    if (fPuppiDiagnostics) getRawAlphas(0,fPFParticles,fPFGrid,fChargedPVGrid);
 
     std::vector<double> pVals;
     for(int i0 = 0; i0 < lNParticles; i0++) {
@@ -0,0 +1,68 @@
+#include "CommonTools/PileupAlgos/interface/PuppiGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr double PuppiGrid::kMaxRap;
+
+int PuppiGrid::rapBin(double iRap) const {
+    double lBin = (iRap + kMaxRap) / fRapCell;
+    // NaN and the values below the range go to the first row
+    if (!(lBin >= 0.)) return 0;
+    if (lBin >= fNRap) return fNRap - 1;
+    return int(lBin);
+}
+
+int PuppiGrid::phiBin(double iPhi) const {
+    // fastjet phi is in [0, 2pi)
+    double lBin = iPhi / fPhiCell;
+    if (!(lBin >= 0.)) return 0;
+    if (lBin >= fNPhi) return fNPhi - 1;
+    return int(lBin);
+}
+
+void PuppiGrid::build(std::vector<PuppiCandidate> const &iParticles, double iCellSize) {
+    fParticles = &iParticles;
+    // slightly larger cells, so that the rounding of the bin computation can't lose a neighbour
+    double lCellSize = iCellSize * (1. + 1e-6);
+    fNRap = std::max(1, int(2. * kMaxRap / lCellSize));
+    fNPhi = std::max(1, int(2. * M_PI / lCellSize));
+    fRapCell = 2. * kMaxRap / fNRap;
+    fPhiCell = 2. * M_PI / fNPhi;
+
+    // counting sort of the particles by cell, keeping their order within a cell
+    std::vector<unsigned int> lCell(iParticles.size());
+    fCellStart.assign(fNRap * fNPhi + 1, 0);
+    for (unsigned int i = 0; i < iParticles.size(); i++) {
+        lCell[i] = rapBin(iParticles[i].rap()) * fNPhi + phiBin(iParticles[i].phi());
+        fCellStart[lCell[i] + 1]++;
+    }
+    for (unsigned int c = 0; c + 1 < fCellStart.size(); c++) fCellStart[c + 1] += fCellStart[c];
+    fCellParticles.resize(iParticles.size());
+    std::vector<unsigned int> lNext(fCellStart.begin(), fCellStart.end() - 1);
+    for (unsigned int i = 0; i < iParticles.size(); i++) fCellParticles[lNext[lCell[i]]++] = i;
+}
+
+void PuppiGrid::neighbours(PuppiCandidate const &iCentre, double iR2, std::vector<unsigned int> &oIndices) const {
+    oIndices.clear();
+    if (fParticles->empty()) return;
+
+    int lRap = rapBin(iCentre.rap());
+    int lPhi = phiBin(iCentre.phi());
+    int lRapMin = std::max(0, lRap - 1), lRapMax = std::min(fNRap - 1, lRap + 1);
+    // phi wraps around: with three columns or less, all of them
+    int lNPhi = std::min(fNPhi, 3);
+    int lPhiFirst = fNPhi <= 3 ? 0 : lPhi - 1 + fNPhi;
+
+    for (int r = lRapMin; r <= lRapMax; r++) {
+        for (int p = 0; p < lNPhi; p++) {
+            int lCell = r * fNPhi + (lPhiFirst + p) % fNPhi;
+            for (unsigned int k = fCellStart[lCell]; k < fCellStart[lCell + 1]; k++) {
+                unsigned int i = fCellParticles[k];
+                // the same selection as the loop over the whole collection
+                if ((*fParticles)[i].squared_distance(iCentre) < iR2) oIndices.push_back(i);
+            }
+        }
+    }
+    std::sort(oIndices.begin(), oIndices.end());
+}
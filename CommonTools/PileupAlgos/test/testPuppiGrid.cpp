@@ -0,0 +1,196 @@
+#include "CommonTools/PileupAlgos/interface/PuppiContainer.h"
+#include "CommonTools/PileupAlgos/interface/PuppiGrid.h"
+#include "CommonTools/PileupAlgos/interface/RecoObj.h"
+#include "DataFormats/Math/interface/deltaR.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Test of the rapidity-phi grid of the PUPPI local shape variables: for
+ * random events, var_within_R computed with the grid must be identical to
+ * the sum over the whole collection, as done before the grid, for all the
+ * variables and for cones up to the cell size. The particles and the cone
+ * centres cover the phi wrap, the rapidity edges of the grid and beyond,
+ * and the particles without a finite rapidity.
+ */
+
+namespace {
+
+  int errors = 0;
+
+  void check(bool ok, const char *what) {
+    if (!ok) {
+      std::cout << "Error: " << what << std::endl;
+      ++errors;
+    }
+  }
+
+  //the container without algos, to call var_within_R
+  class GridContainer : public PuppiContainer {
+  public:
+    explicit GridContainer(const edm::ParameterSet &iConfig) : PuppiContainer(iConfig) {}
+    using PuppiContainer::var_within_R;
+  };
+
+  edm::ParameterSet containerConfig() {
+    edm::ParameterSet config;
+    config.addParameter<bool>("puppiDiagnostics", false);
+    config.addParameter<bool>("applyCHS", true);
+    config.addParameter<bool>("invertPuppi", false);
+    config.addParameter<bool>("useExp", false);
+    config.addParameter<double>("MinPuppiWeight", 0.01);
+    config.addParameter<double>("PtMaxNeutrals", 200.);
+    config.addParameter<std::vector<edm::ParameterSet> >("algos", std::vector<edm::ParameterSet>());
+    return config;
+  }
+
+  //the variables summed over the whole collection, as var_within_R did before the grid
+  double loopVar(int iId, const std::vector<PuppiCandidate> &particles, const PuppiCandidate &centre, double R) {
+    if (iId == -1) return 1;
+    double var = 0;
+    for (const auto &part : particles) {
+      if (!(part.squared_distance(centre) < R*R)) continue;
+      double dr2 = reco::deltaR2(part, centre);
+      double pt = part.pt();
+      if (dr2 < 0.0001) continue;
+      if (iId == 0) var += (pt/dr2);
+      else if (iId == 1) var += pt;
+      else if (iId == 2) var += (1./dr2);
+      else if (iId == 3) var += (1./dr2);
+      else if (iId == 4) var += pt;
+      else if (iId == 5) var += (pt*pt/dr2);
+    }
+    if (iId == 1) var += centre.pt();
+    else if (iId == 0 && var != 0) var = log(var);
+    else if (iId == 3 && var != 0) var = log(var);
+    else if (iId == 5 && var != 0) var = log(var);
+    return var;
+  }
+
+  bool same(double a, double b) {
+    return a == b || (std::isnan(a) && std::isnan(b));
+  }
+
+  //compares the grid with the loop for cones centred on the particles and around them
+  void compare(const std::string &name, GridContainer &container, const std::vector<PuppiCandidate> &particles,
+               std::mt19937 &rng) {
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+    std::vector<PuppiCandidate> centres(particles);
+    for (const auto &part : particles) {
+      PuppiCandidate centre;
+      centre.reset_PtYPhiM(1., part.rap() + 0.2*uniform(rng), part.phi() + 0.2*uniform(rng), 0.);
+      centres.push_back(centre);
+    }
+    for (double rap : {-6., -5., -4.9, 0., 4.9, 5., 6.}) {
+      for (double phi : {-M_PI, -M_PI + 1e-9, 0., 1e-9, M_PI - 1e-9, M_PI}) {
+        PuppiCandidate centre;
+        centre.reset_PtYPhiM(1., rap, phi, 0.);
+        centres.push_back(centre);
+      }
+    }
+
+    unsigned int different = 0, neighbours = 0;
+    size_t nInCones = 0;
+    std::vector<unsigned int> indices;
+    //0.4 and 0.8: the cones of the configurations; 2.5: two phi columns; 7: a single one
+    for (double cellSize : {0.4, 0.8, 2.5, 7.}) {
+      PuppiGrid grid;
+      grid.build(particles, cellSize);
+      for (double R : {0.1*cellSize, 0.5*cellSize, cellSize}) {
+        for (const auto &centre : centres) {
+          grid.neighbours(centre, R*R, indices);
+          std::vector<unsigned int> expected;
+          for (unsigned int i = 0; i < particles.size(); ++i)
+            if (particles[i].squared_distance(centre) < R*R) expected.push_back(i);
+          nInCones += expected.size();
+          if (indices != expected && neighbours++ < 5)
+            std::cout << "Error: " << name << ": " << indices.size() << " neighbours of (" << centre.rap() << ","
+                      << centre.phi() << ") within " << R << " instead of " << expected.size() << std::endl;
+          for (int iId = -1; iId <= 5; ++iId) {
+            double gridVar = container.var_within_R(iId, grid, centre, R);
+            double var = loopVar(iId, particles, centre, R);
+            if (!same(gridVar, var) && different++ < 5)
+              std::cout << "Error: " << name << ": variable " << iId << " of (" << centre.rap() << ","
+                        << centre.phi() << ") within " << R << ": " << gridVar << " instead of " << var
+                        << std::endl;
+          }
+        }
+      }
+    }
+    if (different || neighbours) {
+      std::cout << "Error: " << name << ": " << different << " variables and " << neighbours
+                << " neighbour lists differ from the loop" << std::endl;
+      ++errors;
+    }
+    std::cout << name << ": " << particles.size() << " particles, " << nInCones << " in the cones" << std::endl;
+  }
+
+  //random PF candidates, as given to the container by the PuppiProducer
+  std::vector<RecoObj> randomEvent(std::mt19937 &rng, unsigned int n) {
+    std::uniform_real_distribution<float> rap(-5.5f, 5.5f);
+    std::uniform_real_distribution<float> phi(-M_PI, M_PI);
+    std::exponential_distribution<float> pt(0.5f);
+    std::vector<RecoObj> objects(n);
+    for (unsigned int i = 0; i < n; ++i) {
+      auto &obj = objects[i];
+      obj.pt = 0.1f + pt(rng);
+      obj.rapidity = rap(rng);
+      obj.eta = obj.rapidity;
+      obj.phi = phi(rng);
+      obj.m = (i%3 == 0) ? 0.f : 0.14f;
+      obj.id = i%3;
+      obj.charge = (i%5 == 0) ? 0 : (i%2 ? 1 : -1);
+    }
+    return objects;
+  }
+}
+
+int main()
+{
+  std::mt19937 rng(2018);
+  GridContainer container(containerConfig());
+
+  for (unsigned int n : {0, 1, 50, 400}) {
+    container.initialize(randomEvent(rng, n));
+    compare("random, " + std::to_string(n) + " particles", container, container.pfParticles(), rng);
+    compare("random, " + std::to_string(n) + " particles, charged from the PV", container,
+            container.pvParticles(), rng);
+  }
+
+  //particles on the phi wrap and on the rapidity edges of the grid, and without a finite rapidity
+  std::vector<RecoObj> edges = randomEvent(rng, 100);
+  const float infinity = std::numeric_limits<float>::infinity();
+  for (float rap : {-5.5f, -5.f, -4.999f, -0.001f, 0.f, 4.999f, 5.f, 5.5f, infinity}) {
+    for (float phi : {float(-M_PI), std::nextafter(float(-M_PI), 0.f), 0.f, std::nextafter(float(M_PI), 0.f),
+                      float(M_PI)}) {
+      RecoObj obj;
+      obj.pt = 2.f;
+      obj.rapidity = rap;
+      obj.eta = rap;
+      obj.phi = phi;
+      obj.id = 1;
+      obj.charge = 1;
+      edges.push_back(obj);
+    }
+  }
+  container.initialize(edges);
+  compare("edges", container, container.pfParticles(), rng);
+
+  //an empty grid
+  PuppiCandidate centre;
+  centre.reset_PtYPhiM(1., 0., 0., 0.);
+  PuppiGrid grid;
+  std::vector<PuppiCandidate> none;
+  grid.build(none, 0.4);
+  check(container.var_within_R(1, grid, centre, 0.4) == 1., "the sum in an empty cone is the pt of the centre");
+
+  if (errors) return 1;
+  std::cout << "PuppiGrid validated" << std::endl;
+  return 0;
+}
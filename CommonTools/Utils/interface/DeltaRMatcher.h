@@ -0,0 +1,306 @@
+#ifndef CommonTools_Utils_DeltaRMatcher_h
+#define CommonTools_Utils_DeltaRMatcher_h
+/* DeltaR matching of eta/phi snapshots (see EtaPhiPtSoA.h)
+ *
+ * The distances are the ones of reco::deltaR2(eta1, phi1, eta2, phi2)
+ * computed in T, and a pair matches if deltaR2 < maxDR2 (pass
+ * std::nextafter(x, inf) to cut at deltaR2 <= x).
+ * The targets are copied in eta-phi cells of size maxDR when there are
+ * enough of them for the binning to pay off, so that a query only computes
+ * the distances to the targets of the neighbouring cells; the results are
+ * the same as the ones of the loop over all the targets.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "CommonTools/Utils/interface/EtaPhiPtSoA.h"
+
+namespace reco {
+
+  namespace matching {
+
+    // dR2[j] = reco::deltaR2(eta, phi, etas[j], phis[j]) for j < n, written
+    // without branches so that the loop is vectorized
+    template<typename T>
+    inline void deltaR2s(T eta, T phi, const T * __restrict__ etas, const T * __restrict__ phis,
+			 std::size_t n, T * __restrict__ dR2) {
+      for (std::size_t j = 0; j < n; ++j) {
+	const T deta = eta - etas[j];
+	T dphi = std::abs(phi - phis[j]);
+	dphi = dphi > T(M_PI) ? dphi - T(2*M_PI) : dphi;
+	dR2[j] = deta*deta + dphi*dphi;
+      }
+    }
+
+    // all the pairs, dR2[i*targets.size() + j] for source i and target j
+    template<typename T>
+    inline void allDeltaR2s(const EtaPhiPtSoA<T> & sources, const EtaPhiPtSoA<T> & targets, T * dR2) {
+      const std::size_t n = targets.size();
+      for (std::size_t i = 0; i < sources.size(); ++i) {
+	deltaR2s(sources.eta(i), sources.phi(i), targets.etas(), targets.phis(), n, dR2 + i*n);
+      }
+    }
+
+  }
+
+  template<typename T = float>
+  class DeltaRMatcher {
+  public:
+    explicit DeltaRMatcher(T maxDR2) : maxDR2_(maxDR2) {}
+    DeltaRMatcher(T maxDR2, EtaPhiPtSoA<T> targets) : maxDR2_(maxDR2) { setTargets(std::move(targets)); }
+
+    // to be called again when the targets change (e.g. for each event)
+    void setTargets(EtaPhiPtSoA<T> targets);
+
+    T maxDR2() const { return maxDR2_; }
+    const EtaPhiPtSoA<T> & targets() const { return targets_; }
+    bool binned() const { return nEta_ > 0; }
+
+    // calls f(j, dR2) for each target j matching (eta, phi), in no
+    // particular order
+    template<typename F>
+    void forEachMatch(T eta, T phi, F && f) const;
+
+    // indices (increasing) and distances of the targets matching (eta, phi)
+    void matches(T eta, T phi, std::vector<unsigned> & indices, std::vector<T> & dR2s) const;
+    bool hasMatch(T eta, T phi) const;
+    // closest target, -1 if none; the lowest index wins a tie
+    int nearest(T eta, T phi) const;
+
+    // the same for each source
+    std::vector<bool> hasMatch(const EtaPhiPtSoA<T> & sources) const;
+    std::vector<int> nearest(const EtaPhiPtSoA<T> & sources) const;
+    // one to one matching resolving the ambiguities by order: each source in
+    // turn takes the closest target not taken by the previous ones
+    std::vector<int> uniqueByOrder(const EtaPhiPtSoA<T> & sources) const;
+    // one to one matching resolving the ambiguities by match quality: the
+    // pairs are taken by increasing distance (then source and target index)
+    // if neither the source nor the target has been taken yet
+    std::vector<int> uniqueByDistance(const EtaPhiPtSoA<T> & sources) const;
+
+  private:
+    // number of distances computed at once by the kernel
+    static constexpr std::size_t kBlockSize = 64;
+    // below this number of targets all of them are compared to each query
+    static constexpr std::size_t kMinBinnedSize = 16;
+    static constexpr int kMaxEtaBins = 1000;
+
+    template<typename F>
+    void scan(std::size_t begin, std::size_t end, T eta, T phi, F & f) const;
+    int etaBin(double eta) const;
+
+    T maxDR2_;
+    EtaPhiPtSoA<T> targets_;
+    // targets ordered by cell (by index inside a cell), the ones which
+    // cannot be binned (non-finite eta or phi outside [-pi, pi]) at the end
+    std::vector<T> eta_, phi_;
+    std::vector<unsigned> index_;
+    std::vector<unsigned> cellStart_;
+    std::size_t nBinned_ = 0;
+    // query window in eta and phi, cell sizes >= window
+    double window_ = 0.;
+    int nEta_ = 0, nPhi_ = 0;
+    double etaMin_ = 0., etaBinSize_ = 0., phiBinSize_ = 0.;
+  };
+
+  template<typename T> constexpr std::size_t DeltaRMatcher<T>::kBlockSize;
+  template<typename T> constexpr std::size_t DeltaRMatcher<T>::kMinBinnedSize;
+  template<typename T> constexpr int DeltaRMatcher<T>::kMaxEtaBins;
+
+  template<typename T>
+  void DeltaRMatcher<T>::setTargets(EtaPhiPtSoA<T> targets) {
+    targets_ = std::move(targets);
+    const std::size_t n = targets_.size();
+    eta_.assign(targets_.etas(), targets_.etas() + n);
+    phi_.assign(targets_.phis(), targets_.phis() + n);
+    index_.resize(n);
+    for (std::size_t j = 0; j < n; ++j) index_[j] = j;
+    cellStart_.clear();
+    nBinned_ = 0;
+    nEta_ = nPhi_ = 0;
+
+    // the window covers the rounding of deltaR2 and of the bin edges; with
+    // less than 3 cells in phi the whole ring would be scanned anyway
+    window_ = std::sqrt(double(maxDR2_))*(1. + 1e-5) + 1e-5;
+    if (n < kMinBinnedSize || !(window_ < 2*M_PI/3)) return;
+
+    auto binnable = [](T eta, T phi) {
+      return std::isfinite(eta) && std::abs(double(phi)) <= M_PI + 1e-6;
+    };
+    double etaMin = 0., etaMax = 0.;
+    for (std::size_t j = 0; j < n; ++j) {
+      if (!binnable(eta_[j], phi_[j])) continue;
+      if (nBinned_ == 0 || eta_[j] < etaMin) etaMin = eta_[j];
+      if (nBinned_ == 0 || eta_[j] > etaMax) etaMax = eta_[j];
+      ++nBinned_;
+    }
+    if (nBinned_ == 0) return;
+
+    nPhi_ = int(2*M_PI/window_);
+    phiBinSize_ = 2*M_PI/nPhi_;
+    nEta_ = std::max(1, std::min(kMaxEtaBins, int((etaMax - etaMin)/window_)));
+    etaMin_ = etaMin;
+    etaBinSize_ = (etaMax - etaMin)/nEta_;
+
+    // counting sort of the targets by cell, stable in the target index
+    const int nCells = nEta_*nPhi_;
+    std::vector<int> cell(n, nCells);
+    cellStart_.assign(nCells + 2, 0);
+    for (std::size_t j = 0; j < n; ++j) {
+      if (binnable(eta_[j], phi_[j])) {
+	const int iphi = std::min(nPhi_ - 1, std::max(0, int((double(phi_[j]) + M_PI)/phiBinSize_)));
+	cell[j] = etaBin(eta_[j])*nPhi_ + iphi;
+      }
+      ++cellStart_[cell[j] + 1];
+    }
+    for (int c = 0; c <= nCells; ++c) cellStart_[c + 1] += cellStart_[c];
+    std::vector<unsigned> fill(cellStart_.begin(), cellStart_.end() - 1);
+    for (std::size_t j = 0; j < n; ++j) {
+      const unsigned k = fill[cell[j]]++;
+      eta_[k] = targets_.eta(j);
+      phi_[k] = targets_.phi(j);
+      index_[k] = j;
+    }
+  }
+
+  template<typename T>
+  int DeltaRMatcher<T>::etaBin(double eta) const {
+    if (!(etaBinSize_ > 0.)) return 0;
+    const double x = (eta - etaMin_)/etaBinSize_;
+    return x <= 0. ? 0 : (x >= nEta_ - 1 ? nEta_ - 1 : int(x));
+  }
+
+  template<typename T>
+  template<typename F>
+  void DeltaRMatcher<T>::scan(std::size_t begin, std::size_t end, T eta, T phi, F & f) const {
+    T dR2[kBlockSize];
+    for (std::size_t b = begin; b < end; b += kBlockSize) {
+      const std::size_t m = std::min(kBlockSize, end - b);
+      matching::deltaR2s(eta, phi, eta_.data() + b, phi_.data() + b, m, dR2);
+      for (std::size_t k = 0; k < m; ++k) {
+	if (dR2[k] < maxDR2_) f(index_[b + k], dR2[k]);
+      }
+    }
+  }
+
+  template<typename T>
+  template<typename F>
+  void DeltaRMatcher<T>::forEachMatch(T eta, T phi, F && f) const {
+    const std::size_t n = eta_.size();
+    if (!binned() || !std::isfinite(eta) || !(std::abs(double(phi)) <= M_PI + 1e-6)) {
+      scan(0, n, eta, phi, f);
+      return;
+    }
+    const int etaLo = etaBin(eta - window_), etaHi = etaBin(eta + window_);
+    const int phiLo = int(std::floor((phi - window_ + M_PI)/phiBinSize_));
+    const int phiHi = int(std::floor((phi + window_ + M_PI)/phiBinSize_));
+    for (int ieta = etaLo; ieta <= etaHi; ++ieta) {
+      const unsigned * row = cellStart_.data() + ieta*nPhi_;
+      if (phiHi - phiLo + 1 >= nPhi_) {
+	scan(row[0], row[nPhi_], eta, phi, f);
+      } else if (phiLo < 0) {
+	scan(row[phiLo + nPhi_], row[nPhi_], eta, phi, f);
+	scan(row[0], row[phiHi + 1], eta, phi, f);
+      } else if (phiHi >= nPhi_) {
+	scan(row[phiLo], row[nPhi_], eta, phi, f);
+	scan(row[0], row[phiHi - nPhi_ + 1], eta, phi, f);
+      } else {
+	scan(row[phiLo], row[phiHi + 1], eta, phi, f);
+      }
+    }
+    scan(nBinned_, n, eta, phi, f);
+  }
+
+  template<typename T>
+  void DeltaRMatcher<T>::matches(T eta, T phi, std::vector<unsigned> & indices, std::vector<T> & dR2s) const {
+    std::vector<std::pair<unsigned, T> > found;
+    forEachMatch(eta, phi, [&found](unsigned j, T dR2) { found.emplace_back(j, dR2); });
+    std::sort(found.begin(), found.end());
+    indices.clear();
+    dR2s.clear();
+    for (const auto & m : found) {
+      indices.push_back(m.first);
+      dR2s.push_back(m.second);
+    }
+  }
+
+  template<typename T>
+  bool DeltaRMatcher<T>::hasMatch(T eta, T phi) const {
+    bool found = false;
+    forEachMatch(eta, phi, [&found](unsigned, T) { found = true; });
+    return found;
+  }
+
+  template<typename T>
+  int DeltaRMatcher<T>::nearest(T eta, T phi) const {
+    int best = -1;
+    T bestDR2 = maxDR2_;
+    forEachMatch(eta, phi, [&](unsigned j, T dR2) {
+	if (dR2 < bestDR2 || (dR2 == bestDR2 && int(j) < best)) {
+	  best = j;
+	  bestDR2 = dR2;
+	}
+      });
+    return best;
+  }
+
+  template<typename T>
+  std::vector<bool> DeltaRMatcher<T>::hasMatch(const EtaPhiPtSoA<T> & sources) const {
+    std::vector<bool> result(sources.size());
+    for (std::size_t i = 0; i < sources.size(); ++i) result[i] = hasMatch(sources.eta(i), sources.phi(i));
+    return result;
+  }
+
+  template<typename T>
+  std::vector<int> DeltaRMatcher<T>::nearest(const EtaPhiPtSoA<T> & sources) const {
+    std::vector<int> result(sources.size());
+    for (std::size_t i = 0; i < sources.size(); ++i) result[i] = nearest(sources.eta(i), sources.phi(i));
+    return result;
+  }
+
+  template<typename T>
+  std::vector<int> DeltaRMatcher<T>::uniqueByOrder(const EtaPhiPtSoA<T> & sources) const {
+    std::vector<int> result(sources.size(), -1);
+    std::vector<bool> taken(targets_.size(), false);
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+      int best = -1;
+      T bestDR2 = maxDR2_;
+      forEachMatch(sources.eta(i), sources.phi(i), [&](unsigned j, T dR2) {
+	  if (!taken[j] && (dR2 < bestDR2 || (dR2 == bestDR2 && int(j) < best))) {
+	    best = j;
+	    bestDR2 = dR2;
+	  }
+	});
+      if (best >= 0) {
+	result[i] = best;
+	taken[best] = true;
+      }
+    }
+    return result;
+  }
+
+  template<typename T>
+  std::vector<int> DeltaRMatcher<T>::uniqueByDistance(const EtaPhiPtSoA<T> & sources) const {
+    std::vector<std::tuple<T, unsigned, unsigned> > pairs;
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+      forEachMatch(sources.eta(i), sources.phi(i), [&pairs, i](unsigned j, T dR2) { pairs.emplace_back(dR2, i, j); });
+    }
+    std::sort(pairs.begin(), pairs.end());
+    std::vector<int> result(sources.size(), -1);
+    std::vector<bool> taken(targets_.size(), false);
+    for (const auto & p : pairs) {
+      const unsigned i = std::get<1>(p), j = std::get<2>(p);
+      if (result[i] >= 0 || taken[j]) continue;
+      result[i] = j;
+      taken[j] = true;
+    }
+    return result;
+  }
+
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef CommonTools_Utils_EtaPhiPtSoA_h
+#define CommonTools_Utils_EtaPhiPtSoA_h
+/* Structure-of-arrays snapshot of the eta, phi and pt of a collection
+ *
+ * The accessors of the objects (virtual for reco::Candidate) are called
+ * once per object when filling; the matching kernels of DeltaRMatcher.h
+ * then loop over contiguous arrays.
+ * T is the floating point type the distances are computed in: use the
+ * return type of eta() of the objects to reproduce reco::deltaR2(t1, t2).
+ */
+#include <cstddef>
+#include <vector>
+
+namespace reco {
+
+  template<typename T = float>
+  class EtaPhiPtSoA {
+  public:
+    typedef T value_type;
+
+    EtaPhiPtSoA() {}
+    template<typename C>
+    explicit EtaPhiPtSoA(const C & coll) { fill(coll); }
+
+    // all the objects of coll, in order
+    template<typename C>
+    void fill(const C & coll) {
+      clear();
+      reserve(coll.size());
+      for (const auto & obj : coll) push_back(obj);
+    }
+
+    template<typename O>
+    void push_back(const O & obj) { push_back(obj.eta(), obj.phi(), obj.pt()); }
+    template<typename O>
+    void push_back(const O * obj) { push_back(*obj); }
+    void push_back(T eta, T phi, T pt = T(0)) {
+      eta_.push_back(eta);
+      phi_.push_back(phi);
+      pt_.push_back(pt);
+    }
+
+    void clear() { eta_.clear(); phi_.clear(); pt_.clear(); }
+    void reserve(std::size_t n) { eta_.reserve(n); phi_.reserve(n); pt_.reserve(n); }
+
+    std::size_t size() const { return eta_.size(); }
+    bool empty() const { return eta_.empty(); }
+
+    T eta(std::size_t i) const { return eta_[i]; }
+    T phi(std::size_t i) const { return phi_[i]; }
+    T pt(std::size_t i) const { return pt_[i]; }
+
+    const T * etas() const { return eta_.data(); }
+    const T * phis() const { return phi_.data(); }
+    const T * pts() const { return pt_.data(); }
+
+  private:
+    std::vector<T> eta_;
+    std::vector<T> phi_;
+    std::vector<T> pt_;
+  };
+
+}
+
+#endif
@@ -0,0 +1,50 @@
+// time of the nearest neighbour matching of two random collections of n
+// objects with the loop over all the pairs and with DeltaRMatcher
+#include "CommonTools/Utils/interface/DeltaRMatcher.h"
+#include "DataFormats/Math/interface/deltaR.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+int main() {
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<float> eta(-3, 3), phi(-M_PI, M_PI);
+  const float maxDR2 = 0.4f*0.4f;
+
+  for (unsigned n : {10, 30, 100, 300, 1000, 3000}) {
+    reco::EtaPhiPtSoA<float> sources, targets;
+    for (unsigned i = 0; i < n; ++i) {
+      sources.push_back(eta(gen), phi(gen));
+      targets.push_back(eta(gen), phi(gen));
+    }
+    const unsigned repeat = 10000000/(n*n) + 1;
+
+    long check = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < repeat; ++r) {
+      for (unsigned i = 0; i < n; ++i) {
+	int nearest = -1;
+	float nearestDR2 = maxDR2;
+	for (unsigned j = 0; j < n; ++j) {
+	  const float dR2 = reco::deltaR2(sources.eta(i), sources.phi(i), targets.eta(j), targets.phi(j));
+	  if (dR2 < nearestDR2) { nearestDR2 = dR2; nearest = j; }
+	}
+	check += nearest;
+      }
+    }
+    auto loop = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < repeat; ++r) {
+      reco::DeltaRMatcher<float> matcher(maxDR2, targets);
+      for (int nearest : matcher.nearest(sources)) check -= nearest;
+    }
+    auto matcher = std::chrono::steady_clock::now();
+
+    std::cout << "n = " << n
+	      << ": all pairs " << std::chrono::duration<double, std::micro>(loop - start).count()/repeat << " us"
+	      << ", matcher " << std::chrono::duration<double, std::micro>(matcher - loop).count()/repeat << " us"
+	      << (check == 0 ? "" : ", DIFFERENT RESULTS") << std::endl;
+    if (check != 0) return 1;
+  }
+  return 0;
+}
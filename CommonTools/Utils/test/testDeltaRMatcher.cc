@@ -0,0 +1,143 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "CommonTools/Utils/interface/DeltaRMatcher.h"
+#include "DataFormats/Math/interface/deltaR.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+class testDeltaRMatcher : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testDeltaRMatcher);
+  CPPUNIT_TEST(checkAll);
+  CPPUNIT_TEST(checkAgainstLoops);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+  void checkAll();
+  void checkAgainstLoops();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( testDeltaRMatcher );
+
+namespace test {
+  struct EtaPhi {
+    EtaPhi( double eta, double phi ) : eta_( eta ), phi_( phi ) { }
+    double eta() const { return eta_; }
+    double phi() const { return phi_; }
+    double pt() const { return 1.; }
+  private:
+    double eta_, phi_;
+  };
+
+  // random objects, with some of them on top of each other, at phi = +-pi
+  // or that cannot be binned
+  template<typename T>
+  reco::EtaPhiPtSoA<T> random( std::mt19937 & gen, unsigned n ) {
+    std::uniform_real_distribution<double> eta( -3, 3 ), phi( -M_PI, M_PI ), u( 0, 1 );
+    reco::EtaPhiPtSoA<T> objs;
+    for ( unsigned i = 0; i < n; ++i ) {
+      T e = eta( gen ), p = phi( gen );
+      const double r = u( gen );
+      if ( r < 0.05 ) p = T( M_PI );
+      else if ( r < 0.1 ) p = -T( M_PI );
+      else if ( r < 0.12 ) e = std::numeric_limits<T>::quiet_NaN();
+      else if ( r < 0.14 ) p = 4;
+      else if ( r < 0.2 && i > 0 ) { e = objs.eta( i - 1 ); p = objs.phi( i - 1 ); }
+      objs.push_back( e, p );
+    }
+    return objs;
+  }
+
+  template<typename T>
+  unsigned compare( std::mt19937 & gen, unsigned nSources, unsigned nTargets, T maxDR2 ) {
+    reco::EtaPhiPtSoA<T> sources = random<T>( gen, nSources ), targets = random<T>( gen, nTargets );
+    reco::DeltaRMatcher<T> matcher( maxDR2, targets );
+    unsigned failures = 0;
+    // the loops the matcher replaces
+    std::vector<int> byOrder( nSources, -1 );
+    std::vector<bool> taken( nTargets, false );
+    std::vector<std::tuple<T, unsigned, unsigned> > pairs;
+    for ( unsigned i = 0; i < nSources; ++i ) {
+      int nearest = -1, free = -1;
+      T nearestDR2 = maxDR2, freeDR2 = maxDR2;
+      std::vector<unsigned> matched;
+      for ( unsigned j = 0; j < nTargets; ++j ) {
+	const T dR2 = reco::deltaR2( sources.eta( i ), sources.phi( i ), targets.eta( j ), targets.phi( j ) );
+	if ( dR2 < maxDR2 ) { matched.push_back( j ); pairs.emplace_back( dR2, i, j ); }
+	if ( dR2 < nearestDR2 ) { nearestDR2 = dR2; nearest = j; }
+	if ( !taken[j] && dR2 < freeDR2 ) { freeDR2 = dR2; free = j; }
+      }
+      if ( free >= 0 ) { byOrder[i] = free; taken[free] = true; }
+      std::vector<unsigned> indices;
+      std::vector<T> dR2s;
+      matcher.matches( sources.eta( i ), sources.phi( i ), indices, dR2s );
+      if ( indices != matched ) ++failures;
+      if ( matcher.nearest( sources.eta( i ), sources.phi( i ) ) != nearest ) ++failures;
+      if ( matcher.hasMatch( sources.eta( i ), sources.phi( i ) ) != !matched.empty() ) ++failures;
+    }
+    std::sort( pairs.begin(), pairs.end() );
+    std::vector<int> byDistance( nSources, -1 );
+    std::fill( taken.begin(), taken.end(), false );
+    for ( const auto & p : pairs ) {
+      const unsigned i = std::get<1>( p ), j = std::get<2>( p );
+      if ( byDistance[i] >= 0 || taken[j] ) continue;
+      byDistance[i] = j;
+      taken[j] = true;
+    }
+    if ( matcher.uniqueByOrder( sources ) != byOrder ) ++failures;
+    if ( matcher.uniqueByDistance( sources ) != byDistance ) ++failures;
+    return failures;
+  }
+}
+
+void testDeltaRMatcher::checkAll() {
+  using namespace test;
+  std::vector<EtaPhi> objs = { EtaPhi( 0, 3.1 ), EtaPhi( 0.1, -3.1 ), EtaPhi( 2, 0 ) };
+  reco::EtaPhiPtSoA<double> soa( objs );
+  CPPUNIT_ASSERT( soa.size() == 3 );
+  CPPUNIT_ASSERT( soa.eta( 1 ) == 0.1 && soa.phi( 1 ) == -3.1 && soa.pt( 1 ) == 1. );
+
+  std::vector<double> dR2( 9 );
+  reco::matching::allDeltaR2s( soa, soa, dR2.data() );
+  for ( unsigned i = 0; i < 3; ++i )
+    for ( unsigned j = 0; j < 3; ++j )
+      CPPUNIT_ASSERT( dR2[i*3 + j] == reco::deltaR2( objs[i], objs[j] ) );
+
+  // the cut is strict, the closest target is taken across phi = pi
+  reco::DeltaRMatcher<double> matcher( reco::deltaR2( objs[0], objs[1] ), soa );
+  CPPUNIT_ASSERT( !matcher.binned() );
+  CPPUNIT_ASSERT( matcher.nearest( 0.09, -3.1 ) == 1 );
+  CPPUNIT_ASSERT( matcher.nearest( 0, 0 ) == -1 );
+  CPPUNIT_ASSERT( matcher.nearest( 2, 0.1 ) == 2 );
+  std::vector<int> expected = { 0, 1, 2 };
+  CPPUNIT_ASSERT( matcher.nearest( soa ) == expected );
+
+  // two sources for one target: the first one takes it when resolving by
+  // order, the closest one when resolving by distance
+  reco::EtaPhiPtSoA<float> targets, sources;
+  targets.push_back( 0.f, 0.f );
+  sources.push_back( 0.2f, 0.f );
+  sources.push_back( 0.1f, 0.f );
+  reco::DeltaRMatcher<float> uniqueMatcher( 0.09f, targets );
+  std::vector<int> byOrder = { 0, -1 }, byDistance = { -1, 0 };
+  CPPUNIT_ASSERT( uniqueMatcher.uniqueByOrder( sources ) == byOrder );
+  CPPUNIT_ASSERT( uniqueMatcher.uniqueByDistance( sources ) == byDistance );
+  std::vector<bool> overlaps = { true, true };
+  CPPUNIT_ASSERT( uniqueMatcher.hasMatch( sources ) == overlaps );
+}
+
+void testDeltaRMatcher::checkAgainstLoops() {
+  std::mt19937 gen( 42 );
+  unsigned failures = 0;
+  for ( double maxDR : { 0.01, 0.1, 0.4, 0.8, 2.5, 5. } ) {
+    for ( unsigned n : { 0, 5, 40, 300 } ) {
+      failures += test::compare<float>( gen, 50, n, float( maxDR*maxDR ) );
+      failures += test::compare<double>( gen, 50, n, maxDR*maxDR );
+    }
+  }
+  CPPUNIT_ASSERT( failures == 0 );
+}
@@ -0,0 +1,185 @@
+#ifndef CondCore_CondDB_PayloadCache_h
+#define CondCore_CondDB_PayloadCache_h
+//
+// Package:     CondDB
+// Class  :     PayloadCache
+//
+/**\class PayloadCache PayloadCache.h CondCore/CondDB/interface/PayloadCache.h
+   Description: process-wide cache of the deserialized payloads, keyed by payload hash and type.
+   The objects are kept within a memory budget, measured on the deserialized objects, and evicted
+   in least-recently-used order.
+   Optionally, the payload blobs fetched from the database are also stored in a directory,
+   which can be shared by subsequent jobs.
+   The payloads are immutable (the hash is computed from the content), so all the proxies
+   requesting the same payload share the same object.
+   A prefetch only reserves an entry and queues its load. The first of the queued load and of
+   a fetch to claim the entry loads the payload; a fetch never waits for another thread.
+*/
+//
+
+#include "CondCore/CondDB/interface/Session.h"
+#include "FWCore/Concurrency/interface/SerialTaskQueue.h"
+//
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <typeinfo>
+
+namespace cond {
+
+  namespace persistency {
+
+    class PayloadCache {
+    public:
+      struct Stats {
+	size_t hits;
+	size_t misses;
+	size_t diskHits;
+	size_t prefetched;
+	size_t evicted;
+      };
+
+      static PayloadCache& instance();
+
+      // memoryBudget in bytes, 0 disables the memory cache; an empty directory disables the disk cache
+      void configure( size_t memoryBudget, const std::string& diskCacheDirectory );
+
+      bool isEnabled() const;
+
+      // returns the payload from the memory cache, or loads it on this thread from the disk cache
+      // or the database, in that order, also when a prefetch of the payload is queued or running.
+      // a transaction has to be active on the session.
+      template <typename T> std::shared_ptr<T> fetch( Session& session, const Hash& payloadHash );
+
+      template <typename T> static std::string key( const Hash& payloadHash ){
+	return payloadHash+"@"+typeid(T).name();
+      }
+
+      // reserves an entry for a prefetch: false if the payload is already cached or reserved
+      bool reserve( const std::string& key );
+
+      // claims a reserved entry for the prefetch load: false if a fetch has claimed it meanwhile
+      bool claim( const std::string& key );
+
+      // loads and deserializes the payload, and stores it in the claimed entry. Returns the stored
+      // payload, which is the one of a concurrent load of the same entry if it finished first.
+      // if sessionMutex is not null, the session is locked and a transaction is opened for the data access.
+      template <typename T> std::shared_ptr<T> load( Session& session, std::mutex* sessionMutex, const Hash& payloadHash,
+						     const std::string& key );
+
+      Stats stats() const;
+
+      size_t memoryUsage() const;
+
+      void clear();
+
+      // size in memory of a deserialized object, from its ROOT dictionary; fallback if there is none
+      static size_t objectSize( const void* object, const std::type_info& type, size_t fallback );
+
+    private:
+      PayloadCache();
+
+      // claims the entry for a fetch: false, with the payload, if it is already loaded
+      bool acquire( const std::string& key, std::shared_ptr<void>& payload );
+      void loadData( Session& session, std::mutex* sessionMutex, const Hash& payloadHash,
+		     std::string& payloadType, Binary& payloadData, Binary& streamerInfoData );
+      std::shared_ptr<void> loaded( const std::string& key, std::shared_ptr<void> payload, size_t size );
+      void failed( const std::string& key );
+      void evict();
+
+      bool readFromDisk( const Hash& payloadHash, std::string& payloadType, Binary& payloadData, Binary& streamerInfoData );
+      void writeToDisk( const Hash& payloadHash, const std::string& payloadType, const Binary& payloadData, const Binary& streamerInfoData );
+
+      template <typename T> static const void* mostDerived( const T& payload, std::true_type ){
+	return dynamic_cast<const void*>( &payload );
+      }
+      template <typename T> static const void* mostDerived( const T& payload, std::false_type ){
+	return &payload;
+      }
+
+      struct Entry {
+	std::shared_ptr<void> payload; // null until loaded
+	size_t size;
+	unsigned long long lastUse;
+	bool claimed;                  // a fetch or the prefetch task is loading it
+      };
+
+      mutable std::mutex m_mutex;
+      std::map<std::string,Entry> m_entries;
+      size_t m_memoryBudget;
+      size_t m_memoryUsage;
+      std::string m_diskCacheDirectory;
+      unsigned long long m_clock;
+      Stats m_stats;
+    };
+
+    // loads payloads in the background, with its own session to the database.
+    // the loads run one at a time as TBB tasks, so the prefetch takes at most one of the job's threads.
+    class PayloadPrefetcher {
+    public:
+      explicit PayloadPrefetcher( const Session& session );
+
+      // waits for the pending prefetches
+      ~PayloadPrefetcher();
+
+      template <typename T> void prefetch( const Hash& payloadHash );
+
+      void wait();
+
+    private:
+      Session m_session;
+      std::mutex m_sessionMutex;
+      edm::SerialTaskQueue m_queue;
+    };
+
+    template <typename T> inline std::shared_ptr<T> PayloadCache::fetch( Session& session, const Hash& payloadHash ){
+      std::string k = key<T>( payloadHash );
+      std::shared_ptr<void> payload;
+      if( !acquire( k, payload ) ) return std::static_pointer_cast<T>( payload );
+      return load<T>( session, nullptr, payloadHash, k );
+    }
+
+    template <typename T> inline std::shared_ptr<T> PayloadCache::load( Session& session, std::mutex* sessionMutex, const Hash& payloadHash,
+									const std::string& key ){
+      try {
+	std::string payloadType;
+	Binary payloadData;
+	Binary streamerInfoData;
+	loadData( session, sessionMutex, payloadHash, payloadType, payloadData, streamerInfoData );
+	std::shared_ptr<T> payload;
+	try{
+	  payload = deserialize<T>( payloadType, payloadData, streamerInfoData );
+	} catch ( const cond::persistency::Exception& e ){
+	  std::string em(e.what());
+	  throwException( "Payload of type "+payloadType+" with id "+payloadHash+" could not be loaded. "+em,"PayloadCache::load");
+	}
+	// without a dictionary, the size of the serialized data is taken as an estimate
+	size_t size = objectSize( mostDerived( *payload, std::is_polymorphic<T>() ), typeid( *payload ),
+				  payloadData.size() + sizeof(T) );
+	return std::static_pointer_cast<T>( loaded( key, payload, size ) );
+      } catch ( ... ){
+	failed( key );
+	throw;
+      }
+    }
+
+    template <typename T> inline void PayloadPrefetcher::prefetch( const Hash& payloadHash ){
+      PayloadCache& cache = PayloadCache::instance();
+      std::string key = PayloadCache::key<T>( payloadHash );
+      // already cached, or being loaded
+      if( !cache.reserve( key ) ) return;
+      m_queue.push( [this,&cache,payloadHash,key](){
+	  // a fetch has claimed the payload since, and loads it itself
+	  if( !cache.claim( key ) ) return;
+	  try {
+	    cache.load<T>( m_session, &m_sessionMutex, payloadHash, key );
+	  } catch ( ... ){
+	    // the entry is released: the fetch loads the payload again and reports its own error
+	  }
+	} );
+    }
+
+  }
+}
+#endif
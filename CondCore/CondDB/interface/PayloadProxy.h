@@ -3,6 +3,7 @@
 
 #include "CondCore/CondDB/interface/Session.h"
 #include "CondCore/CondDB/interface/Time.h"
+#include "CondCore/CondDB/interface/PayloadCache.h"
 
 namespace cond {
 
@@ -26,6 +27,9 @@ namespace cond {
       BasePayloadProxy();
 
       void setUp( Session dbSession );
+
+      // the payload of the IOV following the one requested is loaded in the background
+      void setPrefetcher( const std::shared_ptr<PayloadPrefetcher>& prefetcher );
       
       void loadTag( const std::string& tag );
 
@@ -60,6 +64,8 @@ namespace cond {
     
     private:
       virtual void loadPayload() = 0;   
+
+      virtual void prefetchPayload( const Hash& payloadId ) = 0;
       
     
     protected:
@@ -67,6 +73,7 @@ namespace cond {
       Iov_t m_currentIov;
       Session m_session;
       std::vector<Iov_t> m_requests;
+      std::shared_ptr<PayloadPrefetcher> m_prefetcher;
       
     };
     
@@ -117,10 +124,19 @@ namespace cond {
 	if( m_currentIov.payloadId.empty() ){
 	  throwException( "Can't load payload: no valid IOV found.","PayloadProxy::loadPayload" );
 	}
-	m_data = m_session.fetchPayload<DataT>( m_currentIov.payloadId );
+	PayloadCache& cache = PayloadCache::instance();
+	if( cache.isEnabled() ){
+	  m_data = cache.fetch<DataT>( m_session, m_currentIov.payloadId );
+	} else {
+	  m_data = m_session.fetchPayload<DataT>( m_currentIov.payloadId );
+	}
 	m_currentPayloadId = m_currentIov.payloadId;	  
 	m_requests.push_back( m_currentIov );
       }
+
+      void prefetchPayload( const Hash& payloadId ) override {
+	m_prefetcher->prefetch<DataT>( payloadId );
+      }
       
     private:
       std::shared_ptr<DataT> m_data;
@@ -0,0 +1,302 @@
+#include "CondCore/CondDB/interface/PayloadCache.h"
+#include "CondCore/CondDB/interface/Exception.h"
+//
+#include <boost/filesystem/operations.hpp>
+#include "TClass.h"
+#include "TDataMember.h"
+#include "TDataType.h"
+#include "TList.h"
+#include "TRealData.h"
+#include "TVirtualCollectionProxy.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+namespace cond {
+
+  namespace persistency {
+
+    static const char DISK_CACHE_MAGIC[4] = { 'C', 'D', 'B', 'P' };
+
+    PayloadCache& PayloadCache::instance(){
+      static PayloadCache s_instance;
+      return s_instance;
+    }
+
+    PayloadCache::PayloadCache():
+      m_mutex(),
+      m_entries(),
+      m_memoryBudget( 0 ),
+      m_memoryUsage( 0 ),
+      m_diskCacheDirectory(""),
+      m_clock( 0 ),
+      m_stats(){
+    }
+
+    void PayloadCache::configure( size_t memoryBudget, const std::string& diskCacheDirectory ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      // several sources may configure the cache: the largest budget is kept
+      if( memoryBudget > m_memoryBudget ) m_memoryBudget = memoryBudget;
+      if( !diskCacheDirectory.empty() ){
+	if( !m_diskCacheDirectory.empty() && m_diskCacheDirectory != diskCacheDirectory ){
+	  throwException( "The payload disk cache is already configured in "+m_diskCacheDirectory+
+			  ", can't use "+diskCacheDirectory+" in the same process.","PayloadCache::configure" );
+	}
+	boost::system::error_code ec;
+	boost::filesystem::create_directories( diskCacheDirectory, ec );
+	if( ec ) throwException( "Can't create the payload disk cache directory "+diskCacheDirectory+": "+ec.message(),
+				 "PayloadCache::configure" );
+	m_diskCacheDirectory = diskCacheDirectory;
+      }
+    }
+
+    bool PayloadCache::isEnabled() const {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      return m_memoryBudget > 0 || !m_diskCacheDirectory.empty();
+    }
+
+    bool PayloadCache::acquire( const std::string& key, std::shared_ptr<void>& payload ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      Entry& entry = m_entries[ key ];
+      entry.lastUse = ++m_clock;
+      if( entry.payload ){
+	payload = entry.payload;
+	m_stats.hits++;
+	return false;
+      }
+      // a new entry, or one reserved by a prefetch: its queued load will find it claimed.
+      // if the prefetch is already loading it, it is loaded here as well rather than waited for.
+      entry.claimed = true;
+      m_stats.misses++;
+      return true;
+    }
+
+    bool PayloadCache::reserve( const std::string& key ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      if( m_entries.find( key ) != m_entries.end() ) return false;
+      Entry& entry = m_entries[ key ];
+      entry.lastUse = ++m_clock;
+      m_stats.prefetched++;
+      return true;
+    }
+
+    bool PayloadCache::claim( const std::string& key ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      auto it = m_entries.find( key );
+      if( it == m_entries.end() || it->second.claimed ) return false;
+      it->second.claimed = true;
+      return true;
+    }
+
+    std::shared_ptr<void> PayloadCache::loaded( const std::string& key, std::shared_ptr<void> payload, size_t size ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      auto it = m_entries.find( key );
+      // the entry was cleared meanwhile: the payload is not cached
+      if( it == m_entries.end() ) return payload;
+      // the first of two concurrent loads is kept, so that the object is shared
+      if( it->second.payload ) return it->second.payload;
+      it->second.payload = payload;
+      it->second.size = size;
+      m_memoryUsage += size;
+      evict();
+      return payload;
+    }
+
+    void PayloadCache::failed( const std::string& key ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      auto it = m_entries.find( key );
+      // a concurrent load of the same payload may have succeeded
+      if( it == m_entries.end() || it->second.payload ) return;
+      m_entries.erase( it );
+    }
+
+    // to be called with the mutex locked.
+    // the entries still being loaded are not evicted; the payloads of the evicted entries
+    // stay alive as long as a proxy holds them.
+    void PayloadCache::evict(){
+      while( m_memoryUsage > m_memoryBudget ){
+	auto lru = m_entries.end();
+	for( auto it = m_entries.begin(); it != m_entries.end(); ++it ){
+	  if( !it->second.payload ) continue;
+	  if( lru == m_entries.end() || it->second.lastUse < lru->second.lastUse ) lru = it;
+	}
+	if( lru == m_entries.end() ) break;
+	m_memoryUsage -= lru->second.size;
+	m_entries.erase( lru );
+	m_stats.evicted++;
+      }
+    }
+
+    void PayloadCache::loadData( Session& session, std::mutex* sessionMutex, const Hash& payloadHash,
+				 std::string& payloadType, Binary& payloadData, Binary& streamerInfoData ){
+      bool found = readFromDisk( payloadHash, payloadType, payloadData, streamerInfoData );
+      if( found ){
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_stats.diskHits++;
+      } else {
+	if( sessionMutex ){
+	  std::lock_guard<std::mutex> lock( *sessionMutex );
+	  TransactionScope transaction( session.transaction() );
+	  transaction.start( true );
+	  found = session.fetchPayloadData( payloadHash, payloadType, payloadData, streamerInfoData );
+	  transaction.commit();
+	} else {
+	  found = session.fetchPayloadData( payloadHash, payloadType, payloadData, streamerInfoData );
+	}
+	if( !found )
+	  throwException( "Payload with id "+payloadHash+" has not been found in the database.","PayloadCache::loadData" );
+	writeToDisk( payloadHash, payloadType, payloadData, streamerInfoData );
+      }
+    }
+
+    namespace {
+      size_t heapSize( const void* object, TClass* cl );
+
+      // the memory owned by the collections and strings of an object, in addition to its own size
+      size_t memberHeapSize( const void* object, TClass* cl ){
+	size_t size = 0;
+	cl->BuildRealData();
+	TIter next( cl->GetListOfRealData() );
+	while( TRealData* rd = static_cast<TRealData*>( next() ) ){
+	  TDataMember* dm = rd->GetDataMember();
+	  // the owned pointers are not followed; the embedded objects are listed with their own members
+	  if( !dm || dm->IsaPointer() || dm->IsBasic() || dm->IsEnum() ) continue;
+	  TClass* mcl = TClass::GetClass( dm->GetTrueTypeName(), true, true );
+	  if( !mcl || ( !mcl->GetCollectionProxy() && mcl != TClass::GetClass( typeid(std::string) ) ) ) continue;
+	  size_t n = 1;
+	  for( Int_t d = 0; d < dm->GetArrayDim(); ++d ) n *= dm->GetMaxIndex( d );
+	  const char* member = static_cast<const char*>( object ) + rd->GetThisOffset();
+	  for( size_t i = 0; i < n; ++i ) size += heapSize( member + i*mcl->Size(), mcl );
+	}
+	return size;
+      }
+
+      size_t heapSize( const void* object, TClass* cl ){
+	if( cl == TClass::GetClass( typeid(std::string) ) ){
+	  const std::string& str = *static_cast<const std::string*>( object );
+	  // a short string is stored in the object itself
+	  const char* inside = static_cast<const char*>( object );
+	  if( str.data() >= inside && str.data() < inside + sizeof(std::string) ) return 0;
+	  return str.capacity() + 1;
+	}
+	if( !cl->GetCollectionProxy() ) return memberHeapSize( object, cl );
+	// a proxy of its own, since the one of the class may be in use on another thread
+	std::unique_ptr<TVirtualCollectionProxy> proxy( cl->GetCollectionProxy()->Generate() );
+	TVirtualCollectionProxy::TPushPop helper( proxy.get(), const_cast<void*>( object ) );
+	const size_t n = proxy->Size();
+	TClass* value = proxy->GetValueClass();
+	if( !value ){
+	  TDataType* type = TDataType::GetDataType( proxy->GetType() );
+	  return n*( type ? type->Size() : proxy->GetIncrement() );
+	}
+	size_t size = n*value->Size();
+	for( size_t i = 0; i < n; ++i ) size += heapSize( proxy->At( i ), value );
+	return size;
+      }
+    }
+
+    size_t PayloadCache::objectSize( const void* object, const std::type_info& type, size_t fallback ){
+      TClass* cl = TClass::GetClass( type, true, true );
+      if( !cl || !cl->HasDictionary() ) return fallback;
+      return cl->Size() + heapSize( object, cl );
+    }
+
+    namespace {
+      template <typename T> bool readValue( std::ifstream& f, T& value ){
+	return bool( f.read( reinterpret_cast<char*>( &value ), sizeof(T) ) );
+      }
+
+      bool readString( std::ifstream& f, std::string& s ){
+	uint64_t size = 0;
+	if( !readValue( f, size ) ) return false;
+	s.resize( size );
+	return size == 0 || bool( f.read( &s[0], size ) );
+      }
+
+      bool readBinary( std::ifstream& f, Binary& b ){
+	uint64_t size = 0;
+	if( !readValue( f, size ) ) return false;
+	std::vector<char> buffer( size );
+	if( size && !f.read( buffer.data(), size ) ) return false;
+	b = Binary( buffer.data(), size );
+	return true;
+      }
+
+      template <typename T> void writeValue( std::ofstream& f, const T& value ){
+	f.write( reinterpret_cast<const char*>( &value ), sizeof(T) );
+      }
+
+      void writeBuffer( std::ofstream& f, const void* data, uint64_t size ){
+	writeValue( f, size );
+	if( size ) f.write( static_cast<const char*>( data ), size );
+      }
+    }
+
+    bool PayloadCache::readFromDisk( const Hash& payloadHash, std::string& payloadType, Binary& payloadData, Binary& streamerInfoData ){
+      if( m_diskCacheDirectory.empty() ) return false;
+      std::ifstream f( m_diskCacheDirectory+"/"+payloadHash+".payload", std::ios::binary );
+      if( !f ) return false;
+      char magic[4];
+      if( !f.read( magic, 4 ) || !std::equal( magic, magic+4, DISK_CACHE_MAGIC ) ) return false;
+      // a corrupted or truncated file is ignored, and rewritten after the database access
+      return readString( f, payloadType ) && readBinary( f, payloadData ) && readBinary( f, streamerInfoData );
+    }
+
+    void PayloadCache::writeToDisk( const Hash& payloadHash, const std::string& payloadType, const Binary& payloadData, const Binary& streamerInfoData ){
+      if( m_diskCacheDirectory.empty() ) return;
+      std::string fileName = m_diskCacheDirectory+"/"+payloadHash+".payload";
+      // concurrent jobs may write the same payload: each one writes its own file, then renames it
+      std::string tmpName = fileName+"."+std::to_string( ::getpid() )+"."+std::to_string( std::hash<std::thread::id>()( std::this_thread::get_id() ) )+".tmp";
+      {
+	std::ofstream f( tmpName, std::ios::binary );
+	if( !f ) return;
+	f.write( DISK_CACHE_MAGIC, 4 );
+	writeBuffer( f, payloadType.data(), payloadType.size() );
+	writeBuffer( f, payloadData.data(), payloadData.size() );
+	writeBuffer( f, streamerInfoData.data(), streamerInfoData.size() );
+	if( !f ){
+	  f.close();
+	  std::remove( tmpName.c_str() );
+	  return;
+	}
+      }
+      // the disk cache is an optimization: failures are not reported
+      if( std::rename( tmpName.c_str(), fileName.c_str() ) != 0 ) std::remove( tmpName.c_str() );
+    }
+
+    PayloadCache::Stats PayloadCache::stats() const {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      return m_stats;
+    }
+
+    size_t PayloadCache::memoryUsage() const {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      return m_memoryUsage;
+    }
+
+    void PayloadCache::clear(){
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_entries.clear();
+      m_memoryUsage = 0;
+      m_stats = Stats();
+    }
+
+    PayloadPrefetcher::PayloadPrefetcher( const Session& session ):
+      m_session( session ),
+      m_sessionMutex(),
+      m_queue(){
+    }
+
+    PayloadPrefetcher::~PayloadPrefetcher(){
+      wait();
+    }
+
+    void PayloadPrefetcher::wait(){
+      // the queue is serial: the empty task runs after all the pending loads
+      m_queue.pushAndWait( [](){} );
+    }
+
+  }
+}
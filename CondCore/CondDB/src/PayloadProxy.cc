@@ -14,6 +14,10 @@ namespace cond {
       m_session = dbSession;
       invalidateCache();    
     }
+
+    void BasePayloadProxy::setPrefetcher( const std::shared_ptr<PayloadPrefetcher>& prefetcher ){
+      m_prefetcher = prefetcher;
+    }
     
     void BasePayloadProxy::loadTag( const std::string& tag ){
       m_session.transaction().start(true);
@@ -42,6 +46,10 @@ namespace cond {
 	if( it != m_iovProxy.end() ) {
 	  m_currentIov = *it;
 	  if(load) loadPayload();
+	  if( m_prefetcher && m_currentIov.till < cond::time::MAX_VAL ){
+	    auto next = m_iovProxy.find( m_currentIov.till+1 );
+	    if( next != m_iovProxy.end() && (*next).payloadId != m_currentIov.payloadId ) prefetchPayload( (*next).payloadId );
+	  }
 	}
 	m_session.transaction().commit();
       }
@@ -124,6 +124,35 @@ int main (int argc, char** argv)
     } catch ( cond::persistency::Exception& e ){
       std::cout <<"Expected error: "<<e.what()<<std::endl;
     }
+
+    // payload cache and prefetch of the next iov
+    PayloadCache& cache = PayloadCache::instance();
+    cache.configure( 1024*1024, "" );
+    auto prefetcher = std::make_shared<PayloadPrefetcher>( connPool.createReadOnlySession( connectionString, "" ) );
+    PayloadProxy<MyTestData> pp3;
+    pp3.setUp( session );
+    pp3.setPrefetcher( prefetcher );
+    pp3.loadTag( "MyNewIOV2" );
+    pp3.setIntervalFor( 25, true );
+    prefetcher->wait();
+    PayloadCache::Stats s0 = cache.stats();
+    if( pp3() != d0 || s0.misses != 1 || s0.prefetched != 1 ){
+      std::cout <<"ERROR: payload cache: first iov not loaded or next iov not prefetched."<<std::endl;
+    } else {
+      std::cout <<"Next iov prefetched."<<std::endl;
+    }
+    pp3.setIntervalFor( 100000, true );
+    PayloadProxy<MyTestData> pp4;
+    pp4.setUp( session );
+    pp4.loadTag( "MyNewIOV2" );
+    pp4.setIntervalFor( 25, true );
+    PayloadCache::Stats s1 = cache.stats();
+    if( pp3() != d1 || pp4() != d0 || s1.hits != 2 || s1.misses != 1 ){
+      std::cout <<"ERROR: payload cache: cached payloads not shared."<<std::endl;
+    } else {
+      std::cout << "Payload cache hits "<<s1.hits<<" misses "<<s1.misses<<" memory "<<cache.memoryUsage()<<std::endl;
+    }
+    cache.clear();
     
   } catch (const std::exception& e){
     std::cout << "ERROR: " << e.what() << std::endl;
@@ -93,6 +93,9 @@ namespace {
  *  config Param
  *  RefreshEachRun: if true will refresh the IOV at each new run (or lumiSection)
  *  DumpStat: if true dump the statistics of all DataProxy (currently on cout)
+ *  PayloadCacheSizeMB: memory budget of the payload cache shared by the proxies of the process, 0 to disable it
+ *  PayloadDiskCacheDir: if not empty, the payloads read from the database are also cached in this directory
+ *  PrefetchPayloads: if true the payload of the next IOV is loaded in the background
  *  DBParameters: configuration set of the connection
  *  globaltag: The GlobalTag
  *  toGet: list of record label tag connection-string to add/overwrite the content of the global-tag
@@ -103,7 +106,8 @@ CondDBESSource::CondDBESSource( const edm::ParameterSet& iConfig ) :
   m_lastRun(0),  // for the stat
   m_lastLumi(0),  // for the stat
   m_policy( NOREFRESH ),
-  m_doDump( iConfig.getUntrackedParameter<bool>( "DumpStat", false ) )
+  m_doDump( iConfig.getUntrackedParameter<bool>( "DumpStat", false ) ),
+  m_prefetch( iConfig.getUntrackedParameter<bool>( "PrefetchPayloads", false ) )
 {
   if( iConfig.getUntrackedParameter<bool>( "RefreshAlways", false ) ) {
     m_policy = REFRESH_ALWAYS;
@@ -121,6 +125,15 @@ CondDBESSource::CondDBESSource( const edm::ParameterSet& iConfig ) :
   Stats s = {0,0,0,0,0,0,0,0};
   m_stats = s;	
 
+  size_t cacheSize = iConfig.getUntrackedParameter<unsigned int>( "PayloadCacheSizeMB", 0 );
+  std::string diskCacheDir = iConfig.getUntrackedParameter<std::string>( "PayloadDiskCacheDir", "" );
+  if( m_prefetch && cacheSize == 0 && diskCacheDir.empty() ) {
+    throw cond::Exception( std::string( "ESSource: PrefetchPayloads requires the payload cache, set PayloadCacheSizeMB" ) );
+  }
+  if( cacheSize > 0 || !diskCacheDir.empty() ) {
+    cond::persistency::PayloadCache::instance().configure( cacheSize*1024*1024, diskCacheDir );
+  }
+
   /*parameter set parsing
    */  
   std::string globaltag("");
@@ -240,6 +253,9 @@ CondDBESSource::CondDBESSource( const edm::ParameterSet& iConfig ) :
       //open db get tag info (i.e. the IOV token...)
       nsess = m_connection.createReadOnlySession( connStr, "" );
       sessions.insert(std::make_pair( connStr, nsess));
+      // the prefetches run concurrently to the proxies: they need their own session
+      if( m_prefetch ) m_prefetchers.insert( std::make_pair( connStr,
+							     std::make_shared<cond::persistency::PayloadPrefetcher>( m_connection.createReadOnlySession( connStr, "" ) ) ) );
     } else nsess = (*p).second;
 
     // ownership...
@@ -255,6 +271,7 @@ CondDBESSource::CondDBESSource( const edm::ParameterSet& iConfig ) :
       tagSnapshotTime = boost::posix_time::ptime();
 
     proxy->lateInit(nsess, tag, tagSnapshotTime, it->second.recordLabel(), connStr);
+    if( m_prefetch ) proxy->proxy()->setPrefetcher( m_prefetchers[connStr] );
   }
 
   // one loaded expose all other tags to the Proxy! 
@@ -305,6 +322,16 @@ CondDBESSource::~CondDBESSource() {
 	      << " Reconnect " << m_stats.nReconnect
 	      << " Actual Reconnect " << m_stats.nActualReconnect;
     std::cout << std::endl;
+    cond::persistency::PayloadCache& cache = cond::persistency::PayloadCache::instance();
+    if( cache.isEnabled() ) {
+      cond::persistency::PayloadCache::Stats cs = cache.stats();
+      std::cout << "PayloadCache hits " << cs.hits
+		<< " misses " << cs.misses
+		<< " prefetched " << cs.prefetched
+		<< " disk hits " << cs.diskHits
+		<< " evicted " << cs.evicted
+		<< " memory " << cache.memoryUsage()/1024 << " kB" << std::endl;
+    }
 
 
     ProxyMap::iterator b= m_proxies.begin();
@@ -17,6 +17,7 @@
 #include <set>
 // user include files
 #include "CondCore/CondDB/interface/ConnectionPool.h"
+#include "CondCore/CondDB/interface/PayloadCache.h"
 
 #include "FWCore/Framework/interface/DataProxyProvider.h"
 #include "FWCore/Framework/interface/EventSetupRecordIntervalFinder.h"
@@ -67,6 +68,8 @@ class CondDBESSource : public edm::eventsetup::DataProxyProvider,
   TagCollection m_tagCollection;
   std::map<std::string,std::pair<cond::persistency::Session,std::string> > m_sessionPool;
   std::map<std::string,unsigned int> m_lastRecordRuns;
+  // one background loader per connection string, when PrefetchPayloads is set
+  std::map<std::string,std::shared_ptr<cond::persistency::PayloadPrefetcher> > m_prefetchers;
   
   struct Stats {
     int nData;
@@ -86,6 +89,7 @@ class CondDBESSource : public edm::eventsetup::DataProxyProvider,
   RefreshPolicy m_policy;
   
   bool m_doDump;
+  bool m_prefetch;
 
  private:
 
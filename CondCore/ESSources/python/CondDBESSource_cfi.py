@@ -11,6 +11,9 @@ GlobalTag = cms.ESSource( "PoolDBESSource",
                           snapshotTime     = cms.string( '' ),
                           toGet            = cms.VPSet(),   # hook to override or add single payloads
                           DumpStat         = cms.untracked.bool( False ),
+                          PayloadCacheSizeMB  = cms.untracked.uint32( 0 ),
+                          PayloadDiskCacheDir = cms.untracked.string( '' ),
+                          PrefetchPayloads    = cms.untracked.bool( False ),
                           ReconnectEachRun = cms.untracked.bool( False ),
                           RefreshAlways    = cms.untracked.bool( False ),
                           RefreshEachRun   = cms.untracked.bool( False ),
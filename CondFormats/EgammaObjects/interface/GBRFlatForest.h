@@ -0,0 +1,68 @@
+#ifndef EGAMMAOBJECTS_GBRFlatForest
+#define EGAMMAOBJECTS_GBRFlatForest
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// GBRFlatForest                                                        //
+//                                                                      //
+// Transient copy of a GBRForest laid out for batch evaluation: the     //
+// nodes of each tree are stored breadth first (depth-major) in a flat  //
+// array of the whole forest, the daughters of a node are adjacent and  //
+// the terminal nodes point to themselves, so that a block of rows      //
+// walks every tree for a fixed number of steps, without branches, with //
+// independent chains of loads for the rows of the block.               //
+//                                                                      //
+// The responses are identical to GBRForest::GetResponse: same float    //
+// comparisons, and sums in the same order.                             //
+//                                                                      //
+// It is meant to be built once per payload (e.g. in an ESProducer or   //
+// a global cache) and shared between the streams.                      //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GBRFlatForest {
+
+  public:
+
+    explicit GBRFlatForest(const GBRForest &forest);
+
+    double GetResponse(const float* vector) const { double response; GetResponses(vector, 1, 0, &response); return response; }
+    //responses of nRows feature vectors, stored stride floats apart
+    void GetResponses(const float* rows, size_t nRows, size_t stride, double* responses) const;
+
+    size_t NTrees() const { return fTrees.size(); }
+    size_t NNodes() const { return fNodes.size(); }
+
+    //C++ source of a function "double name(const float* vector)" returning the response of the forest
+    //with straight-line code, to be compiled in for the forests which are fixed at build time
+    static std::string GenerateCode(const GBRForest &forest, const std::string &name);
+
+  private:
+
+    struct Tree {
+      int32_t root;
+      int32_t depth;
+    };
+
+    //what a step needs, in a single read; the right daughter follows the left one
+    struct Node {
+      int32_t cutIndex;
+      float cutVal;
+      int32_t left;
+    };
+
+    double fInitialResponse;
+    std::vector<Tree> fTrees;
+    //for the whole forest
+    std::vector<Node> fNodes;
+    std::vector<float> fResponses;
+
+};
+
+#endif
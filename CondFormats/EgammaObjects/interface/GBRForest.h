@@ -36,12 +36,15 @@
        virtual ~GBRForest();
        
        double GetResponse(const float* vector) const;
+       //responses of nRows feature vectors, stored stride floats apart
+       void GetResponses(const float* rows, size_t nRows, size_t stride, double* responses) const;
        double GetGradBoostClassifier(const float* vector) const;
        double GetAdaBoostClassifier(const float* vector) const { return GetResponse(vector); }
        
        //for backwards-compatibility
        double GetClassifier(const float* vector) const { return GetGradBoostClassifier(vector); }
        
+       double InitialResponse() const { return fInitialResponse; }
        void SetInitialResponse(double response) { fInitialResponse = response; }
        
        std::vector<GBRTree> &Trees() { return fTrees; }
@@ -64,6 +67,16 @@ inline double GBRForest::GetResponse(const float* vector) const {
   return response;
 }
 
+//_______________________________________________________________________
+inline void GBRForest::GetResponses(const float* rows, size_t nRows, size_t stride, double* responses) const {
+  //tree by tree, so that each tree is read once for all the rows;
+  //the sums are done in the same order as in GetResponse
+  for (size_t i=0; i<nRows; ++i) responses[i] = fInitialResponse;
+  for (std::vector<GBRTree>::const_iterator it=fTrees.begin(); it!=fTrees.end(); ++it) {
+    for (size_t i=0; i<nRows; ++i) responses[i] += it->GetResponse(rows+i*stride);
+  }
+}
+
 //_______________________________________________________________________
 inline double GBRForest::GetGradBoostClassifier(const float* vector) const {
   double response = GetResponse(vector);
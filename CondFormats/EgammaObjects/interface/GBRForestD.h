@@ -33,6 +33,9 @@ class GBRForestD {
     virtual ~GBRForestD();
 
     double GetResponse(const float* vector) const;
+    //responses of nRows feature vectors, stored stride floats apart, walking the trees
+    //one after the other for all the rows; identical to GetResponse row by row
+    void GetResponses(const float* rows, size_t nRows, size_t stride, double* responses) const;
 
     double InitialResponse() const { return fInitialResponse; }
     void SetInitialResponse(double response) { fInitialResponse = response; }
@@ -57,6 +60,18 @@ inline double GBRForestD::GetResponse(const float* vector) const {
   return response;
 }
 
+//_______________________________________________________________________
+inline void GBRForestD::GetResponses(const float* rows, size_t nRows, size_t stride, double* responses) const {
+  for (size_t irow=0; irow<nRows; ++irow) {
+    responses[irow] = fInitialResponse;
+  }
+  for (std::vector<GBRTreeD>::const_iterator it=fTrees.begin(); it!=fTrees.end(); ++it) {
+    for (size_t irow=0; irow<nRows; ++irow) {
+      responses[irow] += it->GetResponse(it->TerminalIndex(rows + irow*stride));
+    }
+  }
+}
+
 //_______________________________________________________________________
 template<typename InputForestT> GBRForestD::GBRForestD(const InputForestT &forest) : 
  fInitialResponse(forest.InitialResponse()) {
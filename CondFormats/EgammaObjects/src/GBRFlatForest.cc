@@ -0,0 +1,128 @@
+#include "CondFormats/EgammaObjects/interface/GBRFlatForest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+  //rows evaluated together: their indices stay in registers or L1
+  constexpr size_t kBlockSize = 64;
+
+  //GBRTree references: positive for intermediate nodes, zero or negative for terminal ones
+  //(the root, 0, is never a daughter)
+  bool isTerminal(int ref) { return ref<=0; }
+
+  std::string floatLiteral(float value) {
+    if (std::isinf(value))
+      return value>0 ? "std::numeric_limits<float>::infinity()" : "-std::numeric_limits<float>::infinity()";
+    //hexadecimal floats are exact
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%af", value);
+    return buffer;
+  }
+
+  void generateNode(std::ostringstream &code, const GBRTree &tree, int ref, int indent, bool root=false) {
+    std::string pad(indent, ' ');
+    if (!root && isTerminal(ref)) {
+      code << pad << "response += " << floatLiteral(tree.Responses()[-ref]) << ";\n";
+      return;
+    }
+    code << pad << "if (vector[" << int(tree.CutIndices()[ref]) << "] > " << floatLiteral(tree.CutVals()[ref]) << ") {\n";
+    generateNode(code, tree, tree.RightIndices()[ref], indent+2);
+    code << pad << "} else {\n";
+    generateNode(code, tree, tree.LeftIndices()[ref], indent+2);
+    code << pad << "}\n";
+  }
+
+}
+
+//_______________________________________________________________________
+GBRFlatForest::GBRFlatForest(const GBRForest &forest) :
+  fInitialResponse(forest.InitialResponse())
+{
+  fTrees.reserve(forest.Trees().size());
+
+  for (const GBRTree &tree : forest.Trees()) {
+    Tree flat;
+    flat.root = fNodes.size();
+    flat.depth = 0;
+
+    //breadth first: (GBRTree reference, depth), the position in the queue is the flat index
+    std::vector<std::pair<int,int> > nodes;
+    nodes.emplace_back(0, 0);
+    for (size_t i=0; i<nodes.size(); ++i) {
+      int ref = nodes[i].first;
+      int depth = nodes[i].second;
+      int32_t self = flat.root + i;
+      Node node;
+      if (i>0 && isTerminal(ref)) {
+        //terminal: absorbing node, whatever the value of the variable (x > +inf is false, NaN included)
+        node.cutIndex = 0;
+        node.cutVal = std::numeric_limits<float>::infinity();
+        node.left = self;
+        fNodes.push_back(node);
+        fResponses.push_back(tree.Responses()[-ref]);
+        flat.depth = std::max(flat.depth, depth);
+        continue;
+      }
+      //the daughters are consecutive: right = left + 1
+      node.cutIndex = tree.CutIndices()[ref];
+      node.cutVal = tree.CutVals()[ref];
+      node.left = flat.root + nodes.size();
+      nodes.emplace_back(tree.LeftIndices()[ref], depth+1);
+      nodes.emplace_back(tree.RightIndices()[ref], depth+1);
+      fNodes.push_back(node);
+      fResponses.push_back(0.f);
+    }
+
+    fTrees.push_back(flat);
+  }
+}
+
+//_______________________________________________________________________
+void GBRFlatForest::GetResponses(const float* rows, size_t nRows, size_t stride, double* responses) const {
+  int32_t index[kBlockSize];
+  const Node *nodes = fNodes.data();
+  const float *values = fResponses.data();
+
+  for (size_t begin=0; begin<nRows; begin+=kBlockSize) {
+    size_t n = std::min(kBlockSize, nRows-begin);
+    const float *vectors = rows + begin*stride;
+    double *block = responses + begin;
+
+    for (size_t i=0; i<n; ++i) block[i] = fInitialResponse;
+
+    for (const Tree &tree : fTrees) {
+      for (size_t i=0; i<n; ++i) index[i] = tree.root;
+      for (int32_t step=0; step<tree.depth; ++step) {
+        for (size_t i=0; i<n; ++i) {
+          const Node &node = nodes[index[i]];
+          index[i] = node.left + (vectors[i*stride+node.cutIndex] > node.cutVal);
+        }
+      }
+      for (size_t i=0; i<n; ++i) block[i] += values[index[i]];
+    }
+  }
+}
+
+//_______________________________________________________________________
+std::string GBRFlatForest::GenerateCode(const GBRForest &forest, const std::string &name) {
+  std::ostringstream code;
+  code << "// generated by GBRFlatForest::GenerateCode from a forest of " << forest.Trees().size() << " trees\n"
+       << "#include <limits>\n\n"
+       << "double " << name << "(const float* vector) {\n";
+  char initial[64];
+  snprintf(initial, sizeof(initial), "%a", forest.InitialResponse());
+  code << "  double response = " << initial << ";\n";
+  for (size_t itree=0; itree<forest.Trees().size(); ++itree) {
+    const GBRTree &tree = forest.Trees()[itree];
+    code << "  // tree " << itree << "\n";
+    generateNode(code, tree, 0, 2, true);
+  }
+  code << "  return response;\n}\n";
+  return code.str();
+}
@@ -0,0 +1,153 @@
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CondFormats/EgammaObjects/interface/GBRFlatForest.h"
+
+#include "TFile.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Validation and benchmark of the batch evaluation of the GBRForest.
+ *
+ *   testGBRFlatForest
+ *     random forests and feature vectors
+ *   testGBRFlatForest <file.root> <forest name> <features.txt>
+ *     a payload stored in a ROOT file, evaluated on recorded feature vectors
+ *     (one vector per line, the values separated by spaces)
+ *
+ * The responses of GBRForest::GetResponses and GBRFlatForest must be identical
+ * to the ones of GBRForest::GetResponse; the times of the three are printed.
+ */
+
+namespace {
+
+  //random tree of at most maxDepth levels, in the GBRTree layout
+  int addNode(GBRTree &tree, std::mt19937 &rng, int nVars, int depth, int maxDepth) {
+    std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+    if (depth==maxDepth || (depth>1 && uniform(rng)<-0.6f)) {
+      tree.Responses().push_back(uniform(rng));
+      return -int(tree.Responses().size()-1);
+    }
+    int index = tree.CutVals().size();
+    tree.CutIndices().push_back(std::uniform_int_distribution<int>(0, nVars-1)(rng));
+    tree.CutVals().push_back(uniform(rng));
+    tree.LeftIndices().push_back(0);
+    tree.RightIndices().push_back(0);
+    int left = addNode(tree, rng, nVars, depth+1, maxDepth);
+    int right = addNode(tree, rng, nVars, depth+1, maxDepth);
+    tree.LeftIndices()[index] = left;
+    tree.RightIndices()[index] = right;
+    return index;
+  }
+
+  std::unique_ptr<GBRForest> randomForest(std::mt19937 &rng, int nTrees, int nVars, int maxDepth) {
+    std::unique_ptr<GBRForest> forest(new GBRForest());
+    forest->SetInitialResponse(0.25);
+    for (int i=0; i<nTrees; ++i) {
+      GBRTree tree;
+      if (i==0) {
+        //single terminal node, with the fake root of GBRTree
+        tree.CutIndices().push_back(0);
+        tree.CutVals().push_back(0.f);
+        tree.LeftIndices().push_back(0);
+        tree.RightIndices().push_back(0);
+        tree.Responses().push_back(0.5f);
+      }
+      else
+        addNode(tree, rng, nVars, 0, maxDepth);
+      forest->Trees().push_back(tree);
+    }
+    return forest;
+  }
+
+  std::vector<float> randomFeatures(std::mt19937 &rng, size_t nRows, int nVars) {
+    std::normal_distribution<float> gauss(0.f, 0.7f);
+    std::vector<float> features(nRows*nVars);
+    for (auto &x : features) x = gauss(rng);
+    //the edge cases of the comparisons
+    features[0] = std::numeric_limits<float>::quiet_NaN();
+    features[1] = std::numeric_limits<float>::infinity();
+    features[2] = -std::numeric_limits<float>::infinity();
+    return features;
+  }
+
+  template <typename F>
+  double time(F f, int repeat) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i=0; i<repeat; ++i) f();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now()-start).count()/repeat;
+  }
+
+  bool check(const char *name, const GBRForest &forest, const std::vector<float> &features, size_t nVars, int repeat) {
+    size_t nRows = features.size()/nVars;
+    const float *rows = features.data();
+    GBRFlatForest flat(forest);
+
+    std::vector<double> reference(nRows), batch(nRows), flatBatch(nRows);
+    double tReference = time([&]() { for (size_t i=0; i<nRows; ++i) reference[i] = forest.GetResponse(rows+i*nVars); }, repeat);
+    double tBatch = time([&]() { forest.GetResponses(rows, nRows, nVars, batch.data()); }, repeat);
+    double tFlat = time([&]() { flat.GetResponses(rows, nRows, nVars, flatBatch.data()); }, repeat);
+
+    size_t different = 0;
+    for (size_t i=0; i<nRows; ++i) {
+      if (batch[i]!=reference[i] || flatBatch[i]!=reference[i]) ++different;
+      if (flat.GetResponse(rows+i*nVars)!=reference[i]) ++different;
+    }
+
+    std::cout << name << ": " << forest.Trees().size() << " trees, " << flat.NNodes() << " nodes, "
+              << nRows << " rows of " << nVars << " variables\n"
+              << "  GetResponse            " << tReference << " us\n"
+              << "  GBRForest::GetResponses " << tBatch << " us\n"
+              << "  GBRFlatForest          " << tFlat << " us (x" << tReference/tFlat << ")\n";
+    if (different)
+      std::cout << "  " << different << " responses differ from GetResponse" << std::endl;
+    return different==0;
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc==4) {
+    TFile file(argv[1]);
+    const GBRForest *forest = file.Get<GBRForest>(argv[2]);
+    if (!forest) {
+      std::cerr << "no GBRForest " << argv[2] << " in " << argv[1] << std::endl;
+      return 2;
+    }
+    std::ifstream in(argv[3]);
+    std::vector<float> features;
+    size_t nVars = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+      std::istringstream values(line);
+      size_t n = 0;
+      float x;
+      while (values >> x) { features.push_back(x); ++n; }
+      if (n==0) continue;
+      if (nVars==0) nVars = n;
+      if (n!=nVars) {
+        std::cerr << "feature vectors of different sizes in " << argv[3] << std::endl;
+        return 2;
+      }
+    }
+    if (nVars==0) {
+      std::cerr << "no feature vectors in " << argv[3] << std::endl;
+      return 2;
+    }
+    return check(argv[2], *forest, features, nVars, 10) ? 0 : 1;
+  }
+
+  std::mt19937 rng(2018);
+  bool ok = true;
+  //small classifier, as the electron and photon IDs
+  ok &= check("shallow", *randomForest(rng, 300, 20, 4), randomFeatures(rng, 40, 20), 20, 200);
+  //deep regression, over more rows than a block
+  ok &= check("deep", *randomForest(rng, 200, 30, 12), randomFeatures(rng, 1000, 30), 30, 10);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#include "CondFormats/EgammaObjects/interface/GBRForestD.h"
+
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+/*
+ * Validation of the batch evaluation of the GBRForestD, as done for all the
+ * superclusters of an event by the semi-parametric regression:
+ * GBRForestD::GetResponses must give responses identical to the ones of
+ * GBRForestD::GetResponse, whatever the number of rows and the stride
+ * between them.
+ */
+
+namespace {
+
+  //random tree of at most maxDepth levels, in the GBRTreeD layout
+  int addNode(GBRTreeD &tree, std::mt19937 &rng, int nVars, int depth, int maxDepth) {
+    std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+    if (depth==maxDepth || (depth>1 && uniform(rng)<-0.6f)) {
+      tree.Responses().push_back(uniform(rng)*1e3);
+      return -int(tree.Responses().size()-1);
+    }
+    int index = tree.CutVals().size();
+    tree.CutIndices().push_back(std::uniform_int_distribution<int>(0, nVars-1)(rng));
+    tree.CutVals().push_back(uniform(rng));
+    tree.LeftIndices().push_back(0);
+    tree.RightIndices().push_back(0);
+    int left = addNode(tree, rng, nVars, depth+1, maxDepth);
+    int right = addNode(tree, rng, nVars, depth+1, maxDepth);
+    tree.LeftIndices()[index] = left;
+    tree.RightIndices()[index] = right;
+    return index;
+  }
+
+  GBRForestD randomForest(std::mt19937 &rng, int nTrees, int nVars, int maxDepth) {
+    GBRForestD forest;
+    forest.SetInitialResponse(1.25);
+    for (int i=0; i<nTrees; ++i) {
+      GBRTreeD tree;
+      if (i==0) {
+        //single terminal node, with the fake root of GBRTreeD
+        tree.CutIndices().push_back(0);
+        tree.CutVals().push_back(0.f);
+        tree.LeftIndices().push_back(0);
+        tree.RightIndices().push_back(0);
+        tree.Responses().push_back(0.5);
+      }
+      else
+        addNode(tree, rng, nVars, 0, maxDepth);
+      forest.Trees().push_back(tree);
+    }
+    return forest;
+  }
+
+  //nRows rows of nVars features, stride floats apart; the padding between
+  //the rows is never read
+  std::vector<float> randomRows(std::mt19937 &rng, size_t nRows, int nVars, size_t stride) {
+    std::normal_distribution<float> gauss(0.f, 0.7f);
+    std::vector<float> rows(nRows*stride, std::numeric_limits<float>::quiet_NaN());
+    for (size_t i=0; i<nRows; ++i)
+      for (int j=0; j<nVars; ++j) rows[i*stride+j] = gauss(rng);
+    //the edge cases of the comparisons
+    if (nRows>0) {
+      rows[0] = std::numeric_limits<float>::quiet_NaN();
+      rows[nVars>1 ? 1 : 0] = std::numeric_limits<float>::infinity();
+      rows[(nRows-1)*stride] = -std::numeric_limits<float>::infinity();
+    }
+    return rows;
+  }
+
+  bool check(const GBRForestD &forest, const std::vector<float> &rows, size_t nRows, size_t stride) {
+    //one more response than the rows, which must not be written
+    std::vector<double> responses(nRows+1, -1.);
+    forest.GetResponses(rows.data(), nRows, stride, responses.data());
+    size_t different = 0;
+    for (size_t i=0; i<nRows; ++i) {
+      if (responses[i]!=forest.GetResponse(rows.data()+i*stride)) ++different;
+    }
+    if (responses[nRows]!=-1.) ++different;
+    if (different)
+      std::cout << "Error: " << different << " responses of " << nRows << " rows, " << stride
+                << " floats apart, differ from GetResponse" << std::endl;
+    return different==0;
+  }
+}
+
+int main() {
+  std::mt19937 rng(2018);
+  const int nVars = 12;
+  bool ok = true;
+  for (int maxDepth : {1, 4, 10}) {
+    GBRForestD forest = randomForest(rng, 150, nVars, maxDepth);
+    for (size_t nRows : {0, 1, 7, 200}) {
+      for (size_t stride : {size_t(nVars), size_t(nVars+3)}) {
+        ok &= check(forest, randomRows(rng, nRows, nVars, stride), nRows, stride);
+      }
+    }
+  }
+  //a forest without trees gives the initial response
+  GBRForestD empty;
+  empty.SetInitialResponse(3.);
+  ok &= check(empty, randomRows(rng, 5, nVars, nVars), 5, nVars);
+
+  if (!ok) return 1;
+  std::cout << "GBRForestD::GetResponses validated" << std::endl;
+  return 0;
+}
@@ -72,6 +72,9 @@ if not options.inputFiles:
         skipFirstLumis = cms.untracked.bool(options.skipFirstLumis),
         deleteDatFiles = cms.untracked.bool(False),
         endOfRunKills  = cms.untracked.bool(endOfRunKills),
+        # read and uncompress the upcoming events ahead, in TBB tasks
+        readAheadMemoryMB = cms.untracked.uint32(256),
+        readAheadThreads = cms.untracked.uint32(2),
     )
 else:
     print "The list of input files is provided. Disabling discovery and running on everything."
@@ -71,6 +71,9 @@ source = cms.Source("DQMProtobufReader",
     deleteDatFiles = cms.untracked.bool(False),
     loadFiles = cms.untracked.bool(True),
     endOfRunKills  = cms.untracked.bool(endOfRunKills),
+    # decode the files of the upcoming lumis ahead, in TBB tasks
+    readAheadMemoryMB = cms.untracked.uint32(256),
+    readAheadThreads = cms.untracked.uint32(2),
 )
 
 print "Source:", source
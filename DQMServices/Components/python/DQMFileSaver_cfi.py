@@ -4,7 +4,8 @@ import FWCore.ParameterSet.Config as cms
 dqmSaver = cms.EDAnalyzer("DQMFileSaver",
     # Possible conventions are "Online", "Offline" and "RelVal".
     convention = cms.untracked.string('Offline'),
-    # Save files in plain ROOT or encode ROOT objects in ProtocolBuffer
+    # Save files in plain ROOT, encode ROOT objects in ProtocolBuffer ('PB'),
+    # or write the binary DQM format ('BIN', Offline only) for fast merging
     fileFormat = cms.untracked.string('ROOT'),
     # Name of the producer.
     producer = cms.untracked.string('DQM'),
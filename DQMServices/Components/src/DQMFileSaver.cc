@@ -52,6 +52,8 @@ dataFileExtension(DQMFileSaver::FileFormat fileFormat)
     extension = ".root";
   else if (fileFormat ==  DQMFileSaver::PB)
     extension = ".pb";
+  else if (fileFormat ==  DQMFileSaver::BIN)
+    extension = ".dqmb";
   return extension;
 }
 
@@ -82,6 +84,15 @@ DQMFileSaver::saveForOfflinePB(const std::string &workflow, int run) const
   dbe_->savePB(filename, filterName_);
 }
 
+void
+DQMFileSaver::saveForOfflineBinary(const std::string &workflow, int run) const
+{
+  char suffix[64];
+  sprintf(suffix, "R%09d", run);
+  std::string filename = onlineOfflineFileName(fileBaseName_, std::string(suffix), workflow, child_, BIN);
+  dbe_->saveBinary(filename, filterName_);
+}
+
 void
 DQMFileSaver::saveForOffline(const std::string &workflow, int run, int lumi) const
 {
@@ -505,10 +516,15 @@ DQMFileSaver::DQMFileSaver(const edm::ParameterSet &ps)
     fileFormat_ = ROOT;
   else if (fileFormat == "PB")
     fileFormat_ = PB;
+  else if (fileFormat == "BIN")
+    fileFormat_ = BIN;
   else
     throw cms::Exception("DQMFileSaver")
       << "Invalid 'fileFormat' parameter '" << fileFormat << "'."
-      << "  Expected one of 'ROOT' or 'PB'.";
+      << "  Expected one of 'ROOT', 'PB' or 'BIN'.";
+  if (fileFormat_ == BIN && convention_ != Offline)
+    throw cms::Exception("DQMFileSaver")
+      << "The 'BIN' file format is only supported in the 'Offline' convention.";
 
   // Allow file producer to be set to specific values in certain conditions.
   producer_ = ps.getUntrackedParameter<std::string>("producer", producer_);
@@ -772,6 +788,8 @@ DQMFileSaver::globalEndRun(const edm::Run & iRun, const edm::EventSetup &) const
 	saveForOffline(workflow_, irun, 0);
       else if (convention_ == Offline && fileFormat_ == PB)
 	saveForOfflinePB(workflow_, irun);
+      else if (convention_ == Offline && fileFormat_ == BIN)
+	saveForOfflineBinary(workflow_, irun);
       else
 	throw cms::Exception("DQMFileSaver")
 	  << "Internal error.  Can only save files in endRun()"
@@ -45,11 +45,13 @@ public:
   enum FileFormat
   {
     ROOT,
-    PB
+    PB,
+    BIN
   };
 
 private:
   void saveForOfflinePB(const std::string &workflow, int run) const;
+  void saveForOfflineBinary(const std::string &workflow, int run) const;
   void saveForOffline(const std::string &workflow, int run, int lumi) const;
 
   void saveForOnlinePB(int run, const std::string &suffix) const;
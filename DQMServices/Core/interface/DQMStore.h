@@ -28,6 +28,7 @@
 namespace edm { class DQMHttpSource; class ParameterSet; class ActivityRegistry; class GlobalContext; }
 namespace lat { class Regexp; }
 namespace dqmstorepb {class ROOTFilePB; class ROOTFilePB_Histo;}
+namespace dqmbinary {class Writer;}
 
 class MonitorElement;
 class QCriterion;
@@ -62,6 +63,9 @@ class fastmatch
 
   bool match (std::string const& s) const;
 
+  /// the pattern, as given to the constructor
+  std::string const& pattern () const { return pattern_; }
+
  private:
   // checks if two strings are equal, starting at the back of the strings
   bool compare_strings_reverse (std::string const& pattern,
@@ -71,6 +75,7 @@ class fastmatch
                         std::string const& input) const;
 
   std::unique_ptr<lat::Regexp> regexp_{nullptr};
+  std::string pattern_;
   std::string fastString_;
   MatchingHeuristicEnum matching_;
 };
@@ -661,6 +666,10 @@ class DQMStore
                                        const std::string &path = "",
                                        const uint32_t run = 0,
                                        const uint32_t lumi = 0);
+  void                          saveBinary(const std::string &filename,
+                                           const std::string &path = "",
+                                           const uint32_t run = 0,
+                                           const uint32_t lumi = 0);
   bool                          open(const std::string &filename,
                                      bool overwrite = false,
                                      const std::string &path ="",
@@ -672,6 +681,25 @@ class DQMStore
                                      bool fileMustExist = true);
   bool                          mtEnabled() { return enableMultiThread_; };
 
+  /// Monitor element decoded from a file by decodeFilePB.
+  struct DecodedElement
+  {
+    std::string                 path;
+    std::string                 name;
+    uint32_t                    flags;
+    std::unique_ptr<TObject>    object;
+  };
+
+  /// Reads and decodes the monitor elements of a protocol buffer file,
+  /// without touching the store: it can run on any thread, ahead of
+  /// loadDecoded.  Returns false if the file does not exist and
+  /// fileMustExist is false.
+  static bool                   decodeFilePB(const std::string &filename,
+                                             std::vector<DecodedElement> &into,
+                                             bool fileMustExist = true);
+  /// Merges the decoded monitor elements into the store, as load() does.
+  void                          loadDecoded(std::vector<DecodedElement> &elements);
+
 
  public:
   // -------------------------------------------------------------------------
@@ -705,6 +733,12 @@ class DQMStore
                                            const std::string &prepend = "",
                                            OpenRunDirs stripdirs = StripRunDirs,
                                            bool fileMustExist = true);
+  bool                          readFileBinary(const std::string &filename,
+                                               bool overwrite = false,
+                                               const std::string &path ="",
+                                               const std::string &prepend = "",
+                                               OpenRunDirs stripdirs = StripRunDirs,
+                                               bool fileMustExist = true);
   bool                          readFile(const std::string &filename,
                                          bool overwrite = false,
                                          const std::string &path ="",
@@ -725,7 +759,7 @@ class DQMStore
                                            const uint32_t lumi = 0,
                                            const uint32_t moduleId = 0) const;
 
-  void                          get_info(const  dqmstorepb::ROOTFilePB_Histo &,
+  static void                   get_info(const  dqmstorepb::ROOTFilePB_Histo &,
                                          std::string & dirname,
                                          std::string & objname,
                                          TObject ** obj);
@@ -750,7 +784,7 @@ class DQMStore
   void        postGlobalBeginLumi(const edm::GlobalContext&);
 
   bool        extract(TObject *obj, const std::string &dir, bool overwrite, bool collateHistograms);
-  TObject *   extractNextObject(TBufferFile&) const;
+  static TObject * extractNextObject(TBufferFile&);
 
   // ---------------------- Booking ------------------------------------
   MonitorElement *              initialise(MonitorElement *me, const std::string &path);
@@ -817,6 +851,13 @@ class DQMStore
                                     MEMap::const_iterator end,
                                     dqmstorepb::ROOTFilePB & file,
                                     unsigned int & counter);
+  void                          saveMonitorElementRangeToBinary(
+                                    std::string const& dir,
+                                    unsigned int run,
+                                    MEMap::const_iterator begin,
+                                    MEMap::const_iterator end,
+                                    dqmbinary::Writer & file,
+                                    unsigned int & counter);
   void                          saveMonitorElementToROOT(
                                     MonitorElement const& me,
                                     TFile & file);
@@ -851,6 +892,7 @@ class DQMStore
   QCMap                         qtests_;
   QAMap                         qalgos_;
   QTestSpecs                    qtestspecs_;
+  mutable bool                  qtestsModified_{false};
 
   std::mutex book_mutex_;
 
@@ -70,6 +70,8 @@ private:
   TH1                   *reference_; //< Current ROOT reference object.
   TH1                   *refvalue_;  //< Soft reference if any.
   std::vector<QReport>  qreports_;   //< QReports associated to this object.
+  uint64_t              updates_;    //< Number of modifications of the object.
+  uint64_t              tested_;     //< Value of updates_ when the quality tests last ran.
 
   MonitorElement *initialise(Kind kind);
   MonitorElement *initialise(Kind kind, TH1 *rootobj);
@@ -135,7 +137,12 @@ public:
 
   /// Mark the object updated.
   void update()
-    { data_.flags |= DQMNet::DQM_PROP_NEW; }
+    { data_.flags |= DQMNet::DQM_PROP_NEW; ++updates_; }
+
+  /// Get the number of modifications of the object; unlike the "was updated"
+  /// flag it is never reset.
+  uint64_t updates() const
+    { return updates_; }
 
   /// specify whether ME should be reset at end of monitoring cycle (default:false);
   /// (typically called by Sources that control the original ME)
@@ -329,6 +336,11 @@ private:
   void addQReport(const DQMNet::QValue &desc, QCriterion *qc);
   void addQReport(QCriterion *qc);
   void updateQReportStats();
+  /// true if the object was modified since the quality tests last ran
+  bool qtestsOutdated() const
+    { return updates_ != tested_; }
+  bool runQTest(size_t i);
+  void qtestsDone();
 
 public:
   TObject *getRootObject() const;
@@ -0,0 +1,507 @@
+#include "DQMServices/Core/src/DQMBinaryFormat.h"
+#include "DQMServices/Core/src/DQMError.h"
+#include "DQMServices/Core/interface/MonitorElement.h"
+#include "TH1F.h"
+#include "TH1S.h"
+#include "TH1D.h"
+#include "TH2F.h"
+#include "TH2S.h"
+#include "TH2D.h"
+#include "TH3F.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+#include "THashList.h"
+#include "TObjString.h"
+#include <cmath>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace dqmbinary;
+
+namespace
+{
+  const size_t ALIGNMENT = 64;
+
+  size_t aligned(size_t size)
+  {
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  }
+
+  bool isProfile(uint32_t kind)
+  {
+    return kind == MonitorElement::DQM_KIND_TPROFILE
+      || kind == MonitorElement::DQM_KIND_TPROFILE2D;
+  }
+
+  /// Size of the bin contents of each kind of histogram, 0 for the others.
+  uint32_t cellSize(uint32_t kind)
+  {
+    switch (kind)
+    {
+    case MonitorElement::DQM_KIND_TH1F:
+    case MonitorElement::DQM_KIND_TH2F:
+    case MonitorElement::DQM_KIND_TH3F:
+      return sizeof(float);
+    case MonitorElement::DQM_KIND_TH1S:
+    case MonitorElement::DQM_KIND_TH2S:
+      return sizeof(short);
+    case MonitorElement::DQM_KIND_TH1D:
+    case MonitorElement::DQM_KIND_TH2D:
+    case MonitorElement::DQM_KIND_TPROFILE:
+    case MonitorElement::DQM_KIND_TPROFILE2D:
+      return sizeof(double);
+    default:
+      return 0;
+    }
+  }
+
+  TAxis *axis(TH1 *h, unsigned i)
+  {
+    return i == 0 ? h->GetXaxis() : (i == 1 ? h->GetYaxis() : h->GetZaxis());
+  }
+
+  /// The bin contents are added as TH1::Add does, in double precision
+  /// and converted back to the storage type; the loop vectorizes.
+  template <class T>
+  void addCells(T *__restrict__ dst, const T *__restrict__ src, uint64_t n)
+  {
+    for (uint64_t i = 0; i < n; ++i)
+      dst[i] = T(double(dst[i]) + double(src[i]));
+  }
+}
+
+Writer::Writer(uint32_t run, uint32_t lumi)
+  : run_(run),
+    lumi_(lumi),
+    data_(ALIGNMENT, 0)
+{}
+
+uint64_t
+Writer::append(const void *data, size_t size)
+{
+  uint64_t offset = data_.size();
+  data_.resize(aligned(offset + size), 0);
+  if (size)
+    std::memcpy(&data_[offset], data, size);
+  return offset;
+}
+
+StringRef
+Writer::append(const std::string &s)
+{
+  StringRef ref = { append(s.data(), s.size()), s.size() };
+  return ref;
+}
+
+void
+Writer::fillAxis(Axis &a, TAxis *rootAxis)
+{
+  a.nbins = rootAxis->GetNbins();
+  a.min = rootAxis->GetXmin();
+  a.max = rootAxis->GetXmax();
+  a.edges = 0;
+  if (rootAxis->GetXbins()->GetSize())
+    a.edges = append(rootAxis->GetXbins()->GetArray(), rootAxis->GetXbins()->GetSize()*sizeof(double));
+  a.nlabels = 0;
+  a.labels = 0;
+  if (THashList *labels = rootAxis->GetLabels())
+  {
+    std::vector<Label> entries;
+    TIter next(labels);
+    while (TObjString *label = static_cast<TObjString *>(next()))
+    {
+      Label l = { static_cast<int32_t>(label->GetUniqueID()), 0, append(std::string(label->GetName())) };
+      entries.push_back(l);
+    }
+    a.nlabels = entries.size();
+    a.labels = append(entries.data(), entries.size()*sizeof(Label));
+  }
+  a.title = append(std::string(rootAxis->GetTitle()));
+}
+
+void
+Writer::addScalar(const std::string &path, uint32_t kind, uint32_t flags, const std::string &tagString)
+{
+  Record r;
+  std::memset(&r, 0, sizeof(r));
+  r.kind = kind;
+  r.flags = flags;
+  r.path = append(path);
+  r.title = append(tagString);
+  records_.push_back(r);
+}
+
+void
+Writer::addHistogram(const std::string &path, uint32_t kind, uint32_t flags, TH1 *h)
+{
+  Record r;
+  std::memset(&r, 0, sizeof(r));
+  r.kind = kind;
+  r.flags = flags;
+  r.path = append(path);
+  r.title = append(std::string(h->GetTitle()));
+  for (unsigned i = 0; i < 3; ++i)
+    fillAxis(r.axis[i], axis(h, i));
+  h->GetStats(r.stats);
+  r.entries = h->GetEntries();
+  r.nCells = h->GetNcells();
+
+  if (auto *a = dynamic_cast<TArrayF *>(h))
+  {
+    r.cellSize = sizeof(float);
+    r.content = append(a->GetArray(), r.nCells*sizeof(float));
+  }
+  else if (auto *a = dynamic_cast<TArrayS *>(h))
+  {
+    r.cellSize = sizeof(short);
+    r.content = append(a->GetArray(), r.nCells*sizeof(short));
+  }
+  else if (auto *a = dynamic_cast<TArrayD *>(h))
+  {
+    r.cellSize = sizeof(double);
+    r.content = append(a->GetArray(), r.nCells*sizeof(double));
+  }
+  else
+    raiseDQMError("DQMStore", "Cannot write histogram '%s' of type '%s' in binary format",
+                  path.c_str(), h->IsA()->GetName());
+
+  if (h->GetSumw2N())
+    r.sumw2 = append(h->GetSumw2()->GetArray(), r.nCells*sizeof(double));
+
+  if (isProfile(kind))
+  {
+    std::vector<double> binEntries(r.nCells);
+    for (uint64_t i = 0; i < r.nCells; ++i)
+      binEntries[i] = kind == MonitorElement::DQM_KIND_TPROFILE
+        ? static_cast<TProfile *>(h)->GetBinEntries(i)
+        : static_cast<TProfile2D *>(h)->GetBinEntries(i);
+    r.binEntries = append(binEntries.data(), r.nCells*sizeof(double));
+
+    TArrayD *binSumw2 = nullptr;
+    if (kind == MonitorElement::DQM_KIND_TPROFILE)
+    {
+      auto *p = static_cast<TProfile *>(h);
+      r.range[0] = p->GetYmin();
+      r.range[1] = p->GetYmax();
+      r.option = append(std::string(p->GetErrorOption()));
+      binSumw2 = p->GetBinSumw2();
+    }
+    else
+    {
+      auto *p = static_cast<TProfile2D *>(h);
+      r.range[0] = p->GetZmin();
+      r.range[1] = p->GetZmax();
+      r.option = append(std::string(p->GetErrorOption()));
+      binSumw2 = p->GetBinSumw2();
+    }
+    if (binSumw2 && binSumw2->GetSize())
+      r.binSumw2 = append(binSumw2->GetArray(), r.nCells*sizeof(double));
+  }
+  records_.push_back(r);
+}
+
+void
+Writer::write(const std::string &filename)
+{
+  FileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.run = run_;
+  header.lumi = lumi_;
+  header.nRecords = records_.size();
+  header.dataOffset = aligned(sizeof(FileHeader) + records_.size()*sizeof(Record));
+  header.dataSize = data_.size();
+
+  std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(records_.data()), records_.size()*sizeof(Record));
+  std::vector<char> padding(header.dataOffset - sizeof(FileHeader) - records_.size()*sizeof(Record), 0);
+  file.write(padding.data(), padding.size());
+  file.write(data_.data(), data_.size());
+  file.close();
+  if (! file)
+    raiseDQMError("DQMStore", "Failed to write file '%s'", filename.c_str());
+}
+
+Reader::Reader(const std::string &filename)
+  : base_(nullptr),
+    length_(0),
+    data_(nullptr),
+    records_(nullptr)
+{
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    raiseDQMError("DQMStore", "Failed to open file '%s'", filename.c_str());
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader))
+  {
+    ::close(fd);
+    raiseDQMError("DQMStore", "File '%s' is too short to be a DQM binary file", filename.c_str());
+  }
+  length_ = st.st_size;
+  void *addr = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED)
+    raiseDQMError("DQMStore", "Failed to map file '%s'", filename.c_str());
+  base_ = static_cast<const char *>(addr);
+
+  std::memcpy(&header_, base_, sizeof(header_));
+  if (std::memcmp(header_.magic, MAGIC, sizeof(MAGIC)) != 0 || header_.version != VERSION)
+  {
+    ::munmap(const_cast<char *>(base_), length_);
+    raiseDQMError("DQMStore", "File '%s' is not a DQM binary file of version %u", filename.c_str(), VERSION);
+  }
+  if (header_.dataOffset < sizeof(FileHeader) + header_.nRecords*sizeof(Record)
+      || header_.dataOffset > length_
+      || header_.dataSize > length_ - header_.dataOffset)
+  {
+    ::munmap(const_cast<char *>(base_), length_);
+    raiseDQMError("DQMStore", "DQM binary file '%s' is truncated", filename.c_str());
+  }
+  records_ = reinterpret_cast<const Record *>(base_ + sizeof(FileHeader));
+  data_ = base_ + header_.dataOffset;
+  for (uint64_t i = 0; i < header_.nRecords; ++i)
+    if (! valid(records_[i]))
+    {
+      ::munmap(const_cast<char *>(base_), length_);
+      raiseDQMError("DQMStore", "DQM binary file '%s' is corrupted", filename.c_str());
+    }
+}
+
+Reader::~Reader()
+{
+  if (base_)
+    ::munmap(const_cast<char *>(base_), length_);
+}
+
+bool
+Reader::valid(const Record &r) const
+{
+  auto inside = [this](uint64_t offset, uint64_t size)
+    { return offset <= header_.dataSize && size <= header_.dataSize - offset; };
+  if (! inside(r.path.offset, r.path.size)
+      || ! inside(r.title.offset, r.title.size)
+      || ! inside(r.option.offset, r.option.size))
+    return false;
+  if (r.kind < MonitorElement::DQM_KIND_TH1F)
+    return true;
+  if (r.cellSize != cellSize(r.kind)
+      || r.nCells > header_.dataSize / sizeof(double)
+      || (isProfile(r.kind) && (! r.binEntries || ! r.sumw2)))
+    return false;
+  for (const Axis &a : r.axis)
+  {
+    if (a.nbins < 0 || a.nlabels < 0
+        || ! inside(a.title.offset, a.title.size)
+        || (a.edges && ! inside(a.edges, (a.nbins+1)*sizeof(double)))
+        || (a.labels && ! inside(a.labels, a.nlabels*sizeof(Label))))
+      return false;
+    for (int32_t i = 0; a.labels && i < a.nlabels; ++i)
+      if (! inside(array<Label>(a.labels)[i].text.offset, array<Label>(a.labels)[i].text.size))
+        return false;
+  }
+  return r.content && inside(r.content, r.nCells*r.cellSize)
+    && (! r.sumw2 || inside(r.sumw2, r.nCells*sizeof(double)))
+    && (! r.binEntries || inside(r.binEntries, r.nCells*sizeof(double)))
+    && (! r.binSumw2 || inside(r.binSumw2, r.nCells*sizeof(double)));
+}
+
+TH1 *
+Reader::makeHistogram(const Record &r) const
+{
+  std::string path = string(r.path);
+  size_t slash = path.rfind('/');
+  std::string name(path, slash == std::string::npos ? 0 : slash+1);
+  std::string title = string(r.title);
+  const char *n = name.c_str();
+  const char *t = title.c_str();
+  const Axis &x = r.axis[0];
+  const Axis &y = r.axis[1];
+  const Axis &z = r.axis[2];
+
+  TH1 *h = nullptr;
+  switch (r.kind)
+  {
+  case MonitorElement::DQM_KIND_TH1F:
+    h = new TH1F(n, t, x.nbins, x.min, x.max); break;
+  case MonitorElement::DQM_KIND_TH1S:
+    h = new TH1S(n, t, x.nbins, x.min, x.max); break;
+  case MonitorElement::DQM_KIND_TH1D:
+    h = new TH1D(n, t, x.nbins, x.min, x.max); break;
+  case MonitorElement::DQM_KIND_TH2F:
+    h = new TH2F(n, t, x.nbins, x.min, x.max, y.nbins, y.min, y.max); break;
+  case MonitorElement::DQM_KIND_TH2S:
+    h = new TH2S(n, t, x.nbins, x.min, x.max, y.nbins, y.min, y.max); break;
+  case MonitorElement::DQM_KIND_TH2D:
+    h = new TH2D(n, t, x.nbins, x.min, x.max, y.nbins, y.min, y.max); break;
+  case MonitorElement::DQM_KIND_TH3F:
+    h = new TH3F(n, t, x.nbins, x.min, x.max, y.nbins, y.min, y.max, z.nbins, z.min, z.max); break;
+  case MonitorElement::DQM_KIND_TPROFILE:
+    h = new TProfile(n, t, x.nbins, x.min, x.max, r.range[0], r.range[1], string(r.option).c_str()); break;
+  case MonitorElement::DQM_KIND_TPROFILE2D:
+    h = new TProfile2D(n, t, x.nbins, x.min, x.max, y.nbins, y.min, y.max, r.range[0], r.range[1], string(r.option).c_str()); break;
+  default:
+    raiseDQMError("DQMStore", "Unexpected kind %u of element '%s' in DQM binary file", r.kind, path.c_str());
+  }
+  h->SetDirectory(nullptr);
+
+  for (unsigned i = 0; i < 3; ++i)
+  {
+    const Axis &a = r.axis[i];
+    TAxis *rootAxis = axis(h, i);
+    if (a.edges)
+      rootAxis->Set(a.nbins, array<double>(a.edges));
+    for (int32_t l = 0; a.labels && l < a.nlabels; ++l)
+      rootAxis->SetBinLabel(array<Label>(a.labels)[l].bin, string(array<Label>(a.labels)[l].text).c_str());
+    rootAxis->SetTitle(string(a.title).c_str());
+  }
+
+  if (static_cast<uint64_t>(h->GetNcells()) != r.nCells)
+  {
+    delete h;
+    raiseDQMError("DQMStore", "Inconsistent number of bins for element '%s' in DQM binary file", path.c_str());
+  }
+  if (r.cellSize == sizeof(float))
+    dynamic_cast<TArrayF *>(h)->Set(r.nCells, array<float>(r.content));
+  else if (r.cellSize == sizeof(short))
+    dynamic_cast<TArrayS *>(h)->Set(r.nCells, array<short>(r.content));
+  else
+    dynamic_cast<TArrayD *>(h)->Set(r.nCells, array<double>(r.content));
+
+  if (r.sumw2)
+    h->GetSumw2()->Set(r.nCells, array<double>(r.sumw2));
+  else if (h->GetSumw2N())
+    h->Sumw2(kFALSE);
+
+  if (r.kind == MonitorElement::DQM_KIND_TPROFILE)
+  {
+    auto *p = static_cast<TProfile *>(h);
+    for (uint64_t i = 0; i < r.nCells; ++i)
+      p->SetBinEntries(i, array<double>(r.binEntries)[i]);
+    if (r.binSumw2)
+      p->GetBinSumw2()->Set(r.nCells, array<double>(r.binSumw2));
+  }
+  else if (r.kind == MonitorElement::DQM_KIND_TPROFILE2D)
+  {
+    auto *p = static_cast<TProfile2D *>(h);
+    for (uint64_t i = 0; i < r.nCells; ++i)
+      p->SetBinEntries(i, array<double>(r.binEntries)[i]);
+    if (r.binSumw2)
+      p->GetBinSumw2()->Set(r.nCells, array<double>(r.binSumw2));
+  }
+
+  h->PutStats(const_cast<double *>(r.stats));
+  h->SetEntries(r.entries);
+  return h;
+}
+
+bool
+Reader::sameLabels(const Axis &a, TAxis *rootAxis) const
+{
+  // as MonitorElement::CheckBinLabels
+  THashList *labels = rootAxis->GetLabels();
+  if (! labels || ! a.labels)
+    return ! labels && ! a.labels;
+  if (labels->GetSize() != a.nlabels)
+    return false;
+  std::vector<std::string> text(a.nbins+1);
+  for (int32_t l = 0; l < a.nlabels; ++l)
+  {
+    const Label &label = array<Label>(a.labels)[l];
+    if (label.bin >= 1 && label.bin <= a.nbins)
+      text[label.bin] = string(label.text);
+  }
+  for (int32_t bin = 1; bin <= a.nbins; ++bin)
+    if (text[bin] != rootAxis->GetBinLabel(bin))
+      return false;
+  return true;
+}
+
+bool
+Reader::sameBinning(const Record &r, TH1 *h) const
+{
+  // as DQMStore::checkBinningMatches
+  for (unsigned i = 0; i < 3; ++i)
+  {
+    TAxis *rootAxis = axis(h, i);
+    if (rootAxis->GetNbins() != r.axis[i].nbins
+        || rootAxis->GetXmin() != r.axis[i].min
+        || rootAxis->GetXmax() != r.axis[i].max
+        || ! sameLabels(r.axis[i], rootAxis))
+      return false;
+  }
+  return static_cast<uint64_t>(h->GetNcells()) == r.nCells;
+}
+
+/// Same arithmetic as MonitorElement::addProfiles(file, h, h, 1, 1), so
+/// that both paths give identical profiles: the contents are rebuilt from
+/// the bin means, the errors are set from the square root of the summed
+/// squares and the sums of the squared weights of the target are kept.
+template <class PROFILE>
+void
+Reader::addProfileCells(const Record &r, PROFILE *p) const
+{
+  double *content = p->GetArray();
+  double *sumw2 = p->GetSumw2()->GetArray();
+  const double *rContent = array<double>(r.content);
+  const double *rSumw2 = array<double>(r.sumw2);
+  const double *rEntries = array<double>(r.binEntries);
+  for (uint64_t i = 0; i < r.nCells; ++i)
+  {
+    double entries = p->GetBinEntries(i);
+    double rMean = rEntries[i] == 0 ? 0. : rContent[i] / rEntries[i];
+    double mean = entries == 0 ? 0. : content[i] / entries;
+    double error = std::sqrt(rSumw2[i] + sumw2[i]);
+    content[i] = rEntries[i]*rMean + entries*mean;
+    sumw2[i] = error*error;
+    p->SetBinEntries(i, rEntries[i] + entries);
+  }
+}
+
+bool
+Reader::merge(const Record &r, TH1 *h) const
+{
+  if (h->CanExtendAllAxes() || h->TestBit(TH1::kIsAverage) || ! sameBinning(r, h))
+    return false;
+
+  double stats[NSTATS] = { 0 };
+  h->GetStats(stats);
+  for (unsigned i = 0; i < NSTATS; ++i)
+    stats[i] += r.stats[i];
+  double entries = h->GetEntries() + r.entries;
+
+  if (isProfile(r.kind))
+  {
+    auto *content = dynamic_cast<TArrayD *>(h);
+    if (! content || ! r.sumw2 || h->GetSumw2N() != content->GetSize())
+      return false;
+    if (r.kind == MonitorElement::DQM_KIND_TPROFILE)
+      addProfileCells(r, static_cast<TProfile *>(h));
+    else
+      addProfileCells(r, static_cast<TProfile2D *>(h));
+  }
+  else
+  {
+    // TH1::Add creates the errors of the target if only the source has them:
+    // leave that case to it.
+    if (bool(r.sumw2) != bool(h->GetSumw2N()))
+      return false;
+    if (r.cellSize == sizeof(float) && dynamic_cast<TArrayF *>(h))
+      addCells(dynamic_cast<TArrayF *>(h)->GetArray(), array<float>(r.content), r.nCells);
+    else if (r.cellSize == sizeof(short) && dynamic_cast<TArrayS *>(h))
+      addCells(dynamic_cast<TArrayS *>(h)->GetArray(), array<short>(r.content), r.nCells);
+    else if (r.cellSize == sizeof(double) && dynamic_cast<TArrayD *>(h))
+      addCells(dynamic_cast<TArrayD *>(h)->GetArray(), array<double>(r.content), r.nCells);
+    else
+      return false;
+    if (r.sumw2)
+      addCells(h->GetSumw2()->GetArray(), array<double>(r.sumw2), r.nCells);
+  }
+
+  h->PutStats(stats);
+  h->SetEntries(entries);
+  return true;
+}
@@ -0,0 +1,149 @@
+#ifndef DQMSERVICES_CORE_DQM_BINARY_FORMAT_H
+# define DQMSERVICES_CORE_DQM_BINARY_FORMAT_H
+
+# include <cstdint>
+# include <cstring>
+# include <string>
+# include <vector>
+
+class TAxis;
+class TH1;
+
+/** Binary DQM file format (".dqmb"), written and read by the DQMStore.
+
+    The file holds the bin contents of the monitor elements as plain
+    arrays, with the metadata needed to rebuild the ROOT objects, so it
+    can be mapped in memory and merged without ROOT I/O.
+
+    Layout: FileHeader, Record[nRecords], then the data area (strings,
+    bin edges, labels and bin arrays).  All the references inside the
+    file are offsets from the beginning of the data area, where the
+    arrays are 64-byte aligned; offset 0 is never used, and stands for
+    a missing array.  Scalar monitor elements keep their tag string
+    ("<name>i=value</name>") in the title field.  */
+namespace dqmbinary
+{
+  static const char MAGIC[4] = { 'D', 'Q', 'M', 'B' };
+  static const uint32_t VERSION = 1;
+  static const unsigned NSTATS = 13;   // TH1::kNstat
+
+  struct StringRef
+  {
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  struct FileHeader
+  {
+    char     magic[4];
+    uint32_t version;
+    uint32_t run;
+    uint32_t lumi;
+    uint64_t nRecords;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+  };
+
+  struct Label
+  {
+    int32_t   bin;
+    uint32_t  reserved;
+    StringRef text;
+  };
+
+  struct Axis
+  {
+    int32_t   nbins;
+    int32_t   nlabels;
+    double    min;
+    double    max;
+    uint64_t  edges;     // nbins+1 doubles, 0 for a uniform binning
+    uint64_t  labels;    // nlabels Label, 0 without labels
+    StringRef title;
+  };
+
+  struct Record
+  {
+    uint32_t  kind;      // MonitorElement::Kind
+    uint32_t  flags;     // DQMNet flags
+    StringRef path;      // directory/name
+    StringRef title;
+    StringRef option;    // error option of the profiles
+    Axis      axis[3];
+    double    stats[NSTATS];
+    double    entries;
+    double    range[2];  // value range of the profiles
+    uint32_t  cellSize;  // bytes per bin content
+    uint32_t  reserved;
+    uint64_t  nCells;    // number of bins, including under- and overflows
+    uint64_t  content;   // nCells contents, of the type of the histogram
+    uint64_t  sumw2;     // nCells doubles, 0 if the errors are not stored
+    uint64_t  binEntries;// nCells doubles for the profiles, 0 otherwise
+    uint64_t  binSumw2;  // nCells doubles for the weighted profiles, 0 otherwise
+  };
+
+  /// Accumulates the records of a file in memory, then writes it.
+  class Writer
+  {
+  public:
+    Writer(uint32_t run, uint32_t lumi);
+
+    void addScalar(const std::string &path, uint32_t kind, uint32_t flags, const std::string &tagString);
+    void addHistogram(const std::string &path, uint32_t kind, uint32_t flags, TH1 *h);
+
+    void write(const std::string &filename);
+
+  private:
+    uint64_t  append(const void *data, size_t size);
+    StringRef append(const std::string &s);
+    void      fillAxis(Axis &axis, TAxis *rootAxis);
+
+    uint32_t run_;
+    uint32_t lumi_;
+    std::vector<Record> records_;
+    std::vector<char> data_;
+  };
+
+  /// Read-only mapping of a file.
+  class Reader
+  {
+  public:
+    explicit Reader(const std::string &filename);
+    ~Reader();
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    uint32_t run() const { return header_.run; }
+    uint32_t lumi() const { return header_.lumi; }
+    uint64_t size() const { return header_.nRecords; }
+    const Record &record(uint64_t i) const { return records_[i]; }
+
+    std::string string(const StringRef &ref) const
+      { return std::string(data_ + ref.offset, ref.size); }
+    template <class T> const T *array(uint64_t offset) const
+      { return reinterpret_cast<const T *>(data_ + offset); }
+
+    /// New ROOT object with the content of the record, owned by the caller.
+    TH1 *makeHistogram(const Record &r) const;
+
+    /// Adds the content of the record to the histogram with the same
+    /// arithmetic as TH1::Add and MonitorElement::addProfiles; returns false
+    /// without touching the histogram if the binning or the error storage
+    /// differ.
+    bool merge(const Record &r, TH1 *h) const;
+
+  private:
+    bool valid(const Record &r) const;
+    template <class PROFILE> void addProfileCells(const Record &r, PROFILE *p) const;
+    bool sameBinning(const Record &r, TH1 *h) const;
+    bool sameLabels(const Axis &a, TAxis *rootAxis) const;
+
+    const char *base_;
+    size_t length_;
+    const char *data_;
+    FileHeader header_;
+    const Record *records_;
+  };
+}
+
+#endif // DQMSERVICES_CORE_DQM_BINARY_FORMAT_H
@@ -4,6 +4,7 @@
 #include "DQMServices/Core/interface/QTest.h"
 #include "DQMServices/Core/src/ROOTFilePB.pb.h"
 #include "DQMServices/Core/src/DQMError.h"
+#include "DQMServices/Core/src/DQMBinaryFormat.h"
 #include "classlib/utils/RegexpMatch.h"
 #include "classlib/utils/Regexp.h"
 #include "classlib/utils/StringOps.h"
@@ -16,15 +17,18 @@
 #include "TClass.h"
 #include "TSystem.h"
 #include "TBufferFile.h"
+#include <algorithm>
 #include <iterator>
 #include <cerrno>
 #include <boost/algorithm/string.hpp>
 #include <boost/range/iterator_range_core.hpp>
+#include <tbb/parallel_for.h>
 
 #include <fstream>
 #include <sstream>
 #include <exception>
 #include <utility>
+#include <unistd.h>
 
 /** @var DQMStore::verbose_
     Universal verbose flag for DQM. */
@@ -67,6 +71,7 @@ namespace {
   const lat::Regexp s_rxtrace ("(.*)\\((.*)\\+0x.*\\).*");
   const lat::Regexp s_rxself  ("^[^()]*DQMStore::.*");
   const lat::Regexp s_rxpbfile (".*\\.pb$");
+  const lat::Regexp s_rxbinfile (".*\\.dqmb$");
 
   //////////////////////////////////////////////////////////////////////
   /// Check whether the @a path is a subdirectory of @a ofdir.  Returns
@@ -135,7 +140,7 @@ namespace {
 
 /////////////////////////////////////////////////////////////
 fastmatch::fastmatch (std::string  _fastString) :
-  fastString_ (std::move(_fastString)),  matching_ (UseFull)
+  pattern_ (_fastString), fastString_ (std::move(_fastString)),  matching_ (UseFull)
 {
   try
   {
@@ -2330,6 +2335,8 @@ DQMStore::extract(TObject *obj, const std::string &dir,
       // non-reference MonitorElement.
       master->data_.flags |= DQMNet::DQM_PROP_HAS_REFERENCE;
       master->reference_ = refcheck->object_;
+      // the comparisons to the reference have to be rerun
+      master->update();
     }
   }
 
@@ -2775,6 +2782,92 @@ DQMStore::savePB(const std::string &filename,
 }
 
 
+void
+DQMStore::saveMonitorElementRangeToBinary(
+    std::string const& dir,
+    unsigned int run,
+    MEMap::const_iterator begin,
+    MEMap::const_iterator end,
+    dqmbinary::Writer & file,
+    unsigned int & counter)
+{
+  for (auto const& me: boost::make_iterator_range(begin, end))
+  {
+    if (not isSubdirectory(dir, *me.data_.dirname))
+      break;
+
+    // Skip MonitorElements in a subdirectory of the current one.
+    if (dir != *me.data_.dirname)
+      continue;
+
+    std::string path = *me.data_.dirname + '/' + me.data_.objname;
+    if (me.kind() < MonitorElement::DQM_KIND_TH1F)
+      file.addScalar(path, me.kind(), me.data_.flags, me.tagString());
+    else
+      file.addHistogram(path, me.kind(), me.data_.flags, me.object_);
+
+    // Count saved histograms
+    ++counter;
+  }
+}
+
+/// save directory with monitoring objects into a binary file <filename>,
+/// which can be mapped in memory and merged without ROOT I/O;
+/// if directory="", save full monitoring structure
+void
+DQMStore::saveBinary(const std::string &filename,
+                     const std::string &path /* = "" */,
+                     const uint32_t run /* = 0 */,
+                     const uint32_t lumi /* = 0 */)
+{
+  std::lock_guard<std::mutex> guard(book_mutex_);
+
+  unsigned int nme = 0;
+
+  if (verbose_) {
+    std::cout << "DQMStore::saveBinary: Opening file '" << filename << "'"
+              << std::endl;
+  }
+  dqmbinary::Writer file(run, lumi);
+
+  // Same selection of the monitor elements as savePB.
+  for (auto const& dir: dirs_)
+  {
+    if (not path.empty()
+        and not isSubdirectory(path, dir))
+      continue;
+
+    if (not enableMultiThread_) {
+      MonitorElement proto(&dir, std::string(), run, 0);
+      auto begin = data_.lower_bound(proto);
+      auto end   = data_.end();
+      saveMonitorElementRangeToBinary(dir, run, begin, end, file, nme);
+    } else {
+      MonitorElement proto(&dir, std::string(), run, 0);
+      proto.setLumi(lumi);
+      auto begin = data_.lower_bound(proto);
+      proto.setLumi(lumi+1);
+      auto end   = data_.lower_bound(proto);
+      saveMonitorElementRangeToBinary(dir, run, begin, end, file, nme);
+    }
+
+    if (enableMultiThread_ and LSbasedMode_ and lumi != 0) {
+      auto begin = data_.lower_bound(MonitorElement(&dir, std::string(), run, 0));
+      auto end   = data_.lower_bound(MonitorElement(&dir, std::string(), run, 1));
+      saveMonitorElementRangeToBinary(dir, run, begin, end, file, nme);
+    }
+  }
+
+  file.write(filename);
+
+  // Maybe make some noise.
+  if (verbose_) {
+    std::cout << "DQMStore::saveBinary: successfully wrote " << nme
+              << " objects from path '" << path << "/"
+              << "' into DQM file '" << filename << "'\n";
+  }
+}
+
 /// read ROOT objects from file <file> in directory <onlypath>;
 /// return total # of ROOT objects read
 unsigned int
@@ -2963,10 +3056,12 @@ DQMStore::load(const std::string &filename,
       std::cout << "DQMStore::load: in overwrite mode   " << "\n";
   }
 
-  if (!s_rxpbfile.match(filename, 0, 0))
-    return readFile(filename, overwrite, "", "", stripdirs, fileMustExist);
-  else
+  if (s_rxpbfile.match(filename, 0, 0))
     return readFilePB(filename, overwrite, "", "", stripdirs, fileMustExist);
+  else if (s_rxbinfile.match(filename, 0, 0))
+    return readFileBinary(filename, overwrite, "", "", stripdirs, fileMustExist);
+  else
+    return readFile(filename, overwrite, "", "", stripdirs, fileMustExist);
 }
 
 /// private readFile <filename>, and copy MonitorElements;
@@ -3028,7 +3123,7 @@ DQMStore::readFile(const std::string &filename,
 /** Extract the next serialised ROOT object from @a buf. Returns null
 if there are no more objects in the buffer, or a null pointer was
 serialised at this location. */
-inline TObject * DQMStore::extractNextObject(TBufferFile &buf) const {
+inline TObject * DQMStore::extractNextObject(TBufferFile &buf) {
   if (buf.Length() == buf.BufferSize())
     return nullptr;
   buf.InitMap();
@@ -3063,71 +3158,163 @@ DQMStore::readFilePB(const std::string &filename,
                      const std::string &prepend /* ="" */,
                      OpenRunDirs stripdirs /* =StripRunDirs */,
                      bool fileMustExist /* =true */)
+{
+  if (verbose_)
+    std::cout << "DQMStore::readFile: reading from file '" << filename << "'\n";
+
+  std::vector<DecodedElement> elements;
+  if (! decodeFilePB(filename, elements, fileMustExist))
+  {
+    if (verbose_)
+      std::cout << "DQMStore::readFile: file '" << filename << "' does not exist, continuing\n";
+    return false;
+  }
+
+  loadDecoded(elements);
+  return true;
+}
+
+bool
+DQMStore::decodeFilePB(const std::string &filename,
+                       std::vector<DecodedElement> &into,
+                       bool fileMustExist /* =true */)
 {
   using google::protobuf::io::FileInputStream;
-  using google::protobuf::io::FileOutputStream;
   using google::protobuf::io::GzipInputStream;
-  using google::protobuf::io::GzipOutputStream;
   using google::protobuf::io::CodedInputStream;
-  using google::protobuf::io::ArrayInputStream;
-
-  if (verbose_)
-    std::cout << "DQMStore::readFile: reading from file '" << filename << "'\n";
 
   int filedescriptor;
   if ((filedescriptor = ::open(filename.c_str(), O_RDONLY)) == -1) {
     if (fileMustExist)
       raiseDQMError("DQMStore", "Failed to open file '%s'", filename.c_str());
-    else
-      if (verbose_)
-        std::cout << "DQMStore::readFile: file '" << filename << "' does not exist, continuing\n";
     return false;
   }
 
   dqmstorepb::ROOTFilePB dqmstore_message;
-  FileInputStream fin(filedescriptor);
-  GzipInputStream input(&fin);
-  CodedInputStream input_coded(&input);
-  input_coded.SetTotalBytesLimit(1024*1024*1024, -1);
-  if (!dqmstore_message.ParseFromCodedStream(&input_coded)) {
-    raiseDQMError("DQMStore", "Fatal parsing file '%s'", filename.c_str());
-    return false;
+  {
+    FileInputStream fin(filedescriptor);
+    GzipInputStream input(&fin);
+    CodedInputStream input_coded(&input);
+    input_coded.SetTotalBytesLimit(1024*1024*1024, -1);
+    bool parsed = dqmstore_message.ParseFromCodedStream(&input_coded);
+    ::close(filedescriptor);
+    if (! parsed)
+      raiseDQMError("DQMStore", "Fatal parsing file '%s'", filename.c_str());
   }
-  ::close(filedescriptor);
 
+  into.clear();
+  into.reserve(dqmstore_message.histo_size());
   for (int i = 0; i < dqmstore_message.histo_size(); ++i) {
-    std::string path;
-    std::string objname;
-
+    DecodedElement e;
     TObject *obj = nullptr;
     const dqmstorepb::ROOTFilePB::Histo &h = dqmstore_message.histo(i);
-    get_info(h, path, objname, &obj);
+    get_info(h, e.path, e.name, &obj);
+    e.flags = h.flags();
+    e.object.reset(obj);
+    into.push_back(std::move(e));
+  }
 
-    setCurrentFolder(path);
-    if (obj)
+  return true;
+}
+
+void
+DQMStore::loadDecoded(std::vector<DecodedElement> &elements)
+{
+  for (auto &e : elements)
+  {
+    setCurrentFolder(e.path);
+    if (e.object)
     {
       /* Before calling the extract() check if histogram exists:
        * if it does - flags for the given monitor are already set (and merged)
        * else - set the flags after the histogram is created.
        */
-      MonitorElement *me = findObject(path, objname);
+      MonitorElement *me = findObject(e.path, e.name);
 
       /* Run histograms should be collated and not overwritten,
        * Lumi histograms should be overwritten (and collate flag is not checked)
        */
-      bool overwrite = h.flags() & DQMNet::DQM_PROP_LUMI;
-      bool collate = !(h.flags() & DQMNet::DQM_PROP_LUMI);
-      extract(static_cast<TObject *>(obj), path, overwrite, collate);
+      bool overwrite = e.flags & DQMNet::DQM_PROP_LUMI;
+      bool collate = !(e.flags & DQMNet::DQM_PROP_LUMI);
+      extract(e.object.get(), e.path, overwrite, collate);
 
       if (me == nullptr) {
-        me = findObject(path, objname);
-        me->data_.flags = h.flags();
+        me = findObject(e.path, e.name);
+        me->data_.flags = e.flags;
       }
 
-      delete obj;
+      e.object.reset();
+    }
+  }
+
+  cd();
+}
+
+/// private readFileBinary <filename>, and merge the MonitorElements.
+/// The histograms which already exist with the same binning are summed
+/// directly from the mapped bin arrays; the others go through extract(),
+/// as for the protobuf files.
+bool
+DQMStore::readFileBinary(const std::string &filename,
+                         bool overwrite /* = false */,
+                         const std::string &onlypath /* ="" */,
+                         const std::string &prepend /* ="" */,
+                         OpenRunDirs stripdirs /* =StripRunDirs */,
+                         bool fileMustExist /* =true */)
+{
+  if (verbose_)
+    std::cout << "DQMStore::readFile: reading from file '" << filename << "'\n";
+
+  if (::access(filename.c_str(), R_OK) != 0) {
+    if (fileMustExist)
+      raiseDQMError("DQMStore", "Failed to open file '%s'", filename.c_str());
+    else
+      if (verbose_)
+        std::cout << "DQMStore::readFile: file '" << filename << "' does not exist, continuing\n";
+    return false;
+  }
+
+  dqmbinary::Reader file(filename);
+  unsigned int merged = 0;
+  for (uint64_t i = 0; i < file.size(); ++i) {
+    const dqmbinary::Record &r = file.record(i);
+    std::string fullpath = file.string(r.path);
+    size_t slash = fullpath.rfind('/');
+    std::string path(fullpath, 0, slash == std::string::npos ? 0 : slash);
+    std::string objname(fullpath, slash == std::string::npos ? 0 : slash+1);
+
+    setCurrentFolder(path);
+    MonitorElement *me = findObject(path, objname);
+
+    /* Run histograms should be collated and not overwritten,
+     * Lumi histograms should be overwritten (and collate flag is not checked)
+     */
+    bool overwrite = r.flags & DQMNet::DQM_PROP_LUMI;
+    bool collate = !(r.flags & DQMNet::DQM_PROP_LUMI);
+
+    if (r.kind < MonitorElement::DQM_KIND_TH1F) {
+      TObjString obj(file.string(r.title).c_str());
+      extract(&obj, path, overwrite, collate);
+    } else if (me && !overwrite && (isCollateME(me) || collate)
+               && uint32_t(me->kind()) == r.kind && file.merge(r, me->getTH1())) {
+      ++merged;
+    } else {
+      std::unique_ptr<TH1> obj(file.makeHistogram(r));
+      extract(obj.get(), path, overwrite, collate);
+    }
+
+    if (me == nullptr) {
+      me = findObject(path, objname);
+      if (me)
+        me->data_.flags = r.flags;
     }
   }
 
+  if (verbose_)
+    std::cout << "DQMStore::readFileBinary: read " << file.size()
+              << " objects from file '" << filename << "', "
+              << merged << " merged in place\n";
+
   cd();
   return true;
 }
@@ -3210,7 +3397,12 @@ DQMStore::getQCriterion(const std::string &qtname) const
 {
   auto i = qtests_.find(qtname);
   auto e = qtests_.end();
-  return (i == e ? nullptr : i->second);
+  if (i == e)
+    return nullptr;
+
+  // The caller may change the parameters of the test: rerun it everywhere.
+  qtestsModified_ = true;
+  return i->second;
 }
 
 /// create quality test with unique name <qtname> (analogous to ME name);
@@ -3232,6 +3424,7 @@ DQMStore::createQTest(const std::string &algoname, const std::string &qtname)
   qc->setVerbose(verboseQT_);
 
   qtests_[qtname] = qc;
+  qtestsModified_ = true;
   return qc;
 }
 
@@ -3258,34 +3451,45 @@ DQMStore::useQTest(const std::string &dir, const std::string &qtname)
 int
 DQMStore::useQTestByMatch(const std::string &pattern, const std::string &qtname)
 {
-  QCriterion *qc = getQCriterion(qtname);
-  if (! qc)
+  auto qci = qtests_.find(qtname);
+  if (qci == qtests_.end())
     raiseDQMError("DQMStore", "Cannot apply non-existent quality test '%s'",
                   qtname.c_str());
-
-  auto * fm = new fastmatch( pattern );
-
-  // Record the test for future reference.
-  QTestSpec qts(fm, qc);
-  qtestspecs_.push_back(qts);
-
-  // Apply the quality test.
+  QCriterion *qc = qci->second;
+
+  // Record the test for future reference. The clients attach their tests
+  // again on every cycle: the pattern is compiled only the first time.
+  auto spec = std::find_if(qtestspecs_.begin(), qtestspecs_.end(),
+                           [&](QTestSpec const& q)
+                           { return q.second == qc && q.first->pattern() == pattern; });
+  bool known = (spec != qtestspecs_.end());
+  if (! known)
+    spec = qtestspecs_.insert(qtestspecs_.end(), QTestSpec(new fastmatch(pattern), qc));
+
+  // Apply the quality test. The monitor elements which already have it
+  // are left alone, so that their result is kept until they change.
   std::string path;
   int cases = 0;
   for (auto const& me : data_)
   {
     path.clear();
     mergePath(path, *me.data_.dirname, me.data_.objname);
-    if (fm->match(path))
+    if (spec->first->match(path))
     {
       ++cases;
-      const_cast<MonitorElement &>(me).addQReport(qts.second);
+      QReport *qr = nullptr;
+      DQMNet::QValue *qv = nullptr;
+      if (known)
+        const_cast<MonitorElement &>(me).getQReport(false, qtname, qr, qv);
+      if (! qr || qr->qcriterion_ != qc)
+        const_cast<MonitorElement &>(me).addQReport(qc);
     }
   }
 
   //return the number of matched cases
   return cases;
 }
+
 /// run quality tests (also finds updated contents in last monitoring cycle,
 /// including newly added content)
 void
@@ -3296,10 +3500,53 @@ DQMStore::runQTests()
     std::cout << "DQMStore: running runQTests() with reset = "
               << ( reset_ ? "true" : "false" ) << std::endl;
 
-  // Apply quality tests to each monitor element, skipping references.
+  // Only the monitor elements modified since the last run are tested,
+  // unless the tests themselves changed; references are skipped.
+  bool all = qtestsModified_;
+  qtestsModified_ = false;
+  std::vector<MonitorElement *> modified;
   for (auto const& me : data_)
-    if (! isSubdirectory(s_referenceDirName, *me.data_.dirname))
-      const_cast<MonitorElement &>(me).runQTests();
+  {
+    if (me.qreports_.empty() || isSubdirectory(s_referenceDirName, *me.data_.dirname))
+      continue;
+    if (all || me.qtestsOutdated())
+      modified.push_back(const_cast<MonitorElement *>(&me));
+    else
+      const_cast<MonitorElement &>(me).updateQReportStats();
+  }
+
+  // A QCriterion keeps the state of its last test, so its tests run in
+  // sequence; different criteria run in parallel. The tests of the same
+  // monitor element are serialised with a lock.
+  std::map<QCriterion *, std::vector<std::pair<size_t, size_t> > > tasks;
+  for (size_t m = 0, e = modified.size(); m < e; ++m)
+    for (size_t i = 0, n = modified[m]->qreports_.size(); i < n; ++i)
+      if (QCriterion *qc = modified[m]->qreports_[i].qcriterion_)
+        tasks[qc].emplace_back(m, i);
+      else
+        modified[m]->qreports_[i].qvalue_ = &modified[m]->data_.qreports[i];
+
+  std::vector<std::vector<std::pair<size_t, size_t> > *> queues;
+  queues.reserve(tasks.size());
+  for (auto & task : tasks)
+    queues.push_back(&task.second);
+
+  std::vector<std::mutex> locks(std::min<size_t>(modified.size(), 256));
+  tbb::parallel_for(size_t(0), queues.size(), [&](size_t q)
+  {
+    for (auto const& t : *queues[q])
+    {
+      std::lock_guard<std::mutex> guard(locks[t.first % locks.size()]);
+      modified[t.first]->runQTest(t.second);
+    }
+  });
+
+  for (auto me : modified)
+    me->qtestsDone();
+
+  if (verbose_ > 0)
+    std::cout << "DQMStore: ran " << tasks.size() << " quality tests on "
+              << modified.size() << " modified monitor elements" << std::endl;
 
   reset_ = false;
 }
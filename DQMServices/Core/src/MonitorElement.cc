@@ -151,7 +151,9 @@ MonitorElement::initialise(Kind kind, const std::string &value)
 MonitorElement::MonitorElement()
   : object_(nullptr),
     reference_(nullptr),
-    refvalue_(nullptr)
+    refvalue_(nullptr),
+    updates_(1),
+    tested_(0)
 {
   data_.version  = 0;
   data_.dirname  = nullptr;
@@ -169,7 +171,9 @@ MonitorElement::MonitorElement(const std::string *path,
                                const std::string &name)
   : object_(nullptr),
     reference_(nullptr),
-    refvalue_(nullptr)
+    refvalue_(nullptr),
+    updates_(1),
+    tested_(0)
 {
   data_.version  = 0;
   data_.run      = 0;
@@ -190,7 +194,9 @@ MonitorElement::MonitorElement(const std::string *path,
                                uint32_t moduleId)
   : object_(nullptr),
     reference_(nullptr),
-    refvalue_(nullptr)
+    refvalue_(nullptr),
+    updates_(1),
+    tested_(0)
 {
   data_.version  = 0;
   data_.run      = run;
@@ -211,7 +217,9 @@ MonitorElement::MonitorElement(const MonitorElement &x, MonitorElementNoCloneTag
     object_(nullptr),
     reference_(x.reference_),
     refvalue_(nullptr),
-    qreports_(x.qreports_)
+    qreports_(x.qreports_),
+    updates_(x.updates_),
+    tested_(x.tested_)
 {
 }
 
@@ -670,30 +678,50 @@ MonitorElement::runQTests()
 {
   assert(qreports_.size() == data_.qreports.size());
 
-  // Rerun quality tests where the ME or the quality algorithm was modified.
-  bool dirty = wasUpdated();
+  // Rerun quality tests where the ME was modified since they last ran.
+  bool dirty = qtestsOutdated();
   for (size_t i = 0, e = data_.qreports.size(); i < e; ++i)
   {
-    DQMNet::QValue &qv = data_.qreports[i];
-    QReport &qr = qreports_[i];
-    QCriterion *qc = qr.qcriterion_;
-    qr.qvalue_ = &qv;
+    qreports_[i].qvalue_ = &data_.qreports[i];
+    if (dirty)
+      runQTest(i);
+  }
 
-    // if (qc && (dirty || qc->wasModified()))  // removed for new QTest (abm-090503)
-    if (qc && dirty)
-    {
-      assert(qc->getName() == qv.qtname);
-      std::string oldMessage = qv.message;
-      int oldStatus = qv.code;
+  qtestsDone();
+}
 
-      qc->runTest(this, qr, qv);
+/// run the i-th quality test, returns true if its result changed
+bool
+MonitorElement::runQTest(size_t i)
+{
+  DQMNet::QValue &qv = data_.qreports[i];
+  QReport &qr = qreports_[i];
+  QCriterion *qc = qr.qcriterion_;
+  qr.qvalue_ = &qv;
+  if (! qc)
+    return false;
 
-      if (oldStatus != qv.code || oldMessage != qv.message)
-        update();
-    }
-  }
+  assert(qc->getName() == qv.qtname);
+  std::string oldMessage = qv.message;
+  int oldStatus = qv.code;
+
+  qc->runTest(this, qr, qv);
+
+  if (oldStatus == qv.code && oldMessage == qv.message)
+    return false;
+
+  update();
+  return true;
+}
 
-  // Update QReport statistics.
+/// record that the quality tests are up to date, and refresh the
+/// QReport statistics
+void
+MonitorElement::qtestsDone()
+{
+  // the modifications made while testing, including the accesses of the
+  // tests to the object, do not require a new run.
+  tested_ = updates_;
   updateQReportStats();
 }
 
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DQMServices/Core/interface/Standalone.h"
+#include "DQMServices/Core/interface/DQMStore.h"
+#include "DQMServices/Core/interface/MonitorElement.h"
+#include "DQMServices/Core/src/DQMBinaryFormat.h"
+#include "TH1F.h"
+#include "TH1S.h"
+#include "TH2D.h"
+#include "TH3F.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+
+/*
+ * Validation of the binary DQM format against the ROOT path:
+ * - two sets of histograms are written to binary files, read back and
+ *   merged from the mapped bin arrays, then compared bin by bin with the
+ *   same histograms summed with TH1::Add;
+ * - a DQMStore is saved with save() and saveBinary(), each file is loaded
+ *   twice in collate mode into a new store, and all the monitor elements of
+ *   the two stores must be identical.
+ */
+
+namespace {
+
+  struct Entry {
+    std::string path;
+    MonitorElement::Kind kind;
+    std::unique_ptr<TH1> h;
+  };
+
+  std::vector<Entry> book(const char *suffix) {
+    std::vector<Entry> entries;
+    auto add = [&](const char *path, MonitorElement::Kind kind, TH1 *h) {
+      h->SetDirectory(nullptr);
+      entries.push_back(Entry{path, kind, std::unique_ptr<TH1>(h)});
+    };
+    add("Tracking/pt", MonitorElement::DQM_KIND_TH1F, new TH1F((std::string("pt")+suffix).c_str(), "p_{T}", 100, 0., 50.));
+    add("Tracking/nhits", MonitorElement::DQM_KIND_TH1S, new TH1S((std::string("nhits")+suffix).c_str(), "hits", 40, 0., 40.));
+    add("Pixel/occupancy", MonitorElement::DQM_KIND_TH2D, new TH2D((std::string("occupancy")+suffix).c_str(), "occupancy", 64, -3.2, 3.2, 8, -3., 3.));
+    add("Pixel/cluster", MonitorElement::DQM_KIND_TH3F, new TH3F((std::string("cluster")+suffix).c_str(), "cluster", 10, 0., 10., 8, 0., 8., 6, 0., 6.));
+    add("Calo/response", MonitorElement::DQM_KIND_TPROFILE, new TProfile((std::string("response")+suffix).c_str(), "response", 50, -5., 5., 0., 2.));
+    add("Calo/map", MonitorElement::DQM_KIND_TPROFILE2D, new TProfile2D((std::string("map")+suffix).c_str(), "map", 20, -5., 5., 18, -3.2, 3.2, 0., 100.));
+    // weighted errors, labels and a variable binning
+    entries[0].h->Sumw2();
+    entries[1].h->GetXaxis()->SetBinLabel(1, "none");
+    entries[1].h->GetXaxis()->SetBinLabel(2, "one");
+    double edges[] = { -3., -2., -1., -0.5, 0., 0.5, 1., 2., 3. };
+    entries[2].h->GetYaxis()->Set(8, edges);
+    return entries;
+  }
+
+  void fill(std::vector<Entry> &entries, std::mt19937 &rng, int n) {
+    std::normal_distribution<double> gauss;
+    std::uniform_real_distribution<double> flat(0., 1.);
+    for (int i = 0; i < n; ++i) {
+      double w = 0.5 + flat(rng);
+      entries[0].h->Fill(10.+5.*gauss(rng), w);
+      entries[1].h->Fill(20.*flat(rng));
+      static_cast<TH2D *>(entries[2].h.get())->Fill(gauss(rng), gauss(rng), w);
+      static_cast<TH3F *>(entries[3].h.get())->Fill(10.*flat(rng), 8.*flat(rng), 6.*flat(rng));
+      static_cast<TProfile *>(entries[4].h.get())->Fill(3.*gauss(rng), 1.+0.1*gauss(rng), w);
+      static_cast<TProfile2D *>(entries[5].h.get())->Fill(2.*gauss(rng), 2.*gauss(rng), 50.+10.*gauss(rng));
+    }
+  }
+
+  void write(const std::vector<Entry> &entries, const std::string &filename) {
+    dqmbinary::Writer writer(1, 0);
+    for (auto const &e : entries)
+      writer.addHistogram(e.path, e.kind, 0, e.h.get());
+    writer.addScalar("Info/events", MonitorElement::DQM_KIND_INT, 0, "<events>i=42</events>");
+    writer.write(filename);
+  }
+
+  bool close(double a, double b, double tolerance) {
+    return a == b || std::abs(a-b) <= tolerance*std::max(std::abs(a), std::abs(b));
+  }
+
+  double binEntries(TH1 *h, int bin) {
+    if (auto *p = dynamic_cast<TProfile *>(h))
+      return p->GetBinEntries(bin);
+    if (auto *p = dynamic_cast<TProfile2D *>(h))
+      return p->GetBinEntries(bin);
+    return 0.;
+  }
+
+  // profiles are compared with a tolerance with TH1::Add, their bin contents
+  // are ratios; the errors of the weighted profiles are not compared there,
+  // since the profiles are merged as MonitorElement::addProfiles does, which
+  // keeps the sums of the squared weights of the target
+  bool compare(TH1 *root, TH1 *binary, double tolerance, bool errors = true) {
+    bool ok = root->GetNcells() == binary->GetNcells()
+      && close(root->GetEntries(), binary->GetEntries(), tolerance);
+    for (int bin = 0; ok && bin < root->GetNcells(); ++bin)
+      ok = close(root->GetBinContent(bin), binary->GetBinContent(bin), tolerance)
+        && close(binEntries(root, bin), binEntries(binary, bin), tolerance)
+        && (! errors || close(root->GetBinError(bin), binary->GetBinError(bin), tolerance));
+    double s1[dqmbinary::NSTATS] = { 0 }, s2[dqmbinary::NSTATS] = { 0 };
+    root->GetStats(s1);
+    binary->GetStats(s2);
+    for (unsigned i = 0; ok && i < dqmbinary::NSTATS; ++i)
+      ok = close(s1[i], s2[i], tolerance);
+    for (int bin = 1; ok && bin <= root->GetNbinsX(); ++bin)
+      ok = std::string(root->GetXaxis()->GetBinLabel(bin)) == binary->GetXaxis()->GetBinLabel(bin);
+    if (!ok)
+      std::cout << "binary merge of " << root->GetName() << " differs from the ROOT one" << std::endl;
+    return ok;
+  }
+
+  // books the histograms of entries, with their content, and an integer in the store
+  void fillStore(DQMStore &store, const std::vector<Entry> &entries) {
+    for (auto const &e : entries) {
+      size_t slash = e.path.rfind('/');
+      store.setCurrentFolder(e.path.substr(0, slash));
+      std::string name = e.path.substr(slash+1);
+      switch (e.kind) {
+      case MonitorElement::DQM_KIND_TH1F: store.book1D(name, static_cast<TH1F *>(e.h.get())); break;
+      case MonitorElement::DQM_KIND_TH1S: store.book1S(name, static_cast<TH1S *>(e.h.get())); break;
+      case MonitorElement::DQM_KIND_TH2D: store.book2DD(name, static_cast<TH2D *>(e.h.get())); break;
+      case MonitorElement::DQM_KIND_TH3F: store.book3D(name, static_cast<TH3F *>(e.h.get())); break;
+      case MonitorElement::DQM_KIND_TPROFILE: store.bookProfile(name, static_cast<TProfile *>(e.h.get())); break;
+      case MonitorElement::DQM_KIND_TPROFILE2D: store.bookProfile2D(name, static_cast<TProfile2D *>(e.h.get())); break;
+      default: assert(false);
+      }
+    }
+    store.setCurrentFolder("Info");
+    store.bookInt("events")->Fill(42);
+  }
+
+  // the same arrays, bin by bin, for all the monitor elements of the two stores
+  bool compareStores(DQMStore &root, DQMStore &binary, size_t expected) {
+    std::vector<MonitorElement *> fromRoot = root.getAllContents("");
+    std::vector<MonitorElement *> fromBinary = binary.getAllContents("");
+    bool ok = fromRoot.size() == expected && fromBinary.size() == expected;
+    if (! ok)
+      std::cout << "loaded " << fromRoot.size() << " monitor elements from the ROOT file and "
+                << fromBinary.size() << " from the binary one, expected " << expected << std::endl;
+    for (MonitorElement *me : fromRoot) {
+      MonitorElement *other = binary.get(me->getFullname());
+      if (other == nullptr || other->kind() != me->kind()) {
+        std::cout << me->getFullname() << " is missing or different in the binary store" << std::endl;
+        ok = false;
+      } else if (me->kind() < MonitorElement::DQM_KIND_TH1F) {
+        ok &= me->valueString() == other->valueString();
+      } else {
+        ok &= compare(me->getTH1(), other->getTH1(), 0.)
+          && std::string(me->getTH1()->GetTitle()) == other->getTH1()->GetTitle();
+        if (me->kind() == MonitorElement::DQM_KIND_TPROFILE)
+          ok &= me->getTProfile()->GetBinSumw2()->GetSize() == other->getTProfile()->GetBinSumw2()->GetSize()
+            && std::equal(me->getTProfile()->GetBinSumw2()->GetArray(),
+                          me->getTProfile()->GetBinSumw2()->GetArray() + me->getTProfile()->GetBinSumw2()->GetSize(),
+                          other->getTProfile()->GetBinSumw2()->GetArray());
+      }
+    }
+    return ok;
+  }
+}
+
+int main(int argc, char **argv) {
+  TH1::AddDirectory(false);
+  std::mt19937 rng(2018);
+  std::vector<Entry> first = book("_1");
+  std::vector<Entry> second = book("_2");
+  fill(first, rng, 20000);
+  fill(second, rng, 5000);
+
+  write(first, "DQMBinaryFormatTest_1.dqmb");
+  write(second, "DQMBinaryFormatTest_2.dqmb");
+
+  dqmbinary::Reader file1("DQMBinaryFormatTest_1.dqmb");
+  dqmbinary::Reader file2("DQMBinaryFormatTest_2.dqmb");
+  assert(file1.size() == first.size()+1);
+  assert(file1.string(file1.record(first.size()).title) == "<events>i=42</events>");
+
+  bool ok = true;
+  for (unsigned i = 0; i < first.size(); ++i) {
+    // round trip
+    std::unique_ptr<TH1> copy(file1.makeHistogram(file1.record(i)));
+    ok &= compare(first[i].h.get(), copy.get(), 0.);
+
+    // merge
+    bool merged = file2.merge(file2.record(i), copy.get());
+    if (!merged)
+      std::cout << "binary merge of " << copy->GetName() << " refused" << std::endl;
+    ok &= merged;
+    first[i].h->Add(second[i].h.get());
+    bool profile = first[i].kind == MonitorElement::DQM_KIND_TPROFILE
+      || first[i].kind == MonitorElement::DQM_KIND_TPROFILE2D;
+    ok &= compare(first[i].h.get(), copy.get(), profile ? 1.e-12 : 0., ! profile);
+  }
+
+  // a different binning is not merged in place
+  TH1F other("other", "other", 50, 0., 50.);
+  ok &= !file2.merge(file2.record(0), &other);
+
+  std::remove("DQMBinaryFormatTest_1.dqmb");
+  std::remove("DQMBinaryFormatTest_2.dqmb");
+
+  {
+    edm::ServiceToken services(edm::ServiceRegistry::createSet(std::vector<edm::ParameterSet>()));
+    edm::ServiceRegistry::Operate operate(services);
+    edm::ParameterSet pset;
+    pset.addUntrackedParameter<bool>("collateHistograms", true);
+
+    std::vector<Entry> third = book("_3");
+    fill(third, rng, 10000);
+    DQMStore source(pset);
+    fillStore(source, third);
+    source.save("DQMBinaryFormatTest_store.root");
+    source.saveBinary("DQMBinaryFormatTest_store.dqmb");
+
+    // the first load books the monitor elements, the second one merges into them
+    DQMStore fromRoot(pset);
+    DQMStore fromBinary(pset);
+    for (int i = 0; i < 2; ++i) {
+      fromRoot.load("DQMBinaryFormatTest_store.root");
+      fromBinary.load("DQMBinaryFormatTest_store.dqmb");
+      ok &= compareStores(fromRoot, fromBinary, third.size()+1);
+    }
+
+    std::remove("DQMBinaryFormatTest_store.root");
+    std::remove("DQMBinaryFormatTest_store.dqmb");
+  }
+  std::cout << (ok ? "binary format validated against the ROOT path" : "binary format validation FAILED") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DQMServices/Core/interface/Standalone.h"
+#include "DQMServices/Core/interface/DQMStore.h"
+#include "DQMServices/Core/interface/MonitorElement.h"
+#include "DQMServices/Core/interface/QReport.h"
+#include "DQMServices/Core/interface/QTest.h"
+#include "tbb/task_arena.h"
+#include "TH1.h"
+
+/*
+ * Test of the incremental and parallel DQMStore::runQTests:
+ * - only the monitor elements modified since the last run are tested again;
+ * - attaching the same test again, as the clients do on every cycle, keeps
+ *   a single report and its result;
+ * - the parallel run gives the same reports as a run on a single thread.
+ */
+
+namespace {
+
+  int errors = 0;
+
+  void check(bool ok, const char *what) {
+    if (! ok) {
+      std::cout << "Error: " << what << std::endl;
+      ++errors;
+    }
+  }
+
+  float result(MonitorElement *me, const std::string &qtname) {
+    const QReport *qr = me->getQReport(qtname);
+    return qr ? qr->getQTresult() : -1.f;
+  }
+
+  // several tests with overlapping patterns on a set of randomly filled histograms
+  void setup(DQMStore &store, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> gauss(5., 2.);
+    for (int d = 0; d < 4; ++d) {
+      store.setCurrentFolder("Parallel/dir" + std::to_string(d));
+      for (int h = 0; h < 50; ++h) {
+        MonitorElement *me = store.book1D("h" + std::to_string(h), "h", 20, 0., 10.);
+        for (int i = 0, n = rng() % 200; i < n; ++i)
+          me->Fill(gauss(rng));
+      }
+    }
+
+    static_cast<ContentsXRange *>(store.createQTest(ContentsXRange::getAlgoName(), "xrange"))->setAllowedXRange(2., 8.);
+    static_cast<ContentsYRange *>(store.createQTest(ContentsYRange::getAlgoName(), "yrange"))->setAllowedYRange(0., 20.);
+    static_cast<DeadChannel *>(store.createQTest(DeadChannel::getAlgoName(), "dead"))->setThreshold(0.);
+    auto noisy = static_cast<NoisyChannel *>(store.createQTest(NoisyChannel::getAlgoName(), "noisy"));
+    noisy->setTolerance(0.5);
+    noisy->setNumNeighbors(2);
+
+    store.useQTestByMatch("Parallel/*", "xrange");
+    store.useQTestByMatch("Parallel/dir1/*", "yrange");
+    store.useQTestByMatch("Parallel/*/h1*", "yrange");
+    store.useQTestByMatch("Parallel/dir2/*", "dead");
+    store.useQTestByMatch("Parallel/*/h2*", "noisy");
+  }
+
+  // some of the histograms change between two runs
+  void modify(DQMStore &store, unsigned seed) {
+    std::mt19937 rng(seed);
+    for (MonitorElement *me : store.getAllContents("Parallel"))
+      if (rng() % 3 == 0)
+        for (int i = 0; i < 30; ++i)
+          me->Fill(10. * (rng() % 1000) / 1000.);
+  }
+
+  bool sameReports(DQMStore &parallel, DQMStore &serial) {
+    std::vector<MonitorElement *> mes = parallel.getAllContents("Parallel");
+    bool ok = mes.size() == 200;
+    for (MonitorElement *me : mes) {
+      MonitorElement *other = serial.get(me->getFullname());
+      std::vector<QReport *> reports = me->getQReports();
+      ok &= other != nullptr && other->getQReports().size() == reports.size() && ! reports.empty();
+      for (size_t i = 0; ok && i < reports.size(); ++i) {
+        const QReport *qr = other->getQReport(reports[i]->getQRName());
+        ok = qr && qr->getStatus() == reports[i]->getStatus()
+          && qr->getQTresult() == reports[i]->getQTresult()
+          && qr->getMessage() == reports[i]->getMessage();
+      }
+      if (! ok) {
+        std::cout << "Error: the quality tests of " << me->getFullname()
+                  << " differ between the parallel and the serial run" << std::endl;
+        return false;
+      }
+    }
+    return ok;
+  }
+}
+
+int main()
+{
+  edm::ServiceToken services(edm::ServiceRegistry::createSet(std::vector<edm::ParameterSet>()));
+  edm::ServiceRegistry::Operate operate(services);
+  edm::ParameterSet pset;
+
+  // only the modified monitor elements are tested again
+  {
+    DQMStore store(pset);
+    store.setCurrentFolder("Incremental");
+    MonitorElement *a = store.book1D("a", "a", 10, 0., 10.);
+    MonitorElement *b = store.book1D("b", "b", 10, 0., 10.);
+    static_cast<ContentsXRange *>(store.createQTest(ContentsXRange::getAlgoName(), "xrange"))->setAllowedXRange(0., 5.);
+    check(store.useQTestByMatch("Incremental/*", "xrange") == 2, "the test is attached to both elements");
+    for (int i = 0; i < 10; ++i) {
+      a->Fill(1.);
+      b->Fill(1.);
+    }
+    // the histogram itself, modified behind the back of the monitor element below
+    TH1 *ha = a->getTH1();
+
+    store.runQTests();
+    check(result(a, "xrange") == 1.f, "a passes the first run");
+    check(result(b, "xrange") == 1.f, "b passes the first run");
+
+    // attaching the test again keeps one report and its result, and does
+    // not mark the elements as modified
+    uint64_t updates = a->updates();
+    check(store.useQTestByMatch("Incremental/*", "xrange") == 2, "the test is attached again to both elements");
+    check(a->getQReports().size() == 1, "a duplicate test specification gives a single report");
+    check(a->updates() == updates, "attaching the test again does not modify the element");
+    check(result(a, "xrange") == 1.f, "attaching the test again keeps its result");
+
+    // a is not marked as modified, so it is not tested again
+    ha->Fill(8., 10.);
+    b->Fill(8., 10.);
+    store.runQTests();
+    check(result(a, "xrange") == 1.f, "an unmodified element is not tested again");
+    check(result(b, "xrange") < 1.f, "a modified element is tested again");
+
+    // now it is
+    a->Fill(1.);
+    store.runQTests();
+    check(result(a, "xrange") < 1.f, "an element is tested again once modified");
+  }
+
+  // the parallel run gives the same reports as a serial one, for the first
+  // run and for the incremental ones
+  {
+    DQMStore parallel(pset);
+    DQMStore serial(pset);
+    setup(parallel, 2018);
+    setup(serial, 2018);
+    tbb::task_arena single(1);
+    for (unsigned cycle = 0; cycle < 3; ++cycle) {
+      if (cycle > 0) {
+        modify(parallel, cycle);
+        modify(serial, cycle);
+      }
+      parallel.runQTests();
+      single.execute([&serial]() { serial.runQTests(); });
+      check(sameReports(parallel, serial), "the parallel and the serial runs agree");
+    }
+  }
+
+  if (errors)
+    return 1;
+  std::cout << "incremental and parallel quality tests validated" << std::endl;
+  return 0;
+}
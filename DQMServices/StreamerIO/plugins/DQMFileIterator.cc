@@ -141,6 +141,17 @@ bool DQMFileIterator::lumiReady() {
   return false;
 }
 
+std::vector<DQMFileIterator::LumiEntry> DQMFileIterator::readyLumis(
+    std::size_t max) const {
+  std::vector<LumiEntry> lumis;
+  for (auto it = lumiSeen_.lower_bound(nextLumiNumber_);
+       (it != lumiSeen_.end()) && (lumis.size() < max); ++it) {
+    lumis.push_back(it->second);
+  }
+
+  return lumis;
+}
+
 unsigned int DQMFileIterator::runNumber() { return runNumber_; }
 
 unsigned int DQMFileIterator::lastLumiFound() {
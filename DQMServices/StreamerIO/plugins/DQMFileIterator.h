@@ -71,6 +71,10 @@ class DQMFileIterator {
 
   void pop();
 
+  /* the lumis found from the next one on, at most max of them,
+   * for the sources reading ahead */
+  std::vector<LumiEntry> readyLumis(std::size_t max) const;
+
   /* control */
   void reset();
   void update_state();
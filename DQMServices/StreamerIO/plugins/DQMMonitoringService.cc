@@ -40,6 +40,15 @@ DQMMonitoringService::DQMMonitoringService(const edm::ParameterSet& pset,
 
 DQMMonitoringService::~DQMMonitoringService() {}
 
+DQMMonitoringService::StageCounters& DQMMonitoringService::stageCounters(
+    const std::string& stage) {
+  std::lock_guard<std::mutex> lock(stagesLock_);
+
+  std::unique_ptr<StageCounters>& counters = stages_[stage];
+  if (!counters) counters.reset(new StageCounters());
+  return *counters;
+}
+
 void DQMMonitoringService::outputLumiUpdate() {
   using std::chrono::duration_cast;
   using std::chrono::milliseconds;
@@ -78,6 +87,23 @@ void DQMMonitoringService::outputLumiUpdate() {
     doc.add_child(str(boost::format("extra.lumi_stats.%d") % hkey), plumi);
   }
 
+  // totals of the read-ahead stages, the rates are derived from the updates
+  {
+    std::lock_guard<std::mutex> lock(stagesLock_);
+    for (auto const& stage : stages_) {
+      unsigned long bytes = stage.second->bytes;
+      unsigned long micros = stage.second->micros;
+
+      ptree pstage;
+      pstage.put("items", (unsigned long)stage.second->items);
+      pstage.put("bytes", bytes);
+      pstage.put("micros", micros);
+      if (micros > 0) pstage.put("throughput_mbps", (float)bytes / micros);
+
+      doc.add_child("extra.read_ahead." + stage.first, pstage);
+    }
+  }
+
   outputUpdate(doc);
 }
 
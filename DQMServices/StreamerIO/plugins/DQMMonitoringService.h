@@ -14,6 +14,9 @@
 #include "FWCore/Utilities/interface/StreamID.h"
 #include "boost/filesystem.hpp"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <map>
@@ -43,9 +46,21 @@ using edm::GlobalContext;
 
 class DQMMonitoringService {
  public:
+  // throughput counters of a stage of the read-ahead pipelines
+  // of the input sources, updated from their reader thread and TBB tasks
+  struct StageCounters {
+    std::atomic<unsigned long> items{0};
+    std::atomic<unsigned long> bytes{0};
+    std::atomic<unsigned long> micros{0};  // time spent in the stage
+  };
+
   DQMMonitoringService(const edm::ParameterSet&, edm::ActivityRegistry&);
   ~DQMMonitoringService();
 
+  // the counters of the stage, created on first use; they are reported
+  // with the lumi updates
+  StageCounters& stageCounters(const std::string& stage);
+
   void connect();
   void keepAlive();
 
@@ -73,6 +88,9 @@ class DQMMonitoringService {
 
   unsigned long run_;   // current run
   unsigned long lumi_;  // current lumi
+
+  std::mutex stagesLock_;
+  std::map<std::string, std::unique_ptr<StageCounters> > stages_;
 };
 
 }  // end-of-namespace
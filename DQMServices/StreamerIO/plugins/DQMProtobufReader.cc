@@ -5,6 +5,8 @@
 #include "DQMServices/Core/interface/MonitorElement.h"
 
 #include "FWCore/Utilities/interface/UnixSignalHandlers.h"
+
+#include <boost/algorithm/string/predicate.hpp>
 // #include "FWCore/Sources/interface/ProducerSourceBase.h"
 
 using namespace dqmservices;
@@ -17,12 +19,58 @@ DQMProtobufReader::DQMProtobufReader(edm::ParameterSet const& pset,
   flagEndOfRunKills_ = pset.getUntrackedParameter<bool>("endOfRunKills");
   flagDeleteDatFiles_ = pset.getUntrackedParameter<bool>("deleteDatFiles");
   flagLoadFiles_ = pset.getUntrackedParameter<bool>("loadFiles");
+  readAheadThreads_ = pset.getUntrackedParameter<unsigned int>("readAheadThreads");
+  readAheadBytes_ = (size_t)pset.getUntrackedParameter<unsigned int>("readAheadMemoryMB") << 20;
 
   produces<std::string, edm::Transition::BeginLuminosityBlock>("sourceDataPath");
   produces<std::string, edm::Transition::BeginLuminosityBlock>("sourceJsonPath");
 }
 
-DQMProtobufReader::~DQMProtobufReader() {}
+DQMProtobufReader::~DQMProtobufReader() {
+  if (readAhead_) readAhead_->stop();
+}
+
+/**
+ * Submits the files of the lumis already found, past the current one,
+ * to the read-ahead tasks: those are parsed and their histograms
+ * deserialized before the lumi is opened.  Nothing is submitted while
+ * the memory bound is reached; the sizes of the files stand for the
+ * memory of their decoded histograms.
+ */
+void DQMProtobufReader::readAhead() {
+  if ((!flagLoadFiles_) || (readAheadBytes_ == 0)) return;
+
+  if (!readAhead_) {
+    edm::Service<DQMMonitoringService> mon;
+    DQMReadAhead<DecodedFile>::Counters* decode = nullptr;
+    DQMReadAhead<DecodedFile>::Counters* wait = nullptr;
+    if (mon.isAvailable()) {
+      decode = &mon->stageCounters("protobuf_decode");
+      wait = &mon->stageCounters("protobuf_wait");
+    }
+
+    readAhead_.reset(new DQMReadAhead<DecodedFile>(
+        readAheadThreads_, readAheadBytes_, decode, wait));
+  }
+
+  for (auto const& lumi : fiterator_.readyLumis(16)) {
+    std::string path = lumi.get_data_path();
+    if (submitted_.count(path)) continue;
+    if (!boost::algorithm::ends_with(path, ".pb")) continue;
+
+    boost::system::error_code ec;
+    uintmax_t bytes = boost::filesystem::file_size(path, ec);
+    if (ec) continue;  // missing files are reported when the lumi is opened
+
+    bool queued = readAhead_->trySubmit(path, DecodedFile(), bytes,
+                                        [path](DecodedFile& elements) {
+      DQMStore::decodeFilePB(path, elements);
+    });
+    if (!queued) break;
+
+    submitted_.insert(path);
+  }
+}
 
 edm::InputSource::ItemType DQMProtobufReader::getNextItemType() {
   typedef DQMFileIterator::State State;
@@ -51,6 +99,7 @@ edm::InputSource::ItemType DQMProtobufReader::getNextItemType() {
 
     // skip to the next file if we have no files openned yet
     if (fiterator_.lumiReady()) {
+      readAhead();
       return InputSource::IsLumi;
     }
 
@@ -137,7 +186,15 @@ void DQMProtobufReader::beginLuminosityBlock(edm::LuminosityBlock& lb) {
 
     fiterator_.logFileAction("Initiating request to open file ", path);
     fiterator_.logFileAction("Successfully opened file ", path);
-    store->load(path);
+
+    DecodedFile elements;
+    if (readAhead_ && submitted_.count(path) &&
+        readAhead_->take(path, elements)) {
+      store->loadDecoded(elements);
+    } else {
+      store->load(path);
+    }
+    submitted_.erase(path);
     fiterator_.logFileAction("Closed file ", path);
     fiterator_.logLumiState(currentLumi_, "close: ok");
   } else {
@@ -179,6 +236,16 @@ void DQMProtobufReader::fillDescriptions(
       ->setComment(
           "Tells the source load the data files. If set to false, source will create skeleton lumi transitions.");
 
+  desc.addUntracked<unsigned int>("readAheadMemoryMB", 0)
+      ->setComment(
+          "Size of the upcoming data files decoded ahead in TBB tasks, "
+          "0 (the default) to decode them on the source thread.");
+
+  desc.addUntracked<unsigned int>("readAheadThreads", 2)
+      ->setComment(
+          "Number of TBB tasks decoding the upcoming data files "
+          "concurrently.");
+
   DQMFileIterator::fillDescription(desc);
   descriptions.add("source", desc);
 }
@@ -9,8 +9,16 @@
 #include "FWCore/Sources/interface/ProducerSourceBase.h"
 #include "FWCore/Sources/interface/PuttableSourceBase.h"
 
+#include "DQMServices/Core/interface/DQMStore.h"
+
 #include "DQMFileIterator.h"
 #include "DQMMonitoringService.h"
+#include "DQMReadAhead.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace dqmservices {
 
@@ -36,12 +44,21 @@ class DQMProtobufReader : public edm::PuttableSourceBase {
 
   void logFileAction(char const* msg, char const* fileName) const;
   bool prepareNextFile();
+  void readAhead();
 
   bool flagSkipFirstLumis_;
   bool flagEndOfRunKills_;
   bool flagDeleteDatFiles_;
   bool flagLoadFiles_;
 
+  unsigned int readAheadThreads_;
+  size_t readAheadBytes_;
+
+  // the files of the upcoming lumis are decoded by the read-ahead tasks
+  typedef std::vector<DQMStore::DecodedElement> DecodedFile;
+  std::unique_ptr<DQMReadAhead<DecodedFile> > readAhead_;
+  std::set<std::string> submitted_;
+
   std::unique_ptr<double> streamReader_;
   DQMFileIterator fiterator_;
   DQMFileIterator::LumiEntry currentLumi_;
@@ -0,0 +1,264 @@
+#ifndef DQMServices_StreamerIO_DQMReadAhead_h
+#define DQMServices_StreamerIO_DQMReadAhead_h
+
+#include "DQMMonitoringService.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
+
+/*
+ * Read-ahead pipeline of the online DQM input sources.
+ *
+ * The upcoming items (the events of the open streamer file, the files of
+ * the next lumis) are submitted with the function decoding them, which
+ * runs as a TBB task in an arena of the given concurrency, while the
+ * source thread takes the decoded items in submission order. An item
+ * whose decoding has not started when it is taken is decoded by the
+ * source thread itself, so the pipeline also progresses when no TBB
+ * worker is free. The memory held by the submitted items is bounded:
+ * submit() waits, and trySubmit() fails, when the bound is reached. A
+ * decoding error is rethrown on the source thread, when the item is taken.
+ */
+
+namespace dqmservices {
+
+template <typename T>
+class DQMReadAhead {
+ public:
+  typedef DQMMonitoringService::StageCounters Counters;
+  typedef std::function<void(T&)> Decoder;
+
+  // the counters are optional: "decode" counts the decoding work, "wait"
+  // the time the source thread waits for the items; the arena has one slot
+  // for the submitting thread, which only spawns the tasks, and nThreads
+  // slots for the TBB workers decoding
+  DQMReadAhead(unsigned int nThreads, size_t maxBytes,
+               Counters* decode = nullptr, Counters* wait = nullptr)
+      : maxBytes_(maxBytes),
+        usedBytes_(0),
+        closed_(false),
+        stopped_(false),
+        decode_(decode),
+        wait_(wait),
+        arena_((nThreads == 0 ? 1 : nThreads) + 1, 1) {}
+
+  ~DQMReadAhead() { stop(); }
+
+  DQMReadAhead(const DQMReadAhead&) = delete;
+  DQMReadAhead& operator=(const DQMReadAhead&) = delete;
+
+  // queues an item of the given size, waiting while the memory bound is
+  // reached; returns false if the pipeline was stopped
+  bool submit(const std::string& key, T&& item, size_t bytes,
+              Decoder decoder) {
+    std::unique_lock<std::mutex> lock(lock_);
+    cond_.wait(lock, [&]() { return stopped_ || fits(bytes); });
+    if (stopped_) return false;
+
+    push(key, std::move(item), bytes, std::move(decoder));
+    return true;
+  }
+
+  // same, but fails instead of waiting
+  bool trySubmit(const std::string& key, T&& item, size_t bytes,
+                 Decoder decoder) {
+    std::unique_lock<std::mutex> lock(lock_);
+    if (stopped_ || !fits(bytes)) return false;
+
+    push(key, std::move(item), bytes, std::move(decoder));
+    return true;
+  }
+
+  // no more items will be submitted; error, if set, is rethrown by next()
+  // after the items already submitted
+  void close(std::exception_ptr error = std::exception_ptr()) {
+    std::unique_lock<std::mutex> lock(lock_);
+    closed_ = true;
+    error_ = error;
+    cond_.notify_all();
+  }
+
+  // takes the next item, waiting for its decoding; returns false once the
+  // pipeline is closed and all the items were taken
+  bool next(T& item) {
+    std::unique_lock<std::mutex> lock(lock_);
+    auto start = std::chrono::steady_clock::now();
+    cond_.wait(lock, [&]() {
+      return stopped_ || (slots_.empty() && closed_) ||
+             (!slots_.empty() && !slots_.front()->started) ||
+             (!slots_.empty() && slots_.front()->done);
+    });
+    if (!stopped_ && !slots_.empty()) decodeFront(lock, start);
+
+    if (stopped_) return false;
+    if (slots_.empty()) {
+      count(wait_, 0, start);
+      if (error_) {
+        std::exception_ptr error = error_;
+        error_ = std::exception_ptr();
+        std::rethrow_exception(error);
+      }
+      return false;
+    }
+
+    return pop(item);
+  }
+
+  // takes the item with the given key, dropping the items submitted before
+  // it; returns false, and leaves the queue untouched, if it is not queued
+  bool take(const std::string& key, T& item) {
+    std::unique_lock<std::mutex> lock(lock_);
+    auto found = slots_.begin();
+    while ((found != slots_.end()) && ((*found)->key != key)) ++found;
+    if (found == slots_.end()) return false;
+
+    while (slots_.front()->key != key) {
+      release(slots_.front());
+      slots_.pop_front();
+    }
+
+    decodeFront(lock, std::chrono::steady_clock::now());
+    if (stopped_) return false;
+
+    return pop(item);
+  }
+
+  // drops the pending items and waits for the decodings already running;
+  // the tasks not started yet return at once
+  void stop() {
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      if (stopped_) return;
+      stopped_ = true;
+      slots_.clear();
+      cond_.notify_all();
+    }
+
+    arena_.execute([this]() { tasks_.wait(); });
+  }
+
+ private:
+  struct Slot {
+    std::string key;
+    T item;
+    size_t bytes;
+    Decoder decoder;
+    bool started;
+    bool done;
+    std::exception_ptr error;
+  };
+
+  // an item larger than the bound is accepted when nothing else is queued
+  bool fits(size_t bytes) const {
+    return (usedBytes_ == 0) || (usedBytes_ + bytes <= maxBytes_);
+  }
+
+  void push(const std::string& key, T&& item, size_t bytes, Decoder decoder) {
+    std::shared_ptr<Slot> slot(new Slot{key, std::move(item), bytes,
+                                        std::move(decoder), false, false,
+                                        std::exception_ptr()});
+    usedBytes_ += bytes;
+    slots_.push_back(slot);
+    // the lock is held: stop() can not wait for the tasks meanwhile
+    std::weak_ptr<Slot> task(slot);
+    arena_.execute([this, &task]() { tasks_.run([this, task]() { work(task); }); });
+    cond_.notify_all();
+  }
+
+  bool pop(T& item) {
+    std::shared_ptr<Slot> slot = slots_.front();
+    slots_.pop_front();
+    release(slot);
+
+    if (slot->error) std::rethrow_exception(slot->error);
+    item = std::move(slot->item);
+    return true;
+  }
+
+  void release(const std::shared_ptr<Slot>& slot) {
+    usedBytes_ -= slot->bytes;
+    cond_.notify_all();
+  }
+
+  void count(Counters* counters, size_t bytes,
+             std::chrono::steady_clock::time_point start) {
+    if (!counters) return;
+
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    counters->items += 1;
+    counters->bytes += bytes;
+    counters->micros += micros.count();
+  }
+
+  // decodes the slot, called with the lock held, which is released while
+  // decoding
+  void decode(std::unique_lock<std::mutex>& lock, Slot& slot) {
+    slot.started = true;
+
+    lock.unlock();
+    auto start = std::chrono::steady_clock::now();
+    try {
+      slot.decoder(slot.item);
+    } catch (...) {
+      slot.error = std::current_exception();
+    }
+    count(decode_, slot.bytes, start);
+    lock.lock();
+
+    slot.done = true;
+    cond_.notify_all();
+  }
+
+  // the source thread decodes the first item itself if no task started
+  // it yet, else waits for the task; the wait started at start
+  void decodeFront(std::unique_lock<std::mutex>& lock,
+                   std::chrono::steady_clock::time_point start) {
+    std::shared_ptr<Slot> slot = slots_.front();
+    if (!slot->started) {
+      count(wait_, 0, start);
+      decode(lock, *slot);
+      return;
+    }
+
+    cond_.wait(lock, [&]() { return stopped_ || slot->done; });
+    count(wait_, 0, start);
+  }
+
+  // the task does not own the slot: the items dropped by take() or stop()
+  // are not decoded
+  void work(const std::weak_ptr<Slot>& task) {
+    std::unique_lock<std::mutex> lock(lock_);
+    std::shared_ptr<Slot> slot = task.lock();
+    if (slot && !stopped_ && !slot->started) decode(lock, *slot);
+    slot.reset();  // the items are only released under the lock
+  }
+
+  const size_t maxBytes_;
+  size_t usedBytes_;
+  bool closed_;
+  bool stopped_;
+  std::exception_ptr error_;
+
+  std::mutex lock_;
+  std::condition_variable cond_;
+  std::deque<std::shared_ptr<Slot> > slots_;  // in submission order
+
+  Counters* decode_;
+  Counters* wait_;
+  tbb::task_arena arena_;
+  tbb::task_group tasks_;
+};
+
+}  // end-of-namespace
+
+#endif
@@ -13,6 +13,7 @@
 #include "FWCore/Utilities/interface/RegexMatch.h"
 #include "DQMStreamerReader.h"
 
+#include <chrono>
 #include <fstream>
 #include <queue>
 #include <cstdlib>
@@ -38,6 +39,8 @@ DQMStreamerReader::DQMStreamerReader(edm::ParameterSet const& pset,
   flagSkipFirstLumis_ = pset.getUntrackedParameter<bool>("skipFirstLumis");
   flagEndOfRunKills_ = pset.getUntrackedParameter<bool>("endOfRunKills");
   flagDeleteDatFiles_ = pset.getUntrackedParameter<bool>("deleteDatFiles");
+  readAheadThreads_ = pset.getUntrackedParameter<unsigned int>("readAheadThreads");
+  readAheadBytes_ = (size_t)pset.getUntrackedParameter<unsigned int>("readAheadMemoryMB") << 20;
 
   triggerSel();
 
@@ -50,6 +53,9 @@ DQMStreamerReader::~DQMStreamerReader() {
   //
   // Normally, this file should be closed before this destructor is called.
   //closeFile_("destructor");
+
+  // but the read-ahead reader thread and tasks must not outlive the source
+  stopReadAhead_();
 }
 
 void DQMStreamerReader::reset_() {
@@ -128,6 +134,8 @@ void DQMStreamerReader::openFile_(const DQMFileIterator::LumiEntry& entry) {
   // our initialization
   processedEventPerLs_ = 0;
 
+  startReadAhead_();
+
   if (flagDeleteDatFiles_) {
     // unlink the file
     unlink(path.c_str());
@@ -136,6 +144,7 @@ void DQMStreamerReader::openFile_(const DQMFileIterator::LumiEntry& entry) {
 
 void DQMStreamerReader::closeFile_(const std::string& reason) {
   if (file_.open()) {
+    stopReadAhead_();
     file_.streamFile_->closeStreamerFile();
     file_.streamFile_ = nullptr;
 
@@ -143,6 +152,73 @@ void DQMStreamerReader::closeFile_(const std::string& reason) {
   }
 }
 
+/**
+ * Starts reading the events of the open file ahead: the reader thread
+ * reads them and drops the ones rejected by the trigger selection, the
+ * pipeline tasks check and uncompress their data.
+ */
+void DQMStreamerReader::startReadAhead_() {
+  if (readAheadBytes_ == 0) return;
+
+  DQMReadAhead<ReadAheadEvent>::Counters* decode = nullptr;
+  DQMReadAhead<ReadAheadEvent>::Counters* wait = nullptr;
+  DQMReadAhead<ReadAheadEvent>::Counters* read = nullptr;
+  if (mon_.isAvailable()) {
+    decode = &mon_->stageCounters("streamer_unpack");
+    wait = &mon_->stageCounters("streamer_wait");
+    read = &mon_->stageCounters("streamer_read");
+  }
+
+  file_.readAhead_.reset(new DQMReadAhead<ReadAheadEvent>(
+      readAheadThreads_, readAheadBytes_, decode, wait));
+
+  DQMReadAhead<ReadAheadEvent>* readAhead = file_.readAhead_.get();
+  edm::StreamerInputFile* streamFile = file_.streamFile_.get();
+  file_.reader_ = std::thread([this, readAhead, streamFile, read]() {
+    std::exception_ptr error;
+    try {
+      for (unsigned long n = 0;; ++n) {
+        auto start = std::chrono::steady_clock::now();
+        if (!streamFile->next()) break;
+
+        EventMsgView const* msg = streamFile->currentRecord();
+        if (!acceptEvent(msg)) continue;
+
+        ReadAheadEvent event;
+        event.message.assign(msg->startAddress(),
+                             msg->startAddress() + msg->size());
+        if (read) {
+          read->items += 1;
+          read->bytes += msg->size();
+          read->micros += std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - start).count();
+        }
+
+        size_t bytes = msg->size() + msg->origDataSize();
+        bool queued = readAhead->submit(
+            std::to_string(n), std::move(event), bytes, [](ReadAheadEvent& e) {
+              EventMsgView view(&e.message[0]);
+              e.dataSize = edm::StreamerInputSource::unpackEventData(view, e.data);
+            });
+        if (!queued) return;
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    readAhead->close(error);
+  });
+}
+
+void DQMStreamerReader::stopReadAhead_() {
+  if (!file_.readAhead_) return;
+
+  // unblocks the reader thread, if it waits for memory
+  file_.readAhead_->stop();
+  file_.reader_.join();
+  file_.readAhead_.reset();
+  file_.eventView_.reset();
+}
+
 bool DQMStreamerReader::openNextFile_() {
   closeFile_("skipping to another file");
 
@@ -183,6 +259,15 @@ InitMsgView const* DQMStreamerReader::getHeaderMsg() {
 }
 
 EventMsgView const* DQMStreamerReader::getEventMsg() {
+  if (file_.readAhead_) {
+    if (!file_.readAhead_->next(file_.event_)) {
+      return nullptr;
+    }
+
+    file_.eventView_.reset(new EventMsgView(&file_.event_.message[0]));
+    return file_.eventView_.get();
+  }
+
   if (!file_.streamFile_->next()) {
     return nullptr;
   }
@@ -285,7 +370,8 @@ EventMsgView const* DQMStreamerReader::prepareNextEvent() {
         // this means end of file, so close the file
         closeFile_("eof");
       } else {
-        if (!acceptEvent(eview)) {
+        // the trigger selection is applied by the read-ahead reader thread
+        if ((!file_.readAhead_) && (!acceptEvent(eview))) {
           continue;
         } else {
           return eview;
@@ -306,17 +392,23 @@ bool DQMStreamerReader::checkNextEvent() {
       return false;
     }
 
-    // this is reachable only if eview is set
-    // and the file is openned
-    if (file_.streamFile_->newHeader()) {
-      // A new file has been opened and we must compare Headers here !!
-      // Get header/init from reader
+    if (file_.readAhead_) {
+      // the data were already checked and uncompressed,
+      // a single file never has a new header
+      deserializeEvent(*eview, file_.event_.data, file_.event_.dataSize);
+    } else {
+      // this is reachable only if eview is set
+      // and the file is openned
+      if (file_.streamFile_->newHeader()) {
+        // A new file has been opened and we must compare Headers here !!
+        // Get header/init from reader
+
+        InitMsgView const* header = getHeaderMsg();
+        deserializeAndMergeWithRegistry(*header, true);
+      }
 
-      InitMsgView const* header = getHeaderMsg();
-      deserializeAndMergeWithRegistry(*header, true);
+      deserializeEvent(*eview);
     }
-
-    deserializeEvent(*eview);
   } catch (const cms::Exception& e) {
     // try to recover from corrupted files/events
     fiterator_.logFileAction(std::string("Can't deserialize event or registry data: ") + e.what());
@@ -440,6 +532,17 @@ void DQMStreamerReader::fillDescriptions(
           "Kill the processing as soon as the end-of-run file appears, even if "
           "there are/will be unprocessed lumisections.");
 
+  desc.addUntracked<unsigned int>("readAheadMemoryMB", 0)
+      ->setComment(
+          "Memory used to read the upcoming events of the open file ahead "
+          "and uncompress them in TBB tasks, 0 (the default) to read and "
+          "uncompress them on the source thread.");
+
+  desc.addUntracked<unsigned int>("readAheadThreads", 2)
+      ->setComment(
+          "Number of TBB tasks uncompressing the events read ahead "
+          "concurrently.");
+
   // desc.addUntracked<unsigned int>("skipEvents", 0U)
   //    ->setComment("Skip the first 'skipEvents' events that otherwise would "
   //                 "have been processed.");
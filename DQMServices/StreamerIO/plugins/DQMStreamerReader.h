@@ -8,12 +8,15 @@
 
 #include "DQMFileIterator.h"
 #include "DQMMonitoringService.h"
+#include "DQMReadAhead.h"
 #include "TriggerSelector.h"
 
 #include "boost/filesystem.hpp"
 
+#include <exception>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <iterator>
 #include <boost/property_tree/json_parser.hpp>
@@ -49,6 +52,9 @@ class DQMStreamerReader : public edm::StreamerInputSource {
   InitMsgView const* getHeaderMsg();
   EventMsgView const* getEventMsg();
 
+  void startReadAhead_();
+  void stopReadAhead_();
+
   EventMsgView const* prepareNextEvent();
   bool prepareNextFile();
   bool acceptEvent(const EventMsgView*);
@@ -70,12 +76,29 @@ class DQMStreamerReader : public edm::StreamerInputSource {
   bool flagEndOfRunKills_;
   bool flagDeleteDatFiles_;
 
+  unsigned int readAheadThreads_;
+  size_t readAheadBytes_;
+
   DQMFileIterator fiterator_;
 
+  // event read, checked and uncompressed ahead of the source thread
+  struct ReadAheadEvent {
+    std::vector<unsigned char> message;  // as read from the file
+    std::vector<unsigned char> data;     // the unpacked event data
+    unsigned int dataSize = 0;
+  };
+
   struct OpenFile {
     std::unique_ptr<edm::StreamerInputFile> streamFile_;
     DQMFileIterator::LumiEntry lumi_;
 
+    // when reading ahead, the events of the file are read by the reader
+    // thread and unpacked by the pipeline tasks
+    std::unique_ptr<DQMReadAhead<ReadAheadEvent> > readAhead_;
+    std::thread reader_;
+    ReadAheadEvent event_;
+    std::unique_ptr<EventMsgView> eventView_;
+
     bool open() { return (streamFile_.get() != nullptr); }
 
   } file_;
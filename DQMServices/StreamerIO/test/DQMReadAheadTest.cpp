@@ -0,0 +1,229 @@
+#include "DQMServices/StreamerIO/plugins/DQMReadAhead.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+/*
+ * Test of the read-ahead pipeline of the online DQM input sources: the
+ * items are delivered in submission order, the memory bound holds, the
+ * pipeline can be stopped or destroyed while items are read and decoded,
+ * and the decoding errors reach the source thread.
+ */
+
+using dqmservices::DQMReadAhead;
+
+namespace {
+
+int errors = 0;
+
+void check(bool ok, const char* what) {
+  if (!ok) {
+    std::cout << "Error: " << what << std::endl;
+    ++errors;
+  }
+}
+
+void sleep(unsigned int micros) {
+  std::this_thread::sleep_for(std::chrono::microseconds(micros));
+}
+
+// decodes an item into its square, after a delay depending on the item
+// so that the decodings end out of order
+void square(int& item) {
+  sleep(((item * 7919) % 13) * 50);
+  item *= item;
+}
+
+void inOrder() {
+  const int n = 500;
+  DQMReadAhead<int> readAhead(4, 64);
+
+  std::thread reader([&readAhead]() {
+    for (int i = 0; i < n; ++i) {
+      int item = i;
+      if (!readAhead.submit(std::to_string(i), std::move(item), 1, square))
+        return;
+    }
+    readAhead.close();
+  });
+
+  bool ordered = true;
+  int taken = 0;
+  int item;
+  while (readAhead.next(item)) {
+    ordered &= (item == taken * taken);
+    ++taken;
+  }
+  reader.join();
+
+  check(ordered, "the items are delivered in submission order");
+  check(taken == n, "all the items are delivered");
+  check(!readAhead.next(item), "nothing is delivered after the last item");
+}
+
+void memoryBound() {
+  DQMReadAhead<int> readAhead(2, 10);
+  auto none = [](int&) {};
+  int item;
+
+  // three items of 3 bytes fit, a fourth does not
+  for (int i = 0; i < 3; ++i) {
+    int one = i;
+    check(readAhead.trySubmit(std::to_string(i), std::move(one), 3, none),
+          "the items within the bound are accepted");
+  }
+  int four = 3;
+  check(!readAhead.trySubmit("3", std::move(four), 3, none),
+        "an item past the bound is refused");
+
+  // submit() waits until an item is taken
+  std::atomic<bool> submitted(false);
+  std::thread reader([&]() {
+    int one = 3;
+    readAhead.submit("3", std::move(one), 3, none);
+    submitted = true;
+  });
+  sleep(100000);
+  check(!submitted, "submit() waits while the bound is reached");
+  check(readAhead.next(item) && item == 0, "the first item is taken");
+  reader.join();
+  check(submitted, "submit() returns once an item is taken");
+
+  // take() drops the items submitted before the one asked for
+  check(!readAhead.take("7", item), "an item not queued is not taken");
+  check(readAhead.take("2", item) && item == 2, "an item is taken by key");
+  check(readAhead.next(item) && item == 3, "the items before it are dropped");
+
+  // an item larger than the bound is accepted when nothing is queued
+  int large = 4;
+  check(readAhead.trySubmit("4", std::move(large), 100, none),
+        "an item larger than the bound is accepted alone");
+  int small = 5;
+  check(!readAhead.trySubmit("5", std::move(small), 1, none),
+        "no item is accepted with the large one");
+  check(readAhead.next(item) && item == 4, "the large item is taken");
+}
+
+// stops, or destroys, the pipeline while the reader waits for memory and
+// the decodings run
+void stopMidRead(bool destroy) {
+  std::atomic<int> running(0);
+  std::atomic<int> decoded(0);
+  std::atomic<bool> refused(false);
+  auto slow = [&running, &decoded](int&) {
+    ++running;
+    sleep(20000);
+    ++decoded;
+    --running;
+  };
+
+  std::unique_ptr<DQMReadAhead<int> > readAhead(new DQMReadAhead<int>(3, 8));
+  std::thread reader([&]() {
+    for (int i = 0; i < 1000; ++i) {
+      int item = i;
+      if (!readAhead->submit(std::to_string(i), std::move(item), 1, slow)) {
+        refused = true;
+        return;
+      }
+    }
+  });
+
+  int item;
+  check(readAhead->next(item) && item == 0, "the first item is taken");
+  check(readAhead->next(item) && item == 1, "the second item is taken");
+  sleep(10000);
+
+  if (destroy) {
+    // the reader holds a pointer to the pipeline: it has to be unblocked
+    // and joined before the destruction, as the sources do
+    readAhead->stop();
+    reader.join();
+    readAhead.reset();
+  } else {
+    readAhead->stop();
+    reader.join();
+    check(!readAhead->next(item), "nothing is delivered once stopped");
+    int more = 0;
+    check(!readAhead->trySubmit("more", std::move(more), 1, slow),
+          "nothing is accepted once stopped");
+  }
+
+  check(running == 0, "stopping waits for the running decodings");
+  check(refused, "the waiting reader is released by stop()");
+  int stopped = decoded;
+  sleep(50000);
+  check(decoded == stopped, "the dropped items are not decoded");
+}
+
+// the pipeline is destroyed with decodings running, without stop()
+void destroyWhileDecoding() {
+  std::atomic<int> running(0);
+  auto slow = [&running](int&) {
+    ++running;
+    sleep(20000);
+    --running;
+  };
+  {
+    DQMReadAhead<int> readAhead(2, 100);
+    for (int i = 0; i < 20; ++i) {
+      int item = i;
+      readAhead.trySubmit(std::to_string(i), std::move(item), 1, slow);
+    }
+    sleep(10000);
+  }
+  check(running == 0, "the destruction waits for the running decodings");
+}
+
+void exceptions() {
+  DQMReadAhead<int> readAhead(2, 100);
+  auto fail = [](int& item) {
+    if (item == 2) throw std::runtime_error("corrupted item");
+  };
+  for (int i = 0; i < 4; ++i) {
+    int item = i;
+    readAhead.trySubmit(std::to_string(i), std::move(item), 1, fail);
+  }
+  readAhead.close(std::make_exception_ptr(std::runtime_error("read error")));
+
+  int item;
+  check(readAhead.next(item) && item == 0, "the items before an error are delivered");
+  check(readAhead.next(item) && item == 1, "the items before an error are delivered");
+
+  bool thrown = false;
+  try {
+    readAhead.next(item);
+  } catch (std::runtime_error const& e) {
+    thrown = (std::string(e.what()) == "corrupted item");
+  }
+  check(thrown, "a decoding error is rethrown when its item is taken");
+  check(readAhead.next(item) && item == 3, "the items after an error are delivered");
+
+  thrown = false;
+  try {
+    readAhead.next(item);
+  } catch (std::runtime_error const& e) {
+    thrown = (std::string(e.what()) == "read error");
+  }
+  check(thrown, "the error given to close() is rethrown after the last item");
+  check(!readAhead.next(item), "the error given to close() is rethrown once");
+}
+
+}  // namespace
+
+int main() {
+  inOrder();
+  memoryBound();
+  stopMidRead(false);
+  stopMidRead(true);
+  destroyWhileDecoding();
+  exceptions();
+
+  if (errors) return 1;
+  std::cout << "DQMReadAhead validated" << std::endl;
+  return 0;
+}
@@ -24,6 +24,7 @@
 #include "DataFormats/TestObjects/interface/StreamTestTmpl.h"
 
 #include "DataFormats/TestObjects/interface/TableTest.h"
+#include "FWCore/SOA/interface/TableStreamer.h"
 
 #include "DataFormats/TestObjects/interface/DeleteEarly.h"
 
@@ -124,3 +125,6 @@ struct dictionary {
   static_assert(std::is_same<edmtest::TableTest,edm::soa::Table<edmtest::AnInt,edmtest::AFloat,edmtest::AString>>::value, "Definition of edmtest::TableTest changed");
 };
 }
+
+//The Table columns are written by the TableStreamer, given to ROOT when this dictionary is loaded
+EDM_SOA_TABLE_STREAMER(edmtest::TableTest);
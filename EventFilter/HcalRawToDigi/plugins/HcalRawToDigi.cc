@@ -44,6 +44,13 @@ HcalRawToDigi::HcalRawToDigi(edm::ParameterSet const& conf):
     for (int i=FEDNumbering::MINHCALuTCAFEDID; i<=FEDNumbering::MAXHCALuTCAFEDID; i++)
       fedUnpackList_.push_back(i);
   } 
+
+  // regions
+  if (conf.exists("Regions")) {
+    const edm::ParameterSet& regPSet = conf.getParameter<edm::ParameterSet>("Regions");
+    if (!regPSet.getParameterNames().empty())
+      regions_ = std::make_unique<HcalUnpackingRegions>(regPSet, consumesCollector(), firstFED_);
+  }
   
   unpacker_.setExpectedOrbitMessageTime(expectedOrbitMessageTime_);
   unpacker_.setMode(unpackerMode_);
@@ -159,6 +166,11 @@ void HcalRawToDigi::fillDescriptions(edm::ConfigurationDescriptions& description
   desc.addUntracked<int>("ExpectedOrbitMessageTime",-1);
   desc.add<edm::InputTag>("InputLabel",edm::InputTag("rawDataCollector"));
   desc.add<std::string>("ElectronicsMap","");
+  {
+    edm::ParameterSetDescription psd0;
+    HcalUnpackingRegions::fillDescription(psd0);
+    desc.add<edm::ParameterSetDescription>("Regions",psd0)->setComment("## Empty Regions PSet means complete unpacking");
+  }
   descriptions.add("hcalRawToDigi",desc);
 }
 
@@ -176,6 +188,7 @@ void HcalRawToDigi::produce(edm::Event& e, const edm::EventSetup& es)
   es.get<HcalElectronicsMapRcd>().get(electronicsMapLabel_, item);
   const HcalElectronicsMap* readoutMap = item.product();
   filter_.setConditions(pSetup.product());
+  if (regions_) regions_->run(e, es, *readoutMap);
   
   // Step B: Create empty output  : three vectors for three classes...
   std::vector<HBHEDataFrame> hbhe;
@@ -233,6 +246,8 @@ void HcalRawToDigi::produce(edm::Event& e, const edm::EventSetup& es)
       if (!silent_) edm::LogWarning("EmptyData") << "Tiny data " << fed.size() << " for FED " << *i;
       report->addError(*i);
     } else {
+      // only the FEDs reading out the regions of interest
+      if (regions_ && !regions_->mayUnpackFED(fed, *i)) continue;
       try {
 	unpacker_.unpack(fed,*readoutMap,colls, *report,silent_);
 	report->addUnpacked(*i);
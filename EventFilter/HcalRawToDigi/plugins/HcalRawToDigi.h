@@ -23,9 +23,12 @@
 
 #include "EventFilter/HcalRawToDigi/interface/HcalUnpacker.h"
 #include "EventFilter/HcalRawToDigi/interface/HcalDataFrameFilter.h"
+#include "EventFilter/HcalRawToDigi/plugins/HcalUnpackingRegions.h"
 
 #include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
 
+#include <memory>
+
 class HcalRawToDigi : public edm::stream::EDProducer <>
 {
 public:
@@ -54,6 +57,9 @@ private:
   const int unpackerMode_, expectedOrbitMessageTime_;
   std::string electronicsMapLabel_;
 
+  // regional unpacking, all the FEDs are unpacked if null
+  std::unique_ptr<HcalUnpackingRegions> regions_;
+
   // maps to easily associate nSamples to 
   // the tag for additional qie10 and qie11 info
   std::unordered_map<int, std::string> saveQIE10Info_;
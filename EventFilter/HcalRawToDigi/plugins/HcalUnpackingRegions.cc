@@ -0,0 +1,96 @@
+#include "EventFilter/HcalRawToDigi/plugins/HcalUnpackingRegions.h"
+
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "DataFormats/HcalDetId/interface/HcalDetId.h"
+#include "DataFormats/HcalDetId/interface/HcalElectronicsId.h"
+#include "EventFilter/HcalRawToDigi/interface/AMC13Header.h"
+#include "EventFilter/HcalRawToDigi/interface/HcalDCCHeader.h"
+#include "Geometry/CaloGeometry/interface/CaloGeometry.h"
+
+#include <algorithm>
+
+HcalUnpackingRegions::HcalUnpackingRegions(const edm::ParameterSet& regPSet, edm::ConsumesCollector&& iC, int firstFED) :
+  dEta_(regPSet.getParameter<std::vector<double> >("deltaEta")),
+  dPhi_(regPSet.getParameter<std::vector<double> >("deltaPhi")),
+  firstFED_(firstFED),
+  nreg_(0)
+{
+  const auto inputs = regPSet.getParameter<std::vector<edm::InputTag> >("inputs");
+  if (inputs.size() != dEta_.size() || inputs.size() != dPhi_.size()) {
+    throw cms::Exception("Configuration") << "HcalUnpackingRegions: not the same size of config parameters vectors,"
+					  << " inputs " << inputs.size() << " deltaEta " << dEta_.size()
+					  << " deltaPhi " << dPhi_.size();
+  }
+  for (const auto& input : inputs) tCandidateView_.push_back(iC.consumes<reco::CandidateView>(input));
+}
+
+void HcalUnpackingRegions::fillDescription(edm::ParameterSetDescription& desc)
+{
+  desc.addOptional<std::vector<edm::InputTag> >("inputs");
+  desc.addOptional<std::vector<double> >("deltaEta");
+  desc.addOptional<std::vector<double> >("deltaPhi");
+}
+
+void HcalUnpackingRegions::initialize(const edm::EventSetup& es, const HcalElectronicsMap& emap)
+{
+  edm::ESHandle<CaloGeometry> geometry;
+  es.get<CaloGeometryRecord>().get(geometry);
+
+  map_.clear();
+  for (const auto& eid : emap.allElectronicsIdPrecision()) {
+    const DetId id = emap.lookup(eid);
+    if (id.det() != DetId::Hcal || !geometry->present(id)) continue;
+    const HcalSubdetector subdet = HcalDetId(id).subdet();
+    if (subdet != HcalBarrel && subdet != HcalEndcap && subdet != HcalOuter && subdet != HcalForward) continue;
+    const GlobalPoint position = geometry->getPosition(id);
+    map_.add(eid.isVMEid() ? vmeUnit(eid.dccid()) : utcaUnit(eid.crateId()), position.eta(), position.phi());
+  }
+  known_.clear();
+  map_.allUnits(known_);
+  LogDebug("HcalUnpackingRegions") << known_.size() << " readout units in the eta-phi map";
+}
+
+void HcalUnpackingRegions::run(const edm::Event& e, const edm::EventSetup& es, const HcalElectronicsMap& emap)
+{
+  const bool newMap = watcherElectronicsMap_.check(es);
+  const bool newGeometry = watcherCaloGeometry_.check(es);
+  if (newMap || newGeometry) initialize(es, emap);
+
+  selected_.clear();
+  nreg_ = 0;
+  for (unsigned int t = 0; t < tCandidateView_.size(); ++t) {
+    edm::Handle<reco::CandidateView> h;
+    e.getByToken(tCandidateView_[t], h);
+    for (const auto& cand : *h) {
+      map_.unitsInRegion(cand.eta(), cand.phi(), dEta_[t], dPhi_[t], selected_);
+      ++nreg_;
+    }
+  }
+  LogDebug("HcalUnpackingRegions") << nreg_ << " regions, " << selected_.size() << " of "
+				   << known_.size() << " readout units selected";
+}
+
+bool HcalUnpackingRegions::mayUnpackUnit(unsigned int unit) const
+{
+  return std::binary_search(selected_.begin(), selected_.end(), unit) ||
+    !std::binary_search(known_.begin(), known_.end(), unit);
+}
+
+bool HcalUnpackingRegions::mayUnpackFED(const FEDRawData& fed, int fedId) const
+{
+  // same format test as HcalUnpacker::unpack, the unpacker reports the invalid data
+  if (fed.size() < 16) return true;
+  const HcalDCCHeader* dccHeader = (const HcalDCCHeader*)(fed.data());
+  if (dccHeader->BOEshouldBeZeroAlways() == 0) return mayUnpackUnit(vmeUnit(fedId - firstFED_));
+
+  // the crates of the AMC headers, as in HcalUnpacker::unpackUTCA
+  const hcal::AMC13Header* amc13 = (const hcal::AMC13Header*)(fed.data());
+  const int namc = amc13->NAMC();
+  if (fed.size() < 8*(2 + size_t(namc))) return true;
+  for (int iamc = 0; iamc < namc; ++iamc) {
+    if (mayUnpackUnit(utcaUnit(amc13->AMCId(iamc) & 0xFF))) return true;
+  }
+  return false;
+}
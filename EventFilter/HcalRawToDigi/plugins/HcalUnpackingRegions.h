@@ -0,0 +1,68 @@
+#ifndef HcalUnpackingRegions_h
+#define HcalUnpackingRegions_h
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "FWCore/Framework/interface/ConsumesCollector.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "DataFormats/Candidate/interface/Candidate.h"
+#include "DataFormats/FEDRawData/interface/FEDRawData.h"
+#include "CondFormats/HcalObjects/interface/HcalElectronicsMap.h"
+#include "CondFormats/DataRecord/interface/HcalElectronicsMapRcd.h"
+#include "Geometry/Records/interface/CaloGeometryRecord.h"
+#include "EventFilter/Utilities/interface/RegionalReadoutMap.h"
+
+#include <vector>
+
+/** \class HcalUnpackingRegions
+ *
+ * Input: One or several collections of Candidate-based seeds defining the
+ *        directions of the unpacking regions, with their own deltaEta and
+ *        deltaPhi half-widths.
+ * Output: whether a FED has to be unpacked, i.e. whether it reads out a VME
+ *         DCC or a uTCA crate with a channel in one of the regions. FEDs
+ *         with DCCs or crates unknown to the electronics map are unpacked.
+ *
+ */
+class HcalUnpackingRegions
+{
+public:
+  HcalUnpackingRegions(const edm::ParameterSet& regPSet, edm::ConsumesCollector&& iC, int firstFED);
+
+  static void fillDescription(edm::ParameterSetDescription& desc);
+
+  /// has to be run during each event, before mayUnpackFED
+  void run(const edm::Event& e, const edm::EventSetup& es, const HcalElectronicsMap& emap);
+
+  /// check whether a FED has to be unpacked, from its header
+  bool mayUnpackFED(const FEDRawData& fed, int fedId) const;
+
+  unsigned int nRegions() const { return nreg_; }
+  unsigned int nSelectedUnits() const { return selected_.size(); }
+
+private:
+  // readout units of the map: VME DCCs and uTCA crates
+  static unsigned int vmeUnit(int dccid) { return dccid; }
+  static unsigned int utcaUnit(int crate) { return 0x10000 + crate; }
+  bool mayUnpackUnit(unsigned int unit) const;
+
+  /// (re)build the eta-phi footprint of the units when the map or the geometry change
+  void initialize(const edm::EventSetup& es, const HcalElectronicsMap& emap);
+
+  std::vector<edm::EDGetTokenT<reco::CandidateView> > tCandidateView_;
+  std::vector<double> dEta_;
+  std::vector<double> dPhi_;
+  const int firstFED_;
+
+  evf::RegionalReadoutMap map_;
+  // sorted units in the map and selected by the regions of the event
+  std::vector<unsigned int> known_;
+  std::vector<unsigned int> selected_;
+  unsigned int nreg_;
+
+  edm::ESWatcher<HcalElectronicsMapRcd> watcherElectronicsMap_;
+  edm::ESWatcher<CaloGeometryRecord> watcherCaloGeometry_;
+};
+
+#endif
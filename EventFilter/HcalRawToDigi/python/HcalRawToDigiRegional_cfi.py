@@ -0,0 +1,12 @@
+import FWCore.ParameterSet.Config as cms
+
+from EventFilter.HcalRawToDigi.HcalRawToDigi_cfi import *
+
+## regional seeded unpacking for specialized HLT paths:
+## only the FEDs reading out the eta-phi windows around the inputs
+hcalDigisRegional = hcalDigis.clone()
+hcalDigisRegional.Regions = cms.PSet(
+    inputs = cms.VInputTag( "hltL2EtCutDoublePFIsoTau45Trk5" ),
+    deltaEta = cms.vdouble( 0.5 ),
+    deltaPhi = cms.vdouble( 0.5 )
+)
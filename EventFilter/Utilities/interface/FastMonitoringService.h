@@ -15,6 +15,7 @@
 
 #include "EventFilter/Utilities/interface/MicroStateService.h"
 #include "EventFilter/Utilities/interface/FastMonitoringThread.h"
+#include "EventFilter/Utilities/interface/FastMonitoringShm.h"
 
 #include <string>
 #include <vector>
@@ -185,7 +186,10 @@ namespace evf{
       }
       std::string getRunDirName() const { return runDirectory_.stem().string(); }
       void setInputSource(FedRawDataInputSource *inputSource) {inputSource_=inputSource;}
-      void setInState(FastMonitoringThread::InputState inputState) {inputState_=inputState;}
+      void setInState(FastMonitoringThread::InputState inputState) {
+        inputState_=inputState;
+        if (shm_.isOpen()) shm_.setInputState(inputState);
+      }
       void setInStateSup(FastMonitoringThread::InputState inputState) {inputSupervisorState_=inputState;}
 
     private:
@@ -314,6 +318,12 @@ namespace evf{
       std::vector<unsigned int> exceptionInLS_;
       std::vector<std::string> fastPathList_;
 
+      //shared memory export of the states, written directly by the callbacks
+      std::string shmDirectory_;
+      FastMonitoringShm shm_;
+      //microstate (module legend) index of the modules, by module id
+      std::vector<uint32_t> moduleIndex_;
+
     };
 
 }
@@ -0,0 +1,165 @@
+#ifndef EVF_FASTMONITORINGSHM
+#define EVF_FASTMONITORINGSHM
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*Description
+  Shared memory export of the FastMonitoringService states.
+  The segment is a file of fixed layout (normally in /dev/shm) mapped by the HLT process, written by the
+  framework callbacks without building strings nor taking the monitoring lock, and mapped read-only by any
+  external process which wants to sample the states, at any rate.
+  For every stream it holds the current microstate and ministate (indices in the legends written by the service
+  in the mon directory), the lumi, the number of processed events, and the time spent in every microstate so far,
+  so that the occupancy of the modules over any interval is the difference of two snapshots.
+  Every stream block is protected by a sequence counter (seqlock): a writer makes it odd while it updates the block
+  and even again at the end, a reader retries its copy until it sees the same even value before and after it.
+  The global counters are independent values and are not protected.
+*/
+
+namespace evf{
+
+  namespace shm {
+
+    static const char MAGIC[8] = {'F','M','O','N','S','H','M','\0'};
+    static const uint32_t VERSION = 1;
+    static const size_t ALIGNMENT = 64;
+
+    struct Header {
+      char magic[8];
+      uint32_t version;
+      uint32_t pid;
+      uint32_t nStreams;
+      uint32_t nStates;             // number of microstates (bins of the module legend)
+      uint64_t streamOffset;        // offset of the first stream block from the beginning of the segment
+      uint64_t streamStride;        // bytes between two stream blocks
+      uint64_t startTime;           // steady clock ns when the segment was created
+      std::atomic<uint32_t> macrostate;
+      std::atomic<uint32_t> inputState;
+      std::atomic<uint32_t> lumi;   // last global lumi
+      uint32_t reserved;
+      std::atomic<uint64_t> eventsProcessed;
+    };
+
+    struct Stream {
+      std::atomic<uint32_t> seq;
+      std::atomic<uint32_t> microstate;
+      std::atomic<uint32_t> ministate;
+      std::atomic<uint32_t> lumi;
+      std::atomic<uint64_t> processed;  // events processed in the lumi
+      std::atomic<uint64_t> since;      // steady clock ns of the last microstate change
+      // followed by nStates std::atomic<uint64_t>, the ns spent in each microstate
+    };
+
+    /// consistent copy of a stream block
+    struct StreamSnapshot {
+      uint32_t microstate;
+      uint32_t ministate;
+      uint32_t lumi;
+      uint64_t processed;
+      uint64_t since;
+      std::vector<uint64_t> occupancy;
+    };
+  }
+
+  class FastMonitoringShm {
+  public:
+    FastMonitoringShm();
+    ~FastMonitoringShm();
+    FastMonitoringShm(const FastMonitoringShm&) = delete;
+    FastMonitoringShm& operator=(const FastMonitoringShm&) = delete;
+
+    /// creates the segment (replacing any previous file), throws if it can't
+    void create(std::string const& path, unsigned int nStreams, unsigned int nStates);
+    /// maps an existing segment read-only, returns false if it is missing or not valid
+    bool attach(std::string const& path);
+    void close();
+
+    bool isOpen() const {return base_!=nullptr;}
+    shm::Header const* header() const {return header_;}
+
+    //writers, only valid once the segment is created
+    void setMicrostate(unsigned int sid, uint32_t state) {
+      Guard g(stream(sid));
+      changeMicrostate(g.s_,state,now());
+    }
+    void setStates(unsigned int sid, uint32_t micro, uint32_t mini) {
+      Guard g(stream(sid));
+      changeMicrostate(g.s_,micro,now());
+      g.s_->ministate.store(mini,std::memory_order_relaxed);
+    }
+    void setMinistate(unsigned int sid, uint32_t mini) {
+      Guard g(stream(sid));
+      g.s_->ministate.store(mini,std::memory_order_relaxed);
+    }
+    void beginLumi(unsigned int sid, uint32_t lumi, uint32_t micro, uint32_t mini) {
+      Guard g(stream(sid));
+      changeMicrostate(g.s_,micro,now());
+      g.s_->ministate.store(mini,std::memory_order_relaxed);
+      g.s_->lumi.store(lumi,std::memory_order_relaxed);
+      g.s_->processed.store(0,std::memory_order_relaxed);
+    }
+    void eventProcessed(unsigned int sid, uint32_t micro, uint32_t mini) {
+      Guard g(stream(sid));
+      changeMicrostate(g.s_,micro,now());
+      g.s_->ministate.store(mini,std::memory_order_relaxed);
+      g.s_->processed.store(g.s_->processed.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+      header_->eventsProcessed.fetch_add(1,std::memory_order_relaxed);
+    }
+    void setMacrostate(uint32_t state) {header_->macrostate.store(state,std::memory_order_relaxed);}
+    void setInputState(uint32_t state) {header_->inputState.store(state,std::memory_order_relaxed);}
+    void setLumi(uint32_t lumi) {header_->lumi.store(lumi,std::memory_order_relaxed);}
+
+    //reader, returns false if the writer kept updating the block during maxRetries copies
+    bool snapshot(unsigned int sid, shm::StreamSnapshot& snap, unsigned int maxRetries=1000) const;
+
+    static uint64_t now();
+
+  private:
+    //the writers of a stream can be concurrent (modules of the same stream running on several threads):
+    //making the counter odd is also the lock of the writers of the block
+    struct Guard {
+      explicit Guard(shm::Stream *s): s_(s) {
+        uint32_t seq = s_->seq.load(std::memory_order_relaxed);
+        for (;;) {
+          if (!(seq&1) && s_->seq.compare_exchange_weak(seq,seq+1,std::memory_order_acquire,std::memory_order_relaxed))
+            break;
+          seq = s_->seq.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        seq_ = seq+2;
+      }
+      ~Guard() {s_->seq.store(seq_,std::memory_order_release);}
+      shm::Stream *s_;
+      uint32_t seq_;
+    };
+
+    shm::Stream* stream(unsigned int sid) const {
+      return reinterpret_cast<shm::Stream*>(base_+header_->streamOffset+sid*header_->streamStride);
+    }
+    static std::atomic<uint64_t>* occupancy(shm::Stream *s) {
+      return reinterpret_cast<std::atomic<uint64_t>*>(s+1);
+    }
+    void changeMicrostate(shm::Stream *s, uint32_t state, uint64_t t) {
+      uint32_t old = s->microstate.load(std::memory_order_relaxed);
+      uint64_t since = s->since.load(std::memory_order_relaxed);
+      if (old<header_->nStates && t>since) {
+        std::atomic<uint64_t>& occ = occupancy(s)[old];
+        occ.store(occ.load(std::memory_order_relaxed)+(t-since),std::memory_order_relaxed);
+      }
+      s->microstate.store(state,std::memory_order_relaxed);
+      s->since.store(t,std::memory_order_relaxed);
+    }
+
+    char *base_;
+    size_t size_;
+    shm::Header *header_;
+    std::string path_;
+    bool owner_;
+  };
+
+} //end namespace evf
+#endif
@@ -0,0 +1,49 @@
+#ifndef EventFilter_Utilities_RegionalReadoutMap_h
+#define EventFilter_Utilities_RegionalReadoutMap_h
+
+#include <vector>
+
+namespace evf {
+
+  /** \class RegionalReadoutMap
+   *
+   * Eta-phi footprint of the readout units (FEDs, crates, modules...) of a
+   * detector, to find the units to unpack for regions of interest (e.g.
+   * around the L1 seeds) in the regional HLT paths.
+   * The units are listed for each cell of a fixed eta-phi grid; a unit is
+   * selected if one of its cells overlaps the eta-phi window of a region, so
+   * that the selection contains all the units with a channel in the window.
+   */
+  class RegionalReadoutMap {
+  public:
+    RegionalReadoutMap(double etaMax = 5.2, unsigned int nEta = 104, unsigned int nPhi = 72);
+
+    void clear();
+    /// declares a channel (or module) of the unit at (eta, phi)
+    void add(unsigned int unit, double eta, double phi);
+    bool empty() const { return nChannels_ == 0; }
+
+    /// adds to units the units with a channel in the window
+    /// |eta' - eta| <= dEta, |phi' - phi| <= dPhi; units is kept sorted
+    /// without duplicates. All the units are taken for a non-finite region,
+    /// or a NaN or negative window.
+    void unitsInRegion(double eta, double phi, double dEta, double dPhi,
+                       std::vector<unsigned int>& units) const;
+    /// all the units declared
+    void allUnits(std::vector<unsigned int>& units) const;
+
+  private:
+    int etaBin(double eta) const;
+    void addCell(unsigned int cell, std::vector<unsigned int>& units) const;
+
+    double etaMax_;
+    int nEta_, nPhi_;
+    double etaBinSize_, phiBinSize_;
+    // sorted units of each cell, cell = etaBin*nPhi + phiBin
+    std::vector<std::vector<unsigned int> > cells_;
+    unsigned int nChannels_;
+  };
+
+}
+
+#endif
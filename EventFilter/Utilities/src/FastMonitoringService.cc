@@ -68,6 +68,7 @@ namespace evf{
     ,slowName_("slowmoni")
     ,filePerFwkStream_(iPS.getUntrackedParameter<bool>("filePerFwkStream", false))
     ,totalEventsProcessed_(0)
+    ,shmDirectory_(iPS.getUntrackedParameter<std::string>("shmDirectory", ""))
   {
     reg.watchPreallocate(this, &FastMonitoringService::preallocate);//receiving information on number of threads
     reg.watchJobFailure(this,&FastMonitoringService::jobFailure);//global
@@ -128,6 +129,7 @@ namespace evf{
     desc.addUntracked<int> ("sleepTime",1)->setComment("Sleep time of the monitoring thread");
     desc.addUntracked<unsigned int> ("fastMonIntervals",2)->setComment("Modulo of sleepTime intervals on which fastmon file is written out");
     desc.addUntracked<bool> ("filePerFwkStream", false)->setComment("Switches on monitoring output per framework stream");
+    desc.addUntracked<std::string> ("shmDirectory", "")->setComment("Directory (e.g. /dev/shm) of the shared memory segment exporting the per stream states for external readers; empty to disable it");
     desc.setAllowAnything();
     descriptions.add("FastMonitoringService", desc);
   }
@@ -345,6 +347,7 @@ namespace evf{
   void FastMonitoringService::jobFailure()
   {
     macrostate_ = FastMonitoringThread::sError;
+    if (shm_.isOpen()) shm_.setMacrostate(macrostate_);
   }
 
   //new output module name is stream
@@ -362,6 +365,10 @@ namespace evf{
     }
     else
       encModule_.update((void*)&desc);
+
+    //the callbacks writing to the shared segment avoid the hash lookup
+    if (desc.id()>=moduleIndex_.size()) moduleIndex_.resize(desc.id()+1,mInvalid);
+    moduleIndex_[desc.id()] = encModule_.encode(&desc);
   }
 
   void FastMonitoringService::postBeginJob()
@@ -377,17 +384,33 @@ namespace evf{
     //update number of entries in module histogram
     std::lock_guard<std::mutex> lock(fmt_.monlock_);
     fmt_.m_data.microstateBins_ = encModule_.vecsize();
+
+    //all the modules are known: the layout of the shared segment is fixed from now on
+    if (!shmDirectory_.empty()) {
+      std::ostringstream shmFileName;
+      shmFileName << fastName_ << "_pid" << std::setfill('0') << std::setw(5) << getpid() << ".shm";
+      boost::filesystem::path shmPath(shmDirectory_);
+      shmPath /= shmFileName.str();
+      shm_.create(shmPath.string(), nStreams_, encModule_.vecsize());
+      shm_.setMacrostate(macrostate_);
+      shm_.setInputState(inputState_);
+      for (unsigned int i=0;i<nStreams_;i++)
+        shm_.setMicrostate(i,mInvalid);
+      LogDebug("FastMonitoringService") << "Exporting the monitoring states in -: " << shmPath.string();
+    }
   }
 
   void FastMonitoringService::postEndJob()
   {
     macrostate_ = FastMonitoringThread::sJobEnded;
+    if (shm_.isOpen()) shm_.setMacrostate(macrostate_);
     fmt_.stop();
   }
 
   void FastMonitoringService::postGlobalBeginRun(edm::GlobalContext const& gc)
   {
     macrostate_ = FastMonitoringThread::sRunning;
+    if (shm_.isOpen()) shm_.setMacrostate(macrostate_);
     isInitTransition_=false;
   }
 
@@ -397,6 +420,7 @@ namespace evf{
 	  gettimeofday(&lumiStartTime, nullptr);
 	  unsigned int newLumi = gc.luminosityBlockID().luminosityBlock();
 	  lastGlobalLumi_ = newLumi;
+	  if (shm_.isOpen()) shm_.setLumi(newLumi);
 
           std::lock_guard<std::mutex> lock(fmt_.monlock_);
 	  lumiStartTime_[newLumi]=lumiStartTime;
@@ -517,11 +541,13 @@ namespace evf{
 
     ministate_[sid]=&nopath_;
     microstate_[sid]=&reservedMicroStateNames[mBoL];
+    if (shm_.isOpen()) shm_.beginLumi(sid,sc.eventID().luminosityBlock(),mBoL,0);
   }
 
   void FastMonitoringService::postStreamBeginLumi(edm::StreamContext const& sc)
   {
     microstate_[sc.streamID().value()]=&reservedMicroStateNames[mIdle];
+    if (shm_.isOpen()) shm_.setMicrostate(sc.streamID().value(),mIdle);
   }
 
   void FastMonitoringService::preStreamEndLumi(edm::StreamContext const& sc)
@@ -534,10 +560,12 @@ namespace evf{
     //reset this in case stream does not get notified of next lumi (we keep processed events only)
     ministate_[sid]=&nopath_;
     microstate_[sid]=&reservedMicroStateNames[mEoL];
+    if (shm_.isOpen()) shm_.setStates(sid,mEoL,0);
   }
   void FastMonitoringService::postStreamEndLumi(edm::StreamContext const& sc)
   {
     microstate_[sc.streamID().value()]=&reservedMicroStateNames[mFwkEoL];
+    if (shm_.isOpen()) shm_.setMicrostate(sc.streamID().value(),mFwkEoL);
   }
 
 
@@ -570,6 +598,8 @@ namespace evf{
     }
     else {
       ministate_[sc.streamID()] = &(pc.pathName());
+      //the path list of the stream is complete, the lookup is read-only
+      if (shm_.isOpen()) shm_.setMinistate(sc.streamID(),encPath_[sc.streamID()].encode(&(pc.pathName())));
     }
   }
 
@@ -585,6 +615,7 @@ namespace evf{
     ministate_[sc.streamID()] = &nopath_;
 
     (*(fmt_.m_data.processed_[sc.streamID()]))++;
+    if (shm_.isOpen()) shm_.eventProcessed(sc.streamID(),mIdle,0);
     eventCountForPathInit_[sc.streamID()].m_value++;
 
     //fast path counter (events accumulated in a run)
@@ -596,22 +627,30 @@ namespace evf{
   void FastMonitoringService::preSourceEvent(edm::StreamID sid)
   {
     microstate_[sid.value()] = &reservedMicroStateNames[mInput];
+    if (shm_.isOpen()) shm_.setMicrostate(sid.value(),mInput);
   }
 
   void FastMonitoringService::postSourceEvent(edm::StreamID sid)
   {
     microstate_[sid.value()] = &reservedMicroStateNames[mFwkOvhSrc];
+    if (shm_.isOpen()) shm_.setMicrostate(sid.value(),mFwkOvhSrc);
   }
 
   void FastMonitoringService::preModuleEvent(edm::StreamContext const& sc, edm::ModuleCallingContext const& mcc)
   {
     microstate_[sc.streamID().value()] = (void*)(mcc.moduleDescription());
+    if (shm_.isOpen()) {
+      //modules without a beginJob transition seen by the service are exported as invalid
+      unsigned int id = mcc.moduleDescription()->id();
+      shm_.setMicrostate(sc.streamID().value(), id<moduleIndex_.size() ? moduleIndex_[id] : mInvalid);
+    }
   }
 
   void FastMonitoringService::postModuleEvent(edm::StreamContext const& sc, edm::ModuleCallingContext const& mcc)
   {
     //microstate_[sc.streamID().value()] = (void*)(mcc.moduleDescription());
     microstate_[sc.streamID().value()] = &reservedMicroStateNames[mFwkOvhMod];
+    if (shm_.isOpen()) shm_.setMicrostate(sc.streamID().value(),mFwkOvhMod);
   }
 
   //FUNCTIONS CALLED FROM OUTSIDE
@@ -620,14 +659,17 @@ namespace evf{
   //(we assume the worst case - everything is blocked)
   void FastMonitoringService::setMicroState(MicroStateService::Microstate m)
   {
-    for (unsigned int i=0;i<nStreams_;i++)
+    for (unsigned int i=0;i<nStreams_;i++) {
       microstate_[i] = &reservedMicroStateNames[m];
+      if (shm_.isOpen()) shm_.setMicrostate(i,m);
+    }
   }
 
   //this is for services that are multithreading-enabled or rarely blocks other streams
   void FastMonitoringService::setMicroState(edm::StreamID sid, MicroStateService::Microstate m)
   {
     microstate_[sid] = &reservedMicroStateNames[m];
+    if (shm_.isOpen()) shm_.setMicrostate(sid,m);
   }
 
   //from source
@@ -0,0 +1,164 @@
+#include "EventFilter/Utilities/interface/FastMonitoringShm.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace evf{
+
+  namespace {
+    size_t aligned(size_t size) {
+      return (size + shm::ALIGNMENT - 1) / shm::ALIGNMENT * shm::ALIGNMENT;
+    }
+  }
+
+  FastMonitoringShm::FastMonitoringShm(): base_(nullptr), size_(0), header_(nullptr), owner_(false)
+  {
+  }
+
+  FastMonitoringShm::~FastMonitoringShm()
+  {
+    close();
+  }
+
+  uint64_t FastMonitoringShm::now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  void FastMonitoringShm::create(std::string const& path, unsigned int nStreams, unsigned int nStates)
+  {
+    close();
+
+    size_t streamOffset = aligned(sizeof(shm::Header));
+    //stream blocks on separate cache lines, as they are written by different threads
+    size_t streamStride = aligned(sizeof(shm::Stream) + nStates*sizeof(uint64_t));
+    size_t size = streamOffset + nStreams*streamStride;
+
+    //a new file: a reader still mapping the one of a previous process keeps its own copy
+    ::unlink(path.c_str());
+    int fd = ::open(path.c_str(), O_RDWR|O_CREAT|O_EXCL, S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+    if (fd<0)
+      throw cms::Exception("FastMonitoringShm") << "Unable to create the monitoring segment " << path << " -: " << strerror(errno);
+    if (::ftruncate(fd, size)!=0) {
+      int err = errno;
+      ::close(fd);
+      ::unlink(path.c_str());
+      throw cms::Exception("FastMonitoringShm") << "Unable to size the monitoring segment " << path << " -: " << strerror(err);
+    }
+    void *addr = ::mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr==MAP_FAILED) {
+      int err = errno;
+      ::unlink(path.c_str());
+      throw cms::Exception("FastMonitoringShm") << "Unable to map the monitoring segment " << path << " -: " << strerror(err);
+    }
+
+    base_ = static_cast<char*>(addr);
+    size_ = size;
+    path_ = path;
+    owner_ = true;
+
+    //the file is zero filled, the atomics are constructed in place
+    header_ = new (base_) shm::Header;
+    header_->version = shm::VERSION;
+    header_->pid = ::getpid();
+    header_->nStreams = nStreams;
+    header_->nStates = nStates;
+    header_->streamOffset = streamOffset;
+    header_->streamStride = streamStride;
+    header_->startTime = now();
+    header_->macrostate.store(0,std::memory_order_relaxed);
+    header_->inputState.store(0,std::memory_order_relaxed);
+    header_->lumi.store(0,std::memory_order_relaxed);
+    header_->reserved = 0;
+    header_->eventsProcessed.store(0,std::memory_order_relaxed);
+    for (unsigned int i=0;i<nStreams;i++) {
+      shm::Stream *s = new (base_+streamOffset+i*streamStride) shm::Stream;
+      s->seq.store(0,std::memory_order_relaxed);
+      s->microstate.store(0,std::memory_order_relaxed);
+      s->ministate.store(0,std::memory_order_relaxed);
+      s->lumi.store(0,std::memory_order_relaxed);
+      s->processed.store(0,std::memory_order_relaxed);
+      s->since.store(header_->startTime,std::memory_order_relaxed);
+      std::atomic<uint64_t> *occ = occupancy(s);
+      for (unsigned int j=0;j<nStates;j++)
+        new (occ+j) std::atomic<uint64_t>(0);
+    }
+    //the magic is written last, a reader ignores a segment without it
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header_->magic, shm::MAGIC, sizeof(shm::MAGIC));
+  }
+
+  bool FastMonitoringShm::attach(std::string const& path)
+  {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd<0) return false;
+    struct stat st;
+    if (::fstat(fd, &st)!=0 || static_cast<size_t>(st.st_size)<sizeof(shm::Header)) {
+      ::close(fd);
+      return false;
+    }
+    size_t size = st.st_size;
+    void *addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr==MAP_FAILED) return false;
+
+    base_ = static_cast<char*>(addr);
+    size_ = size;
+    header_ = reinterpret_cast<shm::Header*>(base_);
+    owner_ = false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (std::memcmp(header_->magic, shm::MAGIC, sizeof(shm::MAGIC))!=0 || header_->version!=shm::VERSION ||
+        header_->streamOffset+header_->nStreams*header_->streamStride>size ||
+        header_->streamStride<sizeof(shm::Stream)+header_->nStates*sizeof(uint64_t)) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void FastMonitoringShm::close()
+  {
+    if (!base_) return;
+    ::munmap(base_, size_);
+    //the segment is only meaningful while the process runs
+    if (owner_) ::unlink(path_.c_str());
+    base_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+    owner_ = false;
+  }
+
+  bool FastMonitoringShm::snapshot(unsigned int sid, shm::StreamSnapshot& snap, unsigned int maxRetries) const
+  {
+    if (!base_ || sid>=header_->nStreams) return false;
+    shm::Stream *s = stream(sid);
+    std::atomic<uint64_t> *occ = occupancy(s);
+    snap.occupancy.resize(header_->nStates);
+
+    for (unsigned int i=0;i<maxRetries;i++) {
+      uint32_t seq = s->seq.load(std::memory_order_acquire);
+      if (seq&1) continue;
+      snap.microstate = s->microstate.load(std::memory_order_relaxed);
+      snap.ministate = s->ministate.load(std::memory_order_relaxed);
+      snap.lumi = s->lumi.load(std::memory_order_relaxed);
+      snap.processed = s->processed.load(std::memory_order_relaxed);
+      snap.since = s->since.load(std::memory_order_relaxed);
+      for (unsigned int j=0;j<header_->nStates;j++)
+        snap.occupancy[j] = occ[j].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s->seq.load(std::memory_order_relaxed)==seq) return true;
+    }
+    return false;
+  }
+
+} //end namespace evf
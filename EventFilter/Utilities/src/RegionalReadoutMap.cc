@@ -0,0 +1,78 @@
+#include "EventFilter/Utilities/interface/RegionalReadoutMap.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace evf {
+
+  RegionalReadoutMap::RegionalReadoutMap(double etaMax, unsigned int nEta, unsigned int nPhi) :
+    etaMax_(etaMax), nEta_(std::max(1U, nEta)), nPhi_(std::max(1U, nPhi)),
+    etaBinSize_(2*etaMax/nEta_), phiBinSize_(2*M_PI/nPhi_),
+    cells_(nEta_*nPhi_), nChannels_(0)
+  {}
+
+  void RegionalReadoutMap::clear() {
+    for (auto& cell : cells_) cell.clear();
+    nChannels_ = 0;
+  }
+
+  // the first and last bins extend to infinity
+  int RegionalReadoutMap::etaBin(double eta) const {
+    const double x = (eta + etaMax_)/etaBinSize_;
+    return x <= 0 ? 0 : (x >= nEta_ - 1 ? nEta_ - 1 : int(x));
+  }
+
+  void RegionalReadoutMap::add(unsigned int unit, double eta, double phi) {
+    if (!std::isfinite(eta) || !std::isfinite(phi)) return;
+    const double dphi = phi + M_PI - 2*M_PI*std::floor((phi + M_PI)/(2*M_PI));
+    const int iphi = std::min(nPhi_ - 1, int(dphi/phiBinSize_));
+    auto& cell = cells_[etaBin(eta)*nPhi_ + iphi];
+    auto it = std::lower_bound(cell.begin(), cell.end(), unit);
+    if (it == cell.end() || *it != unit) cell.insert(it, unit);
+    ++nChannels_;
+  }
+
+  void RegionalReadoutMap::addCell(unsigned int cell, std::vector<unsigned int>& units) const {
+    for (unsigned int unit : cells_[cell]) units.push_back(unit);
+  }
+
+  void RegionalReadoutMap::unitsInRegion(double eta, double phi, double dEta, double dPhi,
+                                         std::vector<unsigned int>& units) const {
+    if (!std::isfinite(eta) || !std::isfinite(phi) || !(dEta >= 0) || !(dPhi >= 0)) {
+      allUnits(units);
+      return;
+    }
+    // margin for the rounding at the bin edges and at the phi wrap
+    constexpr double margin = 1e-9;
+    const int etaLo = etaBin(eta - dEta - margin), etaHi = etaBin(eta + dEta + margin);
+    // phi is brought into [-pi, pi) as in add(), and the bins are only
+    // computed for a window narrower than the full circle
+    bool fullPhi = dPhi >= M_PI;
+    int phiLo = 0, phiHi = nPhi_ - 1;
+    if (!fullPhi) {
+      const double phi0 = phi - 2*M_PI*std::floor((phi + M_PI)/(2*M_PI));
+      phiLo = int(std::floor((phi0 - dPhi - margin + M_PI)/phiBinSize_));
+      phiHi = int(std::floor((phi0 + dPhi + margin + M_PI)/phiBinSize_));
+      fullPhi = phiHi - phiLo + 1 >= nPhi_;
+    }
+    for (int ieta = etaLo; ieta <= etaHi; ++ieta) {
+      if (fullPhi) {
+        for (int iphi = 0; iphi < nPhi_; ++iphi) addCell(ieta*nPhi_ + iphi, units);
+      } else {
+        for (int iphi = phiLo; iphi <= phiHi; ++iphi) {
+          const int wrapped = (iphi%nPhi_ + nPhi_)%nPhi_;
+          addCell(ieta*nPhi_ + wrapped, units);
+        }
+      }
+    }
+    std::sort(units.begin(), units.end());
+    units.erase(std::unique(units.begin(), units.end()), units.end());
+  }
+
+  void RegionalReadoutMap::allUnits(std::vector<unsigned int>& units) const {
+    for (const auto& cell : cells_) units.insert(units.end(), cell.begin(), cell.end());
+    std::sort(units.begin(), units.end());
+    units.erase(std::unique(units.begin(), units.end()), units.end());
+  }
+
+}
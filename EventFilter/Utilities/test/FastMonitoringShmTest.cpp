@@ -0,0 +1,163 @@
+#include "EventFilter/Utilities/interface/FastMonitoringShm.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+/*
+  Test of the shared memory export of the FastMonitoringService: creation and read-only attachment of the
+  segment, consistency of the snapshots taken while several threads write the same stream blocks, and retry
+  of the reader while a block is being written.
+*/
+
+using namespace evf;
+
+namespace {
+
+  int errors = 0;
+
+  void check(bool ok, const char *what) {
+    if (!ok) {
+      std::cout << "Error: " << what << std::endl;
+      ++errors;
+    }
+  }
+
+  //a snapshot is consistent if it was not torn by a writer: the writers of the test always set equal micro
+  //and ministates, and the time spent in the microstates adds up to the time of the last change
+  bool consistent(shm::StreamSnapshot const& snap, uint64_t startTime) {
+    uint64_t occupancy = std::accumulate(snap.occupancy.begin(), snap.occupancy.end(), uint64_t(0));
+    return snap.microstate==snap.ministate && occupancy==snap.since-startTime;
+  }
+
+  shm::Stream* streamBlock(FastMonitoringShm const& owner, unsigned int sid) {
+    shm::Header const* h = owner.header();
+    char const* base = reinterpret_cast<char const*>(h);
+    return const_cast<shm::Stream*>(reinterpret_cast<shm::Stream const*>(base+h->streamOffset+sid*h->streamStride));
+  }
+
+  void createAndAttach(std::string const& path) {
+    FastMonitoringShm owner;
+    owner.create(path,3,5);
+    owner.setMacrostate(4);
+    owner.setLumi(12);
+    owner.beginLumi(1,12,2,2);
+
+    FastMonitoringShm reader;
+    check(reader.attach(path),"the segment is attached");
+    check(reader.header()->nStreams==3 && reader.header()->nStates==5,"the reader sees the layout");
+    check(reader.header()->pid==(uint32_t)::getpid(),"the reader sees the pid");
+    check(reader.header()->macrostate==4 && reader.header()->lumi==12,"the reader sees the global states");
+    shm::StreamSnapshot snap;
+    check(reader.snapshot(1,snap) && snap.lumi==12 && snap.microstate==2 && snap.occupancy.size()==5,
+          "the reader sees the stream states");
+    check(!reader.snapshot(3,snap),"there is no snapshot of a stream past the last one");
+
+    FastMonitoringShm missing;
+    check(!missing.attach(path+".missing"),"a missing segment is not attached");
+    std::string other = path+".other";
+    std::ofstream(other) << "not a monitoring segment, but long enough to hold a header............";
+    check(!missing.attach(other),"a file without the magic is not attached");
+    std::remove(other.c_str());
+
+    owner.close();
+    check(::access(path.c_str(),F_OK)!=0,"the segment is removed by its owner");
+  }
+
+  //two threads per stream write every block while a reader thread takes snapshots of all of them
+  void concurrentWriters(std::string const& path) {
+    const unsigned int nStreams = 4;
+    const unsigned int nStates = 6;
+    const unsigned int nEvents = 20000;
+
+    FastMonitoringShm owner;
+    owner.create(path,nStreams,nStates);
+    FastMonitoringShm reader;
+    check(reader.attach(path),"the segment is attached");
+    uint64_t startTime = reader.header()->startTime;
+
+    std::atomic<bool> done(false);
+    std::atomic<unsigned int> snapshots(0);
+    std::atomic<unsigned int> torn(0);
+    std::thread sampler([&]() {
+      shm::StreamSnapshot snap;
+      while (!done) {
+        for (unsigned int i=0;i<nStreams;i++) {
+          if (!reader.snapshot(i,snap)) continue;
+          ++snapshots;
+          if (!consistent(snap,startTime)) ++torn;
+        }
+      }
+    });
+
+    std::vector<std::thread> writers;
+    for (unsigned int w=0;w<2*nStreams;w++) {
+      writers.emplace_back([&owner,w]() {
+        unsigned int sid = w%nStreams;
+        for (unsigned int i=0;i<nEvents;i++) {
+          uint32_t state = (w+i)%nStates;
+          owner.setStates(sid,state,state);
+          owner.eventProcessed(sid,(state+1)%nStates,(state+1)%nStates);
+        }
+      });
+    }
+    for (auto& writer : writers) writer.join();
+    done = true;
+    sampler.join();
+
+    check(snapshots>0,"the reader takes snapshots while the writers run");
+    check(torn==0,"the snapshots are consistent");
+    check(reader.header()->eventsProcessed==2*nStreams*nEvents,"no event is lost in the global counter");
+    shm::StreamSnapshot snap;
+    for (unsigned int i=0;i<nStreams;i++) {
+      check(reader.snapshot(i,snap) && consistent(snap,startTime),"the final snapshot is consistent");
+      check(snap.processed==2*nEvents,"the writers of a stream do not lose updates");
+    }
+  }
+
+  //a block in the middle of an update is not copied: the reader retries, and gives up after maxRetries
+  void readerRetry(std::string const& path) {
+    FastMonitoringShm owner;
+    owner.create(path,2,3);
+    FastMonitoringShm reader;
+    check(reader.attach(path),"the segment is attached");
+
+    shm::Stream *block = streamBlock(owner,1);
+    shm::StreamSnapshot snap;
+    block->seq.store(block->seq.load()+1);
+    check(!reader.snapshot(1,snap,100),"a block being written is not copied");
+    check(reader.snapshot(0,snap,100),"the other blocks are copied");
+
+    //the writer ends its update while the reader retries
+    std::thread writer([block]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      block->seq.store(block->seq.load()+1);
+    });
+    bool copied = false;
+    auto giveUp = std::chrono::steady_clock::now()+std::chrono::seconds(10);
+    while (!copied && std::chrono::steady_clock::now()<giveUp) copied = reader.snapshot(1,snap,1000);
+    writer.join();
+    check(copied,"the block is copied once the update ends");
+  }
+}
+
+int main()
+{
+  std::string path = "/tmp/FastMonitoringShmTest_"+std::to_string(::getpid());
+
+  createAndAttach(path);
+  concurrentWriters(path);
+  readerRetry(path);
+
+  if (errors) return 1;
+  std::cout << "FastMonitoringShm validated" << std::endl;
+  return 0;
+}
@@ -0,0 +1,200 @@
+#include "EventFilter/Utilities/interface/RegionalReadoutMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+  Test of the eta-phi map of the readout units used by the regional unpackers: the units selected for a region,
+  compared with a brute-force scan of the channels, must contain all the units with a channel in the window, and
+  only units with a channel close to it. The regions and the channels cover the phi wrap, the eta edges of the
+  grid and beyond, and the non-finite regions and non-finite or negative windows.
+*/
+
+using namespace evf;
+
+namespace {
+
+  int errors = 0;
+
+  void check(bool ok, const char *what) {
+    if (!ok) {
+      std::cout << "Error: " << what << std::endl;
+      ++errors;
+    }
+  }
+
+  const double infinity = std::numeric_limits<double>::infinity();
+  const double notANumber = std::numeric_limits<double>::quiet_NaN();
+
+  //same binning as the default map
+  const double etaMax = 5.2;
+  const double etaBinSize = 0.1;
+  const double phiBinSize = 2*M_PI/72;
+
+  struct Channel {
+    unsigned int unit;
+    double eta, phi;
+  };
+
+  double deltaPhi(double phi1, double phi2) {
+    return std::remainder(phi1 - phi2, 2*M_PI);
+  }
+
+  bool sortedUnique(std::vector<unsigned int> const& units) {
+    for (size_t i=1;i<units.size();i++)
+      if (!(units[i-1]<units[i])) return false;
+    return true;
+  }
+
+  //units with a channel in the window
+  std::vector<unsigned int> bruteForce(std::vector<Channel> const& channels,
+                                       double eta, double phi, double dEta, double dPhi) {
+    std::vector<unsigned int> units;
+    for (auto const& ch : channels) {
+      if (!std::isfinite(ch.eta) || !std::isfinite(ch.phi)) continue;
+      if (std::abs(ch.eta-eta)<=dEta && std::abs(deltaPhi(ch.phi,phi))<=dPhi) units.push_back(ch.unit);
+    }
+    std::sort(units.begin(),units.end());
+    units.erase(std::unique(units.begin(),units.end()),units.end());
+    return units;
+  }
+
+  //a channel is close to the window if it is at most one bin away from it; the first and last eta bins extend
+  //to infinity
+  bool close(Channel const& ch, double eta, double phi, double dEta, double dPhi) {
+    double lo = eta-dEta-etaBinSize, hi = eta+dEta+etaBinSize;
+    if (lo<-etaMax+etaBinSize) lo = -infinity;
+    if (hi>etaMax-etaBinSize) hi = infinity;
+    lo = std::min(lo,etaMax-etaBinSize);
+    hi = std::max(hi,-etaMax+etaBinSize);
+    return ch.eta>=lo && ch.eta<=hi && std::abs(deltaPhi(ch.phi,phi))<=dPhi+phiBinSize;
+  }
+
+  //compares the map with the brute-force scan for regions at the channels, around them and on the edges
+  void compare(std::string const& name, std::vector<Channel> const& channels, std::mt19937& rng) {
+    RegionalReadoutMap map;
+    for (auto const& ch : channels) map.add(ch.unit,ch.eta,ch.phi);
+    std::vector<unsigned int> all;
+    map.allUnits(all);
+    check(sortedUnique(all),"all the units are sorted without duplicates");
+
+    std::uniform_real_distribution<double> uniform(-1.,1.);
+    std::vector<std::pair<double,double> > regions;
+    for (auto const& ch : channels) {
+      regions.emplace_back(ch.eta,ch.phi);
+      regions.emplace_back(ch.eta+0.2*uniform(rng),ch.phi+0.2*uniform(rng));
+    }
+    for (double eta : {-6.,-etaMax,-etaMax+0.05,0.,etaMax-0.05,etaMax,6.})
+      for (double phi : {-M_PI,-M_PI+1e-3,0.,M_PI-1e-3,M_PI,M_PI+0.1,-4*M_PI+0.5})
+        regions.emplace_back(eta,phi);
+
+    const double dEtas[] = {0.,0.05,0.3,1.,20.,infinity};
+    const double dPhis[] = {0.,0.05,0.3,1.,M_PI,4.,100.,infinity};
+    unsigned int missing = 0, far = 0, unordered = 0;
+    for (auto const& region : regions) {
+      for (double dEta : dEtas) {
+        for (double dPhi : dPhis) {
+          std::vector<unsigned int> units;
+          map.unitsInRegion(region.first,region.second,dEta,dPhi,units);
+          if (!sortedUnique(units)) ++unordered;
+          std::vector<unsigned int> expected = bruteForce(channels,region.first,region.second,dEta,dPhi);
+          for (unsigned int unit : expected) {
+            if (std::binary_search(units.begin(),units.end(),unit)) continue;
+            if (missing++<5)
+              std::cout << "Error: " << name << ": unit " << unit << " missing for the region (" << region.first
+                        << "," << region.second << ") within " << dEta << "," << dPhi << std::endl;
+          }
+          for (unsigned int unit : units) {
+            bool near = std::any_of(channels.begin(),channels.end(),[&](Channel const& ch) {
+              return ch.unit==unit && close(ch,region.first,region.second,dEta,dPhi);
+            });
+            if (!near && far++<5)
+              std::cout << "Error: " << name << ": unit " << unit << " far from the region (" << region.first
+                        << "," << region.second << ") within " << dEta << "," << dPhi << std::endl;
+          }
+        }
+      }
+    }
+    if (missing || far || unordered) {
+      std::cout << "Error: " << name << ": " << missing << " units missing, " << far << " far from the region, "
+                << unordered << " selections not sorted" << std::endl;
+      ++errors;
+    }
+
+    //the units already listed are kept, without duplicates
+    if (!all.empty()) {
+      std::vector<unsigned int> units = {all.front(),all.back()+1};
+      map.unitsInRegion(channels.front().eta,channels.front().phi,0.1,0.1,units);
+      check(sortedUnique(units) && std::binary_search(units.begin(),units.end(),all.back()+1) &&
+            std::binary_search(units.begin(),units.end(),all.front()),
+            "the units given are kept, sorted without duplicates");
+    }
+
+    //all the units for a non-finite region or a NaN or negative window
+    const double invalid[][4] = {{notANumber,0.,0.1,0.1},{0.,notANumber,0.1,0.1},{infinity,0.,0.1,0.1},
+                                 {0.,-infinity,0.1,0.1},{0.,0.,notANumber,0.1},{0.,0.,0.1,notANumber},
+                                 {0.,0.,-0.1,0.1},{0.,0.,0.1,-0.1},{0.,0.,-infinity,-infinity}};
+    for (auto const& r : invalid) {
+      std::vector<unsigned int> units;
+      map.unitsInRegion(r[0],r[1],r[2],r[3],units);
+      check(units==all,"all the units are taken for an invalid region");
+    }
+  }
+
+  std::vector<Channel> randomChannels(std::mt19937& rng, unsigned int nUnits, unsigned int nChannels,
+                                      double etaLo, double etaHi) {
+    std::uniform_real_distribution<double> eta(etaLo,etaHi);
+    std::uniform_real_distribution<double> phi(-M_PI,M_PI);
+    std::vector<Channel> channels;
+    for (unsigned int i=0;i<nChannels;i++) {
+      //the channels of a unit are in the same area, as the ones of a crate
+      unsigned int unit = rng()%nUnits;
+      double unitEta = etaLo+(etaHi-etaLo)*(unit+0.5)/nUnits;
+      double unitPhi = -M_PI+2*M_PI*(unit%7)/7;
+      channels.push_back({unit,i%2 ? eta(rng) : unitEta+0.3*std::sin(i),i%2 ? phi(rng) : unitPhi+0.4*std::cos(i)});
+    }
+    return channels;
+  }
+}
+
+int main()
+{
+  std::mt19937 rng(2018);
+
+  compare("barrel and endcaps",randomChannels(rng,30,300,-3.,3.),rng);
+  compare("beyond the eta range",randomChannels(rng,20,200,-7.,7.),rng);
+
+  //channels on the phi wrap and on the eta edges, and phi outside [-pi,pi)
+  std::vector<Channel> edges;
+  unsigned int unit = 0;
+  for (double eta : {-etaMax,-etaMax+1e-9,-1.,0.,1.,etaMax-1e-9,etaMax,8.})
+    for (double phi : {-M_PI,std::nextafter(-M_PI,0.),0.,std::nextafter(M_PI,0.),M_PI,3*M_PI-0.1,-5*M_PI+0.2})
+      edges.push_back({unit++%11,eta,phi});
+  compare("edges",edges,rng);
+
+  //channels without a finite position are not mapped
+  RegionalReadoutMap map;
+  map.add(1,notANumber,0.);
+  map.add(2,0.,infinity);
+  check(map.empty(),"the channels without a finite position are not mapped");
+  std::vector<unsigned int> units;
+  map.unitsInRegion(0.,0.,infinity,infinity,units);
+  check(units.empty(),"an empty map selects no unit");
+
+  map.add(3,0.,0.);
+  check(!map.empty(),"a channel is mapped");
+  map.clear();
+  units.clear();
+  map.allUnits(units);
+  check(map.empty() && units.empty(),"a cleared map is empty");
+
+  if (errors) return 1;
+  std::cout << "RegionalReadoutMap validated" << std::endl;
+  return 0;
+}
@@ -79,10 +79,17 @@ namespace edm {
   DataManagingProductResolver::mergeProduct(std::unique_ptr<WrapperBase> iFrom) const {
     assert(status() == ProductStatus::ProductSet);
     if(not iFrom) { return;}
+    //a product stored as not present, e.g. by a partitioned output, has nothing to merge
+    if(not iFrom->isPresent()) { return;}
     
     checkType(*iFrom);
     
     auto original =getProductData().unsafe_wrapper();
+    //and is replaced by the first present one, whatever the order of the files
+    if(not original->isPresent()) {
+      productData_.unsafe_setWrapper(std::move(iFrom));
+      return;
+    }
     if(original->isMergeable()) {
       original->mergeProduct(iFrom.get());
     } else if(original->hasIsProductEqual()) {
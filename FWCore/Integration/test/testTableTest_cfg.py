@@ -29,7 +29,12 @@ process.out = cms.OutputModule("edmtest::TableTestOutputModule",
                                outputCommands = cms.untracked.vstring("drop *",
                                                                       "keep *_tableTest_*_*"
                                                                     ))
-process.o = cms.EndPath(process.out)
+process.poolOut = cms.OutputModule("PoolOutputModule",
+                                   fileName = cms.untracked.string("testTables.root"),
+                                   outputCommands = cms.untracked.vstring("drop *",
+                                                                          "keep *_tableTest_*_*"
+                                                                        ))
+process.o = cms.EndPath(process.out+process.poolOut)
 
 #process.p = cms.Path(process.tableTest+process.eventContent+process.checkTable)
 
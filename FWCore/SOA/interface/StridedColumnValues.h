@@ -0,0 +1,122 @@
+#ifndef FWCore_SOA_StridedColumnValues_h
+#define FWCore_SOA_StridedColumnValues_h
+// -*- C++ -*-
+//
+// Package:     FWCore/SOA
+// Class  :     StridedColumnValues
+//
+/**\class StridedColumnValues StridedColumnValues.h "StridedColumnValues.h"
+
+ Description: Column like access, without a copy, to one member of the objects of a contiguous container
+
+ Usage:
+    A StridedColumnValues points to a member of the first object of a 'array of structures'
+ container (e.g. a std::vector) and steps from object to object by sizeof the object.
+ It is created with strided_column() from either a pointer to a public data member or
+ a function returning a const reference to data held inside the object.
+ \code
+   reco::TrackCollection const& tracks = ...;
+   auto momenta = edm::soa::strided_column(tracks, [](reco::Track const& t) -> auto const& { return t.momentum(); });
+   for(auto const& p: momenta) {...}
+
+   reco::PFCandidateCollection const& cands = ...;
+   auto p4s = edm::soa::strided_column(cands, [](reco::PFCandidate const& c) -> auto const& { return c.polarP4(); });
+ \endcode
+ Values computed on the fly (e.g. reco::Track::pt()) can not be viewed this way and have to be
+ copied into a Table column, see ColumnFillers.h.
+ The view is only valid as long as the container is not modified.
+*/
+
+// system include files
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// user include files
+
+// forward declarations
+
+namespace edm {
+namespace soa {
+
+template<typename T>
+class StridedColumnValues {
+public:
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T const*;
+    using reference = T const&;
+
+    const_iterator(char const* iPtr, size_t iStride): m_ptr(iPtr), m_stride(iStride) {}
+
+    T const& operator*() const { return *reinterpret_cast<T const*>(m_ptr); }
+    T const* operator->() const { return reinterpret_cast<T const*>(m_ptr); }
+
+    const_iterator& operator++() { m_ptr += m_stride; return *this; }
+    const_iterator operator++(int) { auto old = *this; m_ptr += m_stride; return old; }
+
+    bool operator==(const_iterator const& iOther) const { return m_ptr == iOther.m_ptr; }
+    bool operator!=(const_iterator const& iOther) const { return m_ptr != iOther.m_ptr; }
+
+  private:
+    char const* m_ptr;
+    size_t m_stride;
+  };
+
+  StridedColumnValues(T const* iBegin, size_t iSize, size_t iStride):
+  m_begin(reinterpret_cast<char const*>(iBegin)), m_size(iSize), m_stride(iStride) {}
+
+  const_iterator begin() const { return const_iterator(m_begin, m_stride); }
+  const_iterator end() const { return const_iterator(m_begin+m_size*m_stride, m_stride); }
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  ///distance in bytes between consecutive values
+  size_t stride() const { return m_stride; }
+
+  T const& operator[](size_t iIndex) const { return *reinterpret_cast<T const*>(m_begin+iIndex*m_stride); }
+
+private:
+  char const* m_begin = nullptr;
+  size_t m_size = 0;
+  size_t m_stride = 0;
+};
+
+/**View on the values returned by iAccessor for all the elements of iContainer.
+ iContainer must store its elements contiguously and provide data() and size()
+ (std::vector, std::array, ...)
+ and iAccessor must return a reference to data inside the element it is given.
+ */
+template<typename C, typename F>
+auto strided_column(C const& iContainer, F&& iAccessor) ->
+  StridedColumnValues<std::remove_cv_t<std::remove_reference_t<decltype(iAccessor(*iContainer.data()))>>> {
+  using Element = std::remove_cv_t<std::remove_reference_t<decltype(*iContainer.data())>>;
+  using Result = decltype(iAccessor(*iContainer.data()));
+  static_assert(std::is_lvalue_reference<Result>::value, "strided_column needs an accessor returning a reference");
+  using T = std::remove_cv_t<std::remove_reference_t<Result>>;
+
+  if(iContainer.size() == 0) {
+    return StridedColumnValues<T>(nullptr, 0, sizeof(Element));
+  }
+  auto const& first = *iContainer.data();
+  T const* value = &iAccessor(first);
+  //the value must be held by the element, else the same offset does not hold for the next elements
+  assert(reinterpret_cast<char const*>(value) >= reinterpret_cast<char const*>(&first) and
+         reinterpret_cast<char const*>(value+1) <= reinterpret_cast<char const*>(&first+1));
+  return StridedColumnValues<T>(value, iContainer.size(), sizeof(Element));
+}
+
+///View on the data member iMember of all the elements of iContainer
+template<typename C, typename E, typename T>
+StridedColumnValues<T> strided_column(C const& iContainer, T E::* iMember) {
+  return strided_column(iContainer, [iMember](E const& iElement) -> T const& { return iElement.*iMember; });
+}
+
+}
+}
+
+#endif
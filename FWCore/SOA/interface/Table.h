@@ -107,6 +107,16 @@
  \code
    using MyBTable = RemoveColumn_t<BTable, Phi>; //Phi is a previously defined Column
  \endcode
+
+ All the columns of a Table are held in one memory block. Each column starts on a
+ kAlignment byte boundary so loops over a column can use aligned vector loads.
+ The block holds capacity() rows; resize() within the capacity does not reallocate,
+ so a Table filled repeatedly (e.g. once per event) can reserve() its maximum size once.
+ \code
+   SphereTable sphereTable;
+   sphereTable.reserve(1000);
+   sphereTable.resize(nHits); //no allocation if nHits <= 1000
+ \endcode
  */
 //
 // Original Author:  Chris Jones
@@ -115,8 +125,11 @@
 
 // system include files
 #include <memory>
+#include <new>
 #include <tuple>
 #include <array>
+#include <algorithm>
+#include <cassert>
 
 // user include files
 #include "FWCore/SOA/interface/TableItr.h"
@@ -137,12 +150,14 @@ namespace soa {
   class Table {
   public:
     static constexpr const unsigned int kNColumns = sizeof...(Args);
+    static constexpr const size_t kAlignment = 64;
     using Layout = std::tuple<Args...>;
     using const_iterator = ConstTableItr<Args...>;
     using iterator = TableItr<Args...>;
     
     template <typename T, typename... CArgs>
     Table(T const& iContainer, CArgs... iArgs): m_size(iContainer.size()) {
+      allocate(iContainer.size());
       using CtrChoice = std::conditional_t<sizeof...(CArgs)==0,
       CtrFillerFromAOS,
       CtrFillerFromContainers>;
@@ -152,29 +167,32 @@ namespace soa {
     template<typename T, typename... CArgs>
     Table(T const& iContainer, ColumnFillers<CArgs...> iFiller) {
       m_size = iContainer.size();
+      allocate(iContainer.size());
       CtrFillerFromAOS::fillUsingFiller(iFiller,m_values, iContainer);
     }
     
     Table( Table<Args...> const& iOther):m_size(iOther.m_size), m_values{{nullptr}} {
-      copyFromToWithResize<0>(m_size,iOther.m_values,m_values,std::true_type{});
+      allocate(m_size);
+      copyFromTo<0>(m_size,iOther.m_values,m_values,std::true_type{});
     }
     
     Table( Table<Args...>&& iOther):m_size(0), m_values{{nullptr}} {
-      std::swap(m_size,iOther.m_size);
-      std::swap(m_values,iOther.m_values);
+      swap(iOther);
     }
     
     Table() : m_size(0) {
     }
     
     ~Table() {
-      dtr<0>(m_values, std::true_type{});
+      dtr<0>(m_capacity, m_values, std::true_type{});
+      if(m_storage) {
+        ::operator delete(m_storage);
+      }
     }
     
     Table<Args...>& operator=(Table<Args...>&& iOther) {
       Table<Args...> cp(std::move(iOther));
-      std::swap(m_size,cp.m_size);
-      std::swap(m_values, cp.m_values);
+      swap(cp);
       return *this;
     }
     Table<Args...>& operator=(Table<Args...> const& iOther) {
@@ -185,9 +203,23 @@ namespace soa {
       return m_size;
     }
     
+    unsigned int capacity() const {
+      return m_capacity;
+    }
+    
+    ///Only allocates if iCapacity > capacity(), the rows are kept
+    void reserve(unsigned int iCapacity) {
+      if(iCapacity <= m_capacity) { return; }
+      Table<Args...> temp;
+      temp.allocate(iCapacity);
+      moveFromTo<0>(m_size,m_values,temp.m_values,std::true_type{});
+      temp.m_size = m_size;
+      swap(temp);
+    }
+    
     void resize(unsigned int iNewSize) {
       if(m_size == iNewSize) { return;}
-      resizeFromTo<0>(m_size,iNewSize,m_values,std::true_type{});
+      reserve(iNewSize);
       if(m_size < iNewSize) {
         //initialize the extra values
         resetStartingAt<0>(m_size, iNewSize,m_values,std::true_type{});
@@ -195,6 +227,13 @@ namespace soa {
       m_size = iNewSize;
     }
     
+    void swap(Table<Args...>& iOther) {
+      std::swap(m_size,iOther.m_size);
+      std::swap(m_capacity,iOther.m_capacity);
+      std::swap(m_values,iOther.m_values);
+      std::swap(m_storage,iOther.m_storage);
+    }
+    
     template<typename U>
     typename U::type const& get(size_t iRow) const {
       return *(static_cast<typename U::type const*>(columnAddress<U>())+iRow);
@@ -206,7 +245,7 @@ namespace soa {
     
     template<typename U>
     ColumnValues<typename U::type> column() const {
-      return ColumnValues<typename U::type>{static_cast<typename U::type*>(columnAddress<U>()), m_size};
+      return ColumnValues<typename U::type>{static_cast<typename U::type const*>(columnAddress<U>()), m_size};
     }
     template<typename U>
     MutableColumnValues<typename U::type> column() {
@@ -222,11 +261,11 @@ namespace soa {
     
     const_iterator begin() const { 
       std::array<void const*, sizeof...(Args)> t;
-      for(size_t i = 0; i<size();++i) { t[i] = m_values[i]; }
+      for(size_t i = 0; i<sizeof...(Args);++i) { t[i] = m_values[i]; }
       return const_iterator{t}; }
     const_iterator end() const { 
       std::array<void const*, sizeof...(Args)> t;
-      for(size_t i = 0; i<size();++i) { t[i] = m_values[i]; }
+      for(size_t i = 0; i<sizeof...(Args);++i) { t[i] = m_values[i]; }
       return const_iterator{t,size()}; }
 
     iterator begin() { return iterator{m_values}; }
@@ -246,7 +285,9 @@ namespace soa {
     
     // Member data
     unsigned int m_size = 0;
+    unsigned int m_capacity = 0; //!
     std::array<void *, sizeof...(Args)> m_values = {{nullptr}}; //! keep ROOT from trying to store this
+    void * m_storage = nullptr; //! the block holding all the columns, as allocated
     
     template<typename U>
     void const* columnAddress() const {
@@ -258,16 +299,75 @@ namespace soa {
       return m_values[impl::GetIndex<0,U,Layout>::index];
     }
 
+    //Allocate one block for iCapacity rows and construct the elements of all the columns.
+    // Must only be called on a Table without storage.
+    void allocate(size_t iCapacity) {
+      assert(m_storage == nullptr);
+      if(iCapacity == 0) { return; }
+      std::array<size_t, sizeof...(Args)> offsets;
+      auto nBytes = columnOffsets<0>(iCapacity, 0, offsets, std::true_type{});
+      //pad the end of the last column to a full kAlignment block
+      nBytes = (nBytes + kAlignment - 1)/kAlignment*kAlignment;
+      //over-allocate so that the first column can start on a kAlignment boundary
+      size_t space = nBytes + kAlignment - 1;
+      m_storage = ::operator new(space);
+      void* first = m_storage;
+      std::align(kAlignment, nBytes, first, space);
+      constructColumns<0>(iCapacity, static_cast<char*>(first), offsets, m_values, std::true_type{});
+      m_capacity = iCapacity;
+    }
+    
+    template <int I>
+    static size_t columnOffsets(size_t iCapacity, size_t iOffset, std::array<size_t, sizeof...(Args)>& oOffsets, std::true_type) {
+      using Type = typename std::tuple_element<I,Layout>::type::type;
+      static_assert(alignof(Type) <= kAlignment, "Column type has an alignment larger than Table::kAlignment");
+      oOffsets[I] = (iOffset + kAlignment - 1)/kAlignment*kAlignment;
+      return columnOffsets<I+1>(iCapacity, oOffsets[I]+iCapacity*sizeof(Type), oOffsets, std::conditional_t<I+1<sizeof...(Args), std::true_type, std::false_type>{});
+    }
+    
+    template <int I>
+    static size_t columnOffsets(size_t, size_t iOffset, std::array<size_t, sizeof...(Args)>&, std::false_type) {
+      return iOffset;
+    }
+    
+    template <int I>
+    static void constructColumns(size_t iCapacity, char* iStorage, std::array<size_t, sizeof...(Args)> const& iOffsets, std::array<void*, sizeof...(Args)>& oArray, std::true_type) {
+      using Type = typename std::tuple_element<I,Layout>::type::type;
+      auto ptr = reinterpret_cast<Type*>(iStorage+iOffsets[I]);
+      size_t i = 0;
+      try {
+        for(; i < iCapacity; ++i) {
+          new (ptr+i) Type();
+        }
+      } catch(...) {
+        while(i > 0) {
+          ptr[--i].~Type();
+        }
+        throw;
+      }
+      oArray[I] = ptr;
+      constructColumns<I+1>(iCapacity, iStorage, iOffsets, oArray, std::conditional_t<I+1<sizeof...(Args), std::true_type, std::false_type>{});
+    }
+    
+    template <int I>
+    static void constructColumns(size_t, char*, std::array<size_t, sizeof...(Args)> const&, std::array<void*, sizeof...(Args)>&, std::false_type) {
+    }
+    
     //Recursive destructor handling
     template <int I>
-    static void dtr(std::array<void*, sizeof...(Args)>& iArray, std::true_type) {
+    static void dtr(size_t iCapacity, std::array<void*, sizeof...(Args)>& iArray, std::true_type) {
       using Type = typename std::tuple_element<I,Layout>::type::type;
-      delete [] static_cast<Type*>(iArray[I]);
-      dtr<I+1>(iArray,std::conditional_t<I+1<sizeof...(Args), std::true_type, std::false_type>{});
+      if(iArray[I]) {
+        auto ptr = static_cast<Type*>(iArray[I]);
+        for(size_t i = 0; i < iCapacity; ++i) {
+          ptr[i].~Type();
+        }
+      }
+      dtr<I+1>(iCapacity, iArray,std::conditional_t<I+1<sizeof...(Args), std::true_type, std::false_type>{});
     }
 
     template <int I>
-    static void dtr(std::array<void*, sizeof...(Args)>& iArray, std::false_type) {
+    static void dtr(size_t, std::array<void*, sizeof...(Args)>& iArray, std::false_type) {
     }
     
     //Construct the Table using a container per column
@@ -283,13 +383,12 @@ namespace soa {
       static void ctrFiller(std::array<void *, sizeof...(Args)>& oValues, size_t iSize, T const& iContainer, U... iU) {
         assert(iContainer.size() == iSize);
         using Type = typename std::tuple_element<I,Layout>::type::type;
-        Type  * temp = new Type [iSize];
+        Type  * temp = static_cast<Type*>(oValues[I]);
         unsigned int index = 0;
         for( auto const& v: iContainer) {
           temp[index] = v;
           ++index;
         }
-        oValues[I] = temp;
         
         ctrFiller<I+1>(oValues, iSize, std::forward<U>(iU)... );
       }
@@ -303,7 +402,6 @@ namespace soa {
     struct CtrFillerFromAOS {
       template<typename T>
       static size_t fill(std::array<void *, sizeof...(Args)>& oValues, T const& iContainer) {
-        presize<0>(oValues,iContainer.size(),std::true_type{});
         unsigned index=0;
         for(auto&& item: iContainer) {
           fillElement<0>(item,index,oValues,std::true_type{});
@@ -314,7 +412,6 @@ namespace soa {
       
       template<typename T, typename F>
       static size_t fillUsingFiller(F& iFiller, std::array<void *, sizeof...(Args)>& oValues, T const& iContainer) {
-        presize<0>(oValues,iContainer.size(),std::true_type{});
         unsigned index=0;
         for(auto&& item: iContainer) {
           fillElementUsingFiller<0>(iFiller, item,index,oValues,std::true_type{});
@@ -325,18 +422,6 @@ namespace soa {
       
 
     private:
-      template<int I>
-      static void presize(std::array<void *, sizeof...(Args)>& oValues, size_t iSize, std::true_type) {
-        using Layout = std::tuple<Args...>;
-        using Type = typename std::tuple_element<I,Layout>::type::type;
-        oValues[I] = new Type[iSize];
-        presize<I+1>(oValues,iSize, std::conditional_t<I+1==sizeof...(Args),
-                     std::false_type,
-                     std::true_type>{});
-      }
-      template<int I>
-      static void presize(std::array<void *, sizeof...(Args)>& oValues, size_t iSize, std::false_type) {}
-      
       template<int I, typename E>
       static void fillElement(E const& iItem, size_t iIndex, std::array<void *, sizeof...(Args)>& oValues,  std::true_type) {
         using Layout = std::tuple<Args...>;
@@ -370,34 +455,24 @@ namespace soa {
 
     
     template<int I>
-    static void copyFromToWithResize(size_t iNElements, std::array<void *, sizeof...(Args)> const& iFrom, std::array<void*, sizeof...(Args)>& oTo, std::true_type) {
+    static void copyFromTo(size_t iNElements, std::array<void *, sizeof...(Args)> const& iFrom, std::array<void*, sizeof...(Args)>& oTo, std::true_type) {
       using Layout = std::tuple<Args...>;
       using Type = typename std::tuple_element<I,Layout>::type::type;
-      Type* oldPtr = static_cast<Type*>(oTo[I]);
-      Type* ptr = new Type[iNElements];
-      oTo[I]=ptr;
-      std::copy(static_cast<Type const*>(iFrom[I]), static_cast<Type const*>(iFrom[I])+iNElements, ptr);
-      delete [] oldPtr;
-      copyFromToWithResize<I+1>(iNElements, iFrom, oTo, std::conditional_t<I+1 == sizeof...(Args), std::false_type, std::true_type>{} );
+      std::copy(static_cast<Type const*>(iFrom[I]), static_cast<Type const*>(iFrom[I])+iNElements, static_cast<Type*>(oTo[I]));
+      copyFromTo<I+1>(iNElements, iFrom, oTo, std::conditional_t<I+1 == sizeof...(Args), std::false_type, std::true_type>{} );
     }
     template<int I>
-    static void copyFromToWithResize(size_t, std::array<void *, sizeof...(Args)> const& , std::array<void*, sizeof...(Args)>&, std::false_type) {}
+    static void copyFromTo(size_t, std::array<void *, sizeof...(Args)> const& , std::array<void*, sizeof...(Args)>&, std::false_type) {}
     
     template<int I>
-    static void resizeFromTo(size_t iOldSize, size_t iNewSize, std::array<void *, sizeof...(Args)>& ioArray, std::true_type) {
+    static void moveFromTo(size_t iNElements, std::array<void *, sizeof...(Args)>& iFrom, std::array<void*, sizeof...(Args)>& oTo, std::true_type) {
       using Layout = std::tuple<Args...>;
       using Type = typename std::tuple_element<I,Layout>::type::type;
-      Type* oldPtr = static_cast<Type*>(ioArray[I]);
-      auto ptr = new Type[iNewSize];
-      auto nToCopy = std::min(iOldSize,iNewSize);
-      std::copy(static_cast<Type const*>(ioArray[I]), static_cast<Type const*>(ioArray[I])+nToCopy, ptr);
-      resizeFromTo<I+1>(iOldSize, iNewSize, ioArray, std::conditional_t<I+1 == sizeof...(Args), std::false_type, std::true_type>{} );
-      
-      delete [] oldPtr;
-      ioArray[I]=ptr;
+      std::move(static_cast<Type*>(iFrom[I]), static_cast<Type*>(iFrom[I])+iNElements, static_cast<Type*>(oTo[I]));
+      moveFromTo<I+1>(iNElements, iFrom, oTo, std::conditional_t<I+1 == sizeof...(Args), std::false_type, std::true_type>{} );
     }
     template<int I>
-    static void resizeFromTo(size_t, size_t, std::array<void *, sizeof...(Args)>& , std::false_type) {}
+    static void moveFromTo(size_t, std::array<void *, sizeof...(Args)>& , std::array<void*, sizeof...(Args)>&, std::false_type) {}
     
     template<int I>
     static void resetStartingAt(size_t iStartIndex, size_t iEndIndex,std::array<void *, sizeof...(Args)>& ioArray,std::true_type) {
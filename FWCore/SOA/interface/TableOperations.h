@@ -0,0 +1,143 @@
+#ifndef FWCore_SOA_TableOperations_h
+#define FWCore_SOA_TableOperations_h
+// -*- C++ -*-
+//
+// Package:     FWCore/SOA
+// Class  :     TableOperations
+//
+/**\file TableOperations.h "TableOperations.h"
+
+ Description: Operations creating a new Table from the rows of an existing one
+
+ Usage:
+    The operations work column by column: the selection or the ordering is first
+ expressed as a list of row indices and then each column is gathered in turn,
+ so the inner loops only touch two contiguous arrays.
+ \code
+   using PtTable = edm::soa::Table<Pt,Eta,Phi>;
+   PtTable tracks{...};
+
+   //keep the rows with pt > 1
+   auto hardTracks = edm::soa::filter_column<Pt>(tracks, [](float pt) { return pt > 1.f; });
+
+   //the same with a precomputed mask
+   std::vector<bool> mask = ...;
+   auto selected = edm::soa::filter(tracks, mask);
+
+   //rows ordered by decreasing pt
+   auto ordered = edm::soa::sort_by<Pt>(tracks, std::greater<float>());
+
+   //any subset or permutation of the rows, rows may be repeated
+   std::vector<unsigned int> indices = ...;
+   auto picked = edm::soa::gather(tracks, indices);
+ \endcode
+*/
+
+// system include files
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// user include files
+#include "FWCore/SOA/interface/Table.h"
+
+// forward declarations
+
+namespace edm {
+namespace soa {
+
+  namespace impl {
+    template <int I, typename TABLE, typename C>
+    void gatherColumns(TABLE const&, C const&, TABLE&, std::false_type) {}
+
+    template <int I, typename TABLE, typename C>
+    void gatherColumns(TABLE const& iFrom, C const& iIndices, TABLE& oTo, std::true_type) {
+      using ColumnType = typename std::tuple_element<I, typename TABLE::Layout>::type;
+      auto from = iFrom.template column<ColumnType>().begin();
+      auto to = oTo.template column<ColumnType>().begin();
+      for(auto i: iIndices) {
+        *to = from[i];
+        ++to;
+      }
+      gatherColumns<I+1>(iFrom, iIndices, oTo, std::conditional_t<I+1 < TABLE::kNColumns, std::true_type, std::false_type>{});
+    }
+  }
+
+  /** A Table holding the rows iIndices[0], iIndices[1], ... of iTable.
+   The indices must be smaller than iTable.size() but need not be ordered or unique.
+   */
+  template <typename... Args, typename C>
+  Table<Args...> gather(Table<Args...> const& iTable, C const& iIndices) {
+    Table<Args...> result;
+    result.resize(iIndices.size());
+    impl::gatherColumns<0>(iTable, iIndices, result, std::true_type{});
+    return result;
+  }
+
+  ///Indices of the entries of iMask which are true, in increasing order
+  template <typename MASK>
+  std::vector<unsigned int> selected_indices(MASK const& iMask) {
+    std::vector<unsigned int> indices(iMask.size());
+    //branch free compaction: always write the index, only advance on a selected entry
+    unsigned int n = 0;
+    for(unsigned int i = 0, nEntries = iMask.size(); i < nEntries; ++i) {
+      indices[n] = i;
+      n += iMask[i] ? 1 : 0;
+    }
+    indices.resize(n);
+    return indices;
+  }
+
+  ///Indices of the rows of iTable whose value in column U passes iPredicate, in increasing order
+  template <typename U, typename... Args, typename F>
+  std::vector<unsigned int> selected_indices(Table<Args...> const& iTable, F&& iPredicate) {
+    auto values = iTable.template column<U>().begin();
+    std::vector<unsigned int> indices(iTable.size());
+    unsigned int n = 0;
+    for(unsigned int i = 0, nRows = iTable.size(); i < nRows; ++i) {
+      indices[n] = i;
+      n += iPredicate(values[i]) ? 1 : 0;
+    }
+    indices.resize(n);
+    return indices;
+  }
+
+  ///The rows of iTable for which iMask is true, iMask must hold one entry per row
+  template <typename... Args, typename MASK>
+  Table<Args...> filter(Table<Args...> const& iTable, MASK const& iMask) {
+    assert(iMask.size() == iTable.size());
+    return gather(iTable, selected_indices(iMask));
+  }
+
+  ///The rows of iTable whose value in column U passes iPredicate
+  template <typename U, typename... Args, typename F>
+  Table<Args...> filter_column(Table<Args...> const& iTable, F&& iPredicate) {
+    return gather(iTable, selected_indices<U>(iTable, std::forward<F>(iPredicate)));
+  }
+
+  /** The permutation of the rows of iTable ordering the values of column U according to iCompare.
+   The sort is stable, rows with equal values keep their relative order.
+   */
+  template <typename U, typename... Args, typename COMPARE = std::less<typename U::type>>
+  std::vector<unsigned int> sorted_indices(Table<Args...> const& iTable, COMPARE iCompare = COMPARE()) {
+    auto values = iTable.template column<U>().begin();
+    std::vector<unsigned int> indices(iTable.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(),
+                     [values,&iCompare](unsigned int iLHS, unsigned int iRHS) { return iCompare(values[iLHS], values[iRHS]); });
+    return indices;
+  }
+
+  ///A copy of iTable with the rows ordered by the values of column U
+  template <typename U, typename... Args, typename COMPARE = std::less<typename U::type>>
+  Table<Args...> sort_by(Table<Args...> const& iTable, COMPARE iCompare = COMPARE()) {
+    return gather(iTable, sorted_indices<U>(iTable, iCompare));
+  }
+}
+}
+
+#endif
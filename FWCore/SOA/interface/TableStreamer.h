@@ -0,0 +1,168 @@
+#ifndef FWCore_SOA_TableStreamer_h
+#define FWCore_SOA_TableStreamer_h
+// -*- C++ -*-
+//
+// Package:     FWCore/SOA
+// Class  :     TableStreamer
+//
+/**\class TableStreamer TableStreamer.h "TableStreamer.h"
+
+ Description: ROOT streamer writing and reading the columns of an edm::soa::Table
+
+ Usage:
+    The column data of a Table are not visible to ROOT (they are held in one untyped
+ memory block), so ROOT I/O of a Table needs this streamer. It writes the number
+ of rows followed by each column as one array: arithmetic columns are written with
+ the fast array methods of TBuffer, std::string columns string by string and
+ any other column type through its dictionary.
+
+ The streamer is given to ROOT by the dictionary library of the Table, when it is
+ loaded, whichever module, job or macro makes ROOT load it. The classes.h of the
+ dictionary declares it once per Table type, at global scope
+ \code
+   #include "FWCore/SOA/interface/TableStreamer.h"
+   EDM_SOA_TABLE_STREAMER(MyTable);
+ \endcode
+ where MyTable is the name of the Table type without commas, e.g. a typedef. The
+ Table and its edm::Wrapper also need dictionaries, as for any other data product.
+ Using this header requires ROOT (<use name="rootcore"/>).
+*/
+
+// system include files
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+
+// user include files
+#include "TBuffer.h"
+#include "TClass.h"
+#include "TClassRef.h"
+#include "TClassStreamer.h"
+#include "TGenericClassInfo.h"
+
+#include "FWCore/SOA/interface/Table.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/TypeID.h"
+
+// forward declarations
+
+namespace edm {
+namespace soa {
+
+  namespace impl {
+    template <typename T>
+    TClass* columnClass() {
+      TClass* cl = TClass::GetClass(typeid(T));
+      if(cl == nullptr) {
+        throw cms::Exception("DictionaryNotFound")<<"No dictionary for the Table column type "<<TypeID(typeid(T)).className();
+      }
+      return cl;
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value> writeColumn(TBuffer& ioBuffer, T const* iValues, unsigned int iSize) {
+      ioBuffer.WriteFastArray(iValues, iSize);
+    }
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value> readColumn(TBuffer& ioBuffer, T* oValues, unsigned int iSize) {
+      ioBuffer.ReadFastArray(oValues, iSize);
+    }
+
+    inline void writeColumn(TBuffer& ioBuffer, std::string const* iValues, unsigned int iSize) {
+      for(unsigned int i = 0; i < iSize; ++i) { ioBuffer.WriteStdString(iValues+i); }
+    }
+    inline void readColumn(TBuffer& ioBuffer, std::string* oValues, unsigned int iSize) {
+      for(unsigned int i = 0; i < iSize; ++i) { ioBuffer.ReadStdString(oValues+i); }
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_class<T>::value> writeColumn(TBuffer& ioBuffer, T const* iValues, unsigned int iSize) {
+      ioBuffer.WriteFastArray(const_cast<T*>(iValues), columnClass<T>(), iSize);
+    }
+    template <typename T>
+    std::enable_if_t<std::is_class<T>::value> readColumn(TBuffer& ioBuffer, T* oValues, unsigned int iSize) {
+      ioBuffer.ReadFastArray(oValues, columnClass<T>(), iSize);
+    }
+
+    template <int I, typename TABLE>
+    void writeColumns(TBuffer&, TABLE const&, std::false_type) {}
+
+    template <int I, typename TABLE>
+    void writeColumns(TBuffer& ioBuffer, TABLE const& iTable, std::true_type) {
+      using ColumnType = typename std::tuple_element<I, typename TABLE::Layout>::type;
+      writeColumn(ioBuffer, iTable.template column<ColumnType>().begin(), iTable.size());
+      writeColumns<I+1>(ioBuffer, iTable, std::conditional_t<I+1 < TABLE::kNColumns, std::true_type, std::false_type>{});
+    }
+
+    template <int I, typename TABLE>
+    void readColumns(TBuffer&, TABLE&, std::false_type) {}
+
+    template <int I, typename TABLE>
+    void readColumns(TBuffer& ioBuffer, TABLE& ioTable, std::true_type) {
+      using ColumnType = typename std::tuple_element<I, typename TABLE::Layout>::type;
+      readColumn(ioBuffer, ioTable.template column<ColumnType>().begin(), ioTable.size());
+      readColumns<I+1>(ioBuffer, ioTable, std::conditional_t<I+1 < TABLE::kNColumns, std::true_type, std::false_type>{});
+    }
+  }
+
+  template <typename TABLE>
+  class TableStreamer : public TClassStreamer {
+  public:
+    //the class is looked up by name on first use, the streamer being made while the
+    //dictionary is loaded
+    TableStreamer(): m_class(TypeID(typeid(TABLE)).className().c_str()) {}
+
+    void operator()(TBuffer& R__b, void* objp) override {
+      auto table = static_cast<TABLE*>(objp);
+      if(R__b.IsReading()) {
+        UInt_t start, count;
+        R__b.ReadVersion(&start, &count, m_class);
+        UInt_t size;
+        R__b >> size;
+        table->resize(size);
+        impl::readColumns<0>(R__b, *table, std::true_type{});
+        R__b.CheckByteCount(start, count, m_class);
+      } else {
+        UInt_t start = R__b.WriteVersion(m_class, kTRUE);
+        R__b << static_cast<UInt_t>(table->size());
+        impl::writeColumns<0>(R__b, *table, std::true_type{});
+        R__b.SetByteCount(start, kTRUE);
+      }
+    }
+
+    TClassStreamer* Generate() const override { return new TableStreamer<TABLE>(*this); }
+
+  private:
+    TClassRef m_class;
+  };
+
+  ///Gives the TableStreamer to the class info from which the dictionary of TABLE makes
+  ///its TClass, whether the TClass is already made or not; see EDM_SOA_TABLE_STREAMER
+  template <typename TABLE>
+  class TableStreamerRegistrar {
+  public:
+    explicit TableStreamerRegistrar(ROOT::TGenericClassInfo* iInfo) {
+      iInfo->AdoptStreamer(new TableStreamer<TABLE>());
+    }
+  };
+}
+}
+
+#define EDM_SOA_TABLE_STREAMER_CONCATENATE_HIDDEN(a,b) a ## b
+#define EDM_SOA_TABLE_STREAMER_CONCATENATE(a,b) EDM_SOA_TABLE_STREAMER_CONCATENATE_HIDDEN(a,b)
+
+//The class info is returned by the GenerateInitInstance function the dictionary defines
+//for each of its classes. The registrar only runs in the compiled dictionary, not when
+//cling parses the header.
+#if defined(__CLING__)
+#define EDM_SOA_TABLE_STREAMER(TABLE) static_assert(true, "")
+#else
+#define EDM_SOA_TABLE_STREAMER(TABLE) \
+  namespace ROOT { TGenericClassInfo* GenerateInitInstance(TABLE const*); } \
+  static edm::soa::TableStreamerRegistrar<TABLE> const \
+    EDM_SOA_TABLE_STREAMER_CONCATENATE(s_edmSoaTableStreamerRegistrar_, __LINE__)( \
+      ROOT::GenerateInitInstance(static_cast<TABLE const*>(nullptr)))
+#endif
+
+#endif
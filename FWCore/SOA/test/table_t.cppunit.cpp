@@ -9,6 +9,7 @@ Changed by Viji on 29-06-2005
 #include <cstdint>
 #include <iostream>
 #include <string>
+#include <sstream>
 #include <cmath>
 #include <cppunit/extensions/HelperMacros.h>
 #include "FWCore/SOA/interface/Table.h"
@@ -17,6 +18,8 @@ Changed by Viji on 29-06-2005
 #include "FWCore/SOA/interface/Column.h"
 #include "FWCore/SOA/interface/TableItr.h"
 #include "FWCore/SOA/interface/TableExaminer.h"
+#include "FWCore/SOA/interface/TableOperations.h"
+#include "FWCore/SOA/interface/StridedColumnValues.h"
 
 class testTable: public CppUnit::TestFixture
 {
@@ -31,6 +34,9 @@ class testTable: public CppUnit::TestFixture
   CPPUNIT_TEST(tableExaminerTest);
   CPPUNIT_TEST(tableResizeTest);
   CPPUNIT_TEST(mutabilityTest);
+  CPPUNIT_TEST(tableStorageTest);
+  CPPUNIT_TEST(tableOperationsTest);
+  CPPUNIT_TEST(stridedColumnTest);
   CPPUNIT_TEST_SUITE_END();
 public:
   void setUp(){}
@@ -45,6 +51,9 @@ public:
   void tableExaminerTest();
   void tableResizeTest();
   void mutabilityTest();
+  void tableStorageTest();
+  void tableOperationsTest();
+  void stridedColumnTest();
 };
 
 namespace ts {
@@ -440,5 +449,164 @@ void testTable::mutabilityTest() {
   CPPUNIT_ASSERT(row.get<Phi>() == 10.);
 }
 
+namespace {
+  bool isAligned(void const* iPtr) {
+    return reinterpret_cast<std::uintptr_t>(iPtr) % edm::soa::Table<ts::Eta>::kAlignment == 0;
+  }
+}
+
+void testTable::tableStorageTest() {
+  using namespace edm::soa;
+  using namespace ts;
+
+  std::vector<double> eta = { 0.1, -0.9, 1.3, 2.2, -2.4 };
+  std::vector<double> phi = { 0.8, 1.7, -2.1, 3.1, 0.2 };
+  std::vector<std::string> labels = { "a", "b", "c", "d", "e" };
+
+  MyJetTable jets{eta,phi,labels};
+  CPPUNIT_ASSERT(jets.size() == 5);
+  CPPUNIT_ASSERT(jets.capacity() == 5);
+  CPPUNIT_ASSERT(isAligned(jets.columnAddressByIndex(0)));
+  CPPUNIT_ASSERT(isAligned(jets.columnAddressByIndex(1)));
+  CPPUNIT_ASSERT(isAligned(jets.columnAddressByIndex(2)));
+
+  //iterating a const Table with more rows than columns
+  {
+    MyJetTable const& cJets = jets;
+    unsigned int index = 0;
+    for(auto const& v: cJets) {
+      CPPUNIT_ASSERT(tolerance(eta[index],v.get<Eta>()));
+      CPPUNIT_ASSERT(v.get<Label>() == labels[index]);
+      ++index;
+    }
+    CPPUNIT_ASSERT(index == 5);
+  }
+
+  //no reallocation within the capacity
+  jets.reserve(20);
+  CPPUNIT_ASSERT(jets.capacity() == 20);
+  CPPUNIT_ASSERT(jets.size() == 5);
+  auto address = jets.columnAddressByIndex(1);
+  CPPUNIT_ASSERT(isAligned(address));
+  for(size_t i = 0; i< 5; ++i) {
+    CPPUNIT_ASSERT(tolerance(eta[i],jets.get<Eta>(i)));
+    CPPUNIT_ASSERT(tolerance(phi[i],jets.get<Phi>(i)));
+    CPPUNIT_ASSERT(jets.get<Label>(i) == labels[i]);
+  }
+
+  jets.resize(2);
+  jets.resize(12);
+  CPPUNIT_ASSERT(jets.size() == 12);
+  CPPUNIT_ASSERT(jets.capacity() == 20);
+  CPPUNIT_ASSERT(jets.columnAddressByIndex(1) == address);
+  CPPUNIT_ASSERT(tolerance(eta[1],jets.get<Eta>(1)));
+  CPPUNIT_ASSERT(jets.get<Label>(1) == labels[1]);
+  for(size_t i = 2; i< 12; ++i) {
+    CPPUNIT_ASSERT(jets.get<Eta>(i) == 0.);
+    CPPUNIT_ASSERT(jets.get<Label>(i).empty());
+  }
+
+  jets.resize(21);
+  CPPUNIT_ASSERT(jets.capacity() == 21);
+  CPPUNIT_ASSERT(jets.get<Label>(0) == labels[0]);
+  CPPUNIT_ASSERT(isAligned(jets.columnAddressByIndex(2)));
+
+  MyJetTable copyJets{jets};
+  CPPUNIT_ASSERT(copyJets.size() == 21);
+  CPPUNIT_ASSERT(copyJets.get<Label>(0) == labels[0]);
+
+  MyJetTable empty;
+  CPPUNIT_ASSERT(empty.size() == 0);
+  CPPUNIT_ASSERT(empty.capacity() == 0);
+  MyJetTable copyEmpty{empty};
+  CPPUNIT_ASSERT(copyEmpty.size() == 0);
+  CPPUNIT_ASSERT(copyEmpty.begin() == copyEmpty.end());
+}
+
+void testTable::tableOperationsTest() {
+  using namespace edm::soa;
+  using namespace ts;
+
+  std::vector<double> eta = { 0.1, -0.9, 1.3, 2.2, -2.4 };
+  std::vector<double> phi = { 0.8, 1.7, -2.1, 3.1, 0.2 };
+  std::vector<std::string> labels = { "a", "b", "c", "d", "e" };
+  MyJetTable jets{eta,phi,labels};
+
+  auto compareRows = [&](MyJetTable const& iTable, std::vector<unsigned int> const& iRows) {
+    CPPUNIT_ASSERT(iTable.size() == iRows.size());
+    for(size_t i = 0; i< iRows.size(); ++i) {
+      CPPUNIT_ASSERT(tolerance(eta[iRows[i]],iTable.get<Eta>(i)));
+      CPPUNIT_ASSERT(tolerance(phi[iRows[i]],iTable.get<Phi>(i)));
+      CPPUNIT_ASSERT(iTable.get<Label>(i) == labels[iRows[i]]);
+    }
+  };
+
+  compareRows(gather(jets, std::vector<unsigned int>{4,0,0,2}), {4,0,0,2});
+  compareRows(gather(jets, std::vector<unsigned int>{}), {});
+
+  std::vector<bool> mask = {true, false, false, true, true};
+  CPPUNIT_ASSERT(selected_indices(mask) == (std::vector<unsigned int>{0,3,4}));
+  compareRows(filter(jets, mask), {0,3,4});
+
+  compareRows(filter_column<Eta>(jets, [](float iEta) { return std::abs(iEta) < 1.5f; }), {0,1,2});
+  compareRows(filter_column<Eta>(jets, [](float iEta) { return iEta > 5.f; }), {});
+
+  CPPUNIT_ASSERT(sorted_indices<Eta>(jets) == (std::vector<unsigned int>{4,1,0,2,3}));
+  compareRows(sort_by<Eta>(jets), {4,1,0,2,3});
+  compareRows(sort_by<Phi>(jets, std::greater<float>()), {3,1,0,4,2});
+  compareRows(sort_by<Label>(jets, std::greater<std::string>()), {4,3,2,1,0});
+
+  //stable for equal values
+  std::array<double,4> sameEta = {{1.,0.,1.,0.}};
+  std::array<double,4> index = {{0.,1.,2.,3.}};
+  JetTable same{sameEta,index};
+  CPPUNIT_ASSERT(sorted_indices<Eta>(same) == (std::vector<unsigned int>{1,3,0,2}));
+}
+
+namespace {
+  struct Track {
+    int charge_;
+    std::array<double,3> momentum_;
+    double chi2_;
+
+    std::array<double,3> const& momentum() const { return momentum_; }
+  };
+}
+
+void testTable::stridedColumnTest() {
+  using namespace edm::soa;
+
+  std::vector<Track> tracks = { {1, {{1.,2.,3.}}, 0.5}, {-1, {{4.,5.,6.}}, 1.5}, {1, {{7.,8.,9.}}, 2.5} };
+
+  auto chi2s = strided_column(tracks, &Track::chi2_);
+  CPPUNIT_ASSERT(chi2s.size() == 3);
+  CPPUNIT_ASSERT(chi2s.stride() == sizeof(Track));
+  CPPUNIT_ASSERT(&chi2s[1] == &tracks[1].chi2_);
+  {
+    auto it = tracks.begin();
+    for(auto chi2: chi2s) {
+      CPPUNIT_ASSERT(chi2 == it->chi2_);
+      ++it;
+    }
+    CPPUNIT_ASSERT(it == tracks.end());
+  }
+
+  auto momenta = strided_column(tracks, [](Track const& iT) -> auto const& { return iT.momentum(); });
+  CPPUNIT_ASSERT(momenta.size() == 3);
+  CPPUNIT_ASSERT(&momenta[2] == &tracks[2].momentum_);
+  CPPUNIT_ASSERT(momenta[1][2] == 6.);
+
+  //sees changes of the underlying objects
+  tracks[0].charge_ = -1;
+  auto charges = strided_column(tracks, &Track::charge_);
+  CPPUNIT_ASSERT(charges[0] == -1);
+  tracks[2].charge_ = 0;
+  CPPUNIT_ASSERT(charges[2] == 0);
+
+  std::vector<Track> none;
+  auto noChi2 = strided_column(none, &Track::chi2_);
+  CPPUNIT_ASSERT(noChi2.empty());
+  CPPUNIT_ASSERT(noChi2.begin() == noChi2.end());
+}
 
 #include <Utilities/Testing/interface/CppUnit_testdriver.icpp>
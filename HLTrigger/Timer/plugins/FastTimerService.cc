@@ -1,5 +1,6 @@
 // C++ headers
 #include <cmath>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -34,6 +35,7 @@
 // local headers
 #include "memory_usage.h"
 #include "processor_model.h"
+#include "tsc_clock.h"
 
 using namespace std::literals;
 
@@ -60,6 +62,13 @@ namespace {
   {
     return bytes / 1024;
   }
+
+  // write a value to the binary summary, in the native byte order
+  template <typename T>
+  void write_binary(std::ofstream & out, T value)
+  {
+    out.write(reinterpret_cast<const char *>(& value), sizeof(T));
+  }
 } // namespace
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -307,7 +316,15 @@ FastTimerService::ResourcesPerJob::operator+(ResourcesPerJob const& other) const
 
 // Measurement
 
-FastTimerService::Measurement::Measurement() noexcept {
+FastTimerService::Measurement::Measurement() noexcept :
+  fast(false)
+{
+  measure();
+}
+
+FastTimerService::Measurement::Measurement(bool fast_mode) noexcept :
+  fast(fast_mode)
+{
   measure();
 }
 
@@ -316,8 +333,12 @@ FastTimerService::Measurement::measure() noexcept {
   #ifdef DEBUG_THREAD_CONCURRENCY
   id = std::this_thread::get_id();
   #endif // DEBUG_THREAD_CONCURRENCY
-  time_thread = boost::chrono::thread_clock::now();
-  time_real   = boost::chrono::high_resolution_clock::now();
+  if (fast) {
+    tsc         = tsc_clock::now();
+  } else {
+    time_thread = boost::chrono::thread_clock::now();
+    time_real   = boost::chrono::high_resolution_clock::now();
+  }
   allocated   = memory_usage::allocated();
   deallocated = memory_usage::deallocated();
 }
@@ -327,16 +348,24 @@ FastTimerService::Measurement::measure_and_store(Resources & store) noexcept {
   #ifdef DEBUG_THREAD_CONCURRENCY
   assert(std::this_thread::get_id() == id);
   #endif // DEBUG_THREAD_CONCURRENCY
-  auto new_time_thread = boost::chrono::thread_clock::now();
-  auto new_time_real   = boost::chrono::high_resolution_clock::now();
+  if (fast) {
+    // the thread time is not measured, as it requires a system call
+    auto new_tsc = tsc_clock::now();
+    store.time_thread = boost::chrono::nanoseconds::zero();
+    store.time_real   = boost::chrono::nanoseconds(tsc_clock::nanoseconds(new_tsc - tsc));
+    tsc = new_tsc;
+  } else {
+    auto new_time_thread = boost::chrono::thread_clock::now();
+    auto new_time_real   = boost::chrono::high_resolution_clock::now();
+    store.time_thread = new_time_thread - time_thread;
+    store.time_real   = new_time_real   - time_real;
+    time_thread = new_time_thread;
+    time_real   = new_time_real;
+  }
   auto new_allocated   = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
-  store.time_thread = new_time_thread - time_thread;
-  store.time_real   = new_time_real   - time_real;
   store.allocated   = new_allocated   - allocated;
   store.deallocated = new_deallocated - deallocated;
-  time_thread = new_time_thread;
-  time_real   = new_time_real;
   allocated   = new_allocated;
   deallocated = new_deallocated;
 }
@@ -346,16 +375,22 @@ FastTimerService::Measurement::measure_and_accumulate(Resources & store) noexcep
   #ifdef DEBUG_THREAD_CONCURRENCY
   assert(std::this_thread::get_id() == id);
   #endif // DEBUG_THREAD_CONCURRENCY
-  auto new_time_thread = boost::chrono::thread_clock::now();
-  auto new_time_real   = boost::chrono::high_resolution_clock::now();
+  if (fast) {
+    auto new_tsc = tsc_clock::now();
+    store.time_real   += boost::chrono::nanoseconds(tsc_clock::nanoseconds(new_tsc - tsc));
+    tsc = new_tsc;
+  } else {
+    auto new_time_thread = boost::chrono::thread_clock::now();
+    auto new_time_real   = boost::chrono::high_resolution_clock::now();
+    store.time_thread += new_time_thread - time_thread;
+    store.time_real   += new_time_real   - time_real;
+    time_thread = new_time_thread;
+    time_real   = new_time_real;
+  }
   auto new_allocated   = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
-  store.time_thread += new_time_thread - time_thread;
-  store.time_real   += new_time_real   - time_real;
   store.allocated   += new_allocated   - allocated;
   store.deallocated += new_deallocated - deallocated;
-  time_thread = new_time_thread;
-  time_real   = new_time_real;
   allocated   = new_allocated;
   deallocated = new_deallocated;
 }
@@ -365,16 +400,22 @@ FastTimerService::Measurement::measure_and_accumulate(AtomicResources & store) n
   #ifdef DEBUG_THREAD_CONCURRENCY
   assert(std::this_thread::get_id() == id);
   #endif // DEBUG_THREAD_CONCURRENCY
-  auto new_time_thread = boost::chrono::thread_clock::now();
-  auto new_time_real   = boost::chrono::high_resolution_clock::now();
+  if (fast) {
+    auto new_tsc = tsc_clock::now();
+    store.time_real   += tsc_clock::nanoseconds(new_tsc - tsc);
+    tsc = new_tsc;
+  } else {
+    auto new_time_thread = boost::chrono::thread_clock::now();
+    auto new_time_real   = boost::chrono::high_resolution_clock::now();
+    store.time_thread += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_thread - time_thread).count();
+    store.time_real   += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_real   - time_real).count();
+    time_thread = new_time_thread;
+    time_real   = new_time_real;
+  }
   auto new_allocated   = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
-  store.time_thread += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_thread - time_thread).count();
-  store.time_real   += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_real   - time_real).count();
   store.allocated   += new_allocated   - allocated;
   store.deallocated += new_deallocated - deallocated;
-  time_thread = new_time_thread;
-  time_real   = new_time_real;
   allocated   = new_allocated;
   deallocated = new_deallocated;
 }
@@ -870,6 +911,7 @@ FastTimerService::PlotsPerJob::fill_lumi(AtomicResources const& data, unsigned i
 FastTimerService::FastTimerService(const edm::ParameterSet & config, edm::ActivityRegistry & registry) :
   // configuration
   callgraph_(),
+  threads_(                     [this]() { return Measurement(low_overhead_); } ),
   // job configuration
   concurrent_lumis_(            0 ),
   concurrent_runs_(             0 ),
@@ -878,6 +920,10 @@ FastTimerService::FastTimerService(const edm::ParameterSet & config, edm::Activi
   print_event_summary_(         config.getUntrackedParameter<bool>(     "printEventSummary"        ) ),
   print_run_summary_(           config.getUntrackedParameter<bool>(     "printRunSummary"          ) ),
   print_job_summary_(           config.getUntrackedParameter<bool>(     "printJobSummary"          ) ),
+  // low-overhead configuration
+  low_overhead_(                config.getUntrackedParameter<bool>(     "lowOverheadMode"          ) ),
+  low_overhead_sampling_(       config.getUntrackedParameter<unsigned int>( "lowOverheadSampling"  ) ),
+  binary_summary_file_(         config.getUntrackedParameter<std::string>( "binarySummaryFile"     ) ),
   // dqm configuration
   enable_dqm_(                  config.getUntrackedParameter<bool>(     "enableDQM"                ) ),
   enable_dqm_bymodule_(         config.getUntrackedParameter<bool>(     "enableDQMbyModule"        ) ),
@@ -903,6 +949,15 @@ FastTimerService::FastTimerService(const edm::ParameterSet & config, edm::Activi
   highlight_module_psets_(      config.getUntrackedParameter<std::vector<edm::ParameterSet>>("highlightModules") ),
   highlight_modules_(           highlight_module_psets_.size())         // filled in postBeginJob()
 {
+  if (low_overhead_) {
+    if (low_overhead_sampling_ == 0)
+      throw cms::Exception("Configuration") << "FastTimerService: lowOverheadSampling must be at least 1";
+    // the time-stamp counter is converted to nanoseconds with a constant factor
+    tsc_clock::calibrate();
+    // the per-lumisection summaries replace the DQM plots
+    enable_dqm_ = false;
+  }
+
   // start observing when a thread enters or leaves the TBB global thread arena
   tbb::task_scheduler_observer::observe();
 
@@ -1072,6 +1127,10 @@ FastTimerService::preallocate(edm::service::SystemBounds const& bounds)
   // allocate buffers to keep track of the resources spent in the lumi and run transitions
   lumi_transition_.resize(concurrent_lumis_);
   run_transition_.resize(concurrent_runs_);
+
+  // keep track of the sampled events
+  stream_events_.assign(concurrent_streams_, 0);
+  stream_sampled_.assign(concurrent_streams_, true);
 }
 
 void
@@ -1110,6 +1169,14 @@ FastTimerService::postBeginJob() {
   streams_.resize(concurrent_streams_, temp);
   run_summary_.resize(concurrent_runs_, temp);
   job_summary_ = temp;
+  if (low_overhead_) {
+    stream_summary_.resize(concurrent_streams_, temp);
+    lumi_summary_.resize(concurrent_lumis_, temp);
+  }
+
+  if (low_overhead_ and not binary_summary_file_.empty()) {
+    writeBinarySummaryHeader();
+  }
 
   // check that the DQMStore service is available
   if (enable_dqm_ and not edm::Service<DQMStore>().isAvailable()) {
@@ -1153,6 +1220,8 @@ FastTimerService::preGlobalBeginLumi(edm::GlobalContext const& gc)
     auto index = gc.luminosityBlockIndex();
     subprocess_global_lumi_check_[index] = 0;
     lumi_transition_[index].reset();
+    if (low_overhead_)
+      lumi_summary_[index].reset();
   }
 }
 
@@ -1179,6 +1248,16 @@ FastTimerService::postGlobalEndLumi(edm::GlobalContext const& gc)
   if (not last)
     return;
 
+  if (low_overhead_) {
+    // merge the lumisection into the run and job summaries
+    std::lock_guard<std::mutex> guard(summary_mutex_);
+    auto const& lumi = lumi_summary_[index];
+    job_summary_ += lumi;
+    run_summary_[gc.runIndex()] += lumi;
+    if (binary_summary_.is_open())
+      writeBinarySummary(lumi, gc.luminosityBlockID().run(), gc.luminosityBlockID().luminosityBlock());
+  }
+
   edm::LogVerbatim out("FastReport");
   auto const& label = (boost::format("run %d, lumisection %d") % gc.luminosityBlockID().run() % gc.luminosityBlockID().luminosityBlock()).str();
   printTransition(out, lumi_transition_[index], label);
@@ -1209,6 +1288,15 @@ FastTimerService::preStreamEndLumi(edm::StreamContext const& sc)
 void
 FastTimerService::postStreamEndLumi(edm::StreamContext const& sc) {
   ignoredSignal(__func__);
+
+  if (low_overhead_) {
+    // merge the events processed by this stream into the lumisection summary;
+    // this is the only place where the per-stream summary is shared
+    unsigned int sid = sc.streamID().value();
+    std::lock_guard<std::mutex> guard(summary_mutex_);
+    lumi_summary_[sc.luminosityBlockIndex()] += stream_summary_[sid];
+    stream_summary_[sid].reset();
+  }
 }
 
 void
@@ -1515,8 +1603,11 @@ FastTimerService::postEvent(edm::StreamContext const& sc)
 {
   ignoredSignal(__func__);
 
-  unsigned int pid = callgraph_.processId(* sc.processContext());
   unsigned int sid = sc.streamID();
+  if (not isSampled(sid))
+    return;
+
+  unsigned int pid = callgraph_.processId(* sc.processContext());
   auto & stream  = streams_[sid];
   auto & process = callgraph_.processDescription(pid);
 
@@ -1539,8 +1630,11 @@ FastTimerService::postEvent(edm::StreamContext const& sc)
     for (unsigned int i: highlight_modules_[group].modules)
       stream.highlight[group] += stream.modules[i].total;
 
-  // avoid concurrent access to the summary objects
-  {
+  if (low_overhead_) {
+    // only this stream accesses its summary until the end of the lumisection
+    stream_summary_[sid] += stream;
+  } else {
+    // avoid concurrent access to the summary objects
     std::lock_guard<std::mutex> guard(summary_mutex_);
     job_summary_ += stream;
     run_summary_[sc.runIndex()] += stream;
@@ -1559,6 +1653,11 @@ FastTimerService::postEvent(edm::StreamContext const& sc)
 void
 FastTimerService::preSourceEvent(edm::StreamID sid)
 {
+  // in low-overhead mode, measure only one event every N on each stream
+  stream_sampled_[sid] = not low_overhead_ or (stream_events_[sid]++ % low_overhead_sampling_ == 0);
+  if (not isSampled(sid))
+    return;
+
   // clear the event counters
   auto & stream = streams_[sid];
   stream.reset();
@@ -1567,14 +1666,16 @@ FastTimerService::preSourceEvent(edm::StreamID sid)
   subprocess_event_check_[sid] = 0;
 
   // reuse the same measurement for the Source module and for the explicit begin of the Event
-  auto & measurement = thread();
-  measurement.measure_and_accumulate(stream.overhead);
-  stream.event_measurement = measurement;
+  startMeasurement(stream.overhead);
+  stream.event_measurement = thread();
 }
 
 void
 FastTimerService::postSourceEvent(edm::StreamID sid)
 {
+  if (not isSampled(sid))
+    return;
+
   edm::ModuleDescription const& md = callgraph_.source();
   unsigned int id  = md.id();
   auto & stream = streams_[sid];
@@ -1587,6 +1688,9 @@ void
 FastTimerService::prePathEvent(edm::StreamContext const& sc, edm::PathContext const & pc)
 {
   unsigned int sid = sc.streamID().value();
+  if (not isSampled(sid))
+    return;
+
   unsigned int pid = callgraph_.processId(* sc.processContext());
   unsigned int id  = pc.pathID();
   auto & stream = streams_[sid];
@@ -1599,6 +1703,9 @@ void
 FastTimerService::postPathEvent(edm::StreamContext const& sc, edm::PathContext const & pc, edm::HLTPathStatus const & status)
 {
   unsigned int sid = sc.streamID().value();
+  if (not isSampled(sid))
+    return;
+
   unsigned int pid = callgraph_.processId(* sc.processContext());
   unsigned int id  = pc.pathID();
   auto & stream = streams_[sid];
@@ -1622,16 +1729,22 @@ void
 FastTimerService::preModuleEventAcquire(edm::StreamContext const& sc, edm::ModuleCallingContext const& mcc)
 {
   unsigned int sid = sc.streamID().value();
+  if (not isSampled(sid))
+    return;
+
   auto & stream = streams_[sid];
-  thread().measure_and_accumulate(stream.overhead);
+  startMeasurement(stream.overhead);
 }
 
 void
 FastTimerService::postModuleEventAcquire(edm::StreamContext const& sc, edm::ModuleCallingContext const& mcc)
 {
+  unsigned int sid = sc.streamID().value();
+  if (not isSampled(sid))
+    return;
+
   edm::ModuleDescription const& md = * mcc.moduleDescription();
   unsigned int id  = md.id();
-  unsigned int sid = sc.streamID().value();
   auto & stream = streams_[sid];
   auto & module = stream.modules[id];
 
@@ -1643,16 +1756,22 @@ void
 FastTimerService::preModuleEvent(edm::StreamContext const& sc, edm::ModuleCallingContext const& mcc)
 {
   unsigned int sid = sc.streamID().value();
+  if (not isSampled(sid))
+    return;
+
   auto & stream = streams_[sid];
-  thread().measure_and_accumulate(stream.overhead);
+  startMeasurement(stream.overhead);
 }
 
 void
 FastTimerService::postModuleEvent(edm::StreamContext const& sc, edm::ModuleCallingContext const& mcc)
 {
+  unsigned int sid = sc.streamID().value();
+  if (not isSampled(sid))
+    return;
+
   edm::ModuleDescription const& md = * mcc.moduleDescription();
   unsigned int id  = md.id();
-  unsigned int sid = sc.streamID().value();
   auto & stream = streams_[sid];
   auto & module = stream.modules[id];
 
@@ -1824,6 +1943,64 @@ FastTimerService::thread()
   return threads_.local();
 }
 
+void
+FastTimerService::startMeasurement(Resources & overhead)
+{
+  // in low-overhead mode the thread may have run unsampled events since its
+  // last measurement, so the time in between is not accounted as overhead
+  if (low_overhead_)
+    thread().measure();
+  else
+    thread().measure_and_accumulate(overhead);
+}
+
+// binary summary format, in native byte order:
+//   header:  "FTSB", uint32 version, uint32 sampling, uint32 number of modules,
+//            and for each module uint32 label length followed by the label
+//   records: uint32 run, uint32 lumisection, uint32 measured events,
+//            the event resources and, for each module, uint32 events followed
+//            by the module resources; resources are four uint64 values:
+//            cpu time [ns], real time [ns], allocated and deallocated memory [bytes]
+void
+FastTimerService::writeBinarySummaryHeader()
+{
+  binary_summary_.open(binary_summary_file_, std::ios::binary | std::ios::trunc);
+  if (not binary_summary_)
+    throw cms::Exception("FastTimerService") << "cannot open the binary summary file " << binary_summary_file_;
+
+  binary_summary_.write("FTSB", 4);
+  write_binary<uint32_t>(binary_summary_, 1);
+  write_binary<uint32_t>(binary_summary_, low_overhead_ ? low_overhead_sampling_ : 1);
+  write_binary<uint32_t>(binary_summary_, callgraph_.size());
+  for (unsigned int i = 0; i < callgraph_.size(); ++i) {
+    auto const& label = callgraph_.module(i).moduleLabel();
+    write_binary<uint32_t>(binary_summary_, label.size());
+    binary_summary_.write(label.data(), label.size());
+  }
+  binary_summary_.flush();
+}
+
+void
+FastTimerService::writeBinarySummary(ResourcesPerJob const& data, unsigned int run, unsigned int lumi)
+{
+  auto write_resources = [this](Resources const& resources) {
+    write_binary<uint64_t>(binary_summary_, resources.time_thread.count());
+    write_binary<uint64_t>(binary_summary_, resources.time_real.count());
+    write_binary<uint64_t>(binary_summary_, resources.allocated);
+    write_binary<uint64_t>(binary_summary_, resources.deallocated);
+  };
+
+  write_binary<uint32_t>(binary_summary_, run);
+  write_binary<uint32_t>(binary_summary_, lumi);
+  write_binary<uint32_t>(binary_summary_, data.events);
+  write_resources(data.event);
+  for (auto const& module: data.modules) {
+    write_binary<uint32_t>(binary_summary_, module.events);
+    write_resources(module.total);
+  }
+  binary_summary_.flush();
+}
+
 
 // describe the module's configuration
 void
@@ -1833,6 +2010,9 @@ FastTimerService::fillDescriptions(edm::ConfigurationDescriptions & descriptions
   desc.addUntracked<bool>(        "printEventSummary",        false);
   desc.addUntracked<bool>(        "printRunSummary",          true);
   desc.addUntracked<bool>(        "printJobSummary",          true);
+  desc.addUntracked<bool>(        "lowOverheadMode",          false)->setComment("Measure only the real time, from the TSC, and merge the summaries only at lumisection boundaries; the DQM plots are disabled.");
+  desc.addUntracked<unsigned>(    "lowOverheadSampling",      1)->setComment("In low-overhead mode, measure one event every N on each stream.");
+  desc.addUntracked<std::string>( "binarySummaryFile",        "")->setComment("If not empty, write the per-lumisection summaries to this file in a compact binary format (low-overhead mode only).");
   desc.addUntracked<bool>(        "enableDQM",                true);
   desc.addUntracked<bool>(        "enableDQMbyModule",        false);
   desc.addUntracked<bool>(        "enableDQMbyPath",          false);
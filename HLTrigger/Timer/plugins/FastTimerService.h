@@ -7,6 +7,7 @@
 // C++ headers
 #include <chrono>
 #include <cmath>
+#include <fstream>
 #include <map>
 #include <mutex>
 #include <string>
@@ -187,6 +188,8 @@ private:
   struct Measurement {
   public:
     Measurement() noexcept;
+    // in fast mode, measure only the real time from the TSC, and the memory
+    explicit Measurement(bool fast) noexcept;
     // take per-thread measurements
     void measure() noexcept;
     // take per-thread measurements, compute the delta with respect to the previous measurement, and store them in the argument
@@ -201,8 +204,10 @@ private:
     #endif // DEBUG_THREAD_CONCURRENCY
     boost::chrono::thread_clock::time_point          time_thread;
     boost::chrono::high_resolution_clock::time_point time_real;
+    uint64_t                                         tsc;
     uint64_t                                         allocated;
     uint64_t                                         deallocated;
+    bool                                             fast;
   };
 
   // highlight a group of modules
@@ -420,6 +425,13 @@ private:
   std::vector<ResourcesPerJob>  run_summary_;                   // whole event time accounting per-run
   std::mutex                    summary_mutex_;                 // synchronise access to the summary objects across different threads
 
+  // low-overhead mode: per-stream and per-lumi summaries, merged only at lumi boundaries
+  std::vector<ResourcesPerJob>  stream_summary_;                // events of the current lumisection, accessed only by the stream
+  std::vector<ResourcesPerJob>  lumi_summary_;                  // per-lumi accounting, filled at the end of each stream lumi
+  std::vector<unsigned int>     stream_events_;                 // events seen by each stream, to choose the sampled ones
+  std::vector<char>             stream_sampled_;                // whether the current event of each stream is measured
+  std::ofstream                 binary_summary_;
+
   // per-thread quantities, lazily allocated
   tbb::enumerable_thread_specific<Measurement, tbb::cache_aligned_allocator<Measurement>, tbb::ets_key_per_instance>
                                 threads_;
@@ -443,6 +455,11 @@ private:
   const bool                    print_run_summary_;             // print the time spent in each process, path and module for each run
   const bool                    print_job_summary_;             // print the time spent in each process, path and module for the whole job
 
+  // low-overhead configuration
+  const bool                    low_overhead_;                  // measure only the real time from the TSC, and merge the summaries per lumisection
+  const unsigned int            low_overhead_sampling_;         // measure one event every N per stream
+  const std::string             binary_summary_file_;           // write the per-lumisection summaries to this file
+
   // dqm configuration
   bool                          enable_dqm_;                    // non const, depends on the availability of the DQMStore
   const bool                    enable_dqm_bymodule_;
@@ -501,6 +518,12 @@ private:
   template <typename T>
   void printTransition(T& out, AtomicResources const& data, std::string const& label) const;
 
+  // low-overhead mode helpers
+  bool isSampled(unsigned int sid) const { return stream_sampled_[sid]; }
+  void startMeasurement(Resources & overhead);
+  void writeBinarySummaryHeader();
+  void writeBinarySummary(ResourcesPerJob const& data, unsigned int run, unsigned int lumi);
+
   // check if this is the first process being signalled
   bool isFirstSubprocess(edm::StreamContext const&);
   bool isFirstSubprocess(edm::GlobalContext const&);
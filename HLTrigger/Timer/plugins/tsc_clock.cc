@@ -0,0 +1,72 @@
+#include <chrono>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#include "tsc_clock.h"
+
+namespace {
+  bool initialise();
+
+  const bool have_invariant_tsc = initialise();
+  double ns_per_tick = 1.;
+
+  bool initialise()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    // rdtscp is reported in CPUID.80000001H:EDX[27]
+    if (not __get_cpuid(0x80000001, & eax, & ebx, & ecx, & edx) or not (edx & (1u << 27)))
+      return false;
+    // invariant TSC is reported in CPUID.80000007H:EDX[8]
+    if (not __get_cpuid(0x80000007, & eax, & ebx, & ecx, & edx))
+      return false;
+    return (edx & (1u << 8));
+#else
+    return false;
+#endif
+  }
+
+  uint64_t steady_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+} // namespace
+
+bool tsc_clock::is_available()
+{
+  return have_invariant_tsc;
+}
+
+void tsc_clock::calibrate()
+{
+  if (not have_invariant_tsc)
+    return;
+
+  // measure the TSC frequency against the steady clock over 20 ms
+  uint64_t ticks = now();
+  uint64_t ns    = steady_ns();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ticks = now()       - ticks;
+  ns    = steady_ns() - ns;
+  ns_per_tick = (double) ns / (double) ticks;
+}
+
+uint64_t tsc_clock::now()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  if (have_invariant_tsc) {
+    unsigned int aux;
+    return __rdtscp(& aux);
+  }
+#endif
+  return steady_ns();
+}
+
+uint64_t tsc_clock::nanoseconds(uint64_t ticks)
+{
+  return (uint64_t) (ticks * ns_per_tick);
+}
@@ -0,0 +1,17 @@
+#ifndef tsc_clock_h
+#define tsc_clock_h
+
+#include <cstdint>
+
+// read the processor's time-stamp counter with rdtscp, and convert the
+// number of ticks to nanoseconds; falls back to std::chrono::steady_clock
+// if the processor does not have an invariant TSC
+class tsc_clock {
+public:
+  static bool     is_available();
+  static void     calibrate();
+  static uint64_t now();
+  static uint64_t nanoseconds(uint64_t ticks);
+};
+
+#endif // tsc_clock_h
@@ -0,0 +1,56 @@
+#!/usr/bin/env python
+
+# print the per-module averages from the binary summary written by the
+# FastTimerService in low-overhead mode (see "binarySummaryFile")
+
+from __future__ import print_function
+import sys, struct
+
+def read(f, fmt):
+  size = struct.calcsize(fmt)
+  data = f.read(size)
+  if len(data) < size:
+    return None
+  return struct.unpack(fmt, data)
+
+def main(name):
+  with open(name, 'rb') as f:
+    if f.read(4) != b'FTSB':
+      sys.exit('%s is not a FastTimerService binary summary' % name)
+    version, sampling, modules = read(f, '=3I')
+    if version != 1:
+      sys.exit('unsupported binary summary version %d' % version)
+    labels = []
+    for i in range(modules):
+      (size,) = read(f, '=I')
+      labels.append(f.read(size).decode())
+
+    events = 0
+    event_time = 0
+    module_events = [0] * modules
+    module_time   = [0] * modules
+    lumis = 0
+    while True:
+      header = read(f, '=3I4Q')
+      if header is None:
+        break
+      lumis  += 1
+      events += header[2]
+      event_time += header[4]
+      for i in range(modules):
+        record = read(f, '=I4Q')
+        module_events[i] += record[0]
+        module_time[i]   += record[2]
+
+  print('%d lumisections, %d measured events (one every %d per stream)' % (lumis, events, sampling))
+  if events == 0:
+    return
+  print('%10.3f ms/event  %s' % (event_time / 1e6 / events, 'event'))
+  for i in sorted(range(modules), key = lambda i: -module_time[i]):
+    if module_events[i]:
+      print('%10.3f ms/event  %s' % (module_time[i] / 1e6 / events, labels[i]))
+
+if __name__ == '__main__':
+  if len(sys.argv) != 2:
+    sys.exit('usage: %s FILE' % sys.argv[0])
+  main(sys.argv[1])
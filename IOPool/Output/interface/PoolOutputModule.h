@@ -52,6 +52,7 @@ namespace edm {
     int const& splitLevel() const {return splitLevel_;}
     std::string const& basketOrder() const {return basketOrder_;}
     int const& treeMaxVirtualSize() const {return treeMaxVirtualSize_;}
+    bool parallelCompression() const {return parallelCompression_;}
     bool const& overrideInputFileSplitLevels() const {return overrideInputFileSplitLevels_;}
     DropMetaData const& dropMetaData() const {return dropMetaData_;}
     std::string const& catalog() const {return catalog_;}
@@ -59,6 +60,8 @@ namespace edm {
     unsigned int const& maxFileSize() const {return maxFileSize_;}
     int const& inputFileCount() const {return inputFileCount_;}
     int const& whyNotFastClonable() const {return whyNotFastClonable_;}
+    unsigned int numberOfPartitions() const {return numberOfPartitions_;}
+    unsigned int partition() const {return partition_;}
 
     std::string const& currentFileName() const;
 
@@ -181,6 +184,9 @@ namespace edm {
     int const splitLevel_;
     std::string basketOrder_;
     int const treeMaxVirtualSize_;
+    bool const parallelCompression_;
+    unsigned int const numberOfPartitions_;
+    unsigned int const partition_;
     int whyNotFastClonable_;
     DropMetaData dropMetaData_;
     std::string const moduleLabel_;
@@ -0,0 +1,35 @@
+import FWCore.ParameterSet.Config as cms
+
+def partitionPoolOutputModule(process, label, numberOfPartitions):
+    """Replaces the PoolOutputModule 'label' by numberOfPartitions copies.
+
+    Copy k writes the events with (event number % numberOfPartitions) == k
+    to <fileName without .root>_part<k>.root. All partial files hold all
+    runs and luminosity blocks, but only partition 0 holds their products:
+    the other partitions store them as not present, which the merge of run
+    and lumi products skips or replaces by the real ones, so they are counted
+    once whatever the order of the files. Output modules are serialized per
+    instance only, so the copies write their files concurrently. The partial files are
+    complete EDM files; merging them in partition order with a fast cloning
+    PoolSource (noEventSort = False) + PoolOutputModule job always gives
+    the same file, whatever the number of threads of the producing job.
+    Returns the list of new modules.
+    """
+    original = getattr(process, label)
+    fileName = original.fileName.value()
+    stem = fileName[:-len('.root')] if fileName.endswith('.root') else fileName
+
+    parts = []
+    for k in range(numberOfPartitions):
+        part = original.clone(fileName = cms.untracked.string('%s_part%d.root' % (stem, k)),
+                              numberOfPartitions = cms.untracked.uint32(numberOfPartitions),
+                              partition = cms.untracked.uint32(k))
+        setattr(process, '%sPart%d' % (label, k), part)
+        parts.append(part)
+
+    sequence = cms.Sequence(sum(parts[1:], parts[0]) if len(parts) > 1 else parts[0])
+    setattr(process, '%sPartitions' % label, sequence)
+    for endpath in process.endpaths_().values():
+        endpath.replace(original, sequence)
+    delattr(process, label)
+    return parts
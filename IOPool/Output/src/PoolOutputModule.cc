@@ -51,6 +51,9 @@ namespace edm {
     splitLevel_(std::min<int>(pset.getUntrackedParameter<int>("splitLevel") + 1, 99)),
     basketOrder_(pset.getUntrackedParameter<std::string>("sortBaskets")),
     treeMaxVirtualSize_(pset.getUntrackedParameter<int>("treeMaxVirtualSize")),
+    parallelCompression_(pset.getUntrackedParameter<bool>("parallelCompression")),
+    numberOfPartitions_(pset.getUntrackedParameter<unsigned int>("numberOfPartitions")),
+    partition_(pset.getUntrackedParameter<unsigned int>("partition")),
     whyNotFastClonable_(pset.getUntrackedParameter<bool>("fastCloning") ? FileBlock::CanFastClone : FileBlock::DisabledInConfigFile),
     dropMetaData_(DropNone),
     moduleLabel_(pset.getParameter<std::string>("@module_label")),
@@ -65,6 +68,13 @@ namespace edm {
     rootOutputFile_(),
     statusFileName_() {
 
+      if (numberOfPartitions_ == 0 || partition_ >= numberOfPartitions_) {
+        throw edm::Exception(errors::Configuration)
+          << "PoolOutputModule " << moduleLabel_ << " configured with partition " << partition_
+          << " of " << numberOfPartitions_ << " partitions.\n"
+          << "'partition' must be smaller than 'numberOfPartitions'.\n";
+      }
+
       if (pset.getUntrackedParameter<bool>("writeStatusFile")) {
         std::ostringstream statusfilename;
         statusfilename << moduleLabel_ << '_' << getpid();
@@ -266,6 +276,11 @@ namespace edm {
   }
 
   void PoolOutputModule::write(EventForOutput const& e) {
+    // The partition only depends on the event number, so the content of
+    // each partial file does not depend on scheduling.
+    if (numberOfPartitions_ > 1 && e.id().event() % numberOfPartitions_ != partition_) {
+      return;
+    }
     updateBranchParents(e);
     rootOutputFile_->writeOne(e);
       if (!statusFileName_.empty()) {
@@ -451,9 +466,19 @@ namespace edm {
                      "Used by ROOT when fast copying. Affects performance.");
     desc.addUntracked<int>("treeMaxVirtualSize", -1)
         ->setComment("Size of ROOT TTree TBasket cache.  Affects performance.");
+    desc.addUntracked<bool>("parallelCompression", true)
+        ->setComment("True:  If ROOT implicit multithreading is enabled, compress and write baskets in parallel tasks.\n"
+                     "False: Compress and write baskets on the thread running the module.");
     desc.addUntracked<bool>("fastCloning", true)
         ->setComment("True:  Allow fast copying, if possible.\n"
                      "False: Disable fast copying.");
+    desc.addUntracked<unsigned int>("numberOfPartitions", 1)
+        ->setComment("Number of partial files the output is split into, each written by its own module instance.\n"
+                     "See IOPool/Output/python/partitionOutput.py.");
+    desc.addUntracked<unsigned int>("partition", 0)
+        ->setComment("Only events with (event number % numberOfPartitions) == partition are written.\n"
+                     "Runs and luminosity blocks are written in all partitions, their products only in partition 0\n"
+                     "(the other partitions store them as not present, which a merge ignores or replaces by the real ones).");
     desc.addUntracked<bool>("overrideInputFileSplitLevels", false)
         ->setComment("False: Use branch split levels and basket sizes from input file, if possible.\n"
                      "True:  Always use specified or default split levels and basket sizes.");
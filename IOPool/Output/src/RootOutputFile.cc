@@ -102,9 +102,9 @@ namespace edm {
       pEventEntryInfoVector_(&eventEntryInfoVector_),
       pBranchListIndexes_(nullptr),
       pEventSelectionIDs_(nullptr),
-      eventTree_(filePtr(), InEvent, om_->splitLevel(), om_->treeMaxVirtualSize()),
-      lumiTree_(filePtr(), InLumi, om_->splitLevel(), om_->treeMaxVirtualSize()),
-      runTree_(filePtr(), InRun, om_->splitLevel(), om_->treeMaxVirtualSize()),
+      eventTree_(filePtr(), InEvent, om_->splitLevel(), om_->treeMaxVirtualSize(), om_->parallelCompression()),
+      lumiTree_(filePtr(), InLumi, om_->splitLevel(), om_->treeMaxVirtualSize(), om_->parallelCompression()),
+      runTree_(filePtr(), InRun, om_->splitLevel(), om_->treeMaxVirtualSize(), om_->parallelCompression()),
       treePointers_(),
       dataTypeReported_(false),
       processHistoryRegistry_(),
@@ -684,6 +684,9 @@ namespace edm {
     bool const keepProvenanceForPrior = doProvenance && om_->dropMetaData() != PoolOutputModule::DropPrior;
 
     bool const fastCloning = (branchType == InEvent) && (whyNotFastClonable_ == FileBlock::CanFastClone);
+    // Only the first partition holds the run and lumi products, the other partitions
+    // store them as not present so that merging the partial files counts them once.
+    bool const runLumiProductsInOtherPartition = (branchType != InEvent) && (om_->partition() != 0);
     std::set<StoredProductProvenance> provenanceToKeep;
     //
     //If we are dropping some of the meta data we need to know
@@ -714,7 +717,8 @@ namespace edm {
       ProductProvenance const* productProvenance = nullptr;
       BasicHandle result;
       if(getProd) {
-        bool found = occurrence.getByToken(item.token_, item.branchDescription_->unwrappedTypeID(), result);
+        bool found = !runLumiProductsInOtherPartition &&
+                     occurrence.getByToken(item.token_, item.branchDescription_->unwrappedTypeID(), result);
         product = result.wrapper();
         if(found && keepProvenance) {
           productProvenance = result.provenance()->productProvenance();
@@ -16,6 +16,7 @@
 #include "TBranchElement.h"
 #include "TCollection.h"
 #include "TFile.h"
+#include "TROOT.h"
 #include "TTreeCloner.h"
 #include "Rtypes.h"
 #include "RVersion.h"
@@ -90,7 +91,8 @@ namespace edm {
                    std::shared_ptr<TFile> filePtr,
                    BranchType const& branchType,
                    int splitLevel,
-                   int treeMaxVirtualSize) :
+                   int treeMaxVirtualSize,
+                   bool parallelCompression) :
       filePtr_(filePtr),
       tree_(makeTTree(filePtr.get(), BranchTypeToProductTreeName(branchType), splitLevel)),
       producedBranches_(),
@@ -99,9 +101,13 @@ namespace edm {
       unclonedReadBranches_(),
       clonedReadBranchNames_(),
       currentlyFastCloning_(),
-      fastCloneAuxBranches_(false) {
+      fastCloneAuxBranches_(false),
+      parallelCompression_(parallelCompression) {
 
     if(treeMaxVirtualSize >= 0) tree_->SetMaxVirtualSize(treeMaxVirtualSize);
+    // With implicit MT, TTree::Fill and FlushBaskets compress the baskets of
+    // different branches in parallel tasks.
+    tree_->SetImplicitMT(parallelCompression_);
   }
 
   TTree*
@@ -285,6 +291,8 @@ namespace edm {
 
   void
   RootOutputTree::fillTTree(std::vector<TBranch*> const& branches) {
+    // Branches filled one by one use the serial TBranch::Fill; the parallel
+    // compression of implicit MT only applies to TTree::Fill and FlushBaskets.
     for_all(branches, std::bind(&TBranch::Fill, std::placeholders::_1));
   }
 
@@ -26,7 +26,8 @@ namespace edm {
     RootOutputTree(std::shared_ptr<TFile> filePtr,
                    BranchType const& branchType,
                    int splitLevel,
-                   int treeMaxVirtualSize);
+                   int treeMaxVirtualSize,
+                   bool parallelCompression = true);
 
     ~RootOutputTree() {}
 
@@ -109,7 +110,7 @@ namespace edm {
       tree_->SetAutoFlush(size);
     }
   private:
-    static void fillTTree(std::vector<TBranch*> const& branches);
+    void fillTTree(std::vector<TBranch*> const& branches);
 // We use bare pointers for pointers to some ROOT entities.
 // Root owns them and uses bare pointers internally.
 // Therefore, using smart pointers here will do no good.
@@ -125,6 +126,7 @@ namespace edm {
     std::set<std::string> clonedReadBranchNames_;
     bool currentlyFastCloning_;
     bool fastCloneAuxBranches_;
+    bool parallelCompression_;
   };
 }
 #endif
@@ -0,0 +1,39 @@
+import FWCore.ParameterSet.Config as cms
+import sys
+
+# "cmsRun PoolOutputPartitionMerge_cfg.py reversed" reads the partial files
+# in the opposite order; the merged run and lumi products must be the same
+reverse = len(sys.argv) > 2 and sys.argv[2] == "reversed"
+files = ["file:PoolOutputPartitionTest_part0.root", "file:PoolOutputPartitionTest_part1.root"]
+if reverse:
+    files.reverse()
+
+process = cms.Process("MERGE")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.source = cms.Source("PoolSource",
+                            fileNames = cms.untracked.vstring(*files),
+                            noEventSort = cms.untracked.bool(False))
+
+# even events from the first partial file, then the odd ones
+ids = [cms.EventID(1,e) for e in range(2,21,2)] + [cms.EventID(1,e) for e in range(1,20,2)]
+if reverse:
+    ids = ids[10:] + ids[:10]
+process.check = cms.EDAnalyzer("EventIDChecker", eventSequence = cms.untracked(cms.VEventID(*ids)))
+
+# The lumi is continued across the two partial files and its products merged.
+# Only the first partition holds the lumi products, so the mergeable
+# ThingWithMerge must have the value of a single lumi (1002, not 2004) and
+# ThingWithIsEqual must not be compared with an empty product. When the other
+# partition is read first, its not present products are replaced by the real
+# ones. The values are the same for every transition since only
+# endLuminosityBlock checks them.
+process.testmerge = cms.EDAnalyzer("TestMergeResults",
+    expectedEndLumiNew = cms.untracked.vint32(*([1001, 1002, 1003]*10))
+)
+
+process.output = cms.OutputModule("PoolOutputModule",
+    fileName = cms.untracked.string('file:PoolOutputPartitionMerge%sTest.root' % ('Reversed' if reverse else ''))
+)
+
+process.ep = cms.EndPath(process.check+process.testmerge+process.output)
@@ -0,0 +1,31 @@
+import FWCore.ParameterSet.Config as cms
+from IOPool.Output.partitionOutput import partitionPoolOutputModule
+
+process = cms.Process("TESTOUTPUTPARTITION")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(4)
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(20)
+)
+process.Thing = cms.EDProducer("ThingProducer")
+
+process.OtherThing = cms.EDProducer("OtherThingProducer")
+
+# mergeable run and lumi products, checked after merging the partial files
+process.thingWithMergeProducer = cms.EDProducer("ThingWithMergeProducer")
+
+process.output = cms.OutputModule("PoolOutputModule",
+    fileName = cms.untracked.string('file:PoolOutputPartitionTest.root')
+)
+
+process.source = cms.Source("EmptySource")
+
+process.p = cms.Path(process.Thing*process.OtherThing*process.thingWithMergeProducer)
+process.ep = cms.EndPath(process.output)
+
+partitionPoolOutputModule(process, "output", 2)
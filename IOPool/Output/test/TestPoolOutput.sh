@@ -33,4 +33,9 @@ cmsRun ${LOCAL_TEST_DIR}/TestProvC_cfg.py || die 'Failure using TestProvC_cfg.py
 cmsRun ${LOCAL_TEST_DIR}/PoolOutputTestUnscheduled_cfg.py || die 'Failure using PoolOutputTestUnscheduled_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/PoolOutputTestUnscheduledRead_cfg.py || die 'Failure using PoolOutputTestUnscheduledRead_cfg.py' $?
 
+cmsRun ${LOCAL_TEST_DIR}/PoolOutputPartitionTest_cfg.py || die 'Failure using PoolOutputPartitionTest_cfg.py' $?
+#reads the partial files from above
+cmsRun ${LOCAL_TEST_DIR}/PoolOutputPartitionMerge_cfg.py || die 'Failure using PoolOutputPartitionMerge_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/PoolOutputPartitionMerge_cfg.py reversed || die 'Failure using PoolOutputPartitionMerge_cfg.py reversed' $?
+
 popd
@@ -42,6 +42,25 @@ namespace edm {
 
     void deserializeEvent(EventMsgView const& eventView);
 
+    /**
+     * Deserializes an event message whose data were already checked and
+     * uncompressed by unpackEventData, possibly on another thread.
+     * The eventData buffer is swapped with the internal one.
+     */
+    void deserializeEvent(EventMsgView const& eventView,
+                          std::vector<unsigned char>& eventData,
+                          unsigned int eventDataSize);
+
+    /**
+     * Checks the checksum of the data of the event message and
+     * uncompresses them, if needed, into the output buffer.
+     * Returns the size of the data.  It does not use the state of the
+     * source, so it can be called from any thread.
+     * Errors are reported by throwing exceptions.
+     */
+    static unsigned int unpackEventData(EventMsgView const& eventView,
+                                        std::vector<unsigned char>& outputBuffer);
+
     static
     void mergeIntoRegistry(SendJobHeader const& header,
                            ProductRegistry&,
@@ -89,6 +108,8 @@ namespace edm {
       EventPrincipal const* eventPrincipal_;
     };
 
+    void deserializeEventData(EventMsgView const& eventView, unsigned long dest_size);
+
     void read(EventPrincipal& eventPrincipal) override;
 
     void setRun(RunNumber_t r) override;
@@ -203,6 +203,30 @@ namespace edm {
       throw cms::Exception("StreamTranslation","Event deserialization error")
         << "received wrong message type: expected EVENT, got "
         << eventView.code() << "\n";
+    unsigned long dest_size = unpackEventData(eventView, dest_);
+    deserializeEventData(eventView, dest_size);
+  }
+
+  void
+  StreamerInputSource::deserializeEvent(EventMsgView const& eventView,
+                                        std::vector<unsigned char>& eventData,
+                                        unsigned int eventDataSize) {
+    if(eventView.code() != Header::EVENT)
+      throw cms::Exception("StreamTranslation","Event deserialization error")
+        << "received wrong message type: expected EVENT, got "
+        << eventView.code() << "\n";
+    if(eventData.size() < eventDataSize)
+      throw cms::Exception("StreamTranslation","Event deserialization error")
+        << "unpacked event data of " << eventData.size() << " bytes, expected "
+        << eventDataSize << "\n";
+    // the caller gets back the previous buffer, to be reused
+    dest_.swap(eventData);
+    deserializeEventData(eventView, eventDataSize);
+  }
+
+  unsigned int
+  StreamerInputSource::unpackEventData(EventMsgView const& eventView,
+                                       std::vector<unsigned char>& outputBuffer) {
     FDEBUG(9) << "Decode event: "
          << eventView.event() << " "
          << eventView.run() << " "
@@ -230,15 +254,20 @@ namespace edm {
     if(origsize != 78 && origsize != 0) {
       // compressed
       dest_size = uncompressBuffer(const_cast<unsigned char*>((unsigned char const*)eventView.eventData()),
-                                   eventView.eventLength(), dest_, origsize);
+                                   eventView.eventLength(), outputBuffer, origsize);
     } else { // not compressed
       // we need to copy anyway the buffer as we are using dest in xbuf
       dest_size = eventView.eventLength();
-      dest_.resize(dest_size);
-      unsigned char* pos = (unsigned char*) &dest_[0];
+      outputBuffer.resize(dest_size);
+      unsigned char* pos = (unsigned char*) &outputBuffer[0];
       unsigned char const* from = (unsigned char const*) eventView.eventData();
       std::copy(from,from+dest_size,pos);
     }
+    return dest_size;
+  }
+
+  void
+  StreamerInputSource::deserializeEventData(EventMsgView const& eventView, unsigned long dest_size) {
     //TBuffer xbuf(TBuffer::kRead, dest_size,
     //             (char const*) &dest[0],kFALSE);
     //TBuffer xbuf(TBuffer::kRead, eventView.eventLength(),
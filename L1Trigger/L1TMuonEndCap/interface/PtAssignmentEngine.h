@@ -12,6 +12,7 @@
 #include "L1Trigger/L1TMuonEndCap/interface/PtAssignmentEngineAux.h"
 #include "L1Trigger/L1TMuonEndCap/interface/PtLUTReader.h"
 #include "L1Trigger/L1TMuonEndCap/interface/bdt/Forest.h"
+#include "L1Trigger/L1TMuonEndCap/interface/bdt/FlatForest.h"
 
 
 class PtAssignmentEngine {
@@ -24,6 +25,7 @@ public:
   void read(int pt_lut_version, const std::string& xml_dir);
   void load(int pt_lut_version, const L1TMuonEndCapForest *payload);
   const std::array<emtf::Forest, 16>& getForests(void) const { return forests_; }
+  const std::array<emtf::FlatForest, 16>& getFlatForests(void) const { return flatForests_; }
   const std::vector<int>& getAllowedModes(void) const { return allowedModes_; }
 
   int get_pt_lut_version() const { return ptLUTVersion_; }
@@ -53,6 +55,7 @@ public:
 protected:
   std::vector<int> allowedModes_;
   std::array<emtf::Forest, 16> forests_;
+  std::array<emtf::FlatForest, 16> flatForests_;  // evaluated by calculate_pt_xml, built from forests_
   PtLUTReader ptlut_reader_;
 
   int verbose_;
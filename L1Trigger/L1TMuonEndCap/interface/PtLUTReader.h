@@ -3,18 +3,24 @@
 
 #include <cstdint>
 #include <string>
-#include <vector>
 
 
+// The pT LUT binary file is memory-mapped read-only: the pages are read from
+// disk on first access and shared with the page cache, instead of decoding
+// the whole file into memory at startup.
 class PtLUTReader {
 public:
   explicit PtLUTReader();
   ~PtLUTReader();
 
+  PtLUTReader(const PtLUTReader&) = delete;
+  PtLUTReader& operator=(const PtLUTReader&) = delete;
+
   typedef uint16_t               content_t;
   typedef uint64_t               address_t;
-  typedef std::vector<content_t> table_t;
 
+  // maps the file; reading another file unmaps the one mapped before,
+  // reading the same one again does nothing
   void read(const std::string& lut_full_path);
 
   content_t lookup(const address_t& address) const;
@@ -22,7 +28,12 @@ public:
   content_t get_version() const { return version_; }
 
 private:
-  mutable table_t ptlut_;
+  void unmap();
+
+  // 64-bit words, each one holding four 9-bit entries
+  const uint64_t* ptlut_;
+  size_t size_;  // in bytes
+  std::string path_;
   content_t version_;
   bool ok_;
 };
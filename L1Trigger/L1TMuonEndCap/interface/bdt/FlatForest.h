@@ -0,0 +1,67 @@
+// FlatForest.h
+
+#ifndef L1Trigger_L1TMuonEndCap_emtf_FlatForest
+#define L1Trigger_L1TMuonEndCap_emtf_FlatForest
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace emtf {
+
+class Forest;
+
+// Read-only copy of a Forest for the prediction, built once when the forest
+// is loaded. The nodes of every tree are stored breadth first in one array
+// for the whole forest, the daughters of a node are adjacent and the
+// terminal nodes point to themselves, so that a batch of events walks every
+// tree for a fixed number of steps without branches, the events of the batch
+// being independent chains of loads.
+// The predictions are identical to Forest::predictEvent: same comparisons,
+// same order of the sums.
+
+class FlatForest
+{
+    public:
+
+        FlatForest();
+        explicit FlatForest(Forest& forest);
+
+        // Number of trees in the forest.
+        unsigned int size() const { return trees.size(); }
+
+        // Same as Forest::predictEvent with the predictors of the event.
+        double predictEvent(const std::vector<double>& data, unsigned int numtrees) const;
+        // The events are the rows of nEvents predictors, stride doubles apart.
+        void predictEvents(const double* data, size_t nEvents, size_t stride,
+                           double* predictions, unsigned int numtrees) const;
+
+    private:
+
+        struct FlatTree
+        {
+            int32_t root;
+            int32_t depth;
+        };
+
+        // A step reads a single node: left daughter if x < splitValue,
+        // right daughter (the next node) if x >= splitValue, the node itself
+        // otherwise, so that an event with a NaN predictor stops where the
+        // recursive filtering stops. Terminal nodes are their own daughters.
+        struct FlatNode
+        {
+            double splitValue;
+            int32_t splitVariable;
+            int32_t left;
+            int32_t right;
+        };
+
+        double initialPrediction;
+        std::vector<FlatTree> trees;
+        std::vector<FlatNode> nodes;
+        std::vector<double> fitValues;
+};
+
+} // end of emtf namespace
+
+#endif
@@ -73,10 +73,11 @@ void PtAssignment::process(
       xmlpt   = pt_assign_engine_->calculate_pt(address);
 
       // Check address packing / unpacking
-      if (not( fabs(xmlpt - pt_assign_engine_->calculate_pt(track)) < 0.001 ) )
+      const float track_xmlpt = pt_assign_engine_->calculate_pt(track);
+      if (not( fabs(xmlpt - track_xmlpt) < 0.001 ) )
         { edm::LogWarning("L1T") << "EMTF pT assignment mismatch: xmlpt = " << xmlpt
                                  << ", pt_assign_engine_->calculate_pt(track)) = "
-                                 << pt_assign_engine_->calculate_pt(track); }
+                                 << track_xmlpt; }
 
       pt  = (xmlpt < 0.) ? 1. : xmlpt;  // Matt used fabs(-1) when mode is invalid
       pt *= pt_assign_engine_->scale_pt(pt, track.Mode());  // Multiply by some factor to achieve 90% efficiency at threshold
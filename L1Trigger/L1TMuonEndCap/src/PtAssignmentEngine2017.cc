@@ -410,19 +410,13 @@ float PtAssignmentEngine2017::calculate_pt_xml(const address_t& address) const {
   // Retreive pT from XMLs
   std::vector<double> tree_data(predictors.cbegin(),predictors.cend());
 
-  auto tree_event = std::make_unique<emtf::Event>();
-  tree_event->predictedValue = 0;
-  tree_event->data = tree_data;
-
-  // forests_.at(mode).predictEvent(tree_event.get(), 400);
-  emtf::Forest &forest = const_cast<emtf::Forest&>(forests_.at(mode));
-  forest.predictEvent(tree_event.get(), 400);
+  float prediction = flatForests_.at(mode).predictEvent(tree_data, 400);
 
   // // Adjust this for different XMLs
-  // float log2_pt = tree_event->predictedValue;
+  // float log2_pt = prediction;
   // pt_xml = pow(2, fmax(0.0, log2_pt)); // Protect against negative values
 
-  float inv_pt = tree_event->predictedValue;
+  float inv_pt = prediction;
   pt_xml = 1.0 / fmax(0.001, inv_pt); // Protect against negative values
 
   return pt_xml;
@@ -565,19 +559,13 @@ float PtAssignmentEngine2017::calculate_pt_xml(const EMTFTrack& track) const {
 
   std::vector<double> tree_data(predictors.cbegin(),predictors.cend());
 
-  auto tree_event = std::make_unique<emtf::Event>();
-  tree_event->predictedValue = 0;
-  tree_event->data = tree_data;
-
-  // forests_.at(mode).predictEvent(tree_event.get(), 400);
-  emtf::Forest &forest = const_cast<emtf::Forest&>(forests_.at(mode));
-  forest.predictEvent(tree_event.get(), 400);
+  float prediction = flatForests_.at(mode).predictEvent(tree_data, 400);
 
   // // Adjust this for different XMLs
-  // float log2_pt = tree_event->predictedValue;
+  // float log2_pt = prediction;
   // pt_xml = pow(2, fmax(0.0, log2_pt)); // Protect against negative values
 
-  float inv_pt = tree_event->predictedValue;
+  float inv_pt = prediction;
   pt_xml = 1.0 / fmax(0.001, inv_pt); // Protect against negative values
 
   return pt_xml;
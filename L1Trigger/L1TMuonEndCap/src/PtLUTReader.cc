@@ -1,13 +1,21 @@
 #include "L1Trigger/L1TMuonEndCap/interface/PtLUTReader.h"
 
-#include <fstream>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #define PTLUT_SIZE (1<<30)
 
 PtLUTReader::PtLUTReader() :
-    ptlut_(),
+    ptlut_(nullptr),
+    size_(0),
     version_(4),
     ok_(false)
 {
@@ -15,55 +23,71 @@ PtLUTReader::PtLUTReader() :
 }
 
 PtLUTReader::~PtLUTReader() {
+  unmap();
+}
 
+void PtLUTReader::unmap() {
+  if (ptlut_ != nullptr)
+    munmap(const_cast<uint64_t*>(ptlut_), size_);
+  ptlut_ = nullptr;
+  size_ = 0;
+  ok_ = false;
 }
 
 void PtLUTReader::read(const std::string& lut_full_path) {
-  if (ok_)  return;
+  if (ok_ && lut_full_path == path_)  return;
 
   std::cout << "EMTF emulator: attempting to read pT LUT binary file from local area" << std::endl;
   std::cout << lut_full_path << std::endl;
   std::cout << "Non-standard operation; if it fails, now you know why" << std::endl;
   std::cout << "Be sure to check that the 'scale_pt' function still matches this LUT" << std::endl;
-  std::cout << "Loading LUT, this might take a while..." << std::endl;
 
-  std::ifstream infile(lut_full_path, std::ios::binary);
-  if (!infile.good()) {
+  int fd = open(lut_full_path.c_str(), O_RDONLY);
+  if (fd < 0) {
     char what[256];
     snprintf(what, sizeof(what), "Fail to open %s", lut_full_path.c_str());
     throw std::invalid_argument(what);
   }
 
-  ptlut_.reserve(PTLUT_SIZE);
-
-  typedef uint64_t full_word_t;
-  full_word_t full_word;
-  full_word_t sub_word[4] = {0, 0, 0, 0};
-
-  while (infile.read(reinterpret_cast<char*>(&full_word), sizeof(full_word_t))) {
-    sub_word[0] = (full_word>>0)      & 0x1FF;  // 9-bit
-    sub_word[1] = (full_word>>9)      & 0x1FF;
-    sub_word[2] = (full_word>>32)     & 0x1FF;
-    sub_word[3] = (full_word>>(32+9)) & 0x1FF;
-
-    ptlut_.push_back(sub_word[0]);
-    ptlut_.push_back(sub_word[1]);
-    ptlut_.push_back(sub_word[2]);
-    ptlut_.push_back(sub_word[3]);
+  // four entries per 64-bit word
+  struct stat st;
+  const size_t expected = (PTLUT_SIZE / 4) * sizeof(uint64_t);
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != expected) {
+    close(fd);
+    char what[256];
+    snprintf(what, sizeof(what), "%s is %lld bytes != %lu", lut_full_path.c_str(), (long long) st.st_size, expected);
+    throw std::invalid_argument(what);
   }
-  infile.close();
 
-  if (ptlut_.size() != PTLUT_SIZE) {
+  void* addr = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+  int err = errno;
+  close(fd);
+  if (addr == MAP_FAILED) {
     char what[256];
-    snprintf(what, sizeof(what), "ptlut_.size() is %lu != %i", ptlut_.size(), PTLUT_SIZE);
+    snprintf(what, sizeof(what), "Fail to map %s: %s", lut_full_path.c_str(), strerror(err));
     throw std::invalid_argument(what);
   }
-
-  version_ = ptlut_.at(0);  // address 0 is the pT LUT version number
+  // the lookups are scattered over the whole file: no read-ahead
+  madvise(addr, expected, MADV_RANDOM);
+
+  // the file mapped before stays mapped until the new one is
+  unmap();
+  ptlut_ = static_cast<const uint64_t*>(addr);
+  size_ = expected;
+  path_ = lut_full_path;
   ok_ = true;
+
+  version_ = lookup(0);  // address 0 is the pT LUT version number
   return;
 }
 
 PtLUTReader::content_t PtLUTReader::lookup(const address_t& address) const {
-  return ptlut_.at(address);
+  if (!ok_ || address >= PTLUT_SIZE) {
+    char what[256];
+    snprintf(what, sizeof(what), "pT LUT address %llu is out of range", (unsigned long long) address);
+    throw std::out_of_range(what);
+  }
+
+  static const int shift[4] = {0, 9, 32, 32+9};
+  return (ptlut_[address / 4] >> shift[address % 4]) & 0x1FF;  // 9-bit
 }
@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////
+//                            FlatForest.cc                             //
+// =====================================================================//
+// Flattened copy of a forest of decision trees, for the prediction.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "L1Trigger/L1TMuonEndCap/interface/bdt/FlatForest.h"
+#include "L1Trigger/L1TMuonEndCap/interface/bdt/Forest.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace emtf;
+
+namespace
+{
+    // events walking the trees together
+    const size_t kBlockSize = 32;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// _______________________Constructor(s)________________________________//
+//////////////////////////////////////////////////////////////////////////
+
+FlatForest::FlatForest() : initialPrediction(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ----------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////
+
+FlatForest::FlatForest(Forest& forest) : initialPrediction(0)
+{
+    // just like in Forest::predictEvent, the boost weight of the first tree
+    if(forest.size() > 0) initialPrediction = forest.getTree(0)->getBoostWeight();
+
+    trees.reserve(forest.size());
+    for(unsigned int t=0; t < forest.size(); t++)
+    {
+        FlatTree flat;
+        flat.root = nodes.size();
+        flat.depth = 0;
+
+        // Breadth first: (node, depth), the position in the queue is the flat index.
+        std::vector< std::pair<Node*, int> > queue;
+        queue.emplace_back(forest.getTree(t)->getRootNode(), 0);
+        for(unsigned int i=0; i < queue.size(); i++)
+        {
+            Node* node = queue[i].first;
+            int depth = queue[i].second;
+            FlatNode flatNode;
+            flatNode.splitVariable = node->getSplitVariable();
+
+            if(node->getLeftDaughter() == nullptr || node->getRightDaughter() == nullptr)
+            {
+                // Terminal node: both daughters are the node itself.
+                flatNode.splitValue = 0;
+                flatNode.splitVariable = 0;
+                flatNode.left = flat.root + i;
+                flatNode.right = flat.root + i;
+                flat.depth = std::max(flat.depth, depth);
+            }
+            else
+            {
+                flatNode.splitValue = node->getSplitValue();
+                flatNode.left = flat.root + queue.size();
+                flatNode.right = flatNode.left + 1;
+                queue.emplace_back(node->getLeftDaughter(), depth+1);
+                queue.emplace_back(node->getRightDaughter(), depth+1);
+            }
+            nodes.push_back(flatNode);
+            fitValues.push_back(node->getFitValue());
+        }
+        trees.push_back(flat);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ______________________Prediction_____________________________________//
+//////////////////////////////////////////////////////////////////////////
+
+double FlatForest::predictEvent(const std::vector<double>& data, unsigned int numtrees) const
+{
+    numtrees = std::min<unsigned int>(numtrees, trees.size());
+    double prediction = initialPrediction;
+
+    // A single event stops at the terminal node, rather than walking the
+    // depth of the tree.
+    for(unsigned int t=0; t < numtrees; t++)
+    {
+        int32_t index = trees[t].root;
+        for(;;)
+        {
+            const FlatNode& node = nodes[index];
+            if(node.left == index) break;
+            double x = data[node.splitVariable];
+            if(x < node.splitValue) index = node.left;
+            else if(x >= node.splitValue) index = node.right;
+            else break;
+        }
+        prediction += fitValues[index];
+    }
+    return prediction;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ----------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////
+
+void FlatForest::predictEvents(const double* data, size_t nEvents, size_t stride,
+                               double* predictions, unsigned int numtrees) const
+{
+    numtrees = std::min<unsigned int>(numtrees, trees.size());
+    int32_t index[kBlockSize];
+    const FlatNode* flatNodes = nodes.data();
+
+    for(size_t begin=0; begin < nEvents; begin+=kBlockSize)
+    {
+        size_t n = std::min(kBlockSize, nEvents-begin);
+        const double* events = data + begin*stride;
+        double* block = predictions + begin;
+
+        for(size_t e=0; e < n; e++) block[e] = initialPrediction;
+
+        // Each tree corrects the last prediction.
+        for(unsigned int t=0; t < numtrees; t++)
+        {
+            const FlatTree& tree = trees[t];
+            for(size_t e=0; e < n; e++) index[e] = tree.root;
+            for(int32_t step=0; step < tree.depth; step++)
+            {
+                for(size_t e=0; e < n; e++)
+                {
+                    const FlatNode& node = flatNodes[index[e]];
+                    double x = events[e*stride + node.splitVariable];
+                    // without branches: one of the three terms
+                    int32_t lt = (x <  node.splitValue);
+                    int32_t ge = (x >= node.splitValue);
+                    index[e] = lt*node.left + ge*node.right + (1-lt-ge)*index[e];
+                }
+            }
+            for(size_t e=0; e < n; e++) block[e] += fitValues[index[e]];
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#include "Utilities/Testing/interface/CppUnit_testdriver.icpp"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "L1Trigger/L1TMuonEndCap/interface/bdt/Forest.h"
+#include "L1Trigger/L1TMuonEndCap/interface/bdt/FlatForest.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+
+class TestFlatForest: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestFlatForest);
+  CPPUNIT_TEST(test_predict);
+  CPPUNIT_TEST(test_empty);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestFlatForest() {}
+  ~TestFlatForest() {}
+  void setUp() {}
+  void tearDown() {}
+
+  void test_predict();
+  void test_empty();
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(TestFlatForest);
+
+
+namespace {
+  // random tree in the layout of the conditions payload, node 0 is the root
+  unsigned add_node(L1TMuonEndCapForest::DTree& tree, std::mt19937& rng, int nVars, int depth, int maxDepth) {
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+    unsigned index = tree.size();
+    tree.emplace_back();
+    tree[index].fitVal = uniform(rng);
+    if (depth == maxDepth || (depth > 1 && uniform(rng) < -0.6))
+      return index;
+    tree[index].splitVar = std::uniform_int_distribution<int>(0, nVars-1)(rng);
+    // integer split values as well: predictors equal to them go right
+    tree[index].splitVal = (uniform(rng) < 0.) ? std::round(4. * uniform(rng)) : uniform(rng);
+    unsigned left = add_node(tree, rng, nVars, depth+1, maxDepth);
+    unsigned right = add_node(tree, rng, nVars, depth+1, maxDepth);
+    tree[index].ileft = left;
+    tree[index].iright = right;
+    return index;
+  }
+}
+
+void TestFlatForest::test_predict()
+{
+  std::mt19937 rng(2017);
+  const int nVars = 12;
+  const unsigned nTrees = 400;
+
+  L1TMuonEndCapForest::DForest payload(nTrees);
+  for (auto& tree : payload)
+    add_node(tree, rng, nVars, 0, 6);
+  emtf::Forest forest;
+  forest.loadFromCondPayload(payload);
+  forest.getTree(0)->setBoostWeight(0.125);
+
+  emtf::FlatForest flat(forest);
+  CPPUNIT_ASSERT_EQUAL(nTrees, flat.size());
+
+  std::normal_distribution<double> gauss(0., 2.);
+  const size_t nEvents = 100;
+  std::vector<double> data(nEvents * nVars);
+  for (auto& x : data)
+    x = (gauss(rng) < 0.) ? std::round(gauss(rng)) : gauss(rng);
+  data[3] = std::numeric_limits<double>::quiet_NaN();
+  data[nVars + 5] = std::numeric_limits<double>::infinity();
+
+  for (unsigned numtrees : {nTrees, 64u, 1000u}) {
+    std::vector<double> batch(nEvents);
+    flat.predictEvents(data.data(), nEvents, nVars, batch.data(), numtrees);
+    for (size_t i = 0; i < nEvents; ++i) {
+      emtf::Event event;
+      event.predictedValue = 0;
+      event.data.assign(data.begin() + i*nVars, data.begin() + (i+1)*nVars);
+      forest.predictEvent(&event, numtrees);
+      CPPUNIT_ASSERT_EQUAL(event.predictedValue, batch[i]);
+      CPPUNIT_ASSERT_EQUAL(event.predictedValue, flat.predictEvent(event.data, numtrees));
+    }
+  }
+}
+
+void TestFlatForest::test_empty()
+{
+  emtf::FlatForest flat;
+  CPPUNIT_ASSERT_EQUAL(0u, flat.size());
+  CPPUNIT_ASSERT_EQUAL(0., flat.predictEvent(std::vector<double>(3, 1.), 400));
+}
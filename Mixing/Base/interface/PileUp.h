@@ -9,6 +9,7 @@
 #include "DataFormats/Provenance/interface/EventID.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "Mixing/Base/interface/PileUpProductCache.h"
 
 #include "TRandom.h"
 #include "TFile.h"
@@ -35,6 +36,8 @@ namespace edm {
     double averageNumber_;
     std::shared_ptr<TH1F> histo_;
     const bool playback_;
+    // shared by all streams, null if product caching is disabled
+    std::shared_ptr<PileUpProductCache> productCache_;
   };
 
   class PileUp {
@@ -83,6 +86,10 @@ namespace edm {
     // void recordEventForPlayback(EventPrincipal const& eventPrincipal,
 	//			  std::vector<edm::SecondaryEventIDAndFileInfo> &ids, T& eventOperator);
 
+    // Hash of the secondary file the current pileup event was read from.
+    size_t fileNameHash() const {return fileNameHash_;}
+    PileUpProductCache* productCache() const {return productCache_.get();}
+
     const unsigned int & input()const{return inputType_;}
     void input(unsigned int s){inputType_=s;}
 
@@ -127,6 +134,7 @@ namespace edm {
     std::shared_ptr<LuminosityBlockPrincipal> lumiPrincipal_;
     std::shared_ptr<RunPrincipal> runPrincipal_;
     std::unique_ptr<SecondaryEventProvider> provider_;
+    std::shared_ptr<PileUpProductCache> productCache_;
     std::unique_ptr<CLHEP::RandPoissonQ> PoissonDistribution_;
     std::unique_ptr<CLHEP::RandPoisson> PoissonDistr_OOT_;
     CLHEP::HepRandomEngine* randomEngine_;
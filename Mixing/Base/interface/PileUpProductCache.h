@@ -0,0 +1,106 @@
+#ifndef Mixing_Base_PileUpProductCache_h
+#define Mixing_Base_PileUpProductCache_h
+
+/** \class edm::PileUpProductCache
+ *
+ * Process-wide, memory-budgeted LRU cache of already deserialized pileup
+ * products (PSimHits, PCaloHits, SimTracks, ...).  One instance is held
+ * per pileup source in the MixingModule global cache and is shared
+ * read-only by all streams, so a minbias product that was unpacked once
+ * is not read and decompressed again when the same secondary event is
+ * drawn by another stream or another bunch crossing.
+ *
+ * Entries are keyed by the secondary file name hash, the secondary
+ * EventID, the product type and the InputTag.  The cached Provenance only
+ * carries the branch description and product ID of the original product.
+ *
+ * The cache shares the ownership of the product wrapper read by the
+ * secondary source, the product is not copied.  Only the product types for
+ * which PileUpProductSize gives the memory held can be cached.
+ *
+ ************************************************************/
+
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "DataFormats/Provenance/interface/Provenance.h"
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace edm {
+
+  /// Memory held by a product, counted against the PileUpProductCache budget.
+  /// Products of types without a specialization are not cached, since the
+  /// heap memory they own is unknown. The generic specialization covers the
+  /// vectors of types which own no heap memory (PSimHit, PCaloHit, SimTrack, ...).
+  template<typename T, typename Enable = void>
+  struct PileUpProductSize {
+    static constexpr bool known = false;
+  };
+
+  template<typename T>
+  struct PileUpProductSize<std::vector<T>, typename std::enable_if<std::is_trivially_destructible<T>::value>::type> {
+    static constexpr bool known = true;
+    static size_t size(std::vector<T> const& v) {return sizeof(v) + v.capacity()*sizeof(T);}
+  };
+
+  class PileUpProductCache {
+  public:
+    struct Key {
+      Key(size_t fileNameHash, EventID const& id, std::string const& product) :
+        fileNameHash_(fileNameHash), id_(id), product_(product) {}
+      size_t fileNameHash_;
+      EventID id_;
+      std::string product_;
+      bool operator<(Key const& other) const;
+    };
+
+    struct Entry {
+      std::shared_ptr<void const> product_;
+      Provenance provenance_;
+      size_t bytes_;
+    };
+
+    explicit PileUpProductCache(size_t maxBytes);
+    PileUpProductCache(PileUpProductCache const&) = delete;
+    PileUpProductCache& operator=(PileUpProductCache const&) = delete;
+
+    /// Returns the cached entry, or a null pointer on a miss. The returned
+    /// entry stays valid as long as the caller holds it, even if evicted.
+    std::shared_ptr<Entry const> find(Key const& key);
+
+    /// Inserts a product; entries are evicted in LRU order until the
+    /// memory budget is respected. Products larger than the budget are not cached.
+    void insert(Key const& key, std::shared_ptr<void const> product, Provenance const& provenance, size_t bytes);
+
+    size_t maxBytes() const {return maxBytes_;}
+    size_t usedBytes() const;
+    unsigned long long hits() const {return hits_;}
+    unsigned long long misses() const {return misses_;}
+
+  private:
+    typedef std::list<Key> LRUList;
+    struct Slot {
+      std::shared_ptr<Entry const> entry_;
+      LRUList::iterator lru_;
+    };
+
+    void evict();
+
+    size_t const maxBytes_;
+    size_t usedBytes_;
+    std::map<Key, Slot> entries_;
+    LRUList lru_; // front is most recently used
+    mutable std::mutex mutex_;
+    std::atomic<unsigned long long> hits_;
+    std::atomic<unsigned long long> misses_;
+  };
+
+}
+
+#endif
@@ -154,6 +154,12 @@ namespace
 	    }
 	  }
 	}
+	// optional process-wide cache of deserialized pileup products, shared by all streams
+	unsigned int cacheSizeMB = psin.getUntrackedParameter<unsigned int>("productCacheSizeMB", 0);
+	if (pileupconfig && cacheSizeMB > 0) {
+	  pileupconfig->productCache_ = std::make_shared<edm::PileUpProductCache>(static_cast<size_t>(cacheSizeMB) << 20);
+	  edm::LogInfo("MixingModule") <<" Source "<<sourceName<<" will cache up to "<<cacheSizeMB<<" MB of pileup products";
+	}
       }
     return pileupconfig;
   }
@@ -84,6 +84,7 @@ namespace edm {
     lumiPrincipal_(),
     runPrincipal_(),
     provider_(),
+    productCache_(config->productCache_),
     PoissonDistribution_(),
     PoissonDistr_OOT_(),
     randomEngine_(),
@@ -0,0 +1,70 @@
+#include "Mixing/Base/interface/PileUpProductCache.h"
+
+namespace edm {
+
+  bool PileUpProductCache::Key::operator<(Key const& other) const {
+    if(fileNameHash_ != other.fileNameHash_) return fileNameHash_ < other.fileNameHash_;
+    if(id_ != other.id_) return id_ < other.id_;
+    return product_ < other.product_;
+  }
+
+  PileUpProductCache::PileUpProductCache(size_t maxBytes) :
+    maxBytes_(maxBytes),
+    usedBytes_(0U),
+    entries_(),
+    lru_(),
+    mutex_(),
+    hits_(0U),
+    misses_(0U) {
+  }
+
+  std::shared_ptr<PileUpProductCache::Entry const>
+  PileUpProductCache::find(Key const& key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = entries_.find(key);
+    if(it == entries_.end()) {
+      ++misses_;
+      return std::shared_ptr<Entry const>();
+    }
+    ++hits_;
+    lru_.splice(lru_.begin(), lru_, it->second.lru_);
+    return it->second.entry_;
+  }
+
+  void
+  PileUpProductCache::insert(Key const& key, std::shared_ptr<void const> product, Provenance const& provenance, size_t bytes) {
+    if(bytes > maxBytes_) return;
+    auto entry = std::make_shared<Entry>();
+    entry->product_ = std::move(product);
+    // Only keep the parts of the provenance that do not refer to the
+    // EventPrincipal of the stream which read the product.
+    entry->provenance_ = Provenance(provenance.constBranchDescriptionPtr(), provenance.productID());
+    entry->bytes_ = bytes;
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if(entries_.find(key) != entries_.end()) {
+      // Another stream was faster.
+      return;
+    }
+    lru_.push_front(key);
+    entries_.emplace(key, Slot{std::move(entry), lru_.begin()});
+    usedBytes_ += bytes;
+    evict();
+  }
+
+  size_t
+  PileUpProductCache::usedBytes() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return usedBytes_;
+  }
+
+  void
+  PileUpProductCache::evict() {
+    while(usedBytes_ > maxBytes_ && !lru_.empty()) {
+      auto it = entries_.find(lru_.back());
+      usedBytes_ -= it->second.entry_->bytes_;
+      entries_.erase(it);
+      lru_.pop_back();
+    }
+  }
+}
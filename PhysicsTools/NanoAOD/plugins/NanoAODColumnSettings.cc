@@ -0,0 +1,78 @@
+#include "PhysicsTools/NanoAOD/plugins/NanoAODColumnSettings.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/RegexMatch.h"
+
+#include "TBranch.h"
+#include "Compression.h"
+
+NanoAODColumnSettings::NanoAODColumnSettings(const std::vector<edm::ParameterSet> & rules)
+{
+    for (const auto & pset : rules) {
+        Rule rule;
+        for (const auto & glob : pset.getUntrackedParameter<std::vector<std::string>>("branches")) {
+            rule.patterns.emplace_back(edm::glob2reg(glob));
+        }
+        const std::string & algorithm = pset.getUntrackedParameter<std::string>("compressionAlgorithm");
+        rule.compressionSettings = algorithm.empty() ? -1 : compressionSettings(algorithm, pset.getUntrackedParameter<int>("compressionLevel"));
+        rule.mantissaBits = pset.getUntrackedParameter<int>("mantissaBits");
+        if (rule.mantissaBits < -1 || rule.mantissaBits > 23) {
+            throw cms::Exception("Configuration") << "NanoAODOutputModule configured with mantissaBits " << rule.mantissaBits << ", it must be -1 or between 0 and 23\n";
+        }
+        // 23 bits is the full float precision, which the rounding can not be asked for
+        if (rule.mantissaBits == 23) rule.mantissaBits = -1;
+        m_rules.push_back(std::move(rule));
+    }
+}
+
+void
+NanoAODColumnSettings::fillDescription(edm::ParameterSetDescription & desc)
+{
+    edm::ParameterSetDescription rule;
+    rule.addUntracked<std::vector<std::string>>("branches")
+        ->setComment("Glob patterns of the branch names this rule applies to, e.g. 'Jet_*'");
+    rule.addUntracked<std::string>("compressionAlgorithm", "")
+        ->setComment("ZLIB, LZMA or LZ4 for these branches; empty to use the file setting");
+    rule.addUntracked<int>("compressionLevel", 4)
+        ->setComment("Compression level used with compressionAlgorithm");
+    rule.addUntracked<int>("mantissaBits", -1)
+        ->setComment("Float columns are rounded to this many mantissa bits (0 to 23) when written; -1 or 23 keeps full precision");
+    desc.addVPSetUntracked("columnSettings", rule, std::vector<edm::ParameterSet>())
+        ->setComment("Per-column compression and precision, the first rule matching a branch name is used");
+}
+
+int
+NanoAODColumnSettings::compressionSettings(const std::string & algorithm, int level)
+{
+    if (algorithm == "ZLIB") return ROOT::CompressionSettings(ROOT::kZLIB, level);
+    if (algorithm == "LZMA") return ROOT::CompressionSettings(ROOT::kLZMA, level);
+    if (algorithm == "LZ4") return ROOT::CompressionSettings(ROOT::kLZ4, level);
+    throw cms::Exception("Configuration") << "NanoAODOutputModule configured with unknown compression algorithm '" << algorithm << "'\n"
+                                          << "Allowed compression algorithms are ZLIB, LZMA and LZ4\n";
+}
+
+const NanoAODColumnSettings::Rule *
+NanoAODColumnSettings::find(const std::string & branchName) const
+{
+    for (const auto & rule : m_rules) {
+        for (const auto & pattern : rule.patterns) {
+            if (std::regex_match(branchName, pattern)) return & rule;
+        }
+    }
+    return nullptr;
+}
+
+void
+NanoAODColumnSettings::apply(TBranch & branch) const
+{
+    const Rule * rule = find(branch.GetName());
+    if (rule && rule->compressionSettings >= 0) branch.SetCompressionSettings(rule->compressionSettings);
+}
+
+int
+NanoAODColumnSettings::mantissaBits(const std::string & branchName) const
+{
+    const Rule * rule = find(branchName);
+    return rule ? rule->mantissaBits : -1;
+}
@@ -0,0 +1,43 @@
+#ifndef PhysicsTools_NanoAOD_NanoAODColumnSettings_h
+#define PhysicsTools_NanoAOD_NanoAODColumnSettings_h
+
+#include <regex>
+#include <string>
+#include <vector>
+
+class TBranch;
+namespace edm {
+    class ParameterSet;
+    class ParameterSetDescription;
+}
+
+/// Per-column output settings of the NanoAODOutputModule.
+/// Each rule applies to the branches whose name matches one of its glob patterns,
+/// the first matching rule wins; unmatched branches keep the file settings.
+class NanoAODColumnSettings {
+ public:
+    NanoAODColumnSettings() {}
+    explicit NanoAODColumnSettings(const std::vector<edm::ParameterSet> & rules) ;
+
+    static void fillDescription(edm::ParameterSetDescription & desc) ;
+
+    /// ROOT compression settings for the given algorithm name (ZLIB, LZMA or LZ4) and level
+    static int compressionSettings(const std::string & algorithm, int level) ;
+
+    /// sets the compression of the branch, if a rule with a codec matches its name
+    void apply(TBranch & branch) const ;
+    /// mantissa bits to keep for a float column, -1 to keep it as it is
+    int mantissaBits(const std::string & branchName) const ;
+
+ private:
+    struct Rule {
+        std::vector<std::regex> patterns;
+        int compressionSettings; // -1 if the file settings are kept
+        int mantissaBits;        // -1 if the column is not truncated
+    };
+    const Rule * find(const std::string & branchName) const ;
+
+    std::vector<Rule> m_rules;
+};
+
+#endif
@@ -36,6 +36,7 @@
 #include "DataFormats/Provenance/interface/ProcessHistoryRegistry.h"
 #include "DataFormats/NanoAOD/interface/FlatTable.h"
 #include "DataFormats/NanoAOD/interface/UniqueString.h"
+#include "PhysicsTools/NanoAOD/plugins/NanoAODColumnSettings.h"
 #include "PhysicsTools/NanoAOD/plugins/TableOutputBranches.h"
 #include "PhysicsTools/NanoAOD/plugins/TriggerOutputBranches.h"
 #include "PhysicsTools/NanoAOD/plugins/SummaryTableOutputBranches.h"
@@ -65,6 +66,8 @@ private:
   bool m_writeProvenance;
   bool m_fakeName; //crab workaround, remove after crab is fixed
   int m_autoFlush;
+  bool m_parallelCompression;
+  NanoAODColumnSettings m_columnSettings;
   edm::ProcessHistoryRegistry m_processHistoryRegistry;
   edm::JobReport::Token m_jrToken;
   std::unique_ptr<TFile> m_file;
@@ -144,6 +147,8 @@ NanoAODOutputModule::NanoAODOutputModule(edm::ParameterSet const& pset):
   m_writeProvenance(pset.getUntrackedParameter<bool>("saveProvenance", true)),
   m_fakeName(pset.getUntrackedParameter<bool>("fakeNameForCrab", false)),
   m_autoFlush(pset.getUntrackedParameter<int>("autoFlush", -10000000)),
+  m_parallelCompression(pset.getUntrackedParameter<bool>("parallelCompression")),
+  m_columnSettings(pset.getUntrackedParameterSetVector("columnSettings")),
   m_processHistoryRegistry()
 {
 }
@@ -261,14 +266,7 @@ NanoAODOutputModule::openFile(edm::FileBlock const&) {
                                    std::vector<std::string>()
                                    );
 
-  if (m_compressionAlgorithm == std::string("ZLIB")) {
-      m_file->SetCompressionAlgorithm(ROOT::kZLIB);
-    } else if (m_compressionAlgorithm == std::string("LZMA")) {
-      m_file->SetCompressionAlgorithm(ROOT::kLZMA);
-    } else {
-      throw cms::Exception("Configuration") << "NanoAODOutputModule configured with unknown compression algorithm '" << m_compressionAlgorithm << "'\n"
-					     << "Allowed compression algorithms are ZLIB and LZMA\n";
-    }
+  m_file->SetCompressionSettings(NanoAODColumnSettings::compressionSettings(m_compressionAlgorithm, m_compressionLevel));
   /* Setup file structure here */
   m_tables.clear();
   m_triggers.clear();
@@ -276,10 +274,10 @@ NanoAODOutputModule::openFile(edm::FileBlock const&) {
   const auto & keeps = keptProducts();
   for (const auto & keep : keeps[edm::InEvent]) {
       if(keep.first->className() == "nanoaod::FlatTable" )
-	      m_tables.emplace_back(keep.first, keep.second);
+	      m_tables.emplace_back(keep.first, keep.second, m_columnSettings);
       else if(keep.first->className() == "edm::TriggerResults" )
 	  {
-	      m_triggers.emplace_back(keep.first, keep.second);
+	      m_triggers.emplace_back(keep.first, keep.second, m_columnSettings);
 	  }
       else throw cms::Exception("Configuration", "NanoAODOutputModule cannot handle class " + keep.first->className());     
   }
@@ -297,6 +295,8 @@ NanoAODOutputModule::openFile(edm::FileBlock const&) {
   m_tree.reset(new TTree("Events","Events"));
   m_tree->SetAutoSave(0);
   m_tree->SetAutoFlush(0);
+  // with ROOT implicit MT, Fill and FlushBaskets compress the baskets of the columns in parallel tasks
+  m_tree->SetImplicitMT(m_parallelCompression);
   m_commonBranches.branch(*m_tree);
 
   m_lumiTree.reset(new TTree("LuminosityBlocks","LuminosityBlocks"));
@@ -349,13 +349,16 @@ NanoAODOutputModule::fillDescriptions(edm::ConfigurationDescriptions& descriptio
   desc.addUntracked<int>("compressionLevel", 9)
         ->setComment("ROOT compression level of output file.");
   desc.addUntracked<std::string>("compressionAlgorithm", "ZLIB")
-        ->setComment("Algorithm used to compress data in the ROOT output file, allowed values are ZLIB and LZMA");
+        ->setComment("Algorithm used to compress data in the ROOT output file, allowed values are ZLIB, LZMA and LZ4");
   desc.addUntracked<bool>("saveProvenance", true)
         ->setComment("Save process provenance information, e.g. for edmProvDump");
   desc.addUntracked<bool>("fakeNameForCrab", false)
         ->setComment("Change the OutputModule name in the fwk job report to fake PoolOutputModule. This is needed to run on cran (and publish) till crab is fixed");
   desc.addUntracked<int>("autoFlush", -10000000)
         ->setComment("Autoflush parameter for ROOT file");
+  desc.addUntracked<bool>("parallelCompression", true)
+        ->setComment("Compress the baskets of different columns in parallel tasks when ROOT implicit MT is enabled");
+  NanoAODColumnSettings::fillDescription(desc);
 
   //replace with whatever you want to get from the EDM by default
   const std::vector<std::string> keep = {"drop *", "keep nanoaodFlatTable_*Table_*_*", "keep edmTriggerResults_*_*_*", "keep nanoaodMergeableCounterTable_*Table_*_*", "keep nanoaodUniqueString_nanoMetadata_*_*"};
@@ -49,6 +49,7 @@ TableOutputBranches::branch(TTree &tree)
             }
             m_counterBranch = tree.Branch(("n"+m_baseName).c_str(), & m_counter, ("n"+m_baseName + "/i").c_str());
             m_counterBranch->SetTitle(m_doc.c_str());
+            m_settings->apply(*m_counterBranch);
         }
     }
     std::string varsize = m_singleton ? "" : "[n" + m_baseName + "]";
@@ -57,6 +58,8 @@ TableOutputBranches::branch(TTree &tree)
             std::string branchName = makeBranchName(m_baseName, pair.name);
             pair.branch = tree.Branch(branchName.c_str(), (void*)nullptr, (branchName + varsize + "/" + pair.rootTypeCode).c_str());
             pair.branch->SetTitle(pair.title.c_str());
+            m_settings->apply(*pair.branch);
+            if (pair.rootTypeCode == "F") pair.mantissaBits = m_settings->mantissaBits(branchName);
         }
     }
 }
@@ -85,7 +88,7 @@ void TableOutputBranches::fill(const edm::EventForOutput &iEvent, TTree & tree,
             throw cms::Exception("LogicError", "Mismatch in number of entries between extension and main table for " + tab.name());
         }
     }
-    for (auto & pair : m_floatBranches) fillColumn<float>(pair, tab);
+    for (auto & pair : m_floatBranches) fillFloatColumn(pair, tab);
     for (auto & pair : m_intBranches) fillColumn<int>(pair, tab);
     for (auto & pair : m_uint8Branches) fillColumn<uint8_t>(pair, tab);
 }
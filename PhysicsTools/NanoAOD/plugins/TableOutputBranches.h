@@ -1,6 +1,7 @@
 #ifndef PhysicsTools_NanoAOD_TableOutputBranches_h
 #define PhysicsTools_NanoAOD_TableOutputBranches_h
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <TTree.h>
@@ -8,11 +9,13 @@
 #include "DataFormats/NanoAOD/interface/FlatTable.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
 #include "FWCore/Utilities/interface/EDGetToken.h"
+#include "DataFormats/Math/interface/libminifloat.h"
+#include "PhysicsTools/NanoAOD/plugins/NanoAODColumnSettings.h"
 
 class TableOutputBranches {
  public:
-    TableOutputBranches(const edm::BranchDescription *desc, const edm::EDGetToken & token ) :
-        m_token(token), m_extension(DontKnowYetIfMainOrExtension), m_branchesBooked(false)
+    TableOutputBranches(const edm::BranchDescription *desc, const edm::EDGetToken & token, const NanoAODColumnSettings & settings ) :
+        m_token(token), m_settings(&settings), m_extension(DontKnowYetIfMainOrExtension), m_branchesBooked(false)
     {
         if (desc->className() != "nanoaod::FlatTable") throw cms::Exception("Configuration", "NanoAODOutputModule can only write out nanoaod::FlatTable objects");
     }
@@ -26,6 +29,7 @@ class TableOutputBranches {
 
  private:
     edm::EDGetToken m_token;
+    const NanoAODColumnSettings * m_settings;
     std::string  m_baseName;
     bool         m_singleton;
     enum { IsMain=0, IsExtension=1, DontKnowYetIfMainOrExtension=2 } m_extension;
@@ -34,8 +38,10 @@ class TableOutputBranches {
     struct NamedBranchPtr {
         std::string name, title, rootTypeCode;
         TBranch * branch;
+        int mantissaBits; // >= 0 if the column is rounded into buffer before being written
+        std::vector<float> buffer;
         NamedBranchPtr(const std::string & aname, const std::string & atitle, const std::string & rootType, TBranch *branchptr = nullptr) : 
-            name(aname), title(atitle), rootTypeCode(rootType), branch(branchptr) {}
+            name(aname), title(atitle), rootTypeCode(rootType), branch(branchptr), mantissaBits(-1) {}
     };
     TBranch * m_counterBranch;
     std::vector<NamedBranchPtr> m_floatBranches;
@@ -50,6 +56,16 @@ class TableOutputBranches {
         pair.branch->SetAddress( const_cast<T *>(& tab.columnData<T>(idx).front() ) ); // SetAddress should take a const * !
     }
 
+    void fillFloatColumn(NamedBranchPtr & pair, const nanoaod::FlatTable & tab) {
+        if (pair.mantissaBits < 0) return fillColumn<float>(pair, tab);
+        int idx = tab.columnIndex(pair.name);
+        if (idx == -1) throw cms::Exception("LogicError", "Missing column in input for "+m_baseName+"_"+pair.name);
+        const auto & data = tab.columnData<float>(idx);
+        pair.buffer.resize(std::max<size_t>(data.size(), 1)); // keep a valid address for empty tables
+        MiniFloatConverter::reduceMantissaToNbitsRounding(pair.mantissaBits, data.begin(), data.end(), pair.buffer.begin());
+        pair.branch->SetAddress( pair.buffer.data() );
+    }
+
 };
 
 #endif
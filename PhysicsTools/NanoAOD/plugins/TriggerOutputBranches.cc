@@ -41,6 +41,7 @@ TriggerOutputBranches::updateTriggerNames(TTree & tree, const edm::TriggerNames
                 uint8_t backFillValue=-1;
                 nb.branch= tree.Branch(nb.name.c_str(), &backFillValue, (name + "/O").c_str()); 
                 nb.branch->SetTitle(nb.title.c_str());
+                m_settings->apply(*nb.branch);
                 nb.idx=j;
                 m_triggerBranches.push_back(nb);
                 for(size_t i=0;i<m_fills;i++) nb.branch->Fill(); // Back fill
@@ -9,11 +9,12 @@
 #include "FWCore/Common/interface/TriggerNames.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
 #include "FWCore/Utilities/interface/EDGetToken.h"
+#include "PhysicsTools/NanoAOD/plugins/NanoAODColumnSettings.h"
 
 class TriggerOutputBranches {
  public:
-    TriggerOutputBranches(const edm::BranchDescription *desc, const edm::EDGetToken & token ) :
-        m_token(token), m_lastRun(-1),m_fills(0)
+    TriggerOutputBranches(const edm::BranchDescription *desc, const edm::EDGetToken & token, const NanoAODColumnSettings & settings ) :
+        m_token(token), m_settings(&settings), m_lastRun(-1),m_fills(0)
     {
         if (desc->className() != "edm::TriggerResults") throw cms::Exception("Configuration", "NanoAODOutputModule/TriggerOutputBranches can only write out edm::TriggerResults objects");
     }
@@ -25,6 +26,7 @@ class TriggerOutputBranches {
     edm::TriggerNames triggerNames(const edm::TriggerResults triggerResults); //FIXME: if we have to keep it local we may use PsetID check per event instead of run boundary
 
     edm::EDGetToken m_token;
+    const NanoAODColumnSettings * m_settings;
     std::string  m_baseName;
     bool         m_singleton;
     UInt_t       m_counter;
@@ -0,0 +1,94 @@
+#!/usr/bin/env python
+
+# Read/write throughput of the Events tree of a NanoAOD file for several
+# compression configurations of the NanoAODOutputModule.
+# Each configuration copies the tree into a new file, with the file codec,
+# the per-column codecs (as in the columnSettings parameter of the module)
+# and parallel basket compression, then reads all columns back.
+#
+# This is a manual tool, not part of the unit tests: its timings depend on
+# the machine and its load. Run it on a NanoAOD file, e.g. the one made by
+# runtests.sh:
+#   python nanoIOBenchmark.py -j 4 test94Xv2_NANO.root
+
+from __future__ import print_function
+import sys, os, time, fnmatch
+from optparse import OptionParser
+import ROOT
+ROOT.PyConfig.IgnoreCommandLineOptions = True
+ROOT.gROOT.SetBatch(True)
+
+# (name, file algorithm, file level, [(branch globs, algorithm, level)])
+hotColumns = ["run", "luminosityBlock", "event", "n*", "*_pt", "*_eta", "*_phi", "*_mass", "*_charge", "HLT_*", "Flag_*"]
+configurations = [
+    ("ZLIB-9",          "ZLIB", 9, []),
+    ("LZMA-9",          "LZMA", 9, []),
+    ("LZ4-4",           "LZ4",  4, []),
+    ("hotLZ4-restLZMA", "LZMA", 9, [(hotColumns, "LZ4", 4)]),
+]
+
+algorithms = { "ZLIB" : ROOT.ROOT.kZLIB, "LZMA" : ROOT.ROOT.kLZMA, "LZ4" : ROOT.ROOT.kLZ4 }
+
+def compression(algo, level):
+    return ROOT.ROOT.CompressionSettings(algorithms[algo], level)
+
+def write(tree, fileName, config, parallel):
+    name, algo, level, columns = config
+    fout = ROOT.TFile(fileName, "RECREATE", "", compression(algo, level))
+    out = tree.CloneTree(0)
+    out.SetImplicitMT(parallel)
+    for b in out.GetListOfBranches():
+        for (globs, calgo, clevel) in columns:
+            if any(fnmatch.fnmatchcase(b.GetName(), g) for g in globs):
+                b.SetCompressionSettings(compression(calgo, clevel))
+                break
+    start = time.time()
+    for i in range(tree.GetEntries()):
+        tree.GetEntry(i)
+        out.Fill()
+    out.Write()
+    elapsed = time.time() - start
+    totBytes, zipBytes = out.GetTotBytes(), out.GetZipBytes()
+    fout.Close()
+    return elapsed, totBytes, zipBytes
+
+def read(fileName):
+    fin = ROOT.TFile.Open(fileName)
+    tree = fin.Get("Events")
+    start = time.time()
+    for i in range(tree.GetEntries()):
+        tree.GetEntry(i)
+    elapsed = time.time() - start
+    fin.Close()
+    return elapsed
+
+if __name__ == "__main__":
+    parser = OptionParser(usage="%prog [options] nanoaod.root")
+    parser.add_option("-j", "--threads", dest="threads", type="int", default=4, help="number of threads for implicit MT (default %default, 1 to disable)")
+    parser.add_option("-o", "--outdir", dest="outdir", default=".", help="directory for the temporary output files")
+    parser.add_option("-k", "--keep", dest="keep", action="store_true", default=False, help="keep the output files")
+    (options, args) = parser.parse_args()
+    if len(args) != 1:
+        parser.print_help()
+        sys.exit(1)
+
+    if options.threads > 1:
+        ROOT.ROOT.EnableImplicitMT(options.threads)
+    fin = ROOT.TFile.Open(args[0])
+    tree = fin.Get("Events")
+    nevents = tree.GetEntries()
+    if nevents == 0:
+        print("No events in %s" % args[0])
+        sys.exit(1)
+
+    print("%d events, %.1f MB uncompressed, %d threads" % (nevents, tree.GetTotBytes()/1024.0**2, options.threads))
+    print("%-16s %9s %10s %10s %12s %12s" % ("configuration", "size(MB)", "ratio", "kB/event", "write(MB/s)", "read(MB/s)"))
+    for config in configurations:
+        fileName = os.path.join(options.outdir, "nanoIOBenchmark_%s.root" % config[0])
+        twrite, totBytes, zipBytes = write(tree, fileName, config, options.threads > 1)
+        tread = read(fileName)
+        mb = totBytes/1024.0**2
+        print("%-16s %9.2f %10.2f %10.2f %12.1f %12.1f" % (config[0], zipBytes/1024.0**2, totBytes/float(max(zipBytes,1)),
+                                                          zipBytes/1024.0/nevents, mb/twrite, mb/tread))
+        if not options.keep:
+            os.remove(fileName)
@@ -11,6 +11,7 @@
 #include "DataFormats/RecoCandidate/interface/RecoCandidate.h"
 #include "PhysicsTools/PatUtils/interface/StringParserTools.h"
 #include "PhysicsTools/PatUtils/interface/PATDiObjectProxy.h"
+#include "CommonTools/Utils/interface/DeltaRMatcher.h"
 
 namespace pat { namespace helper {
 
@@ -48,7 +49,9 @@ class BasicOverlapTest : public OverlapTest {
             presel_(iConfig.getParameter<std::string>("preselection")),
             deltaR_(iConfig.getParameter<double>("deltaR")),
             checkRecoComponents_(iConfig.getParameter<bool>("checkRecoComponents")),
-            pairCut_(iConfig.getParameter<std::string>("pairCut")) {}
+            pairCut_(iConfig.getParameter<std::string>("pairCut")),
+            // loose enough to keep all the pairs with deltaR < deltaR_, which is checked for each of them
+            preselMatcher_(deltaR_*deltaR_*(1 + 1e-12)) {}
         // implementation of mother methods
         /// Read input, apply preselection cut
         void readInput(const edm::Event & iEvent, const edm::EventSetup &iSetup) override ;
@@ -69,6 +72,9 @@ class BasicOverlapTest : public OverlapTest {
         edm::Handle<reco::CandidateView> candidates_;
         /// Flag saying if each element has passed the preselection or not
         std::vector<bool> isPreselected_;
+        /// Eta and phi of the preselected elements, and their index in the collection
+        reco::DeltaRMatcher<double> preselMatcher_;
+        std::vector<size_t> preselIndices_;
 };
 
 class OverlapBySuperClusterSeed : public OverlapTest {
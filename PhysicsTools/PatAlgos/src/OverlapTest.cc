@@ -1,7 +1,7 @@
 #include "PhysicsTools/PatAlgos/interface/OverlapTest.h"
 
 #include <algorithm>
-#include "DataFormats/Math/interface/deltaR.h"
+#include <cmath>
 #include "DataFormats/Candidate/interface/OverlapChecker.h"
 
 using namespace pat::helper;
@@ -11,10 +11,17 @@ BasicOverlapTest::readInput(const edm::Event & iEvent, const edm::EventSetup &iS
 {
     iEvent.getByToken(srcToken_, candidates_);
     isPreselected_.resize(candidates_->size());
+    reco::EtaPhiPtSoA<double> preselected;
+    preselIndices_.clear();
     size_t idx = 0;
     for (reco::CandidateView::const_iterator it = candidates_->begin(); it != candidates_->end(); ++it, ++idx) {
         isPreselected_[idx] = presel_(*it);
+        if (isPreselected_[idx]) {
+            preselected.push_back(*it);
+            preselIndices_.push_back(idx);
+        }
     }
+    preselMatcher_.setTargets(std::move(preselected));
     // Yes, I could use std::transform. But would people like it?
     // http://www.sgi.com/tech/stl/transform.html
 }
@@ -22,20 +29,22 @@ BasicOverlapTest::readInput(const edm::Event & iEvent, const edm::EventSetup &iS
 bool
 BasicOverlapTest::fillOverlapsForItem(const reco::Candidate &item, reco::CandidatePtrVector &overlapsToFill) const
 {
-    size_t idx = 0;
     std::vector<std::pair<float,size_t> > matches;
-    for (reco::CandidateView::const_iterator it = candidates_->begin(); it != candidates_->end(); ++it, ++idx) {
-        if (!isPreselected_[idx]) continue;
-        double dr = reco::deltaR(item, *it);
+    // only the preselected candidates close to the item, in no particular order (they are sorted below)
+    preselMatcher_.forEachMatch(item.eta(), item.phi(), [&](unsigned ipresel, double dr2) {
+        // same as reco::deltaR(item, *it)
+        double dr = std::sqrt(dr2);
         if (dr < deltaR_) {
+            size_t idx = preselIndices_[ipresel];
+            const reco::Candidate & cand = (*candidates_)[idx];
             if (checkRecoComponents_) {
                 OverlapChecker overlaps;
-                if (!overlaps(item, *it)) continue;
+                if (!overlaps(item, cand)) return;
             }
-            if (!pairCut_(pat::DiObjectProxy(item,*it))) continue;
+            if (!pairCut_(pat::DiObjectProxy(item,cand))) return;
             matches.push_back(std::make_pair(dr, idx));
         }
-    }
+    });
     // see if we matched anything
     if (matches.empty()) return false;
 
@@ -0,0 +1,106 @@
+/*
+ * Session wrapper that coalesces the inference requests of concurrent callers into batches.
+ * Based on TensorFlow C++ API 1.3.
+ */
+
+#ifndef PHYSICSTOOLS_TENSORFLOW_BATCHEDSESSION_H
+#define PHYSICSTOOLS_TENSORFLOW_BATCHEDSESSION_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+
+#include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+
+namespace tensorflow
+{
+
+// Runs a session on behalf of many callers, e.g. the streams of a job: a request holds one or more
+// rows, i.e. the inputs with the batch dimension first, and is answered asynchronously. The
+// requests waiting at the time a session call can start are concatenated along the batch
+// dimension, up to maxBatchSize rows, the session is run once, and the outputs are split again and
+// handed back to each caller. A batch is started as soon as it is full, or when its oldest request
+// waited for maxLatency. The session calls run on nConcurrentRuns dedicated threads, so that the
+// threads of a model are the number of concurrent runs times the threads of its session.
+// The session is not owned.
+class BatchedSession
+{
+public:
+    typedef std::function<void(std::exception_ptr)> Callback;
+
+    // constants are fed unchanged to every call, e.g. the learning phase flags
+    BatchedSession(Session* session, const std::vector<std::string>& inputNames,
+        const std::vector<std::string>& outputNames, const NamedTensorList& constants,
+        unsigned int maxBatchSize, std::chrono::microseconds maxLatency,
+        unsigned int nConcurrentRuns = 1);
+
+    // runs the remaining requests, then stops the threads
+    ~BatchedSession();
+
+    BatchedSession(const BatchedSession&) = delete;
+    BatchedSession& operator=(const BatchedSession&) = delete;
+
+    // queue the inputs, one tensor per input name, all with the same number of rows; the outputs,
+    // one tensor per output name with the rows of the request, are stored before the callback is
+    // called, from one of the threads of the session; the outputs must stay valid until then
+    // throws a cms exception when the inputs are not consistent
+    void runAsync(const std::vector<Tensor>& inputs, std::vector<Tensor>* outputs,
+        Callback callback);
+
+    // same, for the acquire step of an edm::ExternalWork module
+    void runAsync(const std::vector<Tensor>& inputs, std::vector<Tensor>* outputs,
+        edm::WaitingTaskWithArenaHolder holder);
+
+    // runs the remaining requests and joins the threads, called by the destructor
+    void stop();
+
+    const std::vector<std::string>& inputNames() const { return inputNames_; }
+    const std::vector<std::string>& outputNames() const { return outputNames_; }
+
+    // numbers of requests, rows and session calls so far
+    unsigned long nRequests() const { return nRequests_; }
+    unsigned long nRows() const { return nRows_; }
+    unsigned long nBatches() const { return nBatches_; }
+
+private:
+    struct Request
+    {
+        std::vector<Tensor> inputs;
+        std::vector<Tensor>* outputs;
+        Callback callback;
+        int64 rows;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    void work();
+    void runBatch(std::vector<Request>& batch);
+
+    Session* session_;
+    const std::vector<std::string> inputNames_;
+    const std::vector<std::string> outputNames_;
+    const NamedTensorList constants_;
+    const int64 maxBatchSize_;
+    const std::chrono::microseconds maxLatency_;
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<Request> queue_;
+    int64 queuedRows_;
+    bool stopping_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<unsigned long> nRequests_;
+    std::atomic<unsigned long> nRows_;
+    std::atomic<unsigned long> nBatches_;
+};
+
+} // namespace tensorflow
+
+#endif // PHYSICSTOOLS_TENSORFLOW_BATCHEDSESSION_H
@@ -0,0 +1,60 @@
+/*
+ * Service running the inference of TensorFlow graphs on behalf of the modules of all streams.
+ * Based on TensorFlow C++ API 1.3.
+ */
+
+#ifndef PHYSICSTOOLS_TENSORFLOW_INFERENCESERVICE_H
+#define PHYSICSTOOLS_TENSORFLOW_INFERENCESERVICE_H
+
+#include <map>
+#include <memory>
+
+#include "PhysicsTools/TensorFlow/interface/BatchedSession.h"
+
+namespace edm
+{
+class ActivityRegistry;
+class ConfigurationDescriptions;
+class ParameterSet;
+} // namespace edm
+
+namespace tensorflow
+{
+
+// Each configured model gets its graph loaded once, its own session and a BatchedSession that
+// coalesces the requests of all streams. A module with the edm::ExternalWork ability looks its
+// model up once in the constructor, fills the input tensors in acquire and queues them,
+//
+//     model_ = &edm::Service<tensorflow::InferenceService>()->model("deepFlavour");
+//     ...
+//     model_->runAsync(inputs, &outputs_, holder);
+//
+// and reads its rows of the output tensors in produce. The session calls of a model use
+// concurrentRuns threads of the service, each running a session with nThreads threads.
+class InferenceService
+{
+public:
+    InferenceService(const edm::ParameterSet& pset, edm::ActivityRegistry& registry);
+    ~InferenceService();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+    // throws a cms exception when the model is not configured
+    BatchedSession& model(const std::string& name);
+
+private:
+    struct Model
+    {
+        std::unique_ptr<GraphDef> graphDef;
+        Session* session;
+        std::unique_ptr<BatchedSession> batchedSession;
+    };
+
+    void postEndJob();
+
+    std::map<std::string, Model> models_;
+};
+
+} // namespace tensorflow
+
+#endif // PHYSICSTOOLS_TENSORFLOW_INFERENCESERVICE_H
@@ -0,0 +1,6 @@
+#include "FWCore/ServiceRegistry/interface/ServiceMaker.h"
+
+#include "PhysicsTools/TensorFlow/interface/InferenceService.h"
+
+typedef tensorflow::InferenceService TFInferenceService;
+DEFINE_FWK_SERVICE(TFInferenceService);
@@ -0,0 +1,279 @@
+/*
+ * Session wrapper that coalesces the inference requests of concurrent callers into batches.
+ * Based on TensorFlow C++ API 1.3.
+ */
+
+#include "PhysicsTools/TensorFlow/interface/BatchedSession.h"
+
+#include "tensorflow/core/framework/tensor_util.h"
+
+namespace tensorflow
+{
+
+namespace
+{
+
+// requests can be concatenated when their inputs only differ by the number of rows
+bool concatenable(const std::vector<Tensor>& inputs1, const std::vector<Tensor>& inputs2)
+{
+    for (size_t i = 0; i < inputs1.size(); i++)
+    {
+        const Tensor& t1 = inputs1[i];
+        const Tensor& t2 = inputs2[i];
+        if (t1.dtype() != t2.dtype() || t1.dims() != t2.dims())
+        {
+            return false;
+        }
+        for (int d = 1; d < t1.dims(); d++)
+        {
+            if (t1.dim_size(d) != t2.dim_size(d))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+BatchedSession::BatchedSession(Session* session, const std::vector<std::string>& inputNames,
+    const std::vector<std::string>& outputNames, const NamedTensorList& constants,
+    unsigned int maxBatchSize, std::chrono::microseconds maxLatency, unsigned int nConcurrentRuns)
+    : session_(session)
+    , inputNames_(inputNames)
+    , outputNames_(outputNames)
+    , constants_(constants)
+    , maxBatchSize_(maxBatchSize)
+    , maxLatency_(maxLatency)
+    , queuedRows_(0)
+    , stopping_(false)
+    , nRequests_(0)
+    , nRows_(0)
+    , nBatches_(0)
+{
+    if (session_ == nullptr)
+    {
+        throw cms::Exception("InvalidSession") << "cannot batch the requests of an empty session";
+    }
+    if (inputNames_.empty())
+    {
+        throw cms::Exception("InvalidInput") << "a batched session needs at least one input";
+    }
+    if (maxBatchSize == 0 || nConcurrentRuns == 0)
+    {
+        throw cms::Exception("InvalidBatching")
+            << "the maximum batch size and the number of concurrent runs must be positive";
+    }
+
+    for (unsigned int i = 0; i < nConcurrentRuns; i++)
+    {
+        threads_.emplace_back([this]() { work(); });
+    }
+}
+
+BatchedSession::~BatchedSession()
+{
+    stop();
+}
+
+void BatchedSession::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+    }
+    cond_.notify_all();
+    for (auto& thread : threads_)
+    {
+        thread.join();
+    }
+    threads_.clear();
+}
+
+void BatchedSession::runAsync(const std::vector<Tensor>& inputs, std::vector<Tensor>* outputs,
+    Callback callback)
+{
+    if (inputs.size() != inputNames_.size())
+    {
+        throw cms::Exception("InvalidInput") << "numbers of input names and tensors not equal";
+    }
+    int64 rows = -1;
+    for (const auto& input : inputs)
+    {
+        if (input.dims() == 0 || (rows >= 0 && input.dim_size(0) != rows))
+        {
+            throw cms::Exception("InvalidInput")
+                << "the inputs of a batched session must have the same number of rows, got "
+                << input.DebugString();
+        }
+        rows = input.dim_size(0);
+    }
+    if (rows == 0)
+    {
+        // nothing to run, but the outputs are still defined
+        outputs->clear();
+        callback(std::exception_ptr());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (stopping_)
+        {
+            throw cms::Exception("InvalidSession") << "batched session already stopped";
+        }
+        queue_.push_back(Request{ inputs, outputs, std::move(callback), rows,
+            std::chrono::steady_clock::now() });
+        queuedRows_ += rows;
+    }
+    nRequests_++;
+    nRows_ += rows;
+    cond_.notify_one();
+}
+
+void BatchedSession::runAsync(const std::vector<Tensor>& inputs, std::vector<Tensor>* outputs,
+    edm::WaitingTaskWithArenaHolder holder)
+{
+    runAsync(inputs, outputs,
+        [holder](std::exception_ptr exception) mutable { holder.doneWaiting(exception); });
+}
+
+void BatchedSession::work()
+{
+    std::vector<Request> batch;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                if (queue_.empty())
+                {
+                    if (stopping_)
+                    {
+                        return;
+                    }
+                    cond_.wait(lock);
+                    continue;
+                }
+                // start when the batch is full, when the oldest request waited long enough, or
+                // when no more requests will come
+                auto deadline = queue_.front().arrival + maxLatency_;
+                if (queuedRows_ >= maxBatchSize_ || stopping_
+                    || std::chrono::steady_clock::now() >= deadline)
+                {
+                    break;
+                }
+                cond_.wait_until(lock, deadline);
+            }
+
+            // take the requests in order of arrival, at least one even if it alone is larger than
+            // the maximum batch size
+            int64 rows = 0;
+            do
+            {
+                rows += queue_.front().rows;
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            } while (!queue_.empty() && rows + queue_.front().rows <= maxBatchSize_
+                && concatenable(batch.front().inputs, queue_.front().inputs));
+            queuedRows_ -= rows;
+        }
+        // the rest for another thread
+        cond_.notify_one();
+
+        runBatch(batch);
+        batch.clear();
+    }
+}
+
+void BatchedSession::runBatch(std::vector<Request>& batch)
+{
+    std::exception_ptr exception;
+    try
+    {
+        NamedTensorList inputs(constants_);
+        std::vector<Tensor> outputs;
+
+        if (batch.size() == 1)
+        {
+            // nothing to concatenate
+            for (size_t i = 0; i < inputNames_.size(); i++)
+            {
+                inputs.push_back(NamedTensor(inputNames_[i], batch[0].inputs[i]));
+            }
+            run(session_, inputs, outputNames_, &outputs);
+            *batch[0].outputs = std::move(outputs);
+        }
+        else
+        {
+            std::vector<int64> rows;
+            int64 totalRows = 0;
+            for (const auto& request : batch)
+            {
+                rows.push_back(request.rows);
+                totalRows += request.rows;
+            }
+
+            // concatenate the rows of each input
+            std::vector<Tensor> parts(batch.size());
+            for (size_t i = 0; i < inputNames_.size(); i++)
+            {
+                for (size_t j = 0; j < batch.size(); j++)
+                {
+                    parts[j] = batch[j].inputs[i];
+                }
+                Tensor joined;
+                Status status = tensor::Concat(parts, &joined);
+                if (!status.ok())
+                {
+                    throw cms::Exception("InvalidInput")
+                        << "error while batching input '" << inputNames_[i]
+                        << "': " << status.ToString();
+                }
+                inputs.push_back(NamedTensor(inputNames_[i], joined));
+            }
+
+            run(session_, inputs, outputNames_, &outputs);
+
+            // split each output into the rows of the requests
+            for (auto& request : batch)
+            {
+                request.outputs->clear();
+            }
+            for (size_t i = 0; i < outputs.size(); i++)
+            {
+                if (outputs[i].dims() == 0 || outputs[i].dim_size(0) != totalRows)
+                {
+                    throw cms::Exception("InvalidOutput")
+                        << "output '" << outputNames_[i] << "' does not have one row per input row";
+                }
+                parts.clear();
+                Status status = tensor::Split(outputs[i], rows, &parts);
+                if (!status.ok())
+                {
+                    throw cms::Exception("InvalidOutput")
+                        << "error while splitting output '" << outputNames_[i]
+                        << "': " << status.ToString();
+                }
+                for (size_t j = 0; j < batch.size(); j++)
+                {
+                    batch[j].outputs->push_back(std::move(parts[j]));
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+    nBatches_++;
+
+    for (auto& request : batch)
+    {
+        request.callback(exception);
+    }
+}
+
+} // namespace tensorflow
@@ -0,0 +1,118 @@
+/*
+ * Service running the inference of TensorFlow graphs on behalf of the modules of all streams.
+ * Based on TensorFlow C++ API 1.3.
+ */
+
+#include "PhysicsTools/TensorFlow/interface/InferenceService.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+
+namespace tensorflow
+{
+
+InferenceService::InferenceService(const edm::ParameterSet& pset, edm::ActivityRegistry& registry)
+{
+    // set the tensorflow log level to error
+    setLogging("3");
+
+    for (const auto& modelPSet : pset.getParameter<std::vector<edm::ParameterSet>>("models"))
+    {
+        std::string name = modelPSet.getParameter<std::string>("name");
+        if (models_.count(name) != 0)
+        {
+            throw cms::Exception("Configuration") << "model '" << name << "' defined twice";
+        }
+        Model& model = models_[name];
+
+        // load the graph and create the session
+        std::string pbFile = modelPSet.getParameter<edm::FileInPath>("graphPath").fullPath();
+        model.graphDef.reset(loadGraphDef(pbFile));
+        SessionOptions sessionOptions;
+        setThreading(sessionOptions, modelPSet.getParameter<unsigned int>("nThreads"),
+            modelPSet.getParameter<std::string>("singleThreadPool"));
+        model.session = createSession(model.graphDef.get(), sessionOptions);
+
+        // learning phase placeholders, fed with false
+        NamedTensorList constants;
+        for (const auto& lpName : modelPSet.getParameter<std::vector<std::string>>("lpNames"))
+        {
+            Tensor t(DT_BOOL, {});
+            t.scalar<bool>()() = false;
+            constants.push_back(NamedTensor(lpName, t));
+        }
+
+        model.batchedSession = std::make_unique<BatchedSession>(model.session,
+            modelPSet.getParameter<std::vector<std::string>>("inputNames"),
+            modelPSet.getParameter<std::vector<std::string>>("outputNames"), constants,
+            modelPSet.getParameter<unsigned int>("maxBatchSize"),
+            std::chrono::microseconds(modelPSet.getParameter<unsigned int>("maxLatency")),
+            modelPSet.getParameter<unsigned int>("concurrentRuns"));
+    }
+
+    registry.watchPostEndJob(this, &InferenceService::postEndJob);
+}
+
+InferenceService::~InferenceService()
+{
+    for (auto& it : models_)
+    {
+        // stop the threads before the session goes away
+        it.second.batchedSession.reset();
+        closeSession(it.second.session);
+    }
+}
+
+void InferenceService::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
+{
+    edm::ParameterSetDescription modelDesc;
+    modelDesc.add<std::string>("name");
+    modelDesc.add<edm::FileInPath>("graphPath");
+    modelDesc.add<std::vector<std::string>>("inputNames");
+    modelDesc.add<std::vector<std::string>>("outputNames");
+    modelDesc.add<std::vector<std::string>>("lpNames", {})
+        ->setComment("learning phase placeholders, set to false");
+    modelDesc.add<unsigned int>("maxBatchSize", 64)
+        ->setComment("number of input rows from which a batch is run without waiting");
+    modelDesc.add<unsigned int>("maxLatency", 500)
+        ->setComment("microseconds a request may wait for more rows to join its batch");
+    modelDesc.add<unsigned int>("concurrentRuns", 1)
+        ->setComment("number of threads running the batches of this model");
+    modelDesc.add<unsigned int>("nThreads", 1)
+        ->setComment("number of threads of each session call");
+    modelDesc.add<std::string>("singleThreadPool", "no_threads");
+
+    edm::ParameterSetDescription desc;
+    desc.addVPSet("models", modelDesc, {});
+    descriptions.add("TFInferenceService", desc);
+}
+
+BatchedSession& InferenceService::model(const std::string& name)
+{
+    auto it = models_.find(name);
+    if (it == models_.end())
+    {
+        throw cms::Exception("UnknownModel")
+            << "model '" << name << "' is not configured in the TFInferenceService";
+    }
+    return *it->second.batchedSession;
+}
+
+void InferenceService::postEndJob()
+{
+    for (auto& it : models_)
+    {
+        BatchedSession& batchedSession = *it.second.batchedSession;
+        batchedSession.stop();
+        edm::LogInfo("TFInferenceService")
+            << "model '" << it.first << "': " << batchedSession.nRequests() << " requests, "
+            << batchedSession.nRows() << " rows in " << batchedSession.nBatches()
+            << " session calls";
+    }
+}
+
+} // namespace tensorflow
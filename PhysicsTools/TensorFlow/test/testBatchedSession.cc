@@ -0,0 +1,248 @@
+/*
+ * Tests and throughput benchmark of the batched session.
+ * Based on TensorFlow C++ API 1.3.
+ */
+
+#include <boost/filesystem.hpp>
+#include <cppunit/extensions/HelperMacros.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "PhysicsTools/TensorFlow/interface/BatchedSession.h"
+
+std::string cmsswPath(std::string path)
+{
+    if (path.size() > 0 && path.substr(0, 1) != "/")
+    {
+        path = "/" + path;
+    }
+
+    std::string base = std::string(std::getenv("CMSSW_BASE"));
+    std::string releaseBase = std::string(std::getenv("CMSSW_RELEASE_BASE"));
+
+    return (boost::filesystem::exists(base.c_str()) ? base : releaseBase) + path;
+}
+
+class testBatchedSession : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(testBatchedSession);
+    CPPUNIT_TEST(checkAll);
+    CPPUNIT_TEST(benchmark);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    std::string dataPath;
+    tensorflow::GraphDef* graphDef;
+    tensorflow::Session* session;
+    tensorflow::NamedTensorList constants;
+
+    void setUp();
+    void tearDown();
+    void checkAll();
+    void benchmark();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testBatchedSession);
+
+namespace
+{
+
+// inputs of the graph: rows of 10 values, the output is (sum + 1) * scale
+tensorflow::Tensor makeInput(int64_t rows, float offset)
+{
+    tensorflow::Tensor input(tensorflow::DT_FLOAT, { rows, 10 });
+    float* d = input.flat<float>().data();
+    for (int64_t i = 0; i < rows * 10; i++)
+    {
+        d[i] = offset + float(i % 10);
+    }
+    return input;
+}
+
+float expected(float offset, float scale)
+{
+    return (10 * offset + 45 + 1) * scale;
+}
+
+// blocking call of the batched session
+std::exception_ptr runAndWait(tensorflow::BatchedSession& batchedSession,
+    const std::vector<tensorflow::Tensor>& inputs, std::vector<tensorflow::Tensor>* outputs)
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool done = false;
+    std::exception_ptr exception;
+    batchedSession.runAsync(inputs, outputs,
+        tensorflow::BatchedSession::Callback([&](std::exception_ptr e) {
+            std::lock_guard<std::mutex> guard(mutex);
+            exception = e;
+            done = true;
+            cond.notify_one();
+        }));
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&done]() { return done; });
+    return exception;
+}
+
+} // namespace
+
+void testBatchedSession::setUp()
+{
+    dataPath = cmsswPath("/test/" + std::string(getenv("SCRAM_ARCH"))
+        + "/" + boost::filesystem::unique_path().string());
+
+    // create the graph
+    std::string testPath = cmsswPath("/src/PhysicsTools/TensorFlow/test");
+    std::string cmd = "python " + testPath + "/createconstantgraph.py " + dataPath;
+    std::array<char, 128> buffer;
+    std::string result;
+    std::shared_ptr<FILE> pipe(popen(cmd.c_str(), "r"), pclose);
+    if (!pipe)
+    {
+        throw std::runtime_error("popen() failed!");
+    }
+    while (!feof(pipe.get()))
+    {
+        if (fgets(buffer.data(), 128, pipe.get()) != NULL)
+        {
+            result += buffer.data();
+        }
+    }
+    std::cout << std::endl
+              << result << std::endl;
+
+    tensorflow::setLogging();
+    graphDef = tensorflow::loadGraphDef(dataPath + "/constantgraph.pb");
+    session = tensorflow::createSession(graphDef);
+
+    tensorflow::Tensor scale(tensorflow::DT_FLOAT, {});
+    scale.scalar<float>()() = 2.0;
+    constants = { { "scale", scale } };
+}
+
+void testBatchedSession::tearDown()
+{
+    tensorflow::closeSession(session);
+    delete graphDef;
+
+    if (boost::filesystem::exists(dataPath))
+    {
+        boost::filesystem::remove_all(dataPath);
+    }
+}
+
+void testBatchedSession::checkAll()
+{
+    tensorflow::BatchedSession batchedSession(session, { "input" }, { "output" }, constants, 16,
+        std::chrono::microseconds(2000), 2);
+
+    // requests of 1 to 4 rows from several threads, each with its own values
+    const int nClients = 8;
+    const int nRequests = 200;
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < nClients; c++)
+    {
+        clients.emplace_back([&, c]() {
+            for (int r = 0; r < nRequests; r++)
+            {
+                int64_t rows = 1 + (c + r) % 4;
+                float offset = float(c * nRequests + r);
+                std::vector<tensorflow::Tensor> outputs;
+                std::exception_ptr exception = runAndWait(batchedSession,
+                    { makeInput(rows, offset) }, &outputs);
+                if (exception || outputs.size() != 1 || outputs[0].dim_size(0) != rows)
+                {
+                    wrong++;
+                    continue;
+                }
+                for (int64_t i = 0; i < rows; i++)
+                {
+                    if (outputs[0].matrix<float>()(i, 0) != expected(offset, 2.0))
+                    {
+                        wrong++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& client : clients)
+    {
+        client.join();
+    }
+    CPPUNIT_ASSERT_EQUAL(0, wrong.load());
+    CPPUNIT_ASSERT_EQUAL((unsigned long)(nClients * nRequests), batchedSession.nRequests());
+    CPPUNIT_ASSERT(batchedSession.nBatches() <= batchedSession.nRequests());
+    std::cout << batchedSession.nRequests() << " requests in " << batchedSession.nBatches()
+              << " session calls" << std::endl;
+
+    // inconsistent inputs are rejected when queued
+    std::vector<tensorflow::Tensor> outputs;
+    CPPUNIT_ASSERT_THROW(batchedSession.runAsync({ makeInput(1, 0), makeInput(1, 0) }, &outputs,
+                             tensorflow::BatchedSession::Callback()),
+        cms::Exception);
+
+    // a request that cannot be concatenated with the others fails alone
+    tensorflow::Tensor wide(tensorflow::DT_FLOAT, { 2, 3 });
+    wide.flat<float>().setZero();
+    CPPUNIT_ASSERT(runAndWait(batchedSession, { wide }, &outputs));
+    CPPUNIT_ASSERT(!runAndWait(batchedSession, { makeInput(3, 1) }, &outputs));
+    CPPUNIT_ASSERT(outputs[0].matrix<float>()(2, 0) == expected(1, 2.0));
+
+    // no new requests after the stop
+    batchedSession.stop();
+    CPPUNIT_ASSERT_THROW(runAndWait(batchedSession, { makeInput(1, 0) }, &outputs),
+        cms::Exception);
+}
+
+void testBatchedSession::benchmark()
+{
+    // requests of a single row from several clients, as from taggers evaluating one jet at a time
+    const int nClients = 8;
+    const int nRequests = 2000;
+
+    auto measure = [&](const std::string& label, std::function<void(int64_t)> request) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> clients;
+        for (int c = 0; c < nClients; c++)
+        {
+            clients.emplace_back([&]() {
+                for (int r = 0; r < nRequests; r++)
+                {
+                    request(r);
+                }
+            });
+        }
+        for (auto& client : clients)
+        {
+            client.join();
+        }
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << label << ": " << nClients * nRequests / seconds << " requests/s" << std::endl;
+    };
+
+    measure("one session call per request", [&](int64_t r) {
+        tensorflow::NamedTensorList inputs(constants);
+        inputs.push_back(tensorflow::NamedTensor("input", makeInput(1, r)));
+        std::vector<tensorflow::Tensor> outputs;
+        tensorflow::run(session, inputs, { "output" }, &outputs);
+    });
+
+    for (unsigned int maxBatchSize : { 1, 8, 64 })
+    {
+        tensorflow::BatchedSession batchedSession(session, { "input" }, { "output" }, constants,
+            maxBatchSize, std::chrono::microseconds(200), 1);
+        measure("batches of up to " + std::to_string(maxBatchSize) + " rows", [&](int64_t r) {
+            std::vector<tensorflow::Tensor> outputs;
+            runAndWait(batchedSession, { makeInput(1, r) }, &outputs);
+        });
+        std::cout << "  " << batchedSession.nRequests() << " requests in "
+                  << batchedSession.nBatches() << " session calls" << std::endl;
+    }
+}
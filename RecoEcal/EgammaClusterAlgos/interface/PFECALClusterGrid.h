@@ -0,0 +1,107 @@
+#ifndef RecoEcal_EgammaClusterAlgos_PFECALClusterGrid_h
+#define RecoEcal_EgammaClusterAlgos_PFECALClusterGrid_h
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// eta-phi bins of the clusters of a collection, so that a seed of the
+// PFECALSuperClusterAlgo only tests the clusters around it; each bin keeps
+// the indices in increasing order. The clusters are accessed through
+// operator->, with eta() and phi(); the ones with a non-finite position are
+// candidates of every seed.
+class PFECALClusterGrid {
+public:
+  // binning of the grid
+  static constexpr int nPhi = 64;
+  static constexpr double phiBinSize = 2*M_PI/nPhi;
+  static constexpr double minEtaBinSize = 0.1;
+  static constexpr double maxEtaBins = 1000.;
+
+  template<typename Clusters>
+  PFECALClusterGrid(const Clusters& clusters) :
+    etaMin_(0.), etaBinSize_(minEtaBinSize), nEta_(1), nClusters_(clusters.size()) {
+    double etaMax = 0.;
+    bool first = true;
+    for( const auto& clus : clusters ) {
+      if( !std::isfinite(clus->eta()) || !std::isfinite(clus->phi()) ) continue;
+      etaMin_ = first ? clus->eta() : std::min(etaMin_,double(clus->eta()));
+      etaMax  = first ? clus->eta() : std::max(etaMax,double(clus->eta()));
+      first = false;
+    }
+    etaBinSize_ = std::max(double(minEtaBinSize),(etaMax-etaMin_)/maxEtaBins);
+    nEta_ = unsigned((etaMax-etaMin_)/etaBinSize_) + 1;
+
+    // counting sort of the cluster indices into the bins
+    std::vector<int> bins(clusters.size(),-1);
+    offsets_.assign(nEta_*nPhi + 1,0);
+    for( unsigned i = 0; i < clusters.size(); ++i ) {
+      const auto& clus = clusters[i];
+      if( !std::isfinite(clus->eta()) || !std::isfinite(clus->phi()) ) {
+	unbinned_.push_back(i);
+	continue;
+      }
+      bins[i] = etaBin(clus->eta())*nPhi + phiBin(clus->phi());
+      ++offsets_[bins[i]+1];
+    }
+    for( unsigned b = 0; b < nEta_*nPhi; ++b ) offsets_[b+1] += offsets_[b];
+    indices_.resize(offsets_.back());
+    std::vector<unsigned> fill(offsets_.begin(),offsets_.end()-1);
+    for( unsigned i = 0; i < clusters.size(); ++i ) {
+      if( bins[i] >= 0 ) indices_[fill[bins[i]]++] = i;
+    }
+  }
+
+  // the indices, in increasing order, of a superset of the clusters
+  // within maxDEta and maxDPhi of (eta,phi)
+  void candidates(const double eta, const double phi,
+		  double maxDEta, double maxDPhi,
+		  std::vector<unsigned>& out) const {
+    out.clear();
+    if( !std::isfinite(eta) || !std::isfinite(phi) ||
+	std::isnan(maxDEta) || std::isnan(maxDPhi) ) {
+      for( unsigned i = 0; i < nClusters_; ++i ) out.push_back(i);
+      return;
+    }
+    // margin for the rounding at the bin edges
+    maxDEta += 1e-5;
+    maxDPhi += 1e-5;
+    const unsigned etaLo = etaBin(eta-maxDEta), etaHi = etaBin(eta+maxDEta);
+    int phiLo = 0, phiHi = nPhi - 1;
+    if( maxDPhi < M_PI ) {
+      phiLo = std::floor((phi-maxDPhi+M_PI)/phiBinSize);
+      phiHi = std::floor((phi+maxDPhi+M_PI)/phiBinSize);
+      if( phiHi - phiLo + 1 >= nPhi ) {
+	phiLo = 0;
+	phiHi = nPhi - 1;
+      }
+    }
+    for( unsigned ieta = etaLo; ieta <= etaHi; ++ieta ) {
+      for( int iphi = phiLo; iphi <= phiHi; ++iphi ) {
+	const unsigned b = ieta*nPhi + (iphi%nPhi + nPhi)%nPhi;
+	out.insert(out.end(),
+		   indices_.begin()+offsets_[b],indices_.begin()+offsets_[b+1]);
+      }
+    }
+    out.insert(out.end(),unbinned_.begin(),unbinned_.end());
+    std::sort(out.begin(),out.end());
+  }
+
+private:
+  unsigned etaBin(const double eta) const {
+    const double x = (eta-etaMin_)/etaBinSize_;
+    if( !(x > 0.) ) return 0;
+    return x < nEta_ ? unsigned(x) : nEta_ - 1;
+  }
+  unsigned phiBin(const double phi) const {
+    const double x = (phi+M_PI)/phiBinSize;
+    if( !(x > 0.) ) return 0;
+    return x < nPhi ? unsigned(x) : nPhi - 1;
+  }
+
+  double etaMin_, etaBinSize_;
+  unsigned nEta_, nClusters_;
+  std::vector<unsigned> offsets_, indices_, unbinned_;
+};
+
+#endif
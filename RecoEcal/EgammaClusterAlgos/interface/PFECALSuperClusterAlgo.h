@@ -149,7 +149,8 @@ class PFECALSuperClusterAlgo {
   void buildAllSuperClusters(CalibratedClusterPtrVector&,
 			     double seedthresh);
   void buildSuperCluster(CalibratedClusterPtr&,
-			 CalibratedClusterPtrVector&); 
+			 CalibratedClusterPtrVector&,
+			 reco::SuperClusterCollection&); 
 
   bool verbose_;
   
@@ -1,4 +1,5 @@
 #include "RecoEcal/EgammaClusterAlgos/interface/PFECALSuperClusterAlgo.h"
+#include "RecoEcal/EgammaClusterAlgos/interface/PFECALClusterGrid.h"
 #include "RecoParticleFlow/PFClusterTools/interface/PFClusterWidthAlgo.h"
 #include "RecoParticleFlow/PFClusterTools/interface/LinkByRecHit.h"
 #include "DataFormats/ParticleFlowReco/interface/PFLayer.h"
@@ -22,6 +23,8 @@
 #include <string>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 
 using namespace std;
 namespace MK = reco::MustacheKernel;
@@ -320,38 +323,189 @@ buildAllSuperClusters(CalibClusterPtrVector& clusters,
   IsASeed seedable(seedthresh,threshIsET_);
   // make sure only seeds appear at the front of the list of clusters
   std::stable_partition(clusters.begin(),clusters.end(),seedable);
-  // in each iteration we are working on a list that is already sorted
-  // in the cluster energy and remains so through each iteration
-  // NB: since clusters is sorted in loadClusters any_of has O(1)
-  //     timing until you run out of seeds!  
-  while( std::any_of(clusters.cbegin(), clusters.cend(), seedable) ) {    
-    buildSuperCluster(clusters.front(),clusters);
+  // the clusters are binned in eta-phi and each seed only tests the clusters
+  // of the bins around it; the clustered clusters are flagged instead of
+  // being removed, so that the list remains sorted in the cluster energy,
+  // with the seeds first, through each iteration
+  const PFECALClusterGrid grid(clusters);
+  std::vector<bool> available(clusters.size(),true);
+  // clusters below 10^-1.1 GeV are never in a mustache
+  float minMustacheE = std::numeric_limits<float>::max();
+  for( const auto& clus : clusters ) {
+    if( clus->energy_nocalib() > 0.079 ) {
+      minMustacheE = std::min(minMustacheE,float(clus->energy_nocalib()));
+    }
+  }
+
+  std::vector<unsigned> candidates, selected;
+  CalibClusterPtrVector clustered;
+  reco::SuperClusterCollection superClusters;
+  std::vector<PFLayer::Layer> seedLayers;
+  unsigned iseed = 0;
+  while( true ) {
+    // there are seeds left as long as the first available cluster is one
+    while( iseed < clusters.size() && !available[iseed] ) ++iseed;
+    if( iseed == clusters.size() || !seedable(clusters[iseed]) ) break;
+    CalibClusterPtr& seed = clusters[iseed];
+
+    IsClustered IsClusteredWithSeed(seed,_clustype,_useDynamicDPhi);
+    IsLinkedByRecHit MatchesSeedByRecHit(seed,satelliteThreshold_,
+					 fractionForMajority_,0.1,0.2);
+    switch( seed->the_ptr()->layer() ) {
+    case PFLayer::ECAL_BARREL:
+      IsClusteredWithSeed.phiwidthSuperCluster_ = phiwidthSuperClusterBarrel_;
+      IsClusteredWithSeed.etawidthSuperCluster_ = etawidthSuperClusterBarrel_;
+      break;
+    case PFLayer::HGCAL:  
+    case PFLayer::ECAL_ENDCAP:  
+      IsClusteredWithSeed.phiwidthSuperCluster_ = phiwidthSuperClusterEndcap_; 
+      IsClusteredWithSeed.etawidthSuperCluster_ = etawidthSuperClusterEndcap_;
+      break;
+    default:
+      break;
+    }
+
+    // window around the seed out of which neither IsClustered nor 
+    // IsLinkedByRecHit accept a cluster
+    double maxDPhi = ( _useDynamicDPhi ? MK::maxDPhiInDynamicWindow() : 
+		       IsClusteredWithSeed.phiwidthSuperCluster_ );
+    double maxDEta = 0.;
+    switch( _clustype ) {
+    case kBOX:
+      maxDEta = IsClusteredWithSeed.etawidthSuperCluster_;
+      break;
+    case kMustache:
+      maxDEta = MK::maxDEtaInMustache(seed->eta(),minMustacheE,maxDPhi);
+      break;
+    default:
+      maxDPhi = 0.;
+      break;
+    }
+    if( doSatelliteClusterMerge_ ) {
+      maxDEta = std::max(maxDEta,MatchesSeedByRecHit._maxSatelliteDEta);
+      maxDPhi = std::max(maxDPhi,MatchesSeedByRecHit._maxSatelliteDPhi);
+    }
+    grid.candidates(seed->eta(),seed->phi(),maxDEta,maxDPhi,candidates);
+
+    // the clustered clusters then the satellites, both in the order of the
+    // list, as the stable partitions of the whole list gave them
+    selected.clear();
+    for( unsigned i : candidates ) {
+      if( available[i] && IsClusteredWithSeed(clusters[i]) ) {
+	selected.push_back(i);
+	available[i] = false;
+      }
+    }
+    // satellite cluster merging
+    // it was found that large clusters can split!
+    if( doSatelliteClusterMerge_ ) {    
+      for( unsigned i : candidates ) {
+	if( available[i] && MatchesSeedByRecHit(clusters[i]) ) {
+	  selected.push_back(i);
+	  available[i] = false;
+	}
+      }
+    }
+
+    if(verbose_) {
+      edm::LogInfo("PFClustering") << "Dumping cluster detail";
+      edm::LogVerbatim("PFClustering")
+	<< "\tPassed seed: e = " << seed->energy_nocalib() 
+	<< " eta = " << seed->eta() << " phi = " << seed->phi() 
+	<< std::endl;  
+      for( unsigned i : selected ) {
+	edm::LogVerbatim("PFClustering") 
+	  << "\t\tClustered cluster: e = " << clusters[i]->energy_nocalib() 
+	  << " eta = " << clusters[i]->eta() << " phi = " << clusters[i]->phi() 
+	  << std::endl;
+      }
+      for( unsigned i = iseed; i < clusters.size(); ++i ) {
+	if( !available[i] ) continue;
+	edm::LogVerbatim("PFClustering") 
+	  << "\tNon-Clustered cluster: e = " << clusters[i]->energy_nocalib() 
+	  << " eta = " << clusters[i]->eta() << " phi = " << clusters[i]->phi() 
+	  << std::endl;
+      }    
+    }
+
+    if( selected.empty() ) {
+      if(dropUnseedable_){
+	available[iseed] = false;
+	continue;
+      }
+      else {
+	throw cms::Exception("PFECALSuperClusterAlgo::buildSuperCluster")
+	  << "Cluster is not seedable!" << std::endl 
+	  << "\tNon-Clustered cluster: e = " << seed->energy_nocalib()
+	  << " eta = " << seed->eta() << " phi = " << seed->phi()
+	  << std::endl;
+      }
+    }
+
+    clustered.clear();
+    for( unsigned i : selected ) clustered.push_back(clusters[i]);
+    buildSuperCluster(seed,clustered,superClusters);
+    seedLayers.push_back(seed->the_ptr()->layer());
+  }
+
+  //apply regression energy corrections, to all the super clusters at once
+  if( useRegression_ ) {  
+    regr_->modifyObjects(superClusters);
+  }
+  
+  // save the super clusters to the appropriate list (if they pass the final
+  // Et threshold)
+  //Note that Et is computed here with respect to the beamspot position
+  //in order to be consistent with the cut applied in the
+  //ElectronSeedProducer
+  for( unsigned isc = 0; isc < superClusters.size(); ++isc ) {
+    const reco::SuperCluster& new_sc = superClusters[isc];
+    double scEtBS = 
+      ptFast(new_sc.energy(),new_sc.position(),beamSpot_->position());
+
+    if ( scEtBS > threshSuperClusterEt_ ) {
+      switch( seedLayers[isc] ) {
+      case PFLayer::ECAL_BARREL:
+	if(isOOTCollection_) {
+	  DetId seedId = new_sc.seed()->seed();
+	  EcalRecHitCollection::const_iterator seedRecHit = barrelRecHits_->find(seedId);
+	  if (!seedRecHit->checkFlag(EcalRecHit::kOutOfTime)) break;
+	}
+	superClustersEB_->push_back(new_sc);
+	break;
+      case PFLayer::HGCAL:
+      case PFLayer::ECAL_ENDCAP:    
+	if(isOOTCollection_) {
+	  DetId seedId = new_sc.seed()->seed();
+	  EcalRecHitCollection::const_iterator seedRecHit = endcapRecHits_->find(seedId);
+	  if (!seedRecHit->checkFlag(EcalRecHit::kOutOfTime)) break;
+	}
+	superClustersEE_->push_back(new_sc);    
+	break;
+      default:
+	break;
+      }
+    }
   }
 }
 
 void PFECALSuperClusterAlgo::
 buildSuperCluster(CalibClusterPtr& seed,
-		  CalibClusterPtrVector& clusters) {
-  IsClustered IsClusteredWithSeed(seed,_clustype,_useDynamicDPhi);
-  IsLinkedByRecHit MatchesSeedByRecHit(seed,satelliteThreshold_,
-				       fractionForMajority_,0.1,0.2);
+		  CalibClusterPtrVector& clustered,
+		  reco::SuperClusterCollection& superClusters) {
   bool isEE = false;
   SumPSEnergy sumps1(PFLayer::PS1), sumps2(PFLayer::PS2);  
   switch( seed->the_ptr()->layer() ) {
   case PFLayer::ECAL_BARREL:
-    IsClusteredWithSeed.phiwidthSuperCluster_ = phiwidthSuperClusterBarrel_;
-    IsClusteredWithSeed.etawidthSuperCluster_ = etawidthSuperClusterBarrel_;
     edm::LogInfo("PFClustering") << "Building SC number "  
-				 << superClustersEB_->size() + 1
+				 << superClusters.size() + 1
 				 << " in the ECAL barrel!";
     break;
   case PFLayer::HGCAL:  
   case PFLayer::ECAL_ENDCAP:  
   
-    IsClusteredWithSeed.phiwidthSuperCluster_ = phiwidthSuperClusterEndcap_; 
-    IsClusteredWithSeed.etawidthSuperCluster_ = etawidthSuperClusterEndcap_;
     edm::LogInfo("PFClustering") << "Building SC number "  
-				 << superClustersEE_->size() + 1
+				 << superClusters.size() + 1
 				 << " in the ECAL endcap!" << std::endl;
     isEE = true;
     break;
@@ -359,58 +513,7 @@ buildSuperCluster(CalibClusterPtr& seed,
     break;
   }
   
-  // this function shuffles the list of clusters into a list
-  // where all clustered sub-clusters are at the front 
-  // and returns a pointer to the first unclustered cluster.
-  // The relative ordering of clusters is preserved 
-  // (i.e. both resulting sub-lists are sorted by energy).
-  auto not_clustered = std::stable_partition(clusters.begin(),clusters.end(),
-					     IsClusteredWithSeed);
-  // satellite cluster merging
-  // it was found that large clusters can split!
-  if( doSatelliteClusterMerge_ ) {    
-    not_clustered = std::stable_partition(not_clustered,clusters.end(),
-					  MatchesSeedByRecHit);
-  }
 
-  if(verbose_) {
-    edm::LogInfo("PFClustering") << "Dumping cluster detail";
-    edm::LogVerbatim("PFClustering")
-      << "\tPassed seed: e = " << seed->energy_nocalib() 
-      << " eta = " << seed->eta() << " phi = " << seed->phi() 
-      << std::endl;  
-    for( auto clus = clusters.cbegin(); clus != not_clustered; ++clus ) {
-      edm::LogVerbatim("PFClustering") 
-	<< "\t\tClustered cluster: e = " << (*clus)->energy_nocalib() 
-	<< " eta = " << (*clus)->eta() << " phi = " << (*clus)->phi() 
-	<< std::endl;
-    }
-    for( auto clus = not_clustered; clus != clusters.end(); ++clus ) {
-      edm::LogVerbatim("PFClustering") 
-	<< "\tNon-Clustered cluster: e = " << (*clus)->energy_nocalib() 
-	<< " eta = " << (*clus)->eta() << " phi = " << (*clus)->phi() 
-	<< std::endl;
-    }    
-  }
-
-  if (not_clustered == clusters.begin()) {
-    if(dropUnseedable_){
-      clusters.erase(clusters.begin());
-      return;
-    }
-    else {
-      throw cms::Exception("PFECALSuperClusterAlgo::buildSuperCluster")
-        << "Cluster is not seedable!" << std::endl 
-        << "\tNon-Clustered cluster: e = " << (*not_clustered)->energy_nocalib()
-        << " eta = " << (*not_clustered)->eta() << " phi = " << (*not_clustered)->phi()
-        << std::endl;
-    }
-  }
-
-  // move the clustered clusters out of available cluster list
-  // and into a temporary vector for building the SC  
-  CalibratedClusterPtrVector clustered(clusters.begin(),not_clustered);
-  clusters.erase(clusters.begin(),not_clustered);    
   // need the vector of raw pointers for a PF width class
   std::vector<const reco::PFCluster*> bare_ptrs;
   // calculate necessary parameters and build the SC
@@ -556,41 +659,5 @@ buildSuperCluster(CalibClusterPtr& seed,
   
   // cache the value of the raw energy  
   new_sc.rawEnergy();
-
-  //apply regression energy corrections
-  if( useRegression_ ) {  
-    regr_->modifyObject(new_sc);
-  }
-  
-  // save the super cluster to the appropriate list (if it passes the final
-  // Et threshold)
-  //Note that Et is computed here with respect to the beamspot position
-  //in order to be consistent with the cut applied in the
-  //ElectronSeedProducer
-  double scEtBS = 
-    ptFast(new_sc.energy(),new_sc.position(),beamSpot_->position());
-
-  if ( scEtBS > threshSuperClusterEt_ ) {
-    switch( seed->the_ptr()->layer() ) {
-    case PFLayer::ECAL_BARREL:
-      if(isOOTCollection_) {
-	DetId seedId = new_sc.seed()->seed();
-	EcalRecHitCollection::const_iterator seedRecHit = barrelRecHits_->find(seedId);
-	if (!seedRecHit->checkFlag(EcalRecHit::kOutOfTime)) break;
-      }
-      superClustersEB_->push_back(new_sc);
-      break;
-    case PFLayer::HGCAL:
-    case PFLayer::ECAL_ENDCAP:    
-      if(isOOTCollection_) {
-	DetId seedId = new_sc.seed()->seed();
-	EcalRecHitCollection::const_iterator seedRecHit = endcapRecHits_->find(seedId);
-	if (!seedRecHit->checkFlag(EcalRecHit::kOutOfTime)) break;
-      }
-      superClustersEE_->push_back(new_sc);    
-      break;
-    default:
-      break;
-    }
-  }
+  superClusters.push_back(new_sc);
 }
@@ -0,0 +1,143 @@
+#include "RecoEcal/EgammaClusterAlgos/interface/PFECALClusterGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Test of the eta-phi grid of the PF clusters used by the
+ * PFECALSuperClusterAlgo: the candidates of a seed, compared with a full
+ * scan of the clusters, must contain all the clusters within maxDEta and
+ * maxDPhi of it, in increasing order and without duplicates. The clusters
+ * and the windows cover the phi wrap, the edges of the eta range, the
+ * clusters far in eta and the non-finite positions and windows.
+ */
+
+namespace {
+
+  int errors = 0;
+
+  struct Cluster {
+    Cluster(double eta, double phi) : eta_(eta), phi_(phi) {}
+    double eta() const { return eta_; }
+    double phi() const { return phi_; }
+    double eta_, phi_;
+  };
+  typedef std::vector<std::shared_ptr<Cluster> > Clusters;
+
+  const double infinity = std::numeric_limits<double>::infinity();
+  const double notANumber = std::numeric_limits<double>::quiet_NaN();
+
+  bool inWindow(const Cluster &clus, double eta, double phi, double maxDEta, double maxDPhi) {
+    if (!std::isfinite(clus.eta()) || !std::isfinite(clus.phi())) return true;
+    if (!std::isfinite(eta) || !std::isfinite(phi) || std::isnan(maxDEta) || std::isnan(maxDPhi)) return true;
+    return std::abs(clus.eta() - eta) <= maxDEta &&
+           std::abs(std::remainder(clus.phi() - phi, 2*M_PI)) <= maxDPhi;
+  }
+
+  //compares the candidates of the grid with the full scan for seeds at the
+  //clusters and around them
+  void compare(const std::string &name, const Clusters &clusters, std::mt19937 &rng) {
+    const double maxDEtas[] = {0., 0.02, 0.1, 0.35, 2., infinity, notANumber};
+    const double maxDPhis[] = {0., 0.05, 0.6, 3., M_PI, 4., infinity, notANumber};
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+
+    std::vector<std::pair<double, double> > seeds;
+    for (const auto &clus : clusters) {
+      seeds.emplace_back(clus->eta(), clus->phi());
+      seeds.emplace_back(clus->eta() + 0.1*uniform(rng), clus->phi() + 0.1*uniform(rng));
+    }
+    seeds.emplace_back(0., M_PI);
+    seeds.emplace_back(0., -M_PI);
+    seeds.emplace_back(-10., 3.);
+    seeds.emplace_back(10., -3.);
+    seeds.emplace_back(notANumber, 0.);
+    seeds.emplace_back(0., infinity);
+
+    const PFECALClusterGrid grid(clusters);
+    std::vector<unsigned> candidates;
+    unsigned missing = 0, unordered = 0, outOfRange = 0;
+    size_t nCandidates = 0, nInWindow = 0;
+    for (const auto &seed : seeds) {
+      for (double maxDEta : maxDEtas) {
+        for (double maxDPhi : maxDPhis) {
+          grid.candidates(seed.first, seed.second, maxDEta, maxDPhi, candidates);
+          nCandidates += candidates.size();
+          for (size_t k = 0; k < candidates.size(); ++k) {
+            if (candidates[k] >= clusters.size()) ++outOfRange;
+            if (k > 0 && !(candidates[k-1] < candidates[k])) ++unordered;
+          }
+          for (unsigned i = 0; i < clusters.size(); ++i) {
+            if (!inWindow(*clusters[i], seed.first, seed.second, maxDEta, maxDPhi)) continue;
+            ++nInWindow;
+            if (!std::binary_search(candidates.begin(), candidates.end(), i)) {
+              if (missing++ < 5) {
+                std::cout << "Error: " << name << ": cluster (" << clusters[i]->eta() << ","
+                          << clusters[i]->phi() << ") missing from the candidates of ("
+                          << seed.first << "," << seed.second << ") within " << maxDEta << ","
+                          << maxDPhi << std::endl;
+              }
+            }
+          }
+        }
+      }
+    }
+    if (missing || unordered || outOfRange) {
+      std::cout << "Error: " << name << ": " << missing << " clusters missing, " << unordered
+                << " candidates out of order, " << outOfRange << " out of range" << std::endl;
+      ++errors;
+    }
+    std::cout << name << ": " << clusters.size() << " clusters, " << nInWindow << " in the windows, "
+              << nCandidates << " candidates" << std::endl;
+  }
+
+  Clusters randomClusters(std::mt19937 &rng, unsigned n, double etaMin, double etaMax) {
+    std::uniform_real_distribution<double> eta(etaMin, etaMax);
+    std::uniform_real_distribution<double> phi(-M_PI, M_PI);
+    Clusters clusters;
+    for (unsigned i = 0; i < n; ++i) {
+      double sign = (rng() % 2) ? 1. : -1.;
+      clusters.push_back(std::make_shared<Cluster>(sign*eta(rng), phi(rng)));
+    }
+    return clusters;
+  }
+}
+
+int main()
+{
+  std::mt19937 rng(2018);
+
+  compare("empty", Clusters(), rng);
+  compare("single", randomClusters(rng, 1, 0., 0.), rng);
+  compare("barrel", randomClusters(rng, 300, 0., 1.479), rng);
+  compare("endcaps", randomClusters(rng, 300, 1.479, 3.), rng);
+
+  //all the clusters in a narrow eta range, on the phi edges
+  Clusters edges;
+  for (double phi : {-M_PI, M_PI, std::nextafter(M_PI, 0.), std::nextafter(-M_PI, 0.), 0.}) {
+    for (double eta : {1.2, 1.2001, 1.25}) edges.push_back(std::make_shared<Cluster>(eta, phi));
+  }
+  compare("phi edges", edges, rng);
+
+  //clusters far in eta, which widen the eta bins
+  Clusters far = randomClusters(rng, 200, 0., 3.);
+  far.push_back(std::make_shared<Cluster>(500., 1.));
+  far.push_back(std::make_shared<Cluster>(-1e4, -1.));
+  compare("far in eta", far, rng);
+
+  //clusters without a finite position are candidates of every seed
+  Clusters nonFinite = randomClusters(rng, 100, 0., 3.);
+  nonFinite.push_back(std::make_shared<Cluster>(notANumber, 0.));
+  nonFinite.push_back(std::make_shared<Cluster>(0., infinity));
+  nonFinite.push_back(std::make_shared<Cluster>(-infinity, notANumber));
+  compare("non-finite", nonFinite, rng);
+
+  if (errors) return 1;
+  std::cout << "PFECALClusterGrid validated" << std::endl;
+  return 0;
+}
@@ -16,6 +16,14 @@ namespace reco {
       bool inDynamicDPhiWindow(const float seedEta, const float seedPhi,
 			       const float ClustE, const float ClusEta,
 			       const float clusPhi);
+      // bound on |ClusEta - maxEta| for the clusters accepted by inMustache
+      // with ClustE >= minClustE and |ClusPhi - maxPhi| <= maxDPhi, 
+      // infinite if the mustache is not bounded for these clusters
+      float maxDEtaInMustache(const float maxEta, const float minClustE,
+			      const float maxDPhi);
+      // bound on |ClusPhi - seedPhi| for the clusters accepted by 
+      // inDynamicDPhiWindow
+      float maxDPhiInDynamicWindow();
      
   }
 
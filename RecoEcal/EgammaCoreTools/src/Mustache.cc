@@ -2,8 +2,27 @@
 #include "TMath.h"
 #include "TVector2.h"
 #include <cmath>
+#include <limits>
 using namespace std;
 
+namespace {
+  // parameters of the mustache: curvature (p) and width (w) of the parabolas
+  constexpr float p00 = -0.107537;
+  constexpr float p01 = 0.590969;
+  constexpr float p02 = -0.076494;
+  constexpr float p10 = -0.0268843;
+  constexpr float p11 = 0.147742;
+  constexpr float p12 = -0.0191235;
+  
+  constexpr float w00 = -0.00571429;
+  constexpr float w01 = -0.002;
+  constexpr float w10 = 0.0135714;
+  constexpr float w11 = 0.001;
+
+  // largest of the phi cutoffs of inDynamicDPhiWindow
+  constexpr float maxDynamicDPhiCutoff = 0.60;
+}
+
 namespace reco {  
   namespace MustacheKernel {    
     bool inMustache(const float maxEta, const float maxPhi, 
@@ -13,18 +32,6 @@ namespace reco {
       //float eta0 = maxEta;
       //float phi0 = maxPhi;      
       
-      constexpr float p00 = -0.107537;
-      constexpr float p01 = 0.590969;
-      constexpr float p02 = -0.076494;
-      constexpr float p10 = -0.0268843;
-      constexpr float p11 = 0.147742;
-      constexpr float p12 = -0.0191235;
-      
-      constexpr float w00 = -0.00571429;
-      constexpr float w01 = -0.002;
-      constexpr float w10 = 0.0135714;
-      constexpr float w11 = 0.001;
-      
       const float sineta0 = std::sin(maxEta);
       const float eta0xsineta0 = maxEta*sineta0;
       
@@ -70,6 +77,43 @@ namespace reco {
       return (deta < upper_cut && deta > lower_cut);
     }
 
+    float maxDEtaInMustache(const float maxEta, const float minClustE,
+			    const float maxDPhi) {
+      constexpr float unbounded = std::numeric_limits<float>::infinity();
+
+      const float sineta0 = std::sin(maxEta);
+      const float eta0xsineta0 = maxEta*sineta0;
+      if( !(eta0xsineta0 >= 0.f) ) return unbounded;
+
+      // the half width of the mustache, b_upper = -b_lower in inMustache,
+      // decreases with the cluster energy: take it at the lowest one
+      const float sqrt_log10_clustE = std::sqrt(std::log10(minClustE)+1.1);
+      if( !(sqrt_log10_clustE > 0.f) ) return unbounded;
+      const float b = 0.5*( (w10-w00)*eta0xsineta0 + 
+			    (w11-w01) / sqrt_log10_clustE );
+
+      // 1/(4*a_upper) increases with the width up to the pole at a_upper = 0,
+      // the mustache is not bounded if the width can get close to it
+      const float curv_up=eta0xsineta0*(p00*eta0xsineta0+p01)+p02;
+      const double inv_curv_up = 1/(4*curv_up);
+      double parabola = 0.;
+      if( inv_curv_up > 0. ) {
+	const double a_upper = inv_curv_up - b;
+	if( !(a_upper > 1e-3*inv_curv_up) ) return unbounded;
+	parabola = 1./(4.*a_upper);
+      }
+      
+      // the lower cut is at least -max(b,0.0087) and the upper one is larger 
+      // than that, with a margin for the rounding of the single precision
+      const double dphi2 = double(maxDPhi)*maxDPhi;
+      const double upper_cut = ( parabola*dphi2 + std::max(b,0.0087f) ) + 0.0087;
+      return 1.001*upper_cut + 1e-4;
+    }
+
+    float maxDPhiInDynamicWindow() {
+      return maxDynamicDPhiCutoff;
+    }
+
     bool inDynamicDPhiWindow(const float seedEta, const float seedPhi,
 			     const float ClustE, const float ClusEta,
 			     const float ClusPhi) {
@@ -112,7 +156,7 @@ namespace reco {
 	xoffset = xoffsetEB;
 	width   = 1.0/widthEB;
 	saturation = 0.14;
-	cutoff     = 0.60;
+	cutoff     = maxDynamicDPhiCutoff;
 	break;
       case 1: // 1.479 -> 1.75
 	yoffset = yoffsetEE_0;
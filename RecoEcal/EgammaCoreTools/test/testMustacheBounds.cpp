@@ -0,0 +1,129 @@
+#include "RecoEcal/EgammaCoreTools/interface/Mustache.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+/*
+ * Test of the bounds of the mustache used to restrict the clusters tested
+ * around a seed of the PF superclustering:
+ * - a cluster accepted by inMustache, with an energy of at least minClustE
+ *   and within maxDPhi of the seed, is within maxDEtaInMustache in eta;
+ * - a cluster accepted by inDynamicDPhiWindow is within
+ *   maxDPhiInDynamicWindow in phi.
+ * The seeds are sampled over the barrel and the endcaps of both sides, with
+ * the seed phi close to +-pi so that the clusters wrap around, and the
+ * clusters from the lowest energy up and close to the edges of the mustache.
+ */
+
+namespace MK = reco::MustacheKernel;
+
+namespace {
+
+  int errors = 0;
+
+  void check(bool ok, const char *what) {
+    if (!ok) {
+      std::cout << "Error: " << what << std::endl;
+      ++errors;
+    }
+  }
+
+  double deltaPhi(double phi1, double phi2) {
+    return std::remainder(phi1 - phi2, 2*M_PI);
+  }
+
+  //the seed phi is uniform, or close to the -pi/pi edge
+  float seedPhi(std::mt19937 &rng) {
+    std::uniform_real_distribution<float> uniform(-M_PI, M_PI);
+    std::uniform_real_distribution<float> edge(-0.05f, 0.05f);
+    switch (rng() % 3) {
+      case 0:  return M_PI - std::abs(edge(rng));
+      case 1:  return -M_PI + std::abs(edge(rng));
+      default: return uniform(rng);
+    }
+  }
+
+  void mustacheEtaBound(std::mt19937 &rng) {
+    const float minEnergies[] = {0.08f, 0.1f, 0.2f, 0.5f, 1.f, 5.f, 50.f};
+    const float maxDPhis[] = {0.05f, 0.3f, 0.6f, 1.f};
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+
+    unsigned bounded = 0, accepted = 0, outside = 0;
+    for (float seedEta = -3.f; seedEta <= 3.f; seedEta += 0.0125f) {
+      for (float minE : minEnergies) {
+        for (float maxDPhi : maxDPhis) {
+          const float eta = seedEta + 0.01f*uniform(rng);
+          const float bound = MK::maxDEtaInMustache(eta, minE, maxDPhi);
+          if (std::isnan(bound) || bound <= 0.f) {
+            std::cout << "Error: bound " << bound << " for eta " << eta << " E > " << minE
+                      << " dphi < " << maxDPhi << std::endl;
+            ++errors;
+            continue;
+          }
+          if (std::isinf(bound)) continue;
+          ++bounded;
+
+          const float phi = seedPhi(rng);
+          for (int i = 0; i < 200; ++i) {
+            //from the lowest energy up, with the lowest one itself
+            const float clusE = (i % 10 == 0) ? minE : minE*std::exp(8.f*uniform(rng));
+            const float dphi = maxDPhi*(2.f*uniform(rng) - 1.f);
+            //the cluster phi either wrapped or not into [-pi,pi]
+            float clusPhi = phi + dphi;
+            if (i % 2) clusPhi = deltaPhi(clusPhi, 0.);
+            if (std::abs(deltaPhi(clusPhi, phi)) > maxDPhi) continue;
+            //half of the clusters close to the bound
+            const float deta = (i % 4 < 2) ? 2.f*bound*(2.f*uniform(rng) - 1.f)
+                                           : bound*(1.f + 0.01f*(2.f*uniform(rng) - 1.f))*(i % 4 == 2 ? 1.f : -1.f);
+            const float clusEta = eta + deta;
+            if (!MK::inMustache(eta, phi, clusE, clusEta, clusPhi)) continue;
+            ++accepted;
+            if (!(std::abs(clusEta - eta) < bound)) {
+              if (outside++ < 10) {
+                std::cout << "Error: cluster (" << clusEta << "," << clusPhi << ") of E " << clusE
+                          << " in the mustache of (" << eta << "," << phi << ") beyond the bound "
+                          << bound << std::endl;
+              }
+            }
+          }
+        }
+      }
+    }
+    check(bounded > 0, "the mustache is bounded for some seeds");
+    check(accepted > 0, "some clusters are in the mustache");
+    check(outside == 0, "the clusters in the mustache are within maxDEtaInMustache");
+    std::cout << bounded << " bounded seeds, " << accepted << " clusters in the mustache, "
+              << outside << " beyond the bound" << std::endl;
+  }
+
+  void dynamicPhiBound(std::mt19937 &rng) {
+    const float bound = MK::maxDPhiInDynamicWindow();
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    unsigned accepted = 0, outside = 0;
+    for (int i = 0; i < 200000; ++i) {
+      const float eta = 6.f*uniform(rng) - 3.f;
+      const float phi = seedPhi(rng);
+      const float clusE = 0.05f*std::exp(10.f*uniform(rng));
+      const float clusEta = eta + 0.2f*(2.f*uniform(rng) - 1.f);
+      float clusPhi = phi + (bound + 0.2f)*(2.f*uniform(rng) - 1.f);
+      if (i % 2) clusPhi = deltaPhi(clusPhi, 0.);
+      if (!MK::inDynamicDPhiWindow(eta, phi, clusE, clusEta, clusPhi)) continue;
+      ++accepted;
+      if (!(std::abs(deltaPhi(clusPhi, phi)) <= bound)) ++outside;
+    }
+    check(accepted > 0, "some clusters are in the dynamic window");
+    check(outside == 0, "the clusters in the dynamic window are within maxDPhiInDynamicWindow");
+  }
+}
+
+int main()
+{
+  std::mt19937 rng(2018);
+  mustacheEtaBound(rng);
+  dynamicPhiBound(rng);
+
+  if (errors) return 1;
+  std::cout << "mustache bounds validated" << std::endl;
+  return 0;
+}
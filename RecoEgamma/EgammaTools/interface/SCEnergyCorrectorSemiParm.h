@@ -27,6 +27,8 @@
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include <vector>
+
 class SCEnergyCorrectorSemiParm {
  public:
   SCEnergyCorrectorSemiParm();
@@ -36,6 +38,9 @@ class SCEnergyCorrectorSemiParm {
 
   std::pair<double,double> getCorrections(const reco::SuperCluster &sc) const;
   void modifyObject(reco::SuperCluster &sc);
+  // same corrections as modifyObject, with the inputs of all the super clusters
+  // computed first and each forest evaluated once for all of them
+  void modifyObjects(std::vector<reco::SuperCluster> &scs);
   
   void setEventSetup(const edm::EventSetup &es);
   void setEvent(const edm::Event &e);
@@ -67,6 +72,15 @@ class SCEnergyCorrectorSemiParm {
   std::string uncertaintyKeyEE_;
 
  private:
+  static constexpr size_t kNInputs = 29;
+  static constexpr size_t kNInputsHLT = 7;
+
+  // fills the regression inputs, false when the super cluster is not corrected (HGCal)
+  bool fillInputs(const reco::SuperCluster &sc, float *eval, bool &iseb) const;
+  std::pair<double,double> transformResponses(const reco::SuperCluster &sc, const float *eval, bool iseb,
+					      double rawmean, double rawsigma) const;
+  void applyCorrections(reco::SuperCluster &sc, const std::pair<double,double> &cor) const;
+
   bool isHLT_;
   int nHitsAboveThreshold_;
   float eThreshold_;
@@ -12,6 +12,9 @@
 
 using namespace reco;
 
+constexpr size_t SCEnergyCorrectorSemiParm::kNInputs;
+constexpr size_t SCEnergyCorrectorSemiParm::kNInputsHLT;
+
 //--------------------------------------------------------------------------------------------------
 SCEnergyCorrectorSemiParm::SCEnergyCorrectorSemiParm() :
 foresteb_(nullptr),
@@ -98,15 +101,28 @@ void SCEnergyCorrectorSemiParm::setEvent(const edm::Event &e) {
 
 //--------------------------------------------------------------------------------------------------
 std::pair<double, double> SCEnergyCorrectorSemiParm::getCorrections(const reco::SuperCluster &sc) const {
-  std::pair<double, double> p;
-  p.first=-1;
-  p.second=-1;
-
+  std::array<float, kNInputs> eval;
+  bool iseb;
   // protect against HGCal, don't mod the object
-  if( sc.seed()->seed().det() == DetId::Forward ) return p;
+  if( !fillInputs(sc, eval.data(), iseb) ) return std::make_pair(-1.,-1.);
+
+  const GBRForestD *forestmean = iseb ? foresteb_ : forestee_;
+  const GBRForestD *forestsigma = iseb ? forestsigmaeb_ : forestsigmaee_;
+
+  //these are the actual BDT responses
+  double rawmean = forestmean->GetResponse(eval.data());
+  double rawsigma = isHLT_ ? 0. : forestsigma->GetResponse(eval.data());
+
+  return transformResponses(sc, eval.data(), iseb, rawmean, rawsigma);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SCEnergyCorrectorSemiParm::fillInputs(const reco::SuperCluster &sc, float *eval, bool &iseb) const {
+
+  if( sc.seed()->seed().det() == DetId::Forward ) return false;
 
   const reco::CaloCluster &seedCluster = *(sc.seed());
-  const bool iseb = seedCluster.hitsAndFractions()[0].first.subdetId() == EcalBarrel;
+  iseb = seedCluster.hitsAndFractions()[0].first.subdetId() == EcalBarrel;
   const EcalRecHitCollection *recHits = iseb ? rechitsEB_.product() : rechitsEE_.product();
 
   const CaloTopology *topo = calotopo_.product();
@@ -117,7 +133,6 @@ std::pair<double, double> SCEnergyCorrectorSemiParm::getCorrections(const reco::
   std::vector<float> localCovariances = EcalClusterTools::localCovariances(seedCluster,recHits,topo) ;
   
   if (not isHLT_) {
-    std::array<float, 29> eval;  
     
     const float eLeft = EcalClusterTools::eLeft(seedCluster,recHits,topo);
     const float eRight = EcalClusterTools::eRight(seedCluster,recHits,topo);
@@ -216,39 +231,8 @@ std::pair<double, double> SCEnergyCorrectorSemiParm::getCorrections(const reco::
       eval[27] = eeseedid.ix();
       eval[28] = eeseedid.iy();
     }  
-    
-    //magic numbers for MINUIT-like transformation of BDT output onto limited range
-    //(These should be stored inside the conditions object in the future as well)
-    constexpr double meanlimlow  = 0.2;
-    constexpr double meanlimhigh = 2.0;
-    constexpr double meanoffset  = meanlimlow + 0.5*(meanlimhigh-meanlimlow);
-    constexpr double meanscale   = 0.5*(meanlimhigh-meanlimlow);
-    
-    constexpr double sigmalimlow  = 0.0002;
-    constexpr double sigmalimhigh = 0.5;
-    constexpr double sigmaoffset  = sigmalimlow + 0.5*(sigmalimhigh-sigmalimlow);
-    constexpr double sigmascale   = 0.5*(sigmalimhigh-sigmalimlow);  
-    
-    const GBRForestD *forestmean = iseb ? foresteb_ : forestee_;
-    const GBRForestD *forestsigma = iseb ? forestsigmaeb_ : forestsigmaee_;
-    
-    //these are the actual BDT responses
-    double rawmean = forestmean->GetResponse(eval.data());
-    double rawsigma = forestsigma->GetResponse(eval.data());
-    
-    //apply transformation to limited output range (matching the training)
-    double mean = meanoffset + meanscale*vdt::fast_sin(rawmean);
-    double sigma = sigmaoffset + sigmascale*vdt::fast_sin(rawsigma);
-    
-    double ecor = mean*(eval[1]);
-    const double sigmacor = sigma*ecor;
-    
-	p.first  = ecor;
-	p.second = sigmacor;
-
   } else {
 
-    std::array<float, 7> eval;  
     float clusterMaxDR = 999.;
 
     size_t iclus = 0;
@@ -281,7 +265,19 @@ std::pair<double, double> SCEnergyCorrectorSemiParm::getCorrections(const reco::
     eval[4] = std::max(0,numberOfClusters-1);
     eval[5] = clusterMaxDR;
     eval[6] = raw_energy;
-    
+  }
+
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::pair<double, double> SCEnergyCorrectorSemiParm::transformResponses(const reco::SuperCluster &sc, const float *eval,
+									 bool iseb, double rawmean, double rawsigma) const {
+  std::pair<double, double> p;
+  p.first=-1;
+  p.second=-1;
+
+  if (not isHLT_) {
     //magic numbers for MINUIT-like transformation of BDT output onto limited range
     //(These should be stored inside the conditions object in the future as well)
     constexpr double meanlimlow  = 0.2;
@@ -289,9 +285,30 @@ std::pair<double, double> SCEnergyCorrectorSemiParm::getCorrections(const reco::
     constexpr double meanoffset  = meanlimlow + 0.5*(meanlimhigh-meanlimlow);
     constexpr double meanscale   = 0.5*(meanlimhigh-meanlimlow);
     
-    const GBRForestD *forestmean = iseb ? foresteb_ : forestee_;
+    constexpr double sigmalimlow  = 0.0002;
+    constexpr double sigmalimhigh = 0.5;
+    constexpr double sigmaoffset  = sigmalimlow + 0.5*(sigmalimhigh-sigmalimlow);
+    constexpr double sigmascale   = 0.5*(sigmalimhigh-sigmalimlow);  
+    
+    //apply transformation to limited output range (matching the training)
+    double mean = meanoffset + meanscale*vdt::fast_sin(rawmean);
+    double sigma = sigmaoffset + sigmascale*vdt::fast_sin(rawsigma);
+    
+    double ecor = mean*(eval[1]);
+    const double sigmacor = sigma*ecor;
+    
+	p.first  = ecor;
+	p.second = sigmacor;
+
+  } else {
 
-    double rawmean = forestmean->GetResponse(eval.data());
+    //magic numbers for MINUIT-like transformation of BDT output onto limited range
+    //(These should be stored inside the conditions object in the future as well)
+    constexpr double meanlimlow  = 0.2;
+    constexpr double meanlimhigh = 2.0;
+    constexpr double meanoffset  = meanlimlow + 0.5*(meanlimhigh-meanlimlow);
+    constexpr double meanscale   = 0.5*(meanlimhigh-meanlimlow);
+    
     double mean = meanoffset + meanscale*vdt::fast_sin(rawmean);
 
     double ecor = mean*eval[6];
@@ -308,10 +325,47 @@ std::pair<double, double> SCEnergyCorrectorSemiParm::getCorrections(const reco::
 //--------------------------------------------------------------------------------------------------
 void SCEnergyCorrectorSemiParm::modifyObject(reco::SuperCluster &sc) {
   
-	std::pair<double, double> cor = getCorrections(sc);
+	applyCorrections(sc, getCorrections(sc));
+}
+
+//--------------------------------------------------------------------------------------------------
+void SCEnergyCorrectorSemiParm::modifyObjects(std::vector<reco::SuperCluster> &scs) {
+
+  // the inputs of the barrel and of the endcap super clusters, one row each
+  const size_t nInputs = isHLT_ ? kNInputsHLT : kNInputs;
+  std::vector<float> rows[2];
+  std::vector<size_t> indices[2];
+  std::array<float, kNInputs> eval;
+  bool iseb;
+  for( size_t i = 0; i < scs.size(); ++i ) {
+    if( !fillInputs(scs[i], eval.data(), iseb) ) continue;
+    rows[iseb].insert(rows[iseb].end(), eval.begin(), eval.begin() + nInputs);
+    indices[iseb].push_back(i);
+  }
+
+  // each forest is walked once, tree by tree, for all the rows
+  std::vector<double> rawmeans, rawsigmas;
+  for( const bool eb : { true, false } ) {
+    const size_t nRows = indices[eb].size();
+    if( nRows == 0 ) continue;
+    const GBRForestD *forestmean = eb ? foresteb_ : forestee_;
+    const GBRForestD *forestsigma = eb ? forestsigmaeb_ : forestsigmaee_;
+    rawmeans.resize(nRows);
+    rawsigmas.assign(nRows, 0.);
+    forestmean->GetResponses(rows[eb].data(), nRows, nInputs, rawmeans.data());
+    if( !isHLT_ ) forestsigma->GetResponses(rows[eb].data(), nRows, nInputs, rawsigmas.data());
+    for( size_t j = 0; j < nRows; ++j ) {
+      reco::SuperCluster &sc = scs[indices[eb][j]];
+      applyCorrections(sc, transformResponses(sc, &rows[eb][j*nInputs], eb, rawmeans[j], rawsigmas[j]));
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void SCEnergyCorrectorSemiParm::applyCorrections(reco::SuperCluster &sc, const std::pair<double,double> &cor) const {
+  
 	if(cor.first<0) return;
 	sc.setEnergy(cor.first);
 	sc.setCorrectedEnergy(cor.first);
 	if(! isHLT_ && cor.second>=0.) sc.setCorrectedEnergyUncertainty(cor.second);
 }
-
@@ -23,6 +23,7 @@
 #include <numeric>
 
 #include "KDTreeLinkerAlgoT.h"
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
 
 
 template <typename T>
@@ -78,11 +79,7 @@ HGCalImagingAlgo(const std::vector<double>& vecDeltas_in, double kappa_in, doubl
         noiseMip(noiseMip_in),
         verbosity(the_verbosity),
         initialized(false),
-        points(2*(maxlayer+1)),
-        minpos(2*(maxlayer+1),{
-                {0.0f,0.0f}
-        }),
-        maxpos(2*(maxlayer+1),{ {0.0f,0.0f} })
+        points(2*(maxlayer+1))
 {
 }
 
@@ -109,11 +106,7 @@ HGCalImagingAlgo(const std::vector<double>& vecDeltas_in, double kappa_in, doubl
         noiseMip(noiseMip_in),
         verbosity(the_verbosity),
         initialized(false),
-        points(2*(maxlayer+1)),
-	minpos(2*(maxlayer+1),{
-                {0.0f,0.0f}
-        }),
-	maxpos(2*(maxlayer+1),{ {0.0f,0.0f} })
+        points(2*(maxlayer+1))
 {
 }
 
@@ -145,11 +138,6 @@ void reset(){
                 it.clear();
                 std::vector<KDNode>().swap(it);
         }
-        for(unsigned int i = 0; i < minpos.size(); i++)
-        {
-                minpos[i][0]=0.; minpos[i][1]=0.;
-                maxpos[i][0]=0.; maxpos[i][1]=0.;
-        }
 }
 void computeThreshold();
 
@@ -248,7 +236,6 @@ struct Hexel {
 
 };
 
-typedef KDTreeLinkerAlgo<Hexel,2> KDTree;
 typedef KDTreeNodeInfoT<Hexel,2> KDNode;
 
 
@@ -267,9 +254,6 @@ std::vector<size_t> sort_by_delta(const std::vector<KDNode> &v) const {
 std::vector<std::vector<KDNode> > points;   //a vector of vectors of hexels, one for each layer
 //@@EM todo: the number of layers should be obtained programmatically - the range is 1-n instead of 0-n-1...
 
-std::vector<std::array<float,2> > minpos;
-std::vector<std::array<float,2> > maxpos;
-
 
 //these functions should be in a helper class.
 inline double distance2(const Hexel &pt1, const Hexel &pt2) const{   //distance squared
@@ -280,9 +264,15 @@ inline double distance2(const Hexel &pt1, const Hexel &pt2) const{   //distance
 inline double distance(const Hexel &pt1, const Hexel &pt2) const{   //2-d distance on the layer (x-y)
         return std::sqrt(distance2(pt1,pt2));
 }
-double calculateLocalDensity(std::vector<KDNode> &, KDTree &, const unsigned int) const;   //return max density
-double calculateDistanceToHigher(std::vector<KDNode> &) const;
-int findAndAssignClusters(std::vector<KDNode> &, KDTree &, double, KDTreeBox &, const unsigned int, std::vector<std::vector<KDNode> >&) const;
+// maximum search distance (critical distance) on the layer
+float criticalDistance(const unsigned int layer) const {
+        if (layer <= lastLayerEE) return vecDeltas[0];
+        if (layer <= lastLayerFH) return vecDeltas[1];
+        return vecDeltas[2];
+}
+double calculateLocalDensity(std::vector<KDNode> &, const HGCalLayerTiles &, const unsigned int) const;   //return max density
+double calculateDistanceToHigher(std::vector<KDNode> &, const HGCalLayerTiles &) const;
+int findAndAssignClusters(std::vector<KDNode> &, const HGCalLayerTiles &, double, const unsigned int, std::vector<std::vector<KDNode> >&) const;
 math::XYZPoint calculatePosition(std::vector<KDNode> &) const;
 
 // attempt to find subclusters within a given set of hexels
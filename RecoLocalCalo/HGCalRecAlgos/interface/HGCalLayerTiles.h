@@ -0,0 +1,92 @@
+#ifndef RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+#define RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+
+// Fixed-size square tiles in x-y over the hits of one HGCal layer, used by
+// the imaging algorithm instead of a KD-tree.
+// The positions and weights are copied in SoA layout and sorted by tile
+// (row-major, and by hit index inside a tile): the hits of consecutive tiles
+// of a row are contiguous, so a search window is one range of the arrays per
+// row of tiles, without any allocation.
+// The hits are referred to by their index in the order of push_back.
+
+#include <cstddef>
+#include <vector>
+
+class HGCalLayerTiles {
+public:
+  void clear();
+  void push_back(float x, float y, float weight);
+  // to be called once all the hits are added: tiles of side at least
+  // tileSize over the bounding box of the hits
+  void build(float tileSize);
+
+  size_t size() const { return x_.size(); }
+  double tileSize() const { return size_; }
+
+  // sum of the weights of the hits closer than delta_c (the hit itself
+  // included) for every hit, returns the maximum
+  double localDensity(float delta_c, std::vector<double> &rho) const;
+  // distance to the nearest hit of higher density and its index (-1 and the
+  // distance to the farthest hit for the highest density), rs being the
+  // indices sorted by decreasing density.
+  // Identical to the exhaustive search over rs: the ties in distance go to
+  // the last hit in rs.
+  void distanceToHigher(const std::vector<size_t> &rs,
+                        std::vector<double> &delta,
+                        std::vector<int> &nearestHigher) const;
+  // calls f(j) for the hits j of the tiles overlapping the square of half
+  // side distance around (x,y): a superset of the hits closer than distance
+  template <typename F>
+  void forEachCandidate(float x, float y, float distance, F f) const;
+
+private:
+  int tileX(double x) const;
+  int tileY(double y) const;
+  // range of the hits of the tiles [tx0, tx1] of the row ty
+  size_t rowBegin(int ty, int tx0) const { return tileStart_[ty * nx_ + tx0]; }
+  size_t rowEnd(int ty, int tx1) const { return tileStart_[ty * nx_ + tx1 + 1]; }
+
+  // by tile
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<float> weight_;
+  std::vector<unsigned int> index_;
+  // position of the hit in the arrays above, by hit index
+  std::vector<unsigned int> position_;
+
+  std::vector<unsigned int> tileStart_;
+  double minX_ = 0.;
+  double minY_ = 0.;
+  double size_ = 0.;
+  double invSize_ = 0.;
+  int nx_ = 0;
+  int ny_ = 0;
+};
+
+inline int HGCalLayerTiles::tileX(double x) const {
+  int t = (x - minX_) * invSize_;
+  return t < 0 ? 0 : (t >= nx_ ? nx_ - 1 : t);
+}
+
+inline int HGCalLayerTiles::tileY(double y) const {
+  int t = (y - minY_) * invSize_;
+  return t < 0 ? 0 : (t >= ny_ ? ny_ - 1 : t);
+}
+
+template <typename F>
+void HGCalLayerTiles::forEachCandidate(float x, float y, float distance,
+                                       F f) const {
+  if (index_.empty())
+    return;
+  // a little wider than the window, against the rounding of the tile indices
+  const double d = distance + 1.e-4;
+  const int tx0 = tileX(x - d), tx1 = tileX(x + d);
+  const int ty0 = tileY(y - d), ty1 = tileY(y + d);
+  for (int ty = ty0; ty <= ty1; ++ty) {
+    const size_t end = rowEnd(ty, tx1);
+    for (size_t q = rowBegin(ty, tx0); q < end; ++q)
+      f(index_[q]);
+  }
+}
+
+#endif
@@ -21,7 +21,6 @@ void HGCalImagingAlgo::populate(const HGCRecHitCollection &hits) {
     computeThreshold();
   }
 
-  std::vector<bool> firstHit(2 * (maxlayer + 1), true);
   for (unsigned int i = 0; i < hits.size(); ++i) {
 
     const HGCRecHit &hgrh = hits[i];
@@ -54,28 +53,11 @@ void HGCalImagingAlgo::populate(const HGCRecHitCollection &hits) {
 
     // determine whether this is a half-hexagon
     bool isHalf = rhtools_.isHalfCell(detid);
-    const GlobalPoint position(rhtools_.getPosition(detid));
 
     // here's were the KDNode is passed its dims arguments - note that these are
-    // *copied* from the Hexel
-    points[layer].emplace_back(
-        Hexel(hgrh, detid, isHalf, sigmaNoise, thickness, &rhtools_),
-        position.x(), position.y());
-
-    // for each layer, store the minimum and maximum x and y coordinates for the
-    // KDTreeBox boundaries
-    if (firstHit[layer]) {
-      minpos[layer][0] = position.x();
-      minpos[layer][1] = position.y();
-      maxpos[layer][0] = position.x();
-      maxpos[layer][1] = position.y();
-      firstHit[layer] = false;
-    } else {
-      minpos[layer][0] = std::min((float)position.x(), minpos[layer][0]);
-      minpos[layer][1] = std::min((float)position.y(), minpos[layer][1]);
-      maxpos[layer][0] = std::max((float)position.x(), maxpos[layer][0]);
-      maxpos[layer][1] = std::max((float)position.y(), maxpos[layer][1]);
-    }
+    // *copied* from the Hexel (which gets the position of the cell)
+    const Hexel hexel(hgrh, detid, isHalf, sigmaNoise, thickness, &rhtools_);
+    points[layer].emplace_back(hexel, float(hexel.x), float(hexel.y));
 
   } // end loop hits
 }
@@ -88,23 +70,26 @@ void HGCalImagingAlgo::makeClusters() {
   // assign all hits in each layer to a cluster core or halo
   tbb::this_task_arena::isolate([&] {
     tbb::parallel_for(size_t(0), size_t(2 * maxlayer + 2), [&](size_t i) {
-      KDTreeBox bounds(minpos[i][0], maxpos[i][0], minpos[i][1], maxpos[i][1]);
-      KDTree hit_kdtree;
-      hit_kdtree.build(points[i], bounds);
-
       unsigned int actualLayer =
           i > maxlayer
               ? (i - (maxlayer + 1))
-              : i; // maps back from index used for KD trees to actual layer
+              : i; // maps back from index used for the tiles to actual layer
+
+      // tiles of the size of the critical distance: the search windows span
+      // 3x3 tiles
+      HGCalLayerTiles tiles;
+      for (const auto &node : points[i])
+        tiles.push_back(node.dims[0], node.dims[1], node.data.weight);
+      tiles.build(criticalDistance(actualLayer));
 
       double maxdensity = calculateLocalDensity(
-          points[i], hit_kdtree, actualLayer); // also stores rho (energy
-                                               // density) for each point (node)
+          points[i], tiles, actualLayer); // also stores rho (energy
+                                          // density) for each point (node)
       // calculate distance to nearest point with higher density storing
       // distance (delta) and point's index
-      calculateDistanceToHigher(points[i]);
-      findAndAssignClusters(points[i], hit_kdtree, maxdensity, bounds,
-                            actualLayer, layerClustersPerLayer[i]);
+      calculateDistanceToHigher(points[i], tiles);
+      findAndAssignClusters(points[i], tiles, maxdensity, actualLayer,
+                            layerClustersPerLayer[i]);
     });
   });
 }
@@ -231,91 +216,42 @@ HGCalImagingAlgo::calculatePosition(std::vector<KDNode> &v) const {
 }
 
 double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd,
-                                               KDTree &lp,
+                                               const HGCalLayerTiles &lp,
                                                const unsigned int layer) const {
 
-  double maxdensity = 0.;
-  float delta_c; // maximum search distance (critical distance) for local
-                 // density calculation
-  if (layer <= lastLayerEE)
-    delta_c = vecDeltas[0];
-  else if (layer <= lastLayerFH)
-    delta_c = vecDeltas[1];
-  else
-    delta_c = vecDeltas[2];
-
   // for each node calculate local density rho and store it
-  for (unsigned int i = 0; i < nd.size(); ++i) {
-    // speec up search by looking within +/- delta_c window only
-    KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                         nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-    std::vector<KDNode> found;
-    lp.search(search_box, found);
-    const unsigned int found_size = found.size();
-    for (unsigned int j = 0; j < found_size; j++) {
-      if (distance(nd[i].data, found[j].data) < delta_c) {
-        nd[i].data.rho += found[j].data.weight;
-        maxdensity = std::max(maxdensity, nd[i].data.rho);
-      }
-    } // end loop found
-  }   // end loop nodes
+  std::vector<double> rho;
+  double maxdensity = lp.localDensity(criticalDistance(layer), rho);
+  for (unsigned int i = 0; i < nd.size(); ++i)
+    nd[i].data.rho = rho[i];
   return maxdensity;
 }
 
 double
-HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd) const {
+HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd,
+                                            const HGCalLayerTiles &lp) const {
 
   // sort vector of Hexels by decreasing local density
   std::vector<size_t> rs = sorted_indices(nd);
 
-  double maxdensity = 0.0;
-  int nearestHigher = -1;
-
-  if (!rs.empty())
-    maxdensity = nd[rs[0]].data.rho;
-  else
-    return maxdensity; // there are no hits
-  double dist2 = 0.;
-  // start by setting delta for the highest density hit to
-  // the most distant hit - this is a convention
-
-  for (auto &j : nd) {
-    double tmp = distance2(nd[rs[0]].data, j.data);
-    if (tmp > dist2)
-      dist2 = tmp;
-  }
-  nd[rs[0]].data.delta = std::sqrt(dist2);
-  nd[rs[0]].data.nearestHigher = nearestHigher;
-
-  // now we save the largest distance as a starting point
-  const double max_dist2 = dist2;
-  const unsigned int nd_size = nd.size();
+  if (rs.empty())
+    return 0.; // there are no hits
 
-  for (unsigned int oi = 1; oi < nd_size;
-       ++oi) { // start from second-highest density
-    dist2 = max_dist2;
-    unsigned int i = rs[oi];
-    // we only need to check up to oi since hits
-    // are ordered by decreasing density
-    // and all points coming BEFORE oi are guaranteed to have higher rho
-    // and the ones AFTER to have lower rho
-    for (unsigned int oj = 0; oj < oi; ++oj) {
-      unsigned int j = rs[oj];
-      double tmp = distance2(nd[i].data, nd[j].data);
-      if (tmp <= dist2) { // this "<=" instead of "<" addresses the (rare) case
-                          // when there are only two hits
-        dist2 = tmp;
-        nearestHigher = j;
-      }
-    }
-    nd[i].data.delta = std::sqrt(dist2);
+  // delta is the distance to the nearest hit of higher density, the highest
+  // density hit gets the distance to the most distant hit - this is a
+  // convention
+  std::vector<double> delta;
+  std::vector<int> nearestHigher;
+  lp.distanceToHigher(rs, delta, nearestHigher);
+  for (unsigned int i = 0; i < nd.size(); ++i) {
+    nd[i].data.delta = delta[i];
     nd[i].data.nearestHigher =
-        nearestHigher; // this uses the original unsorted hitlist
+        nearestHigher[i]; // this uses the original unsorted hitlist
   }
-  return maxdensity;
+  return nd[rs[0]].data.rho;
 }
 int HGCalImagingAlgo::findAndAssignClusters(
-    std::vector<KDNode> &nd, KDTree &lp, double maxdensity, KDTreeBox &bounds,
+    std::vector<KDNode> &nd, const HGCalLayerTiles &lp, double maxdensity,
     const unsigned int layer,
     std::vector<std::vector<KDNode>> &clustersOnLayer) const {
 
@@ -325,13 +261,7 @@ int HGCalImagingAlgo::findAndAssignClusters(
   // cluster centers...
 
   unsigned int nClustersOnLayer = 0;
-  float delta_c; // critical distance
-  if (layer <= lastLayerEE)
-    delta_c = vecDeltas[0];
-  else if (layer <= lastLayerFH)
-    delta_c = vecDeltas[1];
-  else
-    delta_c = vecDeltas[2];
+  float delta_c = criticalDistance(layer); // critical distance
 
   std::vector<size_t> rs =
       sorted_indices(nd); // indices sorted by decreasing rho
@@ -389,43 +319,34 @@ int HGCalImagingAlgo::findAndAssignClusters(
   // assign points closer than dc to other clusters to border region
   // and find critical border density
   std::vector<double> rho_b(nClustersOnLayer, 0.);
-  lp.clear();
-  lp.build(nd, bounds);
   // now loop on all hits again :( and check: if there are hits from another
   // cluster within d_c -> flag as border hit
   for (unsigned int i = 0; i < nd_size; ++i) {
     int ci = nd[i].data.clusterIndex;
     bool flag_isolated = true;
     if (ci != -1) {
-      KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                           nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-      std::vector<KDNode> found;
-      lp.search(search_box, found);
-
-      const unsigned int found_size = found.size();
-      for (unsigned int j = 0; j < found_size;
-           j++) { // start from 0 here instead of 1
+      bool flag_border = false;
+      lp.forEachCandidate(nd[i].dims[0], nd[i].dims[1], delta_c,
+                          [&](unsigned int j) {
         // check if the hit is not within d_c of another cluster
-        if (found[j].data.clusterIndex != -1) {
-          float dist = distance(found[j].data, nd[i].data);
-          if (dist < delta_c && found[j].data.clusterIndex != ci) {
-            // in which case we assign it to the border
-            nd[i].data.isBorder = true;
-            break;
-          }
-          // because we are using two different containers, we have to make sure
-          // that we don't unflag the
-          // hit when it finds *itself* closer than delta_c
-          if (dist < delta_c && dist != 0. &&
-              found[j].data.clusterIndex == ci) {
-            // in this case it is not an isolated hit
-            // the dist!=0 is because the hit being looked at is also inside the
-            // search box and at dist==0
-            flag_isolated = false;
-          }
+        if (flag_border || nd[j].data.clusterIndex == -1)
+          return;
+        float dist = distance(nd[j].data, nd[i].data);
+        if (dist < delta_c && nd[j].data.clusterIndex != ci) {
+          // in which case we assign it to the border
+          flag_border = true;
+          return;
         }
-      }
-      if (flag_isolated)
+        // we have to make sure that we don't unflag the hit when it finds
+        // *itself* closer than delta_c
+        if (dist < delta_c && dist != 0. && nd[j].data.clusterIndex == ci) {
+          // in this case it is not an isolated hit
+          // the dist!=0 is because the hit being looked at is also inside the
+          // search box and at dist==0
+          flag_isolated = false;
+        }
+      });
+      if (flag_border || flag_isolated)
         nd[i].data.isBorder =
             true; // the hit is more than delta_c from any of its brethren
     }
@@ -0,0 +1,201 @@
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// against the rounding of the tile indices in the bounds on the distances
+const double kMargin = 1.e-4;
+// beyond this number of tiles per side the tiles get larger than requested:
+// the search windows would cross too many empty tiles
+const int kMaxTiles = 256;
+} // namespace
+
+void HGCalLayerTiles::clear() {
+  x_.clear();
+  y_.clear();
+  weight_.clear();
+  index_.clear();
+  position_.clear();
+  tileStart_.clear();
+  nx_ = ny_ = 0;
+}
+
+void HGCalLayerTiles::push_back(float x, float y, float weight) {
+  x_.push_back(x);
+  y_.push_back(y);
+  weight_.push_back(weight);
+}
+
+void HGCalLayerTiles::build(float tileSize) {
+  const unsigned int n = x_.size();
+  index_.clear();
+  position_.clear();
+  tileStart_.clear();
+  nx_ = ny_ = 0;
+  if (n == 0)
+    return;
+
+  const auto xrange = std::minmax_element(x_.begin(), x_.end());
+  const auto yrange = std::minmax_element(y_.begin(), y_.end());
+  minX_ = *xrange.first;
+  minY_ = *yrange.first;
+  const double extent = std::max<double>(*xrange.second - minX_,
+                                         *yrange.second - minY_);
+  size_ = std::max<double>(tileSize, extent / (kMaxTiles - 1));
+  if (size_ <= 0.)
+    size_ = 1.;
+  invSize_ = 1. / size_;
+  nx_ = std::min(kMaxTiles, int((*xrange.second - minX_) * invSize_) + 1);
+  ny_ = std::min(kMaxTiles, int((*yrange.second - minY_) * invSize_) + 1);
+
+  // counting sort by tile, stable: by index inside a tile
+  std::vector<unsigned int> tile(n);
+  tileStart_.assign(nx_ * ny_ + 1, 0);
+  for (unsigned int i = 0; i < n; ++i) {
+    tile[i] = tileY(y_[i]) * nx_ + tileX(x_[i]);
+    ++tileStart_[tile[i] + 1];
+  }
+  for (int t = 0; t < nx_ * ny_; ++t)
+    tileStart_[t + 1] += tileStart_[t];
+
+  std::vector<float> x(n), y(n), weight(n);
+  std::vector<unsigned int> fill(tileStart_.begin(), tileStart_.end() - 1);
+  index_.resize(n);
+  position_.resize(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    const unsigned int p = fill[tile[i]]++;
+    x[p] = x_[i];
+    y[p] = y_[i];
+    weight[p] = weight_[i];
+    index_[p] = i;
+    position_[i] = p;
+  }
+  x_.swap(x);
+  y_.swap(y);
+  weight_.swap(weight);
+}
+
+double HGCalLayerTiles::localDensity(float delta_c,
+                                     std::vector<double> &rho) const {
+  const unsigned int n = size();
+  rho.assign(n, 0.);
+  double maxdensity = 0.;
+  const double d = delta_c + kMargin;
+
+  // in the order of the tiles, the windows of consecutive hits overlap
+  for (unsigned int p = 0; p < n; ++p) {
+    const double xi = x_[p];
+    const double yi = y_[p];
+    const int tx0 = tileX(xi - d), tx1 = tileX(xi + d);
+    const int ty0 = tileY(yi - d), ty1 = tileY(yi + d);
+    double sum = 0.;
+    for (int ty = ty0; ty <= ty1; ++ty) {
+      // no branch: the distances of the range can be computed in parallel
+      const size_t end = rowEnd(ty, tx1);
+      for (size_t q = rowBegin(ty, tx0); q < end; ++q) {
+        const double dx = xi - x_[q];
+        const double dy = yi - y_[q];
+        sum += std::sqrt(dx * dx + dy * dy) < delta_c ? double(weight_[q]) : 0.;
+      }
+    }
+    rho[index_[p]] = sum;
+    maxdensity = std::max(maxdensity, sum);
+  }
+  return maxdensity;
+}
+
+void HGCalLayerTiles::distanceToHigher(const std::vector<size_t> &rs,
+                                       std::vector<double> &delta,
+                                       std::vector<int> &nearestHigher) const {
+  const unsigned int n = size();
+  delta.assign(n, 0.);
+  nearestHigher.assign(n, -1);
+  if (n == 0)
+    return;
+
+  // rank in rs, by position in the tiles
+  std::vector<unsigned int> rank(n);
+  for (unsigned int oi = 0; oi < n; ++oi)
+    rank[position_[rs[oi]]] = oi;
+
+  // the highest density hit gets the distance to the most distant hit, by
+  // convention
+  const unsigned int top = position_[rs[0]];
+  double maxDist2 = 0.;
+  for (unsigned int q = 0; q < n; ++q) {
+    const double dx = double(x_[top]) - x_[q];
+    const double dy = double(y_[top]) - y_[q];
+    maxDist2 = std::max(maxDist2, dx * dx + dy * dy);
+  }
+  delta[rs[0]] = std::sqrt(maxDist2);
+
+  for (unsigned int oi = 1; oi < n; ++oi) {
+    const unsigned int p = position_[rs[oi]];
+    const double xi = x_[p];
+    const double yi = y_[p];
+    const int tx = tileX(xi), ty = tileY(yi);
+    const int maxRing =
+        std::max(std::max(tx, nx_ - 1 - tx), std::max(ty, ny_ - 1 - ty));
+
+    // rings of tiles around the hit, until the ones left can only be farther
+    // than the nearest one found; beyond the tiles of as many hits as the
+    // ones of higher density, scanning them is cheaper
+    double dist2 = maxDist2;
+    int best = -1;
+    bool exhaustive = false;
+    for (int k = 0; k <= maxRing; ++k) {
+      const double bound = (k - 1) * size_ - kMargin;
+      if (best >= 0 && bound > 0. && dist2 < bound * bound)
+        break;
+      if ((2 * k + 1) * (2 * k + 1) > int(oi)) {
+        exhaustive = true;
+        break;
+      }
+      for (int oy = -k; oy <= k; ++oy) {
+        const int row = ty + oy;
+        if (row < 0 || row >= ny_)
+          continue;
+        // the whole row of tiles on the top and bottom of the ring, the two
+        // ends of it otherwise
+        const bool full = (oy == -k || oy == k);
+        for (int col = tx - k; col <= tx + k; col += (full ? 2 * k + 1 : 2 * k)) {
+          const int col0 = full ? std::max(col, 0) : col;
+          const int col1 = full ? std::min(tx + k, nx_ - 1) : col;
+          if (col1 < 0 || col0 >= nx_)
+            continue;
+          const size_t end = rowEnd(row, col1);
+          for (size_t q = rowBegin(row, col0); q < end; ++q) {
+            if (rank[q] >= oi)
+              continue;
+            const double dx = xi - x_[q];
+            const double dy = yi - y_[q];
+            const double tmp = dx * dx + dy * dy;
+            if (tmp < dist2 || (tmp == dist2 && int(rank[q]) > best)) {
+              dist2 = tmp;
+              best = rank[q];
+            }
+          }
+        }
+      }
+    }
+
+    if (exhaustive) {
+      dist2 = maxDist2;
+      best = -1;
+      for (unsigned int oj = 0; oj < oi; ++oj) {
+        const unsigned int q = position_[rs[oj]];
+        const double dx = xi - x_[q];
+        const double dy = yi - y_[q];
+        const double tmp = dx * dx + dy * dy;
+        if (tmp <= dist2) {
+          dist2 = tmp;
+          best = oj;
+        }
+      }
+    }
+
+    delta[rs[oi]] = std::sqrt(dist2);
+    nearestHigher[rs[oi]] = rs[best];
+  }
+}
@@ -0,0 +1,191 @@
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/*
+ * Validation and benchmark of the tiles of the HGCal imaging algorithm.
+ *
+ *   testHGCalLayerTiles [hits per layer in the first layer]
+ *
+ * The local densities and the distances to the nearest hit of higher density
+ * computed with the tiles are compared with the exhaustive loops of the
+ * algorithm on a few layers, then the time of the clustering steps of a
+ * Phase-2 like event (2x52 layers, showers on top of a uniform occupancy
+ * decreasing with the depth) is printed for an increasing number of threads.
+ */
+
+namespace {
+
+  struct Layer {
+    std::vector<float> x, y, weight;
+  };
+
+  Layer makeLayer(std::mt19937 &rng, unsigned int nHits) {
+    Layer layer;
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    std::exponential_distribution<float> energy(20.f);
+    std::normal_distribution<float> shower(0.f, 1.5f);
+    float sx = 0.f, sy = 0.f;
+    for (unsigned int i = 0; i < nHits; ++i) {
+      float x, y;
+      if (i % 4 == 0) {
+        // uniform in the annulus of the endcap
+        const float r = 30.f + 130.f * std::sqrt(uniform(rng));
+        const float phi = 2.f * M_PI * uniform(rng);
+        x = r * std::cos(phi);
+        y = r * std::sin(phi);
+        sx = x;
+        sy = y;
+      } else {
+        // the other hits in showers
+        x = sx + shower(rng);
+        y = sy + shower(rng);
+      }
+      // the cells of about 1 cm: some hits at the same distance
+      layer.x.push_back(std::round(x * 2.f) / 2.f);
+      layer.y.push_back(std::round(y * 2.f) / 2.f);
+      layer.weight.push_back(energy(rng));
+    }
+    return layer;
+  }
+
+  std::vector<size_t> sortedByDensity(const std::vector<double> &rho) {
+    std::vector<size_t> idx(rho.size());
+    std::iota(idx.begin(), idx.end(), 0);
+    std::sort(idx.begin(), idx.end(),
+              [&rho](size_t i1, size_t i2) { return rho[i1] > rho[i2]; });
+    return idx;
+  }
+
+  // the loops of HGCalImagingAlgo before the tiles
+  void reference(const Layer &layer, float delta_c, std::vector<double> &rho,
+                 const std::vector<size_t> &rs, std::vector<double> &delta,
+                 std::vector<int> &nearestHigher) {
+    const unsigned int n = layer.x.size();
+    rho.assign(n, 0.);
+    for (unsigned int i = 0; i < n; ++i)
+      for (unsigned int j = 0; j < n; ++j) {
+        const double dx = double(layer.x[i]) - layer.x[j];
+        const double dy = double(layer.y[i]) - layer.y[j];
+        if (std::sqrt(dx * dx + dy * dy) < delta_c)
+          rho[i] += layer.weight[j];
+      }
+    delta.assign(n, 0.);
+    nearestHigher.assign(n, -1);
+    double dist2 = 0.;
+    for (unsigned int j = 0; j < n; ++j) {
+      const double dx = double(layer.x[rs[0]]) - layer.x[j];
+      const double dy = double(layer.y[rs[0]]) - layer.y[j];
+      dist2 = std::max(dist2, dx * dx + dy * dy);
+    }
+    delta[rs[0]] = std::sqrt(dist2);
+    const double max_dist2 = dist2;
+    for (unsigned int oi = 1; oi < n; ++oi) {
+      dist2 = max_dist2;
+      const unsigned int i = rs[oi];
+      for (unsigned int oj = 0; oj < oi; ++oj) {
+        const unsigned int j = rs[oj];
+        const double dx = double(layer.x[i]) - layer.x[j];
+        const double dy = double(layer.y[i]) - layer.y[j];
+        const double tmp = dx * dx + dy * dy;
+        if (tmp <= dist2) {
+          dist2 = tmp;
+          nearestHigher[i] = j;
+        }
+      }
+      delta[i] = std::sqrt(dist2);
+    }
+  }
+
+  bool check(const Layer &layer, float delta_c) {
+    HGCalLayerTiles tiles;
+    for (unsigned int i = 0; i < layer.x.size(); ++i)
+      tiles.push_back(layer.x[i], layer.y[i], layer.weight[i]);
+    tiles.build(delta_c);
+
+    std::vector<double> rho, refRho, delta, refDelta;
+    std::vector<int> nearestHigher, refNearestHigher;
+    tiles.localDensity(delta_c, rho);
+    // the same ranking for both, the sums may differ in the last bit
+    std::vector<size_t> rs = sortedByDensity(rho);
+    tiles.distanceToHigher(rs, delta, nearestHigher);
+    reference(layer, delta_c, refRho, rs, refDelta, refNearestHigher);
+
+    unsigned int different = 0;
+    for (unsigned int i = 0; i < rho.size(); ++i) {
+      if (std::abs(rho[i] - refRho[i]) > 1.e-12 * refRho[i])
+        ++different;
+      if (delta[i] != refDelta[i] || nearestHigher[i] != refNearestHigher[i])
+        ++different;
+    }
+    std::cout << layer.x.size() << " hits, delta_c " << delta_c << ": "
+              << different << " differences" << std::endl;
+    return different == 0;
+  }
+
+  void clusterLayer(const Layer &layer, float delta_c) {
+    HGCalLayerTiles tiles;
+    for (unsigned int i = 0; i < layer.x.size(); ++i)
+      tiles.push_back(layer.x[i], layer.y[i], layer.weight[i]);
+    tiles.build(delta_c);
+    std::vector<double> rho, delta;
+    std::vector<int> nearestHigher;
+    tiles.localDensity(delta_c, rho);
+    tiles.distanceToHigher(sortedByDensity(rho), delta, nearestHigher);
+  }
+} // namespace
+
+int main(int argc, char **argv) {
+  const unsigned int maxHits = argc > 1 ? std::atoi(argv[1]) : 12000;
+  std::mt19937 rng(2018);
+
+  bool ok = true;
+  ok &= check(makeLayer(rng, 1), 2.f);
+  ok &= check(makeLayer(rng, 7), 2.f);
+  ok &= check(makeLayer(rng, 3000), 2.f);
+  ok &= check(makeLayer(rng, 3000), 5.f);
+  ok &= check(makeLayer(rng, 500), 0.3f);
+
+  // both endcaps, the occupancy falls with the depth
+  const unsigned int nLayers = 52;
+  std::vector<Layer> event;
+  std::vector<float> deltas;
+  for (unsigned int side = 0; side < 2; ++side)
+    for (unsigned int l = 1; l <= nLayers; ++l) {
+      event.push_back(makeLayer(rng, maxHits * std::exp(-0.06 * l) + 50));
+      deltas.push_back(l <= 40 ? 2.f : 5.f);
+    }
+
+  double single = 0.;
+  for (int threads = 1; threads <= 8; threads *= 2) {
+    tbb::task_arena arena(threads);
+    const int repeat = 5;
+    auto start = std::chrono::steady_clock::now();
+    arena.execute([&] {
+      for (int r = 0; r < repeat; ++r)
+        tbb::parallel_for(size_t(0), event.size(), [&](size_t i) {
+          clusterLayer(event[i], deltas[i]);
+        });
+    });
+    const double t = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count() /
+                     repeat;
+    if (threads == 1)
+      single = t;
+    std::cout << threads << " threads: " << t << " ms per event (x"
+              << single / t << ")" << std::endl;
+  }
+
+  return ok ? 0 : 1;
+}
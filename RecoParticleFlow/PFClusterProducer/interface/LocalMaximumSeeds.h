@@ -0,0 +1,59 @@
+#ifndef RecoParticleFlow_PFClusterProducer_LocalMaximumSeeds_h
+#define RecoParticleFlow_PFClusterProducer_LocalMaximumSeeds_h
+
+#include "CommonTools/Utils/interface/DynArray.h"
+
+#include <queue>
+#include <vector>
+
+// Seed selection of the LocalMaximumSeedFinder, once the rechits passing the
+// thresholds are known.
+//
+// A rechit with a higher neighbour is never a seed, whatever the order in
+// which the rechits are visited: only the local maxima need to be run over
+// in energy order, for the suppression of the neighbours of the seeds.
+// Neighbours of equal energy are both local maxima, the one with the lower
+// index is taken first, so that the seeds do not depend on the content of
+// the queue.
+//
+// energies[i] and usable[i] are read for the rechits in the mask, usable is
+// updated with the neighbours of the seeds; neighboursOf(i) gives the
+// indices of the neighbours of the rechit i.
+namespace pfseeding {
+
+  template <typename Energies, typename Usable, typename NeighboursOf>
+  void localMaximumSeeds(unsigned int nhits,
+                         const std::vector<bool>& mask,
+                         const Energies& energies,
+                         Usable& usable,
+                         NeighboursOf neighboursOf,
+                         std::vector<bool>& seedable) {
+    unInitDynArray(int,nhits,qst); // queue storage
+    auto cmp = [&](int i, int j) {
+      return energies[i] < energies[j] || ( energies[i] == energies[j] && i > j );
+    };
+    std::priority_queue<int, DynArray<int>, decltype(cmp)> ordered_hits(cmp,std::move(qst));
+
+    for( unsigned i = 0; i < nhits; ++i ) {
+      if( !mask[i] || !usable[i] ) continue;
+      bool maximum = true;
+      for( auto neighbour : neighboursOf(i) ) {
+        maximum &= !( mask[neighbour] && energies[neighbour] > energies[i] );
+      }
+      if( maximum ) ordered_hits.push(i);
+    }
+
+    while(!ordered_hits.empty() ) {
+      auto idx = ordered_hits.top();
+      ordered_hits.pop();
+      if( !usable[idx] ) continue;
+      seedable[idx] = true;
+      for( auto neighbour : neighboursOf(idx) ) {
+        usable[neighbour] = false;
+      }
+    }
+  }
+
+}
+
+#endif
@@ -99,12 +99,13 @@ buildClusters(const reco::PFClusterCollection& input,
 	      const std::vector<bool>& seedable,
 	      reco::PFClusterCollection& output) {
   reco::PFClusterCollection clustersInTopo;
+  TopoHits topoHits;
   for( const auto& topocluster : input ) {
     clustersInTopo.clear();
     seedPFClustersFromTopo(topocluster,seedable,clustersInTopo);
     const unsigned tolScal = 
       std::pow(std::max(1.0,clustersInTopo.size()-1.0),2.0);
-    growPFClusters(topocluster,seedable,tolScal,0,tolScal,clustersInTopo);
+    growPFClusters(topocluster,seedable,topoHits,tolScal,0,tolScal,clustersInTopo);
     // step added by Josh Bendavid, removes low-fraction clusters
     // did not impact position resolution with fraction cut of 1e-7
     // decreases the size of each pf cluster considerably
@@ -146,37 +147,13 @@ seedPFClustersFromTopo(const reco::PFCluster& topo,
 }
 
 void Basic2DGenericPFlowClusterizer::
-growPFClusters(const reco::PFCluster& topo,
-	       const std::vector<bool>& seedable,
-	       const unsigned toleranceScaling,
-	       const unsigned iter,
-	       double diff,
-	       reco::PFClusterCollection& clusters) const {
-  if( iter >= _maxIterations ) {
-    LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
-      <<"reached " << _maxIterations << " iterations, terminated position "
-      << "fit with diff = " << diff;
-  }      
-  if( iter >= _maxIterations || 
-      diff <= _stoppingTolerance*toleranceScaling) return;
-  // reset the rechits in this cluster, keeping the previous position    
-  std::vector<reco::PFCluster::REPPoint> clus_prev_pos;  
-  for( auto& cluster : clusters) {
-    const reco::PFCluster::REPPoint& repp = cluster.positionREP();
-    clus_prev_pos.emplace_back(repp.rho(),repp.eta(),repp.phi());
-    if( _convergencePosCalc ) {
-      if( clusters.size() == 1 && _allCellsPosCalc ) {
-	_allCellsPosCalc->calculateAndSetPosition(cluster);
-      } else {
-	_positionCalc->calculateAndSetPosition(cluster);
-      }
-    }
-    cluster.resetHitsAndFractions();
-  }
-  // loop over topo cluster and grow current PFCluster hypothesis 
-  std::vector<double> dist2, frac;
-  double fractot = 0;
-  for( const reco::PFRecHitFraction& rhf : topo.recHitFractions() ) {
+fillTopoHits(const reco::PFCluster& topo,
+	     const std::vector<bool>& seedable,
+	     TopoHits& hits) const {
+  const auto& recHitFractions = topo.recHitFractions();
+  hits.x.clear(); hits.y.clear(); hits.z.clear();
+  hits.energyNorm.clear(); hits.detId.clear(); hits.seedable.clear();
+  for( const reco::PFRecHitFraction& rhf : recHitFractions ) {
     const reco::PFRecHitRef& refhit = rhf.recHitRef();
     int cell_layer = (int)refhit->layer();
     if( cell_layer == PFLayer::HCAL_BARREL2 && 
@@ -184,8 +161,10 @@ growPFClusters(const reco::PFCluster& topo,
       cell_layer *= 100;
     }  
 
-    math::XYZPoint topocellpos_xyz(refhit->position());
-    dist2.clear(); frac.clear(); fractot = 0;
+    const math::XYZPoint topocellpos_xyz(refhit->position());
+    hits.x.push_back(topocellpos_xyz.x());
+    hits.y.push_back(topocellpos_xyz.y());
+    hits.z.push_back(topocellpos_xyz.z());
 
     double recHitEnergyNorm=0.;
     auto const& recHitEnergyNormDepthPair = _recHitEnergyNorms.find(cell_layer)->second;
@@ -198,73 +177,128 @@ growPFClusters(const reco::PFCluster& topo,
 	  || ( cell_layer != PFLayer::HCAL_ENDCAP && cell_layer != PFLayer::HCAL_BARREL1)
 	  ) recHitEnergyNorm = recHitEnergyNormDepthPair.second[j];
     }
+    hits.energyNorm.push_back(recHitEnergyNorm);
+    hits.detId.push_back(refhit->detId());
+    hits.seedable.push_back(seedable[refhit.key()]);
+  }
+}
 
-    // add rechits to clusters, calculating fraction based on distance
-    for( auto& cluster : clusters ) {      
-      const math::XYZPoint& clusterpos_xyz = cluster.position();
-      const math::XYZVector deltav = clusterpos_xyz - topocellpos_xyz;
-      const double d2 = deltav.Mag2()/_showerSigma2;
-      dist2.emplace_back( d2 );
-      if( d2 > 100 ) {
-	LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
-	  << "Warning! :: pfcluster-topocell distance is too large! d= "
-	  << d2;
+void Basic2DGenericPFlowClusterizer::
+growPFClusters(const reco::PFCluster& topo,
+	       const std::vector<bool>& seedable,
+	       TopoHits& hits,
+	       const unsigned toleranceScaling,
+	       unsigned iter,
+	       double diff,
+	       reco::PFClusterCollection& clusters) const {
+  const auto& recHitFractions = topo.recHitFractions();
+  const unsigned nclusters = clusters.size();
+  std::vector<reco::PFCluster::REPPoint> clus_prev_pos;  
+  // the positions, energies and seeds of the clusters during an iteration
+  std::vector<double> clus_x(nclusters), clus_y(nclusters), clus_z(nclusters);
+  std::vector<double> clus_energy(nclusters);
+  std::vector<unsigned> clus_seed(nclusters);
+  std::vector<double> dist2(nclusters), frac(nclusters);
+  for( ; ; ++iter ) {
+    if( iter >= _maxIterations ) {
+      LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
+	<<"reached " << _maxIterations << " iterations, terminated position "
+	<< "fit with diff = " << diff;
+    }      
+    if( iter >= _maxIterations || 
+	diff <= _stoppingTolerance*toleranceScaling) return;
+    if( iter == 0 ) fillTopoHits(topo,seedable,hits);
+    // reset the rechits in this cluster, keeping the previous position    
+    clus_prev_pos.clear();
+    for( unsigned i = 0; i < nclusters; ++i ) {
+      auto& cluster = clusters[i];
+      const reco::PFCluster::REPPoint& repp = cluster.positionREP();
+      clus_prev_pos.emplace_back(repp.rho(),repp.eta(),repp.phi());
+      if( _convergencePosCalc ) {
+	if( nclusters == 1 && _allCellsPosCalc ) {
+	  _allCellsPosCalc->calculateAndSetPosition(cluster);
+	} else {
+	  _positionCalc->calculateAndSetPosition(cluster);
+	}
+      }
+      cluster.resetHitsAndFractions();
+      clus_x[i] = cluster.position().x();
+      clus_y[i] = cluster.position().y();
+      clus_z[i] = cluster.position().z();
+      clus_energy[i] = cluster.energy();
+      clus_seed[i] = cluster.seed().rawId();
+    }
+    // loop over topo cluster and grow current PFCluster hypothesis 
+    for( unsigned k = 0; k < hits.size(); ++k ) {
+      const double hit_x = hits.x[k], hit_y = hits.y[k], hit_z = hits.z[k];
+      for( unsigned i = 0; i < nclusters; ++i ) {
+	const double dx = clus_x[i] - hit_x;
+	const double dy = clus_y[i] - hit_y;
+	const double dz = clus_z[i] - hit_z;
+	dist2[i] = (dx*dx + dy*dy + dz*dz)/_showerSigma2;
       }
 
       // fraction assignment logic
-      double fraction;
-      if( refhit->detId() == cluster.seed() && _excludeOtherSeeds ) {
-	fraction = 1.0;	
-      } else if ( seedable[refhit.key()] && _excludeOtherSeeds ) {
-	fraction = 0.0;
-      } else {
-	fraction = cluster.energy()/recHitEnergyNorm * vdt::fast_expf( -0.5*d2 );
-      }      
-      fractot += fraction;
-      frac.emplace_back(fraction);
-    }
-    for( unsigned i = 0; i < clusters.size(); ++i ) {      
-      if( fractot > _minFracTot || 
-	  ( refhit->detId() == clusters[i].seed() && fractot > 0.0 ) ) {
-	frac[i]/=fractot;
-      } else {
-	continue;
+      double fractot = 0;
+      for( unsigned i = 0; i < nclusters; ++i ) {
+	const double d2 = dist2[i];
+	if( d2 > 100 ) {
+	  LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
+	    << "Warning! :: pfcluster-topocell distance is too large! d= "
+	    << d2;
+	}
+	double fraction;
+	if( hits.detId[k] == clus_seed[i] && _excludeOtherSeeds ) {
+	  fraction = 1.0;	
+	} else if ( hits.seedable[k] && _excludeOtherSeeds ) {
+	  fraction = 0.0;
+	} else {
+	  fraction = clus_energy[i]/hits.energyNorm[k] * vdt::fast_expf( -0.5*d2 );
+	}      
+	fractot += fraction;
+	frac[i] = fraction;
       }
-      // if the fraction has been set to 0, the cell 
-      // is now added to the cluster - careful ! (PJ, 19/07/08)
-      // BUT KEEP ONLY CLOSE CELLS OTHERWISE MEMORY JUST EXPLOSES
-      // (PJ, 15/09/08 <- similar to what existed before the 
-      // previous bug fix, but keeps the close seeds inside, 
-      // even if their fraction was set to zero.)
-      // Also add a protection to keep the seed in the cluster 
-      // when the latter gets far from the former. These cases
-      // (about 1% of the clusters) need to be studied, as 
-      // they create fake photons, in general.
-      // (PJ, 16/09/08) 
-      if( dist2[i] < 100.0 || frac[i] > 0.9999 ) {	
-	clusters[i].addRecHitFraction(reco::PFRecHitFraction(refhit,frac[i]));
+      for( unsigned i = 0; i < nclusters; ++i ) {      
+	if( fractot > _minFracTot || 
+	    ( hits.detId[k] == clus_seed[i] && fractot > 0.0 ) ) {
+	  frac[i]/=fractot;
+	} else {
+	  continue;
+	}
+	// if the fraction has been set to 0, the cell 
+	// is now added to the cluster - careful ! (PJ, 19/07/08)
+	// BUT KEEP ONLY CLOSE CELLS OTHERWISE MEMORY JUST EXPLOSES
+	// (PJ, 15/09/08 <- similar to what existed before the 
+	// previous bug fix, but keeps the close seeds inside, 
+	// even if their fraction was set to zero.)
+	// Also add a protection to keep the seed in the cluster 
+	// when the latter gets far from the former. These cases
+	// (about 1% of the clusters) need to be studied, as 
+	// they create fake photons, in general.
+	// (PJ, 16/09/08) 
+	if( dist2[i] < 100.0 || frac[i] > 0.9999 ) {	
+	  clusters[i].addRecHitFraction(reco::PFRecHitFraction(recHitFractions[k].recHitRef(),frac[i]));
+	}
       }
     }
-  }
-  // recalculate positions and calculate convergence parameter
-  double diff2 = 0.0;  
-  for( unsigned i = 0; i < clusters.size(); ++i ) {
-    if( _convergencePosCalc ) {
-      _convergencePosCalc->calculateAndSetPosition(clusters[i]);
-    } else {
-      if( clusters.size() == 1 && _allCellsPosCalc ) {
-	_allCellsPosCalc->calculateAndSetPosition(clusters[i]);
+    // recalculate positions and calculate convergence parameter
+    double diff2 = 0.0;  
+    for( unsigned i = 0; i < nclusters; ++i ) {
+      if( _convergencePosCalc ) {
+	_convergencePosCalc->calculateAndSetPosition(clusters[i]);
       } else {
-	_positionCalc->calculateAndSetPosition(clusters[i]);
+	if( nclusters == 1 && _allCellsPosCalc ) {
+	  _allCellsPosCalc->calculateAndSetPosition(clusters[i]);
+	} else {
+	  _positionCalc->calculateAndSetPosition(clusters[i]);
+	}
       }
+      const double delta2 = 
+	reco::deltaR2(clusters[i].positionREP(),clus_prev_pos[i]);    
+      if( delta2 > diff2 ) diff2 = delta2;
     }
-    const double delta2 = 
-      reco::deltaR2(clusters[i].positionREP(),clus_prev_pos[i]);    
-    if( delta2 > diff2 ) diff2 = delta2;
+    diff = std::sqrt(diff2);
   }
-  diff = std::sqrt(diff2);
-  dist2.clear(); frac.clear(); clus_prev_pos.clear();// avoid badness
-  growPFClusters(topo,seedable,toleranceScaling,iter+1,diff,clusters);
 }
 
 void Basic2DGenericPFlowClusterizer::
@@ -37,14 +37,29 @@ class Basic2DGenericPFlowClusterizer : public PFClusterBuilderBase {
   std::unique_ptr<PFCPositionCalculatorBase> _allCellsPosCalc;
   std::unique_ptr<PFCPositionCalculatorBase> _convergencePosCalc;
   
+  // the rechits of a topo cluster, laid out once for all the iterations
+  // of the position fit
+  struct TopoHits {
+    std::vector<double> x, y, z;
+    std::vector<double> energyNorm;
+    std::vector<unsigned> detId;
+    std::vector<bool> seedable;
+    unsigned size() const { return detId.size(); }
+  };
+
   void seedPFClustersFromTopo(const reco::PFCluster&,
 			      const std::vector<bool>&,
 			      reco::PFClusterCollection&) const;
 
+  void fillTopoHits(const reco::PFCluster&,
+		    const std::vector<bool>&,
+		    TopoHits&) const;
+
   void growPFClusters(const reco::PFCluster&,
 		      const std::vector<bool>&,
+		      TopoHits&,
 		      const unsigned toleranceScaling,
-		      const unsigned iter,
+		      unsigned iter,
 		      double dist,
 		      reco::PFClusterCollection&) const;
   
@@ -13,6 +13,13 @@
 #define LOGDRESSED(x) LogDebug(x)
 #endif
 
+namespace {
+  // gathering threshold state of the rechits, evaluated when first reached
+  constexpr char kNotTested = 0;
+  constexpr char kAbove = 1;
+  constexpr char kBelow = 2;
+}
+
 void Basic2DGenericTopoClusterizer::
 buildClusters(const edm::Handle<reco::PFRecHitCollection>& input,
 	      const std::vector<bool>& rechitMask,
@@ -20,6 +27,7 @@ buildClusters(const edm::Handle<reco::PFRecHitCollection>& input,
 	      reco::PFClusterCollection& output) {
   auto const & hits = *input;  
   std::vector<bool> used(hits.size(),false);
+  std::vector<char> threshold(hits.size(),kNotTested);
   std::vector<unsigned int> seeds;
   
   // get the seeds and sort them descending in energy
@@ -36,18 +44,13 @@ buildClusters(const edm::Handle<reco::PFRecHitCollection>& input,
   for( auto seed : seeds ) {    
     if( !rechitMask[seed] || !seedable[seed] || used[seed] ) continue;    
     temp.reset();
-    buildTopoCluster(input,rechitMask,seed,used,temp);
+    buildTopoCluster(input,rechitMask,seed,used,threshold,temp);
     if( !temp.recHitFractions().empty() ) output.push_back(temp);
   }
 }
 
-void Basic2DGenericTopoClusterizer::
-buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
-		 const std::vector<bool>& rechitMask,
-		 unsigned int kcell,
-		 std::vector<bool>& used,		 
-		 reco::PFCluster& topocluster) {
-  auto const & cell = (*input)[kcell];
+bool Basic2DGenericTopoClusterizer::
+passesGatheringThreshold(const reco::PFRecHit& cell) const {
   int cell_layer = (int)cell.layer();
   if( cell_layer == PFLayer::HCAL_BARREL2 && 
       std::abs(cell.positionREP().eta()) > 0.34 ) {
@@ -73,19 +76,49 @@ buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
     LOGDRESSED("GenericTopoCluster::buildTopoCluster()")
       << "RecHit " << cell.detId() << " with enegy "
       << cell.energy() << " GeV was rejected!." << std::endl;
-    return;
+    return false;
   }
+  return true;
+}
 
+void Basic2DGenericTopoClusterizer::
+buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
+		 const std::vector<bool>& rechitMask,
+		 unsigned int kcell,
+		 std::vector<bool>& used,		 
+		 std::vector<char>& threshold,
+		 reco::PFCluster& topocluster) {
+  auto const & hits = *input;
+  auto passes = [&](unsigned int k) {
+    if( threshold[k] == kNotTested ) {
+      threshold[k] = passesGatheringThreshold(hits[k]) ? kAbove : kBelow;
+    }
+    return threshold[k] == kAbove;
+  };
+  if( !passes(kcell) ) return;
 
-  auto k = kcell;
-  used[k] = true;
-  auto ref = makeRefhit(input,k);
-  topocluster.addRecHitFraction(reco::PFRecHitFraction(ref, 1.0));
-  
-  auto const & neighbours = 
-    ( _useCornerCells ? cell.neighbours8() : cell.neighbours4() );
-  
-  for( auto nb : neighbours ) {
+  // depth-first walk of the neighbours with an explicit stack of
+  // (rechit, next neighbour to visit): the rechits are added in the
+  // same order as the recursive walk, which defines the order of the
+  // seeds and of the rechits of the PF clusters made from this topo cluster
+  std::vector<std::pair<unsigned int, unsigned int> > stack;
+  auto add = [&](unsigned int k) {
+    used[k] = true;
+    topocluster.addRecHitFraction(reco::PFRecHitFraction(makeRefhit(input,k), 1.0));
+    stack.emplace_back(k,0);
+  };
+  add(kcell);
+
+  while( !stack.empty() ) {
+    auto const & cell = hits[stack.back().first];
+    auto const & neighbours = 
+      ( _useCornerCells ? cell.neighbours8() : cell.neighbours4() );
+    const unsigned int inb = stack.back().second++;
+    if( inb == neighbours.size() ) {
+      stack.pop_back();
+      continue;
+    }
+    const unsigned int nb = *(neighbours.begin()+inb);
     if( used[nb] || !rechitMask[nb] ) {
       LOGDRESSED("GenericTopoCluster::buildTopoCluster()")
       	<< "  RecHit " << cell.detId() << "\'s" 
@@ -96,6 +129,6 @@ buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
 	<< !rechitMask[nb] << " (masked)." << std::endl;
       continue;
     }
-    buildTopoCluster(input,rechitMask,nb,used,topocluster);
+    if( passes(nb) ) add(nb);
   }
 }
@@ -26,7 +26,9 @@ class Basic2DGenericTopoClusterizer : public InitialClusteringStepBase {
 			const std::vector<bool>&, // masked rechits
 			unsigned int, //present rechit
 			std::vector<bool>&, // hit usage state
+			std::vector<char>&, // gathering threshold state
 			reco::PFCluster&); // the topocluster
+  bool passesGatheringThreshold(const reco::PFRecHit&) const;
   
 };
 
@@ -0,0 +1,149 @@
+#include "RecoParticleFlow/PFClusterProducer/interface/LocalMaximumSeeds.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Test of the seed selection of the LocalMaximumSeedFinder: the seeds must
+ * be the ones of a scan of the local maxima sorted by decreasing energy,
+ * the lower index first for equal energies, whatever the order in which
+ * the priority queue gives them. The rechits are on grids of 4 or 8
+ * neighbours, with energies rounded so that neighbours of equal energy are
+ * frequent, with masked rechits and rechits below the thresholds.
+ */
+
+namespace {
+
+  int errors = 0;
+
+  void check(bool ok, const char *what) {
+    if (!ok) {
+      std::cout << "Error: " << what << std::endl;
+      ++errors;
+    }
+  }
+
+  typedef std::vector<std::vector<unsigned int> > Neighbours;
+
+  //nx x ny grid, with 4 or 8 neighbours per cell
+  Neighbours grid(unsigned int nx, unsigned int ny, int nNeighbours) {
+    Neighbours neighbours(nx*ny);
+    for (int x = 0; x < int(nx); ++x) {
+      for (int y = 0; y < int(ny); ++y) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          for (int dy = -1; dy <= 1; ++dy) {
+            if ((dx == 0 && dy == 0) || (nNeighbours == 4 && dx != 0 && dy != 0)) continue;
+            if (x+dx < 0 || x+dx >= int(nx) || y+dy < 0 || y+dy >= int(ny)) continue;
+            neighbours[x*ny+y].push_back((x+dx)*ny+y+dy);
+          }
+        }
+      }
+    }
+    return neighbours;
+  }
+
+  std::vector<bool> seeds(const Neighbours &neighbours, const std::vector<bool> &mask,
+                          const std::vector<float> &energies, std::vector<bool> usable) {
+    std::vector<bool> seedable(neighbours.size(), false);
+    pfseeding::localMaximumSeeds(neighbours.size(), mask, energies, usable,
+                                 [&](unsigned int i) { return neighbours[i]; }, seedable);
+    return seedable;
+  }
+
+  //the local maxima sorted by decreasing energy and increasing index, then taken in turn
+  std::vector<bool> referenceSeeds(const Neighbours &neighbours, const std::vector<bool> &mask,
+                                   const std::vector<float> &energies, std::vector<bool> usable) {
+    std::vector<unsigned int> maxima;
+    for (unsigned int i = 0; i < neighbours.size(); ++i) {
+      if (!mask[i] || !usable[i]) continue;
+      bool maximum = std::none_of(neighbours[i].begin(), neighbours[i].end(), [&](unsigned int j) {
+        return mask[j] && energies[j] > energies[i];
+      });
+      if (maximum) maxima.push_back(i);
+    }
+    std::sort(maxima.begin(), maxima.end(), [&](unsigned int i, unsigned int j) {
+      return energies[i] > energies[j] || (energies[i] == energies[j] && i < j);
+    });
+    std::vector<bool> seedable(neighbours.size(), false);
+    for (unsigned int i : maxima) {
+      if (!usable[i]) continue;
+      seedable[i] = true;
+      for (unsigned int j : neighbours[i]) usable[j] = false;
+    }
+    return seedable;
+  }
+
+  void compare(const std::string &name, const Neighbours &neighbours, std::mt19937 &rng, unsigned int nEvents) {
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    unsigned int different = 0, nSeeds = 0;
+    for (unsigned int n = 0; n < nEvents; ++n) {
+      const unsigned int nhits = neighbours.size();
+      //few energy values: many neighbours of equal energy
+      const float step = (n%2) ? 1.f : 0.25f;
+      std::vector<float> energies(nhits);
+      std::vector<bool> mask(nhits), usable(nhits);
+      for (unsigned int i = 0; i < nhits; ++i) {
+        energies[i] = step*int(5.f*uniform(rng));
+        mask[i] = uniform(rng) > 0.1f;
+        usable[i] = uniform(rng) > 0.2f;
+      }
+      std::vector<bool> seedable = seeds(neighbours, mask, energies, usable);
+      nSeeds += std::count(seedable.begin(), seedable.end(), true);
+      if (seedable != referenceSeeds(neighbours, mask, energies, usable)) ++different;
+      for (unsigned int i = 0; i < nhits; ++i) {
+        if (!seedable[i]) continue;
+        if (!mask[i] || !usable[i]) ++different;
+        for (unsigned int j : neighbours[i]) {
+          if (seedable[j]) ++different;
+        }
+      }
+    }
+    if (different) {
+      std::cout << "Error: " << name << ": " << different << " differences with the sorted scan" << std::endl;
+      ++errors;
+    }
+    std::cout << name << ": " << nEvents << " events, " << nSeeds << " seeds" << std::endl;
+  }
+}
+
+int main()
+{
+  std::mt19937 rng(2018);
+
+  //a line of rechits
+  const Neighbours line = grid(1, 5, 4);
+  const std::vector<bool> all(5, true);
+
+  //two neighbours of equal energy: the lower index is the seed, whichever comes first
+  std::vector<bool> seedable = seeds(line, all, {1.f, 3.f, 3.f, 1.f, 0.f}, all);
+  check(seedable == std::vector<bool>({false, true, false, false, false}),
+        "the lower index is the seed of two neighbours of equal energy");
+
+  //three in a row of equal energy: the first and the last are seeds
+  seedable = seeds(line, all, {2.f, 2.f, 2.f, 1.f, 0.f}, all);
+  check(seedable == std::vector<bool>({true, false, true, false, false}),
+        "the first and the last of three neighbours of equal energy are seeds");
+
+  //a higher masked neighbour does not prevent a seed, a masked rechit is never a seed
+  std::vector<bool> mask = {true, false, true, true, true};
+  seedable = seeds(line, mask, {1.f, 5.f, 3.f, 1.f, 0.f}, all);
+  check(seedable == std::vector<bool>({true, false, true, false, false}),
+        "the masked rechits neither are seeds nor prevent them");
+
+  //a higher neighbour below the thresholds prevents a seed, but is not a seed
+  std::vector<bool> usable = {true, true, false, true, true};
+  seedable = seeds(line, all, {1.f, 3.f, 5.f, 1.f, 2.f}, usable);
+  check(seedable == std::vector<bool>({false, false, false, false, true}),
+        "a higher neighbour below the thresholds prevents a seed");
+
+  compare("4 neighbours", grid(10, 12, 4), rng, 500);
+  compare("8 neighbours", grid(10, 12, 8), rng, 500);
+  compare("HF, no neighbours", Neighbours(50), rng, 50);
+
+  if (errors) return 1;
+  std::cout << "LocalMaximumSeedFinder seeding validated" << std::endl;
+  return 0;
+}
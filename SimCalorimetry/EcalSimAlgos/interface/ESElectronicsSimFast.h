@@ -12,6 +12,7 @@
 namespace CLHEP {
   class HepRandomEngine;
 }
+class CounterBasedGaussianGenerator;
 
 class ESElectronicsSimFast
 {
@@ -20,7 +21,8 @@ class ESElectronicsSimFast
       typedef CaloTSamples<float,3> ESSamples ;
 
       enum { MAXADC = 4095,
-	     MINADC =    0 } ;
+	     MINADC =    0,
+	     MAXSAMPLES = 3 } ; // capacity of the ESSamples
   
       ESElectronicsSimFast( bool addNoise , bool PreMix1) ;
       ~ESElectronicsSimFast() ;
@@ -31,6 +33,13 @@ class ESElectronicsSimFast
 
       void setMIPToGeV( double MIPToGeV ) ;
 
+      /// the noise is taken from this generator instead of the engine
+      void setCounterBasedGenerator( const CounterBasedGaussianGenerator* generator ) ;
+
+      /// generates in one batch the noise of the channels about to be
+      /// digitized; the other channels are generated one by one
+      void generateNoise( const std::vector<uint32_t>& channels ) ;
+
       void analogToDigital( CLHEP::HepRandomEngine*,
                             ESSamples&   cs ,
 			    ESDataFrame& df ,
@@ -51,6 +60,10 @@ class ESElectronicsSimFast
       const ESPedestals* m_peds ;
 
       const ESIntercalibConstants* m_mips ;
+
+      const CounterBasedGaussianGenerator* m_counterBasedGenerator ;
+      std::vector<uint32_t> m_noiseChannels ; // sorted
+      std::vector<double>   m_noise ;         // MAXSAMPLES per channel
 } ;
 
 #endif
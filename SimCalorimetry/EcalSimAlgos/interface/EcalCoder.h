@@ -12,6 +12,7 @@ template<typename M> class CorrelatedNoisifier ;
 class EcalMGPASample;
 class EcalDataFrame;
 class DetId;
+class CounterBasedGaussianGenerator;
 
 #include<vector>
 
@@ -58,6 +59,10 @@ class EcalCoder
 			       double EEscale   ) ;
 
       void setIntercalibConstants( const EcalIntercalibConstantsMC* ical ) ; 
+
+      /// if set, the correlated noise is built from per-channel
+      /// counter-based gaussians instead of the engine
+      void setCounterBasedGenerator( const CounterBasedGaussianGenerator* generator ) ;
  
 
       /// from EcalSamples to EcalDataFrame
@@ -107,6 +112,9 @@ class EcalCoder
 
       const Noisifier* m_ebCorrNoise[3] ;
       const Noisifier* m_eeCorrNoise[3] ;
+
+      const CounterBasedGaussianGenerator* m_counterBasedGenerator ;
+      mutable std::vector<double> m_gauss ; // buffer for the counter-based gaussians
 };
 
 #endif
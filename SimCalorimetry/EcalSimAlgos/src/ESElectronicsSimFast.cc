@@ -1,8 +1,10 @@
 #include "SimCalorimetry/EcalSimAlgos/interface/ESElectronicsSimFast.h"
 #include "DataFormats/DetId/interface/DetId.h"
+#include "SimGeneral/NoiseGenerators/interface/CounterBasedGaussianGenerator.h"
 
 #include "CLHEP/Random/RandGaussQ.h"
 
+#include <algorithm>
 #include <iostream>
 
 ESElectronicsSimFast::ESElectronicsSimFast( bool addNoise , bool PreMix1 ) :
@@ -10,7 +12,8 @@ ESElectronicsSimFast::ESElectronicsSimFast( bool addNoise , bool PreMix1 ) :
    m_PreMix1  ( PreMix1  ) ,
    m_MIPToGeV (        0 ) ,
    m_peds     (        nullptr ) ,
-   m_mips     (        nullptr )
+   m_mips     (        nullptr ) ,
+   m_counterBasedGenerator ( nullptr )
 {
    // Preshower "Fast" Electronics Simulation
    // gain = 1 : low gain for data taking 
@@ -40,6 +43,28 @@ ESElectronicsSimFast::setMIPToGeV( double MIPToGeV )
    m_MIPToGeV = MIPToGeV ;
 }
 
+void 
+ESElectronicsSimFast::setCounterBasedGenerator( const CounterBasedGaussianGenerator* generator )
+{
+   m_counterBasedGenerator = generator ;
+}
+
+void 
+ESElectronicsSimFast::generateNoise( const std::vector<uint32_t>& channels )
+{
+   m_noiseChannels.clear() ;
+   m_noise.clear() ;
+   if( nullptr == m_counterBasedGenerator || !m_addNoise ) return ;
+
+   m_noiseChannels = channels ;
+   std::sort( m_noiseChannels.begin(), m_noiseChannels.end() ) ;
+   m_noiseChannels.erase( std::unique( m_noiseChannels.begin(), m_noiseChannels.end() ),
+			  m_noiseChannels.end() ) ;
+   m_noise.resize( m_noiseChannels.size()*MAXSAMPLES ) ;
+   m_counterBasedGenerator->generate( m_noiseChannels.data(), m_noiseChannels.size(),
+				      MAXSAMPLES, m_noise.data() ) ;
+}
+
 void 
 ESElectronicsSimFast::analogToDigital( CLHEP::HepRandomEngine* engine,
                                        ESSamples&   cs,
@@ -62,12 +87,31 @@ ESElectronicsSimFast::analogToDigital( CLHEP::HepRandomEngine* engine,
    const double MIPADC   ( isNoise ? 0. : (double) (*it_mip) ) ;
    const double ADCGeV   ( isNoise ? 1. : MIPADC/m_MIPToGeV ) ;
 
+   // gaussians of the channel from the counter-based generator, batched if possible
+   double gauss[ MAXSAMPLES ] ;
+   const double* noise ( nullptr ) ;
+   if( nullptr != m_counterBasedGenerator && m_addNoise && !isNoise )
+   {
+      const std::vector<uint32_t>::const_iterator it (
+	 std::lower_bound( m_noiseChannels.begin(), m_noiseChannels.end(), id.rawId() ) ) ;
+      if( it != m_noiseChannels.end() && *it == id.rawId() )
+      {
+	 noise = &m_noise[ ( it - m_noiseChannels.begin() )*MAXSAMPLES ] ;
+      }
+      else
+      {
+	 m_counterBasedGenerator->generate( id.rawId(), cs.size(), gauss ) ;
+	 noise = gauss ;
+      }
+   }
+
    int adc = 0 ;
 //   std::cout<<"   **Id="<<ESDetId(df.id())<<", size="<<df.size();
    for( unsigned int i ( 0 ) ; i != cs.size(); ++i ) 
    {
       const double noi ( isNoise || (!m_addNoise) ? 0 :
-			 sigma*CLHEP::RandGaussQ::shoot(engine, 0, 1) ) ;
+			 sigma*( nullptr != noise ? noise[i] :
+				 CLHEP::RandGaussQ::shoot(engine, 0, 1) ) ) ;
       double signal;
 
       if(!m_PreMix1) signal = cs[i]*ADCGeV + noi + baseline ;
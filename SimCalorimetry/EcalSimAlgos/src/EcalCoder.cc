@@ -1,6 +1,7 @@
 #include "SimCalorimetry/EcalSimAlgos/interface/EcalCoder.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "SimGeneral/NoiseGenerators/interface/CorrelatedNoisifier.h"
+#include "SimGeneral/NoiseGenerators/interface/CounterBasedGaussianGenerator.h"
 #include "DataFormats/EcalDigi/interface/EcalMGPASample.h"
 #include "DataFormats/EcalDigi/interface/EcalDataFrame.h"
 
@@ -23,7 +24,8 @@ EcalCoder::EcalCoder( bool                  addNoise     ,
    m_maxEneEB    (      1668.3 ) , // 4095(MAXADC)*12(gain 2)*0.035(GeVtoADC)*0.97
    m_maxEneEE    (      2859.9 ) , // 4095(MAXADC)*12(gain 2)*0.060(GeVtoADC)*0.97
    m_addNoise    ( addNoise    ) ,
-   m_PreMix1     ( PreMix1     ) 
+   m_PreMix1     ( PreMix1     ) ,
+   m_counterBasedGenerator ( nullptr )
    {
    m_ebCorrNoise[0] = ebCorrNoise0 ;
    assert( nullptr != m_ebCorrNoise[0] ) ;
@@ -53,6 +55,12 @@ EcalCoder::setPedestals( const EcalPedestals* pedestals )
    m_peds = pedestals ;
 }
 
+void  
+EcalCoder::setCounterBasedGenerator( const CounterBasedGaussianGenerator* generator ) 
+{
+   m_counterBasedGenerator = generator ;
+}
+
 void  
 EcalCoder::setGainRatios( const EcalGainRatios* gainRatios ) 
 {
@@ -159,7 +167,14 @@ EcalCoder::encode( const EcalSamples& ecalSamples ,
 
    if( m_addNoise )
    {
-     noisy[0]->noisify( noiseframe[0], engine ) ; // high gain
+     if( nullptr != m_counterBasedGenerator )
+     {
+        m_gauss.resize( csize ) ; // only allocates for the first channel
+        m_counterBasedGenerator->generate( detId.rawId(), csize, &m_gauss.front() ) ;
+        noisy[0]->noisify( noiseframe[0], engine, &m_gauss ) ; // high gain
+     }
+     else
+        noisy[0]->noisify( noiseframe[0], engine ) ; // high gain
       if( nullptr == noisy[1] ) noisy[0]->noisify( noiseframe[1] ,
                                              engine,
 					     &noisy[0]->vecgau() ) ; // med 
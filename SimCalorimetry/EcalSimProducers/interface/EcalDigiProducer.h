@@ -7,6 +7,7 @@
 #include "SimCalorimetry/EcalSimAlgos/interface/ESShape.h"
 #include "DataFormats/Math/interface/Error.h"
 #include "SimGeneral/NoiseGenerators/interface/CorrelatedNoisifier.h"
+#include "SimGeneral/NoiseGenerators/interface/CounterBasedGaussianGenerator.h"
 #include "SimCalorimetry/EcalSimAlgos/interface/EcalCorrelatedNoiseMatrix.h"
 #include "SimCalorimetry/EcalSimAlgos/interface/ESElectronicsSim.h"
 
@@ -147,6 +148,9 @@ class EcalDigiProducer : public DigiAccumulatorMixMod {
       std::array< std::unique_ptr<CorrelatedNoisifier<EcalCorrMatrix> >, 3 > m_EECorrNoise ;
 
       CLHEP::HepRandomEngine* randomEngine_ = nullptr;
+
+      const bool m_useCounterBasedNoise ;
+      CounterBasedGaussianGenerator m_noiseGenerator ;
 };
 
 #endif 
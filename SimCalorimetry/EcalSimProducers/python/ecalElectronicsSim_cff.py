@@ -2,6 +2,8 @@ import FWCore.ParameterSet.Config as cms
 
 ecal_electronics_sim = cms.PSet(
     doENoise = cms.bool(True),
+    # per-channel counter-based noise, reproducible independently of the digitization order
+    useCounterBasedNoise = cms.bool(False),
     ConstantTerm = cms.double(0.003),
     applyConstantTerm = cms.bool(True)
 )
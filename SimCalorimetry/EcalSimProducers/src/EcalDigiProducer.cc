@@ -161,7 +161,9 @@ EcalDigiProducer::EcalDigiProducer( const edm::ParameterSet& params,  edm::Consu
    m_APDCoder          ( nullptr ) ,
    m_Geometry          ( nullptr ) ,
    m_EBCorrNoise       ( { {nullptr, nullptr, nullptr} } ) ,
-   m_EECorrNoise       ( { {nullptr, nullptr, nullptr} } ) 
+   m_EECorrNoise       ( { {nullptr, nullptr, nullptr} } ) ,
+   m_useCounterBasedNoise ( params.getParameter<bool> ("useCounterBasedNoise") ) ,
+   m_noiseGenerator    (   )
 {
   // "produces" statements taken care of elsewhere.
   //   if(m_apdSeparateDigi) mixMod.produces<EBDigiCollection>(m_apdDigiTag);
@@ -247,6 +249,8 @@ EcalDigiProducer::EcalDigiProducer( const edm::ParameterSet& params,  edm::Consu
                                  m_EECorrNoise[1].get() ,
                                  m_EBCorrNoise[2].get() ,
                                  m_EECorrNoise[2].get()   ) );
+   if( m_useCounterBasedNoise ) m_Coder->setCounterBasedGenerator( &m_noiseGenerator ) ;
+   if( m_useCounterBasedNoise && m_doFastES ) m_ESElectronicsSimFast->setCounterBasedGenerator( &m_noiseGenerator ) ;
 
    m_ElectronicsSim.reset( new EcalElectronicsSim( m_ParameterMap.get()    ,
                                                    m_Coder.get()           ,
@@ -395,6 +399,9 @@ EcalDigiProducer::finalizeEvent(edm::Event& event, edm::EventSetup const& eventS
    std::unique_ptr<EBDigiCollection> barrelResult   ( new EBDigiCollection() ) ;
    std::unique_ptr<EEDigiCollection> endcapResult   ( new EEDigiCollection() ) ;
    std::unique_ptr<ESDigiCollection> preshowerResult( new ESDigiCollection() ) ;
+
+   // one key per event; the noise of each crystal then only depends on its DetId
+   if( m_useCounterBasedNoise ) m_noiseGenerator.setEventKey( randomEngine_ ) ;
    
    // run the algorithm
 
@@ -417,6 +424,14 @@ EcalDigiProducer::finalizeEvent(edm::Event& event, edm::EventSetup const& eventS
    }
    if( m_doES ) {
      if(m_doFastES) {
+       if( m_useCounterBasedNoise ) {
+         // the noise of all the channels with a signal in one batch
+         std::vector<uint32_t> esChannels ;
+         esChannels.reserve( m_ESResponse->samplesSize() ) ;
+         for( unsigned int i ( 0 ) ; i != m_ESResponse->samplesSize() ; ++i )
+           esChannels.push_back( (*m_ESResponse)[ i ]->id().rawId() ) ;
+         m_ESElectronicsSimFast->generateNoise( esChannels ) ;
+       }
        m_ESDigitizer->run( *preshowerResult, randomEngine_ ) ;
      } else {
        m_ESOldDigitizer->run( *preshowerResult, randomEngine_ ) ;
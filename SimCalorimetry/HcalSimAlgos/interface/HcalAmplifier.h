@@ -12,6 +12,7 @@ class HcalDbService;
 class HPDIonFeedbackSim;
 class HcalTimeSlewSim;
 class HcalTimeSlew;
+class CounterBasedGaussianGenerator;
 
 namespace CLHEP {
   class HepRandomEngine;
@@ -45,6 +46,12 @@ public:
 
   void setStartingCapId(int capId) {theStartingCapId = capId;}
 
+  /// if it's set, pedestal noise is drawn from this per-channel
+  /// counter-based generator instead of the engine
+  void setCounterBasedGenerator(const CounterBasedGaussianGenerator * generator) {
+    theCounterBasedGenerator = generator;
+  }
+
 private:
 
   void pe2fC(CaloSamples & frame) const;
@@ -56,6 +63,7 @@ private:
   const CaloVNoiseSignalGenerator * theNoiseSignalGenerator;
   HPDIonFeedbackSim * theIonFeedbackSim;
   HcalTimeSlewSim * theTimeSlewSim;
+  const CounterBasedGaussianGenerator * theCounterBasedGenerator;
   unsigned theStartingCapId;
   bool addNoise_;
   bool preMixDigi_;
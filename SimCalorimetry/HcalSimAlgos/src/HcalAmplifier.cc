@@ -12,6 +12,7 @@
 #include "CalibFormats/CaloObjects/interface/CaloSamples.h"
 #include "DataFormats/HcalDetId/interface/HcalDetId.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "SimGeneral/NoiseGenerators/interface/CounterBasedGaussianGenerator.h"
 
 #include "CalibFormats/HcalObjects/interface/HcalCalibrations.h"
 
@@ -27,6 +28,7 @@ HcalAmplifier::HcalAmplifier(const CaloVSimParameterMap * parameters, bool addNo
   theNoiseSignalGenerator(nullptr),
   theIonFeedbackSim(nullptr),
   theTimeSlewSim(nullptr),
+  theCounterBasedGenerator(nullptr),
   theStartingCapId(0),
   addNoise_(addNoise),
   preMixDigi_(PreMix1),
@@ -88,7 +90,8 @@ void HcalAmplifier::addPedestals(CaloSamples & frame, CLHEP::HepRandomEngine* en
   if(addNoise_)
   {
     double gauss [32]; //big enough
-    for (int i = 0; i < frame.size(); i++) gauss[i] = CLHEP::RandGaussQ::shoot(engine, 0., 1.);
+    if(theCounterBasedGenerator) theCounterBasedGenerator->generate(frame.id().rawId(), frame.size(), gauss);
+    else for (int i = 0; i < frame.size(); i++) gauss[i] = CLHEP::RandGaussQ::shoot(engine, 0., 1.);
     makeNoise(hcalSubDet, calibWidths, frame.size(), gauss, noise);
   }
    
@@ -6,6 +6,7 @@
 #include "SimCalorimetry/HcalSimAlgos/interface/HcalQIE1011Traits.h"
 #include "SimCalorimetry/HcalSimAlgos/interface/HcalHitFilter.h"
 #include "SimCalorimetry/HcalSimAlgos/interface/ZDCHitFilter.h"
+#include "SimGeneral/NoiseGenerators/interface/CounterBasedGaussianGenerator.h"
 #include "Geometry/HcalCommonData/interface/HcalHitRelabeller.h"
 #include "Geometry/HcalCommonData/interface/HcalDDDRecConstants.h"
 #include "Geometry/CaloGeometry/interface/CaloGeometry.h"
@@ -131,6 +132,9 @@ private:
 
   HcalTimeSlewSim * theTimeSlewSim;
 
+  bool useCounterBasedNoise_;
+  CounterBasedGaussianGenerator theNoiseGenerator;
+
   HBHEDigitizer * theHBHEDigitizer;
   HODigitizer* theHODigitizer;
   HODigitizer* theHOSiPMDigitizer;
@@ -29,6 +29,9 @@ hcalSimBlock = cms.PSet(
     minFCToDelay=cms.double(5.), # old TC model! set to 5 for the new one
     debugCaloSamples=cms.bool(False),
     ignoreGeantTime=cms.bool(False),
+    # draw pedestal noise from a per-channel counter-based generator,
+    # reproducible independently of the digitization order
+    useCounterBasedNoise=cms.bool(False),
     # settings for SimHit test injection
     injectTestHits = cms.bool(False),
     # if no time is specified for injected hits, t = 0 will be used
@@ -69,6 +69,8 @@ HcalDigitizer::HcalDigitizer(const edm::ParameterSet& ps, edm::ConsumesCollector
   theHOHitFilter(),
   theHOSiPMHitFilter(),
   theZDCHitFilter(),
+  useCounterBasedNoise_(ps.getParameter<bool>("useCounterBasedNoise")),
+  theNoiseGenerator(),
   theHBHEDigitizer(nullptr),
   theHODigitizer(nullptr),
   theHOSiPMDigitizer(nullptr),
@@ -136,6 +138,15 @@ HcalDigitizer::HcalDigitizer(const edm::ParameterSet& ps, edm::ConsumesCollector
   theHFQIE10ElectronicsSim = new HcalElectronicsSim(theHFQIE10Amplifier, theCoderFactory, PreMix1); //should this use a different coder factory?
   theHBHEQIE11ElectronicsSim = new HcalElectronicsSim(theHBHEQIE11Amplifier, theCoderFactory, PreMix1); //should this use a different coder factory?
 
+  if(useCounterBasedNoise_) {
+    theHBHEAmplifier->setCounterBasedGenerator(&theNoiseGenerator);
+    theHFAmplifier->setCounterBasedGenerator(&theNoiseGenerator);
+    theHOAmplifier->setCounterBasedGenerator(&theNoiseGenerator);
+    theZDCAmplifier->setCounterBasedGenerator(&theNoiseGenerator);
+    theHFQIE10Amplifier->setCounterBasedGenerator(&theNoiseGenerator);
+    theHBHEQIE11Amplifier->setCounterBasedGenerator(&theNoiseGenerator);
+  }
+
   bool doHOHPD = (theHOSiPMCode != 1);
   bool doHOSiPM = (theHOSiPMCode != 0);
   if(doHOHPD) {
@@ -463,6 +474,9 @@ void HcalDigitizer::finalizeEvent(edm::Event& e, const edm::EventSetup& eventSet
     )
   );
 
+  // one key per event; the noise of each channel then only depends on its DetId
+  if(useCounterBasedNoise_) theNoiseGenerator.setEventKey(engine);
+
   // Step C: Invoke the algorithm, getting back outputs.
   if(isHCAL&&hbhegeo){
     if(theHBHEDigitizer)        theHBHEDigitizer->run(*hbheResult, engine);
@@ -46,6 +46,7 @@ protected:
 private:    
 
   void                      initMap(const G4String&, const DDCompactView &);
+  void                      buildMap(const G4String&, const DDCompactView &);
   uint16_t                  getRadiationLength(const G4StepPoint* hitPoint, 
                                                const G4LogicalVolume* lv);
   uint16_t                  getLayerIDForTimeSim();
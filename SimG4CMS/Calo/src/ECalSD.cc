@@ -4,6 +4,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "SimG4CMS/Calo/interface/ECalSD.h"
 #include "SimG4Core/Notification/interface/TrackInformation.h"
+#include "SimG4Core/SensitiveDetector/interface/SharedSDTables.h"
 #include "Geometry/EcalCommonData/interface/EcalBarrelNumberingScheme.h"
 #include "Geometry/EcalCommonData/interface/EcalBaseNumber.h"
 #include "Geometry/EcalCommonData/interface/EcalEndcapNumberingScheme.h"
@@ -312,7 +313,33 @@ void ECalSD::setNumberingScheme(EcalNumberingScheme* scheme) {
   }
 }
 
+namespace {
+  struct ECalSDMaps {
+    std::map<const G4LogicalVolume*,double> xtalLMap;
+    std::vector<const G4LogicalVolume*>     useDepth1, useDepth2, noWeight;
+  };
+}
+
 void ECalSD::initMap(const G4String& sd, const DDCompactView & cpv) {
+  // The maps only depend on the geometry, which is the same on all
+  // threads: build them once and copy them into each worker's instance
+  std::string key = "ECalSD|" + sd + "|" + crystalMat + "|" + depth1Name + "|" + depth2Name;
+  auto maps = SharedSDTables::instance().get<ECalSDMaps>(key, [&]() {
+      buildMap(sd, cpv);
+      auto built = std::make_unique<ECalSDMaps>();
+      built->xtalLMap = xtalLMap;
+      built->useDepth1 = useDepth1;
+      built->useDepth2 = useDepth2;
+      built->noWeight = noWeight;
+      return built;
+    });
+  xtalLMap = maps->xtalLMap;
+  useDepth1 = maps->useDepth1;
+  useDepth2 = maps->useDepth2;
+  noWeight = maps->noWeight;
+}
+
+void ECalSD::buildMap(const G4String& sd, const DDCompactView & cpv) {
 
   G4String attribute = "ReadOutName";
   DDSpecificsMatchesValueFilter filter{DDValue(attribute,sd,0)};
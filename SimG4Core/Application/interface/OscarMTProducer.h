@@ -31,6 +31,7 @@ public:
   static void globalEndRun(const edm::Run& iRun, const edm::EventSetup& iSetup, const RunContext *iContext);
   static void globalEndJob(OscarMTMasterThread *masterThread);
 
+  void beginRun(const edm::Run & r,const edm::EventSetup& c) override;
   void endRun(const edm::Run & r,const edm::EventSetup& c) override;
   void produce(edm::Event & e, const edm::EventSetup& c) override;
 
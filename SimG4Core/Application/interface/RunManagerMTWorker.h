@@ -7,6 +7,7 @@
 #include "SimG4Core/Generators/interface/Generator.h"
 #include "SimDataFormats/Forward/interface/LHCTransportLinkContainer.h"
 
+#include <chrono>
 #include <memory>
 
 namespace edm {
@@ -41,6 +42,7 @@ public:
   explicit RunManagerMTWorker(const edm::ParameterSet& iConfig, edm::ConsumesCollector&& i);
   ~RunManagerMTWorker();
 
+  void beginRun(RunManagerMT& runManagerMaster, const edm::EventSetup& es);
   void endRun();
 
   void produce(const edm::Event& inpevt, const edm::EventSetup& es, RunManagerMT& runManagerMaster);
@@ -63,7 +65,9 @@ public:
 private:
 
   void initializeTLS();
+  void initializeThreadIfNeeded(RunManagerMT& runManagerMaster, const edm::EventSetup& es);
   void initializeThread(RunManagerMT& runManagerMaster, const edm::EventSetup& es);
+  void reportFirstEvent();
   void initializeUserActions();
 
   void initializeRun();
@@ -79,6 +83,7 @@ private:
   bool m_nonBeam;
   bool m_pUseMagneticField;
   bool m_hasWatchers;
+  bool m_initializeAtBeginRun;
   int  m_EvtMgrVerbosity;
 
   edm::ParameterSet m_pField;
@@ -95,6 +100,8 @@ private:
 
   std::unique_ptr<G4SimEvent> m_simEvent;
   std::unique_ptr<CMSSteppingVerbose> m_sVerbose;
+
+  std::chrono::steady_clock::time_point m_startTime;
 };
 
 #endif
@@ -156,6 +156,14 @@ void OscarMTProducer::globalEndJob(OscarMTMasterThread *masterThread) {
   masterThread->stopThread();
 }
 
+void 
+OscarMTProducer::beginRun(const edm::Run&, const edm::EventSetup& es)
+{
+  // Random number generation not allowed here
+  StaticRandomEngineSetUnset random(nullptr);
+  m_runManagerWorker->beginRun(globalCache()->runManagerMaster(), es);
+}
+
 void 
 OscarMTProducer::endRun(const edm::Run&, const edm::EventSetup&)
 {
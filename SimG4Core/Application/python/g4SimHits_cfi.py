@@ -43,6 +43,7 @@ common_UseLuminosity = cms.PSet(
 g4SimHits = cms.EDProducer("OscarMTProducer",
     NonBeamEvent = cms.bool(False),
     G4EventManagerVerbosity = cms.untracked.int32(0),
+    InitializeWorkersAtBeginRun = cms.untracked.bool(False),
     G4StackManagerVerbosity = cms.untracked.int32(0),
     G4TrackingManagerVerbosity = cms.untracked.int32(0),
     UseMagneticField = cms.bool(True),
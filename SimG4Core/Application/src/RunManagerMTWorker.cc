@@ -19,6 +19,7 @@
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 
 #include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/MessageLogger/interface/JobReport.h"
 #include "SimG4Core/Notification/interface/G4SimEvent.h"
 #include "SimG4Core/Notification/interface/SimActivityRegistry.h"
 #include "SimG4Core/Notification/interface/SimG4Exception.h"
@@ -56,9 +57,13 @@
 #include "G4TransportationManager.hh"
 
 #include <atomic>
+#include <map>
 #include <thread>
 #include <sstream>
 #include <vector>
+#include <cstdio>
+
+#include <unistd.h>
 
 // from https://hypernews.cern.ch/HyperNews/CMS/get/edmFramework/3302/2.html
 namespace {
@@ -72,6 +77,17 @@ namespace {
 
   int getThreadIndex() { return s_thread_index; }
 
+  // resident set size of the process in MB, 0 if not available
+  double residentMemoryMB() {
+    long pages = 0, resident = 0;
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if(statm) {
+      if(std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) { resident = 0; }
+      std::fclose(statm);
+    }
+    return double(resident)*sysconf(_SC_PAGESIZE)/(1024.*1024.);
+  }
+
   void createWatchers(const edm::ParameterSet& iP,
                       SimActivityRegistry& iReg,
                       std::vector<std::shared_ptr<SimWatcher> >& oWatchers,
@@ -120,6 +136,9 @@ struct RunManagerMTWorker::TLSData {
   G4RunManagerKernel* kernel = nullptr;
   bool threadInitialized = false;
   bool runTerminated = false;
+  bool firstEventReported = false;
+  double initSeconds = 0.;
+  double initMemoryMB = 0.;
 };
 
 thread_local RunManagerMTWorker::TLSData *RunManagerMTWorker::m_tls = nullptr;
@@ -138,7 +157,8 @@ RunManagerMTWorker::RunManagerMTWorker(const edm::ParameterSet& iConfig, edm::Co
   m_pTrackingAction(iConfig.getParameter<edm::ParameterSet>("TrackingAction")),
   m_pSteppingAction(iConfig.getParameter<edm::ParameterSet>("SteppingAction")),
   m_pCustomUIsession(iConfig.getUntrackedParameter<edm::ParameterSet>("CustomUIsession")),
-  m_p(iConfig)
+  m_p(iConfig),
+  m_startTime(std::chrono::steady_clock::now())
 {
   initializeTLS();
   m_simEvent.reset(nullptr);
@@ -146,12 +166,23 @@ RunManagerMTWorker::RunManagerMTWorker(const edm::ParameterSet& iConfig, edm::Co
   std::vector<edm::ParameterSet> watchers = 
     iConfig.getParameter<std::vector<edm::ParameterSet> >("Watchers");
   m_hasWatchers = (watchers.empty()) ? false : true;
+  m_initializeAtBeginRun = iConfig.getUntrackedParameter<bool>("InitializeWorkersAtBeginRun",false);
 }
 
 RunManagerMTWorker::~RunManagerMTWorker() {
   if(m_tls && !m_tls->runTerminated) { terminateRun(); }
 }
 
+void RunManagerMTWorker::beginRun(RunManagerMT& runManagerMaster, const edm::EventSetup& es) {
+  // Stream begin run transitions of all streams are scheduled together,
+  // so initializing here lets the threads build their Geant4 state in
+  // parallel instead of when each of them happens to get its first event.
+  // Threads not visited here are still initialized lazily in produce().
+  if(m_initializeAtBeginRun) {
+    initializeThreadIfNeeded(runManagerMaster, es);
+  }
+}
+
 void RunManagerMTWorker::endRun() {
   terminateRun();
 }
@@ -175,6 +206,44 @@ void RunManagerMTWorker::initializeTLS() {
   }
 }
 
+void RunManagerMTWorker::initializeThreadIfNeeded(RunManagerMT& runManagerMaster, const edm::EventSetup& es) {
+  if(m_tls && m_tls->threadInitialized) { return; }
+
+  const double memoryBefore = residentMemoryMB();
+  const auto timeBefore = std::chrono::steady_clock::now();
+
+  initializeThread(runManagerMaster, es);
+  m_tls->threadInitialized = true;
+
+  // with several threads initializing at once the memory difference
+  // includes what the others allocated meanwhile, it is an upper bound
+  m_tls->initSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeBefore).count();
+  m_tls->initMemoryMB = residentMemoryMB() - memoryBefore;
+
+  edm::LogInfo("SimG4CoreApplication")
+    << "RunManagerMTWorker: thread " << getThreadIndex() << " initialized in "
+    << m_tls->initSeconds << " s, resident memory increased by "
+    << m_tls->initMemoryMB << " MB";
+}
+
+void RunManagerMTWorker::reportFirstEvent() {
+  m_tls->firstEventReported = true;
+  const double timeToFirstEvent = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+
+  edm::LogInfo("SimG4CoreApplication")
+    << "RunManagerMTWorker: thread " << getThreadIndex()
+    << " finished its first event " << timeToFirstEvent << " s after construction";
+
+  edm::Service<edm::JobReport> reportSvc;
+  if(reportSvc.isAvailable()) {
+    std::map<std::string, std::string> metrics;
+    metrics["InitializationTime"] = std::to_string(m_tls->initSeconds);
+    metrics["InitializationMemoryMB"] = std::to_string(m_tls->initMemoryMB);
+    metrics["TimeToFirstEvent"] = std::to_string(timeToFirstEvent);
+    reportSvc->reportPerformanceSummary("SimG4WorkerThread" + std::to_string(getThreadIndex()), metrics);
+  }
+}
+
 void RunManagerMTWorker::initializeThread(RunManagerMT& runManagerMaster, const edm::EventSetup& es) {
   // I guess everything initialized here should be in thread_local storage
   initializeTLS();
@@ -409,8 +478,7 @@ void RunManagerMTWorker::produce(const edm::Event& inpevt, const edm::EventSetup
     LogDebug("SimG4CoreApplication") 
       << "RunManagerMTWorker::produce(): stream " 
       << inpevt.streamID() << " thread " << getThreadIndex() << " initializing";
-    initializeThread(runManagerMaster, es);
-    m_tls->threadInitialized = true;
+    initializeThreadIfNeeded(runManagerMaster, es);
   }
   // Initialize run
   if(inpevt.id().run() != m_tls->currentRunNumber) {
@@ -465,6 +533,8 @@ void RunManagerMTWorker::produce(const edm::Event& inpevt, const edm::EventSetup
 
     edm::LogInfo("SimG4CoreApplication")
       << " RunManagerMTWorker::produce: ended Event " << inpevt.id().event(); 
+
+    if(!m_tls->firstEventReported) { reportFirstEvent(); }
   } 
 }
 
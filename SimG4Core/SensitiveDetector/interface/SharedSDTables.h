@@ -0,0 +1,64 @@
+#ifndef SimG4Core_SensitiveDetector_SharedSDTables_h
+#define SimG4Core_SensitiveDetector_SharedSDTables_h
+
+/** \class SharedSDTables
+ *
+ * Process-wide store of read-only lookup tables built by sensitive
+ * detectors from the DDCompactView and the G4 geometry.
+ *
+ * Geometry is shared between the master and all worker threads, so a
+ * table keyed on G4LogicalVolume pointers or DD names is identical on
+ * every thread. The first thread asking for a key builds the table, the
+ * others wait for it and get the same object instead of walking the
+ * geometry again. Different keys are built concurrently.
+ */
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class SharedSDTables
+{
+public:
+  static SharedSDTables& instance();
+
+  /// Returns the table stored under key, building it with build() if
+  /// needed; build must return a std::unique_ptr<T>
+  template<typename T, typename F>
+  std::shared_ptr<T const> get(std::string const& key, F&& build) {
+    std::promise<std::shared_ptr<void const> > promise;
+    std::shared_future<std::shared_ptr<void const> > future;
+    bool builder = false;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto found = tables_.find(key);
+      if(found == tables_.end()) {
+        future = promise.get_future().share();
+        tables_.emplace(key, future);
+        builder = true;
+      } else {
+        future = found->second;
+      }
+    }
+    if(builder) {
+      try {
+        promise.set_value(std::shared_ptr<T const>(build()));
+      } catch(...) {
+        promise.set_exception(std::current_exception());
+      }
+    }
+    return std::static_pointer_cast<T const>(future.get());
+  }
+
+private:
+  SharedSDTables() = default;
+  SharedSDTables(SharedSDTables const&) = delete;
+  SharedSDTables& operator=(SharedSDTables const&) = delete;
+
+  std::mutex mutex_;
+  std::map<std::string, std::shared_future<std::shared_ptr<void const> > > tables_;
+};
+
+#endif
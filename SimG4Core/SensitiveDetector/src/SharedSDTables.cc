@@ -0,0 +1,6 @@
+#include "SimG4Core/SensitiveDetector/interface/SharedSDTables.h"
+
+SharedSDTables& SharedSDTables::instance() {
+  static SharedSDTables s_tables;
+  return s_tables;
+}
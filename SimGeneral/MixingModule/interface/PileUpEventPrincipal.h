@@ -1,8 +1,11 @@
 #ifndef SimGeneral_MixingModule_PileUpEventPrincipal_h
 #define SimGeneral_MixingModule_PileUpEventPrincipal_h
 
+#include <memory>
 #include <set>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/Utilities/interface/InputTag.h"
@@ -10,7 +13,9 @@
 #include "FWCore/Utilities/interface/TypeID.h"
 #include "DataFormats/Common/interface/BasicHandle.h"
 #include "DataFormats/Common/interface/ConvertHandle.h"
+#include "DataFormats/Common/interface/Wrapper.h"
 #include "SimDataFormats/EncodedEventId/interface/EncodedEventId.h"
+#include "Mixing/Base/interface/PileUpProductCache.h"
 
 namespace edm {
   class ModuleCallingContext;
@@ -19,8 +24,9 @@ namespace edm {
 class PileUpEventPrincipal {
 public:
 
-  PileUpEventPrincipal(edm::EventPrincipal const& ep, edm::ModuleCallingContext const* mcc, int bcr) :
-    principal_(ep), mcc_(mcc), bunchCrossing_(bcr) {}
+  PileUpEventPrincipal(edm::EventPrincipal const& ep, edm::ModuleCallingContext const* mcc, int bcr,
+                       edm::PileUpProductCache* cache = nullptr, size_t fileNameHash = 0U) :
+    principal_(ep), mcc_(mcc), bunchCrossing_(bcr), cache_(cache), fileNameHash_(fileNameHash) {}
 
   edm::EventPrincipal const& principal() {
     return principal_;
@@ -42,15 +48,59 @@ public:
   template<typename T>
   bool
   getByLabel(edm::InputTag const& tag, edm::Handle<T>& result) const {
+    if(cache_ != nullptr && edm::PileUpProductSize<T>::known) {
+      return getCachedByLabel(tag, result);
+    }
     edm::BasicHandle bh = principal_.getByLabel(edm::PRODUCT_TYPE, edm::TypeID(typeid(T)), tag, nullptr, nullptr, mcc_);
     convert_handle(std::move(bh), result);
     return result.isValid();
   }
 
 private: 
+  template<typename T>
+  bool
+  getCachedByLabel(edm::InputTag const& tag, edm::Handle<T>& result) const {
+    edm::TypeID type(typeid(T));
+    edm::PileUpProductCache::Key key(fileNameHash_, principal_.id(), type.className() + '|' + tag.encode());
+    auto entry = cache_->find(key);
+    if(!entry) {
+      edm::BasicHandle bh = principal_.getByLabel(edm::PRODUCT_TYPE, type, tag, nullptr, nullptr, mcc_);
+      convert_handle(std::move(bh), result);
+      if(!result.isValid()) {
+        return false;
+      }
+      cacheProduct(key, tag, result, std::integral_constant<bool, edm::PileUpProductSize<T>::known>());
+      return true;
+    }
+    // keep the product alive while this pileup event is processed, even if it is evicted meanwhile
+    pinned_.push_back(entry);
+    result = edm::Handle<T>(static_cast<T const*>(entry->product_.get()), &entry->provenance_);
+    return true;
+  }
+
+  template<typename T>
+  void
+  cacheProduct(edm::PileUpProductCache::Key const& key, edm::InputTag const& tag, edm::Handle<T> const& result, std::true_type) const {
+    // share the ownership of the wrapper held by the secondary EventPrincipal,
+    // which only drops its own reference when it is cleared for the next event
+    auto wrapper = edm::getProductByTag<T>(principal_, tag, mcc_);
+    if(!wrapper || wrapper->product() != result.product()) {
+      return;
+    }
+    std::shared_ptr<void const> product(wrapper, wrapper->product());
+    cache_->insert(key, std::move(product), *result.provenance(), edm::PileUpProductSize<T>::size(*result));
+  }
+
+  template<typename T>
+  void
+  cacheProduct(edm::PileUpProductCache::Key const&, edm::InputTag const&, edm::Handle<T> const&, std::false_type) const {}
+
   edm::EventPrincipal const& principal_;
   edm::ModuleCallingContext const* mcc_;
   int bunchCrossing_;
+  edm::PileUpProductCache* cache_;
+  size_t fileNameHash_;
+  mutable std::vector<std::shared_ptr<edm::PileUpProductCache::Entry const>> pinned_;
 };
 
 #endif
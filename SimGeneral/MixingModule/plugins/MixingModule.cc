@@ -322,6 +322,7 @@ namespace edm {
 
   void MixingModule::pileAllWorkers(EventPrincipal const& eventPrincipal,
                                     ModuleCallingContext const* mcc,
+                                    PileUp const& source,
                                     int bunchCrossing, int eventId,
                                     int& vertexOffset,
                                     const edm::EventSetup& setup,
@@ -336,7 +337,8 @@ namespace edm {
     for (auto const& adjuster : adjusters_) {
       adjuster->doOffset(bunchSpace_, bunchCrossing, eventPrincipal, &moduleCallingContext, eventId, vertexOffset);
     }
-    PileUpEventPrincipal pep(eventPrincipal, &moduleCallingContext, bunchCrossing);
+    PileUpEventPrincipal pep(eventPrincipal, &moduleCallingContext, bunchCrossing,
+                             source.productCache(), source.fileNameHash());
 
     accumulateEvent(pep, setup, streamID);
 
@@ -487,7 +489,7 @@ namespace edm {
           int numberOfEvents = (readSrcIdx == 0 ? PileupList[bunchIdx - minBunch_] : 1);
           sizes.push_back(numberOfEvents);
           inputSources_[readSrcIdx]->readPileUp(e.id(), recordEventID,
-                                                std::bind(&MixingModule::pileAllWorkers, std::ref(*this), _1, mcc, bunchIdx,
+                                                std::bind(&MixingModule::pileAllWorkers, std::ref(*this), _1, mcc, std::cref(*source), bunchIdx,
                                                             _2, vertexOffset, std::ref(setup), e.streamID()), numberOfEvents, e.streamID());
         } else if(oldFormatPlayback) {
           std::vector<edm::EventID> const& playEventID = oldFormatPlaybackInfo_H->getStartEventId(readSrcIdx, bunchIdx);
@@ -501,7 +503,7 @@ namespace edm {
           std::vector<EventID>::const_iterator end = playEventID.end();
           inputSources_[readSrcIdx]->playOldFormatPileUp(
             begin, end, recordEventID,
-            std::bind(&MixingModule::pileAllWorkers, std::ref(*this), _1, mcc, bunchIdx,
+            std::bind(&MixingModule::pileAllWorkers, std::ref(*this), _1, mcc, std::cref(*source), bunchIdx,
                         _2, vertexOffset, std::ref(setup), e.streamID()));
         } else {
           size_t numberOfEvents = playbackInfo_H->getNumberOfEvents(bunchIdx, readSrcIdx);
@@ -515,7 +517,7 @@ namespace edm {
           std::vector<SecondaryEventIDAndFileInfo>::const_iterator end = playbackInfo_H->getEventId(playbackCounter);
           inputSources_[readSrcIdx]->playPileUp(
             begin, end, recordEventID,
-            std::bind(&MixingModule::pileAllWorkers, std::ref(*this), _1, mcc, bunchIdx,
+            std::bind(&MixingModule::pileAllWorkers, std::ref(*this), _1, mcc, std::cref(*source), bunchIdx,
                         _2, vertexOffset, std::ref(setup), e.streamID()));
 	}
       }
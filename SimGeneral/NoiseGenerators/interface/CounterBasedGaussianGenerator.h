@@ -0,0 +1,50 @@
+/** \class CounterBasedGaussianGenerator
+ * Counter-based generation of standard normal random numbers for
+ * electronics noise.
+ *
+ * The numbers for a channel are a pure function of (event key, channel,
+ * sample index), computed with the Philox4x32-10 bijection followed by a
+ * Box-Muller transform. The noise of a channel therefore does not depend
+ * on the order in which channels are digitized nor on the number of
+ * threads, and all channels of a subdetector can be generated in one
+ * batched pass without virtual calls to a CLHEP engine.
+ *
+ * The event key is drawn once per event from the stream engine of the
+ * RandomNumberGeneratorService, which keeps the event reproducible.
+ */
+#ifndef CounterBasedGaussianGenerator_h
+#define CounterBasedGaussianGenerator_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CLHEP {
+  class HepRandomEngine;
+}
+
+class CounterBasedGaussianGenerator {
+
+public:
+
+  CounterBasedGaussianGenerator() : key0_(0), key1_(0) {}
+
+  /// draws a new event key from the engine
+  void setEventKey(CLHEP::HepRandomEngine*);
+  void setEventKey(uint64_t key) { key0_ = uint32_t(key); key1_ = uint32_t(key >> 32); }
+
+  /// fills n standard normal numbers for one channel
+  void generate(uint32_t channel, unsigned int n, double* out) const;
+
+  /// fills nSamples standard normal numbers for each of nChannels channels,
+  /// out[i*nSamples + k] is sample k of channels[i]; identical to calling
+  /// generate() channel by channel, but the Philox rounds of several
+  /// channels are computed together
+  void generate(uint32_t const* channels, size_t nChannels, unsigned int nSamples, double* out) const;
+
+private:
+
+  uint32_t key0_;
+  uint32_t key1_;
+};
+
+#endif
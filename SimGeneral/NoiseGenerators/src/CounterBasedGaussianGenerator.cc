@@ -0,0 +1,114 @@
+#include "SimGeneral/NoiseGenerators/interface/CounterBasedGaussianGenerator.h"
+#include "CLHEP/Random/RandomEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // Philox4x32-10, Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (SC11)
+  constexpr uint32_t kM0 = 0xD2511F53;
+  constexpr uint32_t kM1 = 0xCD9E8D57;
+  constexpr uint32_t kW0 = 0x9E3779B9;
+  constexpr uint32_t kW1 = 0xBB67AE85;
+
+  constexpr uint32_t kTag = 0x43414c4f; // "CALO"
+
+  inline void philox(uint32_t ctr[4], uint32_t k0, uint32_t k1) {
+    for(int round = 0; round < 10; ++round) {
+      uint64_t p0 = uint64_t(kM0) * ctr[0];
+      uint64_t p1 = uint64_t(kM1) * ctr[2];
+      uint32_t c0 = uint32_t(p1 >> 32) ^ ctr[1] ^ k0;
+      uint32_t c2 = uint32_t(p0 >> 32) ^ ctr[3] ^ k1;
+      ctr[0] = c0;
+      ctr[1] = uint32_t(p1);
+      ctr[2] = c2;
+      ctr[3] = uint32_t(p0);
+      k0 += kW0;
+      k1 += kW1;
+    }
+  }
+
+  // the same rounds for kLanes counters at once, in a layout the compiler can vectorize
+  constexpr unsigned int kLanes = 8;
+
+  inline void philoxLanes(uint32_t c0[kLanes], uint32_t c1[kLanes], uint32_t c2[kLanes], uint32_t c3[kLanes],
+                          uint32_t k0, uint32_t k1) {
+    for(int round = 0; round < 10; ++round) {
+      for(unsigned int l = 0; l < kLanes; ++l) {
+        uint64_t p0 = uint64_t(kM0) * c0[l];
+        uint64_t p1 = uint64_t(kM1) * c2[l];
+        uint32_t n0 = uint32_t(p1 >> 32) ^ c1[l] ^ k0;
+        uint32_t n2 = uint32_t(p0 >> 32) ^ c3[l] ^ k1;
+        c0[l] = n0;
+        c1[l] = uint32_t(p1);
+        c2[l] = n2;
+        c3[l] = uint32_t(p0);
+      }
+      k0 += kW0;
+      k1 += kW1;
+    }
+  }
+
+  // uniform in the open interval (0,1)
+  inline double uniform(uint32_t x) { return (double(x) + 0.5) * (1.0/4294967296.0); }
+
+  // the two normal numbers of a pair of uniform words
+  inline void boxMuller(uint32_t u0, uint32_t u1, double& x0, double& x1) {
+    double r = std::sqrt(-2.*std::log(uniform(u0)));
+    double phi = 2.*M_PI*uniform(u1);
+    x0 = r*std::cos(phi);
+    x1 = r*std::sin(phi);
+  }
+
+  // one Philox block gives four normal numbers
+  inline void block(uint32_t channel, uint32_t index, uint32_t k0, uint32_t k1, double out[4]) {
+    uint32_t ctr[4] = {channel, index, kTag, 0};
+    philox(ctr, k0, k1);
+    boxMuller(ctr[0], ctr[1], out[0], out[1]);
+    boxMuller(ctr[2], ctr[3], out[2], out[3]);
+  }
+}
+
+void CounterBasedGaussianGenerator::setEventKey(CLHEP::HepRandomEngine* engine) {
+  key0_ = static_cast<unsigned int>(*engine);
+  key1_ = static_cast<unsigned int>(*engine);
+}
+
+void CounterBasedGaussianGenerator::generate(uint32_t channel, unsigned int n, double* out) const {
+  double tmp[4];
+  unsigned int i = 0;
+  for(uint32_t b = 0; i + 4 <= n; ++b, i += 4) {
+    block(channel, b, key0_, key1_, out + i);
+  }
+  if(i < n) {
+    block(channel, i/4, key0_, key1_, tmp);
+    for(unsigned int j = 0; i < n; ++i, ++j) out[i] = tmp[j];
+  }
+}
+
+void CounterBasedGaussianGenerator::generate(uint32_t const* channels, size_t nChannels, unsigned int nSamples, double* out) const {
+  const unsigned int nBlocks = (nSamples + 3)/4;
+  uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+  for(size_t first = 0; first < nChannels; first += kLanes) {
+    const unsigned int nLanes = std::min<size_t>(kLanes, nChannels - first);
+    for(unsigned int b = 0; b < nBlocks; ++b) {
+      // the unused lanes of the last group repeat its first channel
+      for(unsigned int l = 0; l < kLanes; ++l) {
+        c0[l] = channels[first + (l < nLanes ? l : 0)];
+        c1[l] = b;
+        c2[l] = kTag;
+        c3[l] = 0;
+      }
+      philoxLanes(c0, c1, c2, c3, key0_, key1_);
+      const unsigned int k0 = 4*b;
+      const unsigned int nk = std::min(4u, nSamples - k0);
+      for(unsigned int l = 0; l < nLanes; ++l) {
+        double x[4];
+        boxMuller(c0[l], c1[l], x[0], x[1]);
+        boxMuller(c2[l], c3[l], x[2], x[3]);
+        double* o = out + (first + l)*nSamples + k0;
+        for(unsigned int k = 0; k < nk; ++k) o[k] = x[k];
+      }
+    }
+  }
+}
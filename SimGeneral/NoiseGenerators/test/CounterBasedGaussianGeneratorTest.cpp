@@ -0,0 +1,112 @@
+#include "SimGeneral/NoiseGenerators/interface/CounterBasedGaussianGenerator.h"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+   // correlation coefficient of the pairs (x[i], y[i])
+   double correlation( const std::vector<double>& x , const std::vector<double>& y )
+   {
+      double sx ( 0 ) , sy ( 0 ) , sxx ( 0 ) , syy ( 0 ) , sxy ( 0 ) ;
+      for( size_t i ( 0 ) ; i != x.size() ; ++i )
+      {
+	 sx += x[i] ; sy += y[i] ;
+	 sxx += x[i]*x[i] ; syy += y[i]*y[i] ; sxy += x[i]*y[i] ;
+      }
+      const double n ( x.size() ) ;
+      const double cov ( sxy/n - sx/n*sy/n ) ;
+      return cov/std::sqrt( ( sxx/n - sx/n*sx/n )*( syy/n - sy/n*sy/n ) ) ;
+   }
+}
+
+int main()
+{
+   CounterBasedGaussianGenerator generator ;
+   generator.setEventKey( 0x123456789abcdefULL ) ;
+
+   // 10 samples as in an ECAL frame: two full Philox blocks and a partial one
+   const unsigned int nSamples ( 10 ) ;
+   std::vector<uint32_t> channels ;
+   for( uint32_t ch ( 0 ) ; ch != 50000 ; ++ch ) channels.push_back( 0x10000000 + ch ) ;
+
+   std::vector<double> all ( channels.size()*nSamples ) ;
+   for( size_t i ( 0 ) ; i != channels.size() ; ++i )
+      generator.generate( channels[i], nSamples, &all[i*nSamples] ) ;
+
+   // the noise of a channel does not depend on the order of generation
+   std::vector<double> single ( nSamples ) ;
+   for( size_t i ( channels.size() ) ; i-- > 0 ; )
+   {
+      generator.generate( channels[i], nSamples, &single.front() ) ;
+      for( unsigned int k ( 0 ) ; k != nSamples ; ++k ) assert( single[k] == all[i*nSamples + k] ) ;
+   }
+
+   // the batch gives the same numbers as channel-by-channel generation, for
+   // any number of channels (full and partial groups of lanes) and samples
+   for( unsigned int n : { 1u , 3u , 4u , 10u } )
+   {
+      for( size_t nChannels : { size_t( 0 ) , size_t( 1 ) , size_t( 7 ) , size_t( 8 ) , size_t( 1001 ) } )
+      {
+	 std::vector<double> batch ( nChannels*n + 1 , -1. ) ;
+	 generator.generate( channels.data(), nChannels, n, batch.data() ) ;
+	 for( size_t i ( 0 ) ; i != nChannels ; ++i )
+	 {
+	    generator.generate( channels[i], n, &single.front() ) ;
+	    for( unsigned int k ( 0 ) ; k != n ; ++k ) assert( single[k] == batch[i*n + k] ) ;
+	 }
+	 assert( batch[nChannels*n] == -1. ) ; // nothing written beyond the last channel
+      }
+   }
+
+   // a prefix of the samples is the same whatever the number of samples asked for
+   std::vector<double> longer ( 32 ) ;
+   generator.generate( channels[7], longer.size(), &longer.front() ) ;
+   for( unsigned int k ( 0 ) ; k != nSamples ; ++k ) assert( longer[k] == all[7*nSamples + k] ) ;
+
+   // standard normal: the statistical uncertainty on mean and width is 1/sqrt(500000) ~ 0.0014
+   double sum ( 0 ) , sum2 ( 0 ) ;
+   unsigned int beyond3 ( 0 ) ;
+   for( double x : all ) { sum += x ; sum2 += x*x ; if( std::abs( x ) > 3. ) ++beyond3 ; }
+   const double mean ( sum/all.size() ) ;
+   const double rms ( std::sqrt( sum2/all.size() - mean*mean ) ) ;
+   const double tail ( double( beyond3 )/all.size() ) ;
+   std::cout << "mean " << mean << " rms " << rms << " fraction beyond 3 sigma " << tail << std::endl ;
+   assert( std::abs( mean ) < 0.007 ) ;
+   assert( std::abs( rms - 1. ) < 0.007 ) ;
+   assert( std::abs( tail - 0.0027 ) < 0.0005 ) ;
+
+   // no correlation between the same sample of neighbouring channels, nor
+   // between the samples of a channel, in particular across the Philox blocks
+   // and between the two numbers of a Box-Muller pair; the uncertainty on
+   // each coefficient is 1/sqrt(50000) ~ 0.0045
+   for( unsigned int k ( 0 ) ; k != nSamples ; ++k )
+   {
+      std::vector<double> x , y , z ;
+      for( size_t i ( 0 ) ; i + 1 < channels.size() ; ++i )
+      {
+	 x.push_back( all[i*nSamples + k] ) ;
+	 y.push_back( all[(i+1)*nSamples + k] ) ;
+	 z.push_back( all[i*nSamples + (k+1)%nSamples] ) ;
+      }
+      const double rChannels ( correlation( x, y ) ) ;
+      const double rSamples ( correlation( x, z ) ) ;
+      std::cout << "sample " << k << " correlation with next channel " << rChannels
+		<< " with next sample " << rSamples << std::endl ;
+      assert( std::abs( rChannels ) < 0.025 ) ;
+      assert( std::abs( rSamples ) < 0.025 ) ;
+   }
+
+   // a different event key gives different noise, uncorrelated with the first one
+   generator.setEventKey( 42 ) ;
+   std::vector<double> other ( all.size() ) ;
+   for( size_t i ( 0 ) ; i != channels.size() ; ++i )
+      generator.generate( channels[i], nSamples, &other[i*nSamples] ) ;
+   assert( other[0] != all[0] ) ;
+   const double rKeys ( correlation( all, other ) ) ;
+   std::cout << "correlation between event keys " << rKeys << std::endl ;
+   assert( std::abs( rKeys ) < 0.007 ) ;
+
+   return 0 ;
+}
@@ -0,0 +1,141 @@
+#ifndef SimGeneral_PreMixingModule_PremixLibrary_h
+#define SimGeneral_PreMixingModule_PremixLibrary_h
+
+/** \class PremixLibraryWriter, PremixLibraryReader
+ *
+ * Columnar, memory-mappable storage for premixed pileup digis.
+ *
+ * For every event and every subdetector the digis are stored as three
+ * columns (detid, channel, adc) sorted by (detid, channel). The reader
+ * maps the file read-only and gives random access to any event by index
+ * without deserializing anything, so that premixing workers can merge
+ * signal into pileup with a single linear pass (see premix::mergeSorted).
+ * Each event is identified by the (run, lumi, event) numbers of the premixed
+ * event it was written from, so that a premixing worker finds the columns of
+ * the pileup event given to it by the pileup source.
+ *
+ * File layout (native endianness):
+ *   header  : magic, version, number of subdetectors, number of events, index offset
+ *   payload : per event, per subdetector: detid[n] channel[n] adc[n], 8-byte aligned
+ *   index   : subdetector names, then (run << 32 | lumi, event) per event,
+ *             then (offset, size) per event and subdetector
+ *
+ ************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace premix {
+  /// Read-only view of the columns of one subdetector in one event.
+  struct ColumnView {
+    uint32_t const* detId = nullptr;
+    uint32_t const* channel = nullptr;
+    uint16_t const* adc = nullptr;
+    size_t size = 0;
+  };
+
+  /// Owning columns, used to build an event and as merge output.
+  struct Columns {
+    std::vector<uint32_t> detId;
+    std::vector<uint32_t> channel;
+    std::vector<uint16_t> adc;
+
+    void clear() { detId.clear(); channel.clear(); adc.clear(); }
+    void reserve(size_t n) { detId.reserve(n); channel.reserve(n); adc.reserve(n); }
+    void push_back(uint32_t d, uint32_t c, uint16_t a) { detId.push_back(d); channel.push_back(c); adc.push_back(a); }
+    size_t size() const { return detId.size(); }
+    ColumnView view() const { return ColumnView{detId.data(), channel.data(), adc.data(), detId.size()}; }
+    /// Sorts the columns by (detid, channel)
+    void sort();
+  };
+
+  /**
+   * Merges two sorted column sets in one linear pass. Digis present in
+   * both inputs are combined with combine(adcA, adcB), e.g. a saturating sum.
+   */
+  template<typename F>
+  void mergeSorted(ColumnView const& a, ColumnView const& b, Columns& out, F&& combine) {
+    out.clear();
+    out.reserve(a.size + b.size);
+    size_t i = 0, j = 0;
+    while(i < a.size && j < b.size) {
+      uint64_t ka = (uint64_t(a.detId[i]) << 32) | a.channel[i];
+      uint64_t kb = (uint64_t(b.detId[j]) << 32) | b.channel[j];
+      if(ka < kb) {
+        out.push_back(a.detId[i], a.channel[i], a.adc[i]); ++i;
+      }
+      else if(kb < ka) {
+        out.push_back(b.detId[j], b.channel[j], b.adc[j]); ++j;
+      }
+      else {
+        out.push_back(a.detId[i], a.channel[i], combine(a.adc[i], b.adc[j])); ++i; ++j;
+      }
+    }
+    for(; i < a.size; ++i) out.push_back(a.detId[i], a.channel[i], a.adc[i]);
+    for(; j < b.size; ++j) out.push_back(b.detId[j], b.channel[j], b.adc[j]);
+  }
+}
+
+class PremixLibraryWriter {
+public:
+  PremixLibraryWriter(std::string const& fileName, std::vector<std::string> subdetectors);
+  ~PremixLibraryWriter();
+  PremixLibraryWriter(PremixLibraryWriter const&) = delete;
+  PremixLibraryWriter& operator=(PremixLibraryWriter const&) = delete;
+
+  /// Columns of the event being built for a subdetector; need not be sorted.
+  premix::Columns& columns(unsigned int subdet) { return current_.at(subdet); }
+
+  /// Sorts and appends the current event, then clears it.
+  void endEvent(uint32_t run, uint32_t lumi, uint64_t event);
+
+  /// Writes the index; called by the destructor if not done explicitly.
+  void close();
+
+  uint64_t numberOfEvents() const { return nEvents_; }
+
+private:
+  std::ofstream file_;
+  std::vector<std::string> subdetectors_;
+  std::vector<premix::Columns> current_;
+  std::vector<uint64_t> index_;
+  std::vector<uint64_t> ids_;
+  uint64_t nEvents_;
+  uint64_t offset_;
+  bool closed_;
+};
+
+class PremixLibraryReader {
+public:
+  explicit PremixLibraryReader(std::string const& fileName);
+  ~PremixLibraryReader();
+  PremixLibraryReader(PremixLibraryReader const&) = delete;
+  PremixLibraryReader& operator=(PremixLibraryReader const&) = delete;
+
+  uint64_t numberOfEvents() const { return nEvents_; }
+  std::vector<std::string> const& subdetectors() const { return subdetectors_; }
+  /// Index of a subdetector name, throws if unknown
+  unsigned int subdetectorIndex(std::string const& name) const;
+
+  /// Index of the event written from (run, lumi, event); false if there is none
+  bool find(uint32_t run, uint32_t lumi, uint64_t event, uint64_t& index) const;
+
+  /// Thread safe, the mapping is read-only.
+  premix::ColumnView columns(uint64_t event, unsigned int subdet) const;
+
+private:
+  std::string fileName_;
+  char const* data_;
+  size_t length_;
+  std::vector<std::string> subdetectors_;
+  uint64_t const* index_;
+  uint64_t nEvents_;
+  // (run << 32 | lumi, event, index) sorted, for find()
+  std::vector<std::array<uint64_t, 3> > ids_;
+};
+
+#endif
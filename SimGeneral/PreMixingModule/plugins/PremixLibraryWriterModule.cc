@@ -0,0 +1,74 @@
+/** \class PremixLibraryWriterModule
+ *
+ * Writes the digis of premixed pileup events into a premix library (see
+ * PremixLibrary.h), to be read by the premixing workers in place of the
+ * ROOT products. It runs on the premixed pileup files themselves, so that
+ * each library event carries the run, lumi and event numbers the pileup
+ * source gives to the PreMixingModule.
+ *
+ * Stored subdetectors:
+ *   "strip": the SiStrip digis, as (detid, strip, adc)
+ *
+ ************************************************************/
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/SiStripDigi/interface/SiStripDigi.h"
+
+#include "SimGeneral/PreMixingModule/interface/PremixLibrary.h"
+
+#include <memory>
+
+class PremixLibraryWriterModule: public edm::one::EDAnalyzer<> {
+public:
+  explicit PremixLibraryWriterModule(edm::ParameterSet const& ps);
+  ~PremixLibraryWriterModule() override = default;
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  void analyze(edm::Event const& e, edm::EventSetup const& es) override;
+  void endJob() override;
+
+private:
+  edm::EDGetTokenT<edm::DetSetVector<SiStripDigi> > stripToken_;
+  std::unique_ptr<PremixLibraryWriter> writer_;
+  unsigned int strip_;
+};
+
+PremixLibraryWriterModule::PremixLibraryWriterModule(edm::ParameterSet const& ps):
+  stripToken_(consumes<edm::DetSetVector<SiStripDigi> >(ps.getParameter<edm::InputTag>("siStripDigis"))),
+  writer_(new PremixLibraryWriter(ps.getParameter<std::string>("fileName"), {"strip"})),
+  strip_(0)
+{}
+
+void PremixLibraryWriterModule::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<std::string>("fileName", "premixLibrary.bin");
+  desc.add<edm::InputTag>("siStripDigis", edm::InputTag("siStripDigis", "ZeroSuppressed"));
+  descriptions.add("premixLibraryWriter", desc);
+}
+
+void PremixLibraryWriterModule::analyze(edm::Event const& e, edm::EventSetup const& es) {
+  edm::Handle<edm::DetSetVector<SiStripDigi> > stripDigis;
+  e.getByToken(stripToken_, stripDigis);
+  auto& strips = writer_->columns(strip_);
+  for(auto const& detSet : *stripDigis) {
+    for(auto const& digi : detSet) {
+      strips.push_back(detSet.detId(), digi.strip(), digi.adc());
+    }
+  }
+  writer_->endEvent(e.id().run(), e.id().luminosityBlock(), e.id().event());
+}
+
+void PremixLibraryWriterModule::endJob() {
+  writer_->close();
+  edm::LogInfo("PremixLibraryWriterModule") << writer_->numberOfEvents() << " events written to the premix library";
+}
+
+DEFINE_FWK_MODULE(PremixLibraryWriterModule);
@@ -102,6 +102,9 @@ mixData = cms.EDProducer("PreMixingModule",
 
             SistripLabelSig = cms.InputTag("simSiStripDigis","ZeroSuppressed"),
             SiStripPileInputTag = cms.InputTag("siStripDigis","ZeroSuppressed","@MIXING"),
+            # premix library written by PremixLibraryWriterModule from the pileup files;
+            # events not in it are read from SiStripPileInputTag
+            pileupLibrary = cms.string(''),
             # Dead APV Vector
             SistripAPVPileInputTag = cms.InputTag("mix","AffectedAPVList"),
             SistripAPVLabelSig = cms.InputTag("mix","AffectedAPVList"),
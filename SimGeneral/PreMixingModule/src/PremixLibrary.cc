@@ -0,0 +1,241 @@
+#include "SimGeneral/PreMixingModule/interface/PremixLibrary.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  constexpr char kMagic[8] = {'C','M','S','P','M','X','L','B'};
+  constexpr uint32_t kVersion = 2;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t nSubdets;
+    uint64_t nEvents;
+    uint64_t indexOffset;
+  };
+  static_assert(sizeof(Header) == 32, "PremixLibrary header must be 32 bytes");
+
+  size_t padded(size_t n) { return (n + 7) & ~size_t(7); }
+  size_t columnBytes(size_t n) { return padded(n*sizeof(uint32_t)) + padded(n*sizeof(uint32_t)) + padded(n*sizeof(uint16_t)); }
+
+  template<typename T>
+  void writeColumn(std::ofstream& file, std::vector<T> const& v) {
+    static char const zeros[8] = {0};
+    size_t bytes = v.size()*sizeof(T);
+    file.write(reinterpret_cast<char const*>(v.data()), bytes);
+    file.write(zeros, padded(bytes) - bytes);
+  }
+}
+
+namespace premix {
+  void Columns::sort() {
+    std::vector<uint32_t> order(size());
+    std::iota(order.begin(), order.end(), 0U);
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return detId[a] != detId[b] ? detId[a] < detId[b] : channel[a] < channel[b];
+      });
+    Columns sorted;
+    sorted.reserve(size());
+    for(auto i: order) {
+      sorted.push_back(detId[i], channel[i], adc[i]);
+    }
+    std::swap(*this, sorted);
+  }
+}
+
+PremixLibraryWriter::PremixLibraryWriter(std::string const& fileName, std::vector<std::string> subdetectors):
+  file_(fileName, std::ios::binary | std::ios::trunc),
+  subdetectors_(std::move(subdetectors)),
+  current_(subdetectors_.size()),
+  nEvents_(0),
+  offset_(sizeof(Header)),
+  closed_(false)
+{
+  if(!file_) {
+    throw cms::Exception("PremixLibrary") << "Could not open " << fileName << " for writing";
+  }
+  // placeholder header, completed in close()
+  Header header{};
+  file_.write(reinterpret_cast<char const*>(&header), sizeof(header));
+}
+
+PremixLibraryWriter::~PremixLibraryWriter() {
+  if(!closed_) {
+    try {
+      close();
+    } catch(...) {}
+  }
+}
+
+void PremixLibraryWriter::endEvent(uint32_t run, uint32_t lumi, uint64_t event) {
+  ids_.push_back((uint64_t(run) << 32) | lumi);
+  ids_.push_back(event);
+  for(auto& cols: current_) {
+    cols.sort();
+    index_.push_back(offset_);
+    index_.push_back(cols.size());
+    writeColumn(file_, cols.detId);
+    writeColumn(file_, cols.channel);
+    writeColumn(file_, cols.adc);
+    offset_ += columnBytes(cols.size());
+    cols.clear();
+  }
+  ++nEvents_;
+  if(!file_) {
+    throw cms::Exception("PremixLibrary") << "Write error after event " << nEvents_;
+  }
+}
+
+void PremixLibraryWriter::close() {
+  closed_ = true;
+  uint64_t indexOffset = offset_;
+  for(auto const& name: subdetectors_) {
+    std::vector<char> buf(name.begin(), name.end());
+    uint64_t len = buf.size();
+    file_.write(reinterpret_cast<char const*>(&len), sizeof(len));
+    writeColumn(file_, buf);
+  }
+  file_.write(reinterpret_cast<char const*>(ids_.data()), ids_.size()*sizeof(uint64_t));
+  file_.write(reinterpret_cast<char const*>(index_.data()), index_.size()*sizeof(uint64_t));
+
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.nSubdets = subdetectors_.size();
+  header.nEvents = nEvents_;
+  header.indexOffset = indexOffset;
+  file_.seekp(0);
+  file_.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  file_.close();
+  if(file_.fail()) {
+    throw cms::Exception("PremixLibrary") << "Write error while closing the premix library";
+  }
+}
+
+PremixLibraryReader::PremixLibraryReader(std::string const& fileName):
+  fileName_(fileName),
+  data_(nullptr),
+  length_(0),
+  index_(nullptr),
+  nEvents_(0)
+{
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if(fd < 0) {
+    throw cms::Exception("PremixLibrary") << "Could not open " << fileName;
+  }
+  struct stat st;
+  if(::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    ::close(fd);
+    throw cms::Exception("PremixLibrary") << fileName << " is too short to be a premix library";
+  }
+  length_ = st.st_size;
+  void* addr = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if(addr == MAP_FAILED) {
+    throw cms::Exception("PremixLibrary") << "Could not map " << fileName;
+  }
+  data_ = static_cast<char const*>(addr);
+
+  // the checks below must not read beyond length_ nor overflow, whatever the content of the file
+  auto corrupted = [this](char const* what) {
+    ::munmap(const_cast<char*>(data_), length_);
+    data_ = nullptr;
+    throw cms::Exception("PremixLibrary") << fileName_ << " has a corrupted " << what;
+  };
+
+  Header header;
+  if(length_ < sizeof(header)) {
+    corrupted("header");
+  }
+  std::memcpy(&header, data_, sizeof(header));
+  if(std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+    ::munmap(const_cast<char*>(data_), length_);
+    data_ = nullptr;
+    throw cms::Exception("PremixLibrary") << fileName << " is not a premix library of version " << kVersion;
+  }
+  nEvents_ = header.nEvents;
+
+  if(header.indexOffset < sizeof(header) || header.indexOffset > length_ || header.indexOffset % sizeof(uint64_t) != 0) {
+    corrupted("index offset");
+  }
+  size_t pos = header.indexOffset;
+  for(uint32_t i = 0; i < header.nSubdets; ++i) {
+    uint64_t len;
+    if(length_ - pos < sizeof(len)) {
+      corrupted("subdetector list");
+    }
+    std::memcpy(&len, data_ + pos, sizeof(len));
+    pos += sizeof(len);
+    if(len > length_ - pos || padded(len) > length_ - pos) {
+      corrupted("subdetector list");
+    }
+    subdetectors_.emplace_back(data_ + pos, len);
+    pos += padded(len);
+  }
+  // one (id, event) pair per event, then one (offset, size) pair per event and subdetector
+  size_t const entryBytes = 2*sizeof(uint64_t);
+  if(nEvents_ > (length_ - pos)/entryBytes/(subdetectors_.size() + 1)) {
+    corrupted("index");
+  }
+  uint64_t const* ids = reinterpret_cast<uint64_t const*>(data_ + pos);
+  index_ = ids + 2*nEvents_;
+  ids_.reserve(nEvents_);
+  for(uint64_t i = 0; i < nEvents_; ++i) {
+    ids_.push_back({{ids[2*i], ids[2*i+1], i}});
+  }
+  std::sort(ids_.begin(), ids_.end());
+}
+
+PremixLibraryReader::~PremixLibraryReader() {
+  if(data_) {
+    ::munmap(const_cast<char*>(data_), length_);
+  }
+}
+
+unsigned int PremixLibraryReader::subdetectorIndex(std::string const& name) const {
+  auto found = std::find(subdetectors_.begin(), subdetectors_.end(), name);
+  if(found == subdetectors_.end()) {
+    throw cms::Exception("PremixLibrary") << "Subdetector " << name << " not found in " << fileName_;
+  }
+  return found - subdetectors_.begin();
+}
+
+bool PremixLibraryReader::find(uint32_t run, uint32_t lumi, uint64_t event, uint64_t& index) const {
+  std::array<uint64_t, 3> const key{{(uint64_t(run) << 32) | lumi, event, 0}};
+  auto found = std::lower_bound(ids_.begin(), ids_.end(), key);
+  if(found == ids_.end() || (*found)[0] != key[0] || (*found)[1] != key[1]) {
+    return false;
+  }
+  index = (*found)[2];
+  return true;
+}
+
+premix::ColumnView PremixLibraryReader::columns(uint64_t event, unsigned int subdet) const {
+  if(event >= nEvents_ || subdet >= subdetectors_.size()) {
+    throw cms::Exception("PremixLibrary") << "Event " << event << " subdetector " << subdet << " out of range in " << fileName_;
+  }
+  uint64_t const* entry = index_ + 2*(event*subdetectors_.size() + subdet);
+  uint64_t const offset = entry[0];
+  uint64_t const n = entry[1];
+  // the columns must lie within the file: n is bounded first so that the size computation cannot overflow
+  if(offset > length_ || offset % sizeof(uint64_t) != 0 || n > (length_ - offset)/(2*sizeof(uint32_t) + sizeof(uint16_t)) ||
+     2*padded(n*sizeof(uint32_t)) + n*sizeof(uint16_t) > length_ - offset) {
+    throw cms::Exception("PremixLibrary") << "Event " << event << " subdetector " << subdet << " has a corrupted index entry in " << fileName_;
+  }
+  char const* base = data_ + offset;
+  premix::ColumnView view;
+  view.detId = reinterpret_cast<uint32_t const*>(base);
+  view.channel = reinterpret_cast<uint32_t const*>(base + padded(n*sizeof(uint32_t)));
+  view.adc = reinterpret_cast<uint16_t const*>(base + 2*padded(n*sizeof(uint32_t)));
+  view.size = n;
+  return view;
+}
@@ -0,0 +1,139 @@
+#include "SimGeneral/PreMixingModule/interface/PremixLibrary.h"
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static constexpr auto s_tag = "[PremixLibrary]";
+TEST_CASE("Write and read back a premix library", s_tag) {
+  std::string const fileName = "premixLibraryTest.bin";
+  {
+    PremixLibraryWriter writer(fileName, {"strip", "pixel"});
+    // event 0, unsorted input
+    writer.columns(0).push_back(20, 5, 100);
+    writer.columns(0).push_back(10, 7, 30);
+    writer.columns(0).push_back(10, 3, 40);
+    writer.columns(1).push_back(1, 1, 1);
+    writer.endEvent(1, 7, 1234);
+    // event 1, empty strips
+    writer.columns(1).push_back(2, 9, 7);
+    writer.columns(1).push_back(2, 8, 6);
+    writer.endEvent(1, 3, 99);
+    writer.close();
+  }
+
+  PremixLibraryReader reader(fileName);
+  REQUIRE(reader.numberOfEvents() == 2);
+  REQUIRE(reader.subdetectors().size() == 2);
+  REQUIRE(reader.subdetectorIndex("pixel") == 1);
+  REQUIRE_THROWS(reader.subdetectorIndex("hcal"));
+
+  SECTION("events are found by their run, lumi and event numbers") {
+    uint64_t index = 2;
+    REQUIRE(reader.find(1, 7, 1234, index));
+    REQUIRE(index == 0);
+    REQUIRE(reader.find(1, 3, 99, index));
+    REQUIRE(index == 1);
+    REQUIRE(!reader.find(1, 3, 1234, index));
+    REQUIRE(!reader.find(2, 7, 1234, index));
+    REQUIRE(!reader.find(1, 7, 99, index));
+  }
+
+  SECTION("columns are sorted by detid and channel") {
+    auto strips = reader.columns(0, 0);
+    REQUIRE(strips.size == 3);
+    REQUIRE(strips.detId[0] == 10);
+    REQUIRE(strips.channel[0] == 3);
+    REQUIRE(strips.adc[0] == 40);
+    REQUIRE(strips.channel[1] == 7);
+    REQUIRE(strips.detId[2] == 20);
+    REQUIRE(strips.adc[2] == 100);
+
+    REQUIRE(reader.columns(1, 0).size == 0);
+    auto pixels = reader.columns(1, 1);
+    REQUIRE(pixels.size == 2);
+    REQUIRE(pixels.channel[0] == 8);
+    REQUIRE(pixels.adc[1] == 7);
+    REQUIRE_THROWS(reader.columns(2, 0));
+  }
+
+  SECTION("sorted merge combines common channels") {
+    premix::Columns signal;
+    signal.push_back(10, 3, 1000);
+    signal.push_back(15, 0, 2);
+    signal.push_back(20, 5, 1);
+    premix::Columns merged;
+    premix::mergeSorted(reader.columns(0, 0), signal.view(), merged,
+                        [](uint16_t a, uint16_t b) { return std::min<uint32_t>(a + b, 1023); });
+    REQUIRE(merged.size() == 4);
+    REQUIRE(merged.adc[0] == 1023);
+    REQUIRE(merged.channel[1] == 7);
+    REQUIRE(merged.detId[2] == 15);
+    REQUIRE(merged.adc[3] == 101);
+  }
+
+  std::remove(fileName.c_str());
+}
+
+namespace {
+  std::vector<char> readFile(std::string const& fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+
+  void writeFile(std::string const& fileName, std::vector<char> const& content, size_t size) {
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), size);
+  }
+}
+
+TEST_CASE("Corrupted premix libraries are rejected", s_tag) {
+  std::string const fileName = "premixLibraryCorruptTest.bin";
+  std::string const corruptName = "premixLibraryCorruptTest2.bin";
+  {
+    PremixLibraryWriter writer(fileName, {"strip", "pixel"});
+    writer.columns(0).push_back(20, 5, 100);
+    writer.columns(1).push_back(1, 1, 1);
+    writer.endEvent(1, 1, 1);
+    writer.columns(0).push_back(3, 2, 1);
+    writer.endEvent(1, 1, 2);
+    writer.close();
+  }
+  auto const content = readFile(fileName);
+  REQUIRE(content.size() > 64);
+
+  SECTION("truncated files") {
+    // the index is at the end of the file, so every truncation must be detected
+    for(size_t size = 0; size < content.size(); ++size) {
+      writeFile(corruptName, content, size);
+      REQUIRE_THROWS(PremixLibraryReader(corruptName));
+    }
+  }
+
+  SECTION("index entries pointing outside of the file") {
+    // the index holds (offset, size) per event and subdetector and closes the file
+    size_t const nEntries = 2*2;
+    size_t const indexPos = content.size() - nEntries*2*sizeof(uint64_t);
+    std::vector<uint64_t> const bad = {content.size(), content.size() - 8, uint64_t(1) << 62, ~uint64_t(0)};
+    for(unsigned int field = 0; field < 2; ++field) {
+      for(uint64_t value : bad) {
+        auto corrupt = content;
+        std::copy(reinterpret_cast<char const*>(&value), reinterpret_cast<char const*>(&value) + sizeof(value),
+                  corrupt.begin() + indexPos + field*sizeof(uint64_t));
+        writeFile(corruptName, corrupt, corrupt.size());
+        PremixLibraryReader reader(corruptName);
+        REQUIRE_THROWS(reader.columns(0, 0));
+        REQUIRE(reader.columns(1, 0).size == 1);
+      }
+    }
+  }
+
+  std::remove(corruptName.c_str());
+  std::remove(fileName.c_str());
+}
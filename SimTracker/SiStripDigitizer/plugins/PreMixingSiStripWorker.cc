@@ -35,6 +35,7 @@
 
 #include "SimGeneral/PreMixingModule/interface/PreMixingWorker.h"
 #include "SimGeneral/PreMixingModule/interface/PreMixingWorkerFactory.h"
+#include "SimGeneral/PreMixingModule/interface/PremixLibrary.h"
 
 #include <map>
 #include <memory>
@@ -62,6 +63,9 @@ private:
   edm::InputTag SiStripAPVPileInputTag_;
   std::string SistripAPVListDM_;          // output tag
 
+  // premix library read in place of the pileup strips, if given
+  std::unique_ptr<PremixLibraryReader> pileupLibrary_;
+  unsigned int pileupLibraryStrip_ = 0;
 
   // 
 
@@ -75,6 +79,7 @@ private:
   typedef SiDigitalConverter::DigitalVecType DigitalVecType;
 
   SiGlobalIndex SiHitStorage_;
+  void addPileupDigis(uint32_t detID, OneDetectorMap const& digis);
   SiGlobalRawIndex SiRawDigis_;
 
   // variables for temporary storage of mixed hits:
@@ -158,6 +163,12 @@ PreMixingSiStripWorker::PreMixingSiStripWorker(const edm::ParameterSet& ps, edm:
 
   producer.produces< edm::DetSetVector<SiStripDigi> > (SiStripDigiCollectionDM_);
 
+  const std::string pileupLibrary = ps.getParameter<std::string>("pileupLibrary");
+  if(!pileupLibrary.empty()) {
+    pileupLibrary_.reset(new PremixLibraryReader(pileupLibrary));
+    pileupLibraryStrip_ = pileupLibrary_->subdetectorIndex("strip");
+  }
+
   if(APVSaturationFromHIP_) { 
     SistripAPVLabelSig_ = ps.getParameter<edm::InputTag>("SistripAPVLabelSig");
     SiStripAPVPileInputTag_ = ps.getParameter<edm::InputTag>("SistripAPVPileInputTag");
@@ -273,48 +284,41 @@ void PreMixingSiStripWorker::addPileups(PileUpEventPrincipal const& pep, edm::Ev
 
   // fill in maps of hits; same code as addSignals, except now applied to the pileup events
 
-  edm::Handle<edm::DetSetVector<SiStripDigi>> inputHandle;
-  pep.getByLabel(SiStripPileInputTag_, inputHandle);
-
-  if(inputHandle.isValid()) {
-    const auto& input = *inputHandle;
-
+  // the pileup event is taken from the library if it is there, otherwise from the event
+  bool found = false;
+  uint64_t index = 0;
+  const auto& id = pep.principal().id();
+  if(pileupLibrary_ && pileupLibrary_->find(id.run(), id.luminosityBlock(), id.event(), index)) {
+    const premix::ColumnView strips = pileupLibrary_->columns(index, pileupLibraryStrip_);
     OneDetectorMap LocalMap;
+    // the library columns are sorted by (detid, strip)
+    for(size_t i = 0; i < strips.size; ) {
+      const uint32_t detID = strips.detId[i];
+      LocalMap.clear();
+      for(; i < strips.size && strips.detId[i] == detID; ++i) {
+        LocalMap.emplace_back(strips.channel[i], strips.adc[i]);
+      }
+      addPileupDigis(detID, LocalMap);
+    }
+    found = true;
+  }
+  else {
+    edm::Handle<edm::DetSetVector<SiStripDigi>> inputHandle;
+    pep.getByLabel(SiStripPileInputTag_, inputHandle);
 
-    //loop on all detsets (detectorIDs) inside the input collection
-    edm::DetSetVector<SiStripDigi>::const_iterator DSViter=input.begin();
-    for (; DSViter!=input.end();DSViter++){
-
+    if(inputHandle.isValid()) {
+      //loop on all detsets (detectorIDs) inside the input collection
+      for(auto const& detSet : *inputHandle) {
 #ifdef DEBUG
-      LogDebug("PreMixingSiStripWorker")  << "Pileups: Processing DetID " << DSViter->id;
+        LogDebug("PreMixingSiStripWorker")  << "Pileups: Processing DetID " << detSet.id;
 #endif
-
-      // find correct local map (or new one) for this detector ID
-
-      SiGlobalIndex::const_iterator itest;
-
-      itest = SiHitStorage_.find(DSViter->id);
-
-      if(itest!=SiHitStorage_.end()) {  // this detID already has hits, add to existing map
-
-        LocalMap = itest->second;
-
-        // fill in local map with extra channels
-        LocalMap.insert(LocalMap.end(),(DSViter->data).begin(),(DSViter->data).end());
-        std::stable_sort(LocalMap.begin(),LocalMap.end(),PreMixingSiStripWorker::StrictWeakOrdering());
-        SiHitStorage_[DSViter->id]=LocalMap;
-	  
-      }
-      else{ // fill local storage with this information, put in global collection
-
-        LocalMap.clear();
-        LocalMap.reserve((DSViter->data).size());
-        LocalMap.insert(LocalMap.end(),(DSViter->data).begin(),(DSViter->data).end());
-
-        SiHitStorage_.insert( SiGlobalIndex::value_type( DSViter->id, LocalMap ) );
+        addPileupDigis(detSet.id, detSet.data);
       }
+      found = true;
     }
+  }
 
+  if(found) {
     if(APVSaturationFromHIP_) {
       edm::Handle<std::vector<std::pair<int,std::bitset<6>>>> inputAPVHandle;
       pep.getByLabel(SiStripAPVPileInputTag_, inputAPVHandle);
@@ -332,6 +336,21 @@ void PreMixingSiStripWorker::addPileups(PileUpEventPrincipal const& pep, edm::Ev
   }
 }
 
+void PreMixingSiStripWorker::addPileupDigis(uint32_t detID, OneDetectorMap const& digis) {
+  // find correct local map (or new one) for this detector ID
+  SiGlobalIndex::iterator itest = SiHitStorage_.find(detID);
+
+  if(itest!=SiHitStorage_.end()) {  // this detID already has hits, add to existing map
+    // fill in local map with extra channels
+    OneDetectorMap& LocalMap = itest->second;
+    LocalMap.insert(LocalMap.end(),digis.begin(),digis.end());
+    std::stable_sort(LocalMap.begin(),LocalMap.end(),PreMixingSiStripWorker::StrictWeakOrdering());
+  }
+  else{ // fill local storage with this information, put in global collection
+    SiHitStorage_.insert( SiGlobalIndex::value_type( detID, digis ) );
+  }
+}
+
 
  
 void PreMixingSiStripWorker::put(edm::Event &e, edm::EventSetup const& iSetup, std::vector<PileupSummaryInfo> const& ps, int bs) {
@@ -3,6 +3,8 @@
 
 #include "TrackingTools/GsfTools/interface/MultiGaussianStateMerger.h"
 #include "TrackingTools/GsfTools/interface/DistanceBetweenComponents.h"
+#include "TrackingTools/GsfTools/interface/KullbackLeiblerDistance.h"
+#include "TrackingTools/GsfTools/interface/GaussianMixtureSoA.h"
 #include "DataFormats/GeometryCommonDetAlgo/interface/DeepCopyPointerByClone.h"
 
 #include <map>
@@ -13,6 +15,9 @@
  *  which are close to one another. The actual calculation
  *  of the distance between components is done by a specific
  *  (polymorphic) class, given at construction time.
+ *  With the Kullback-Leibler distance the mixture is converted to a
+ *  GaussianMixtureSoA and the distances are computed for all candidate
+ *  components at once.
  */
 
 template <unsigned int N>
@@ -40,6 +45,9 @@ class CloseComponentsMerger final : public MultiGaussianStateMerger<N> {
   
   MultiState mergeOld(const MultiState& mgs) const;
 
+  /// same clustering as merge, on the SoA representation (KL distance only)
+  MultiState mergeSoA(const MultiState& mgs) const;
+
 
 public:
   typedef std::multimap< double, SingleStatePtr > SingleStateMap;
@@ -53,6 +61,7 @@ private:
 
   int theMaxNumberOfComponents;
   DeepCopyPointerByClone< DistanceBetweenComponents<N> > theDistance;
+  bool theDistanceIsKL;
 
 };  
 
@@ -0,0 +1,72 @@
+#ifndef GaussianMixtureSoA_H
+#define GaussianMixtureSoA_H
+
+#include "TrackingTools/GsfTools/interface/SingleGaussianState.h"
+
+#include <memory>
+#include <vector>
+
+/** Structure-of-arrays representation of a Gaussian mixture, used by
+ *  CloseComponentsMerger. Each element of mean, covariance and weight
+ *  matrix is stored contiguously for all components, so that the
+ *  Kullback-Leibler distances from one component to all the others are
+ *  computed in a single loop over components which the compiler can
+ *  vectorize. Symmetric matrices are stored as their lower triangle.
+ */
+
+template <unsigned int N>
+class GaussianMixtureSoA {
+public:
+  using SingleState = SingleGaussianState<N>;
+  using SingleStatePtr = std::shared_ptr<SingleState>;
+  using Vector = typename SingleState::Vector;
+  using Matrix = typename SingleState::Matrix;
+
+  static constexpr unsigned int kSym = N*(N+1)/2;
+
+  explicit GaussianMixtureSoA(unsigned int capacity=0);
+
+  unsigned int size() const { return theSize; }
+  void clear() { theSize = 0; }
+  void reserve(unsigned int capacity);
+
+  /// appends a component (computes its weight matrix if not yet done)
+  void addState(const SingleState& state);
+  /// appends a copy of component i of mixture src
+  void addState(const GaussianMixtureSoA& src, unsigned int i);
+  /** appends the moment-preserving combination of components i and j
+   *  of mixture src (same result as MultiGaussianStateCombiner)
+   */
+  void addMergedState(const GaussianMixtureSoA& src, unsigned int i, unsigned int j);
+
+  double weight(unsigned int i) const { return theWeights[i]; }
+
+  /// Kullback-Leibler distances from component ref to all components
+  void distancesTo(unsigned int ref, double* dist) const;
+  /// all pairwise distances, dist[i*size()+j]
+  void distanceMatrix(double* dist) const;
+
+  /// component i as a SingleGaussianState
+  SingleStatePtr state(unsigned int i) const;
+
+private:
+  double& mean(unsigned int k, unsigned int i) { return theMeans[k*theStride+i]; }
+  double mean(unsigned int k, unsigned int i) const { return theMeans[k*theStride+i]; }
+  double& cov(unsigned int s, unsigned int i) { return theCovariances[s*theStride+i]; }
+  double cov(unsigned int s, unsigned int i) const { return theCovariances[s*theStride+i]; }
+  double& gmat(unsigned int s, unsigned int i) { return theWeightMatrices[s*theStride+i]; }
+  double gmat(unsigned int s, unsigned int i) const { return theWeightMatrices[s*theStride+i]; }
+
+  void setWeightMatrix(unsigned int i, const Matrix& covariance);
+
+  unsigned int theSize;
+  unsigned int theStride;
+  std::vector<double> theWeights;
+  std::vector<double> theMeans;
+  std::vector<double> theCovariances;
+  std::vector<double> theWeightMatrices;
+};
+
+#include "TrackingTools/GsfTools/interface/GaussianMixtureSoA.icc"
+
+#endif // GaussianMixtureSoA_H
@@ -0,0 +1,103 @@
+#include "TrackingTools/GsfTools/interface/CloseComponentsMerger.h"
+#include "TrackingTools/GsfTools/interface/KullbackLeiblerDistance.h"
+#include "TrackingTools/GsfTools/interface/MultiGaussianState.h"
+
+#include "FWCore/Utilities/interface/HRRealTime.h"
+#include<algorithm>
+#include<cassert>
+#include<cmath>
+#include<cstdlib>
+#include<iostream>
+#include<random>
+#include<vector>
+
+/*
+ * Microbenchmark of the GSF component merging: mixtures of 5D states shaped
+ * like electron track states after the material update (36 components)
+ * are merged down to 12, once through the generic distance interface and
+ * once through the SoA path taken for the Kullback-Leibler distance.
+ */
+
+typedef SingleGaussianState<5> GS;
+typedef MultiGaussianState<5> MGS;
+typedef GS::Vector Vector;
+typedef GS::Matrix Matrix;
+
+namespace {
+  // hides the distance type from the merger, so it takes the generic path
+  class GenericKL final : public DistanceBetweenComponents<5> {
+  public:
+    double operator() (const GS& a, const GS& b) const override { return kl(a,b); }
+    GenericKL* clone() const override { return new GenericKL(*this); }
+  private:
+    KullbackLeiblerDistance<5> kl;
+  };
+
+  MGS buildMixture(std::mt19937& rng, int nComp) {
+    // q/p, angles and positions with the typical spread of a GSF state
+    std::normal_distribution<double> gauss;
+    std::uniform_real_distribution<double> flat(0.1,1.);
+    const double sigma[5] = {0.05, 0.001, 0.001, 0.01, 0.01};
+    MGS::SingleStateContainer comps;
+    for (int i=0; i<nComp; ++i) {
+      Vector mean;
+      Matrix cov;
+      for (int k=0; k<5; ++k) {
+        mean(k) = sigma[k]*gauss(rng);
+        cov(k,k) = sigma[k]*sigma[k]*(1.+flat(rng));
+      }
+      cov(0,1) = 0.3*sigma[0]*sigma[1];
+      cov(3,4) = -0.2*sigma[3]*sigma[4];
+      comps.push_back(std::make_shared<GS>(mean, cov, flat(rng)));
+    }
+    return MGS(comps);
+  }
+
+  double compare(const MGS& a, const MGS& b) {
+    assert(a.components().size()==b.components().size());
+    double maxDiff = std::abs(a.weight()-b.weight());
+    for (unsigned int i=0; i<5; ++i)
+      maxDiff = std::max(maxDiff, std::abs(a.mean()(i)-b.mean()(i))/std::sqrt(a.covariance()(i,i)));
+    return maxDiff;
+  }
+}
+
+int main(int argc, char * argv[]) {
+
+  const int nMixtures = argc>1 ? std::atoi(argv[1]) : 10000;
+
+  std::mt19937 rng(12345);
+  std::vector<MGS> mixtures;
+  for (int i=0; i<nMixtures; ++i) mixtures.push_back(buildMixture(rng,36));
+
+  GenericKL genericDistance;
+  KullbackLeiblerDistance<5> klDistance;
+  CloseComponentsMerger<5> generic(12, &genericDistance);
+  CloseComponentsMerger<5> soa(12, &klDistance);
+
+  std::vector<MGS> resGeneric, resSoA;
+  resGeneric.reserve(nMixtures); resSoA.reserve(nMixtures);
+
+  // force the weight matrices of the inputs so both paths start equal
+  for (auto const& m : mixtures) for (auto const& c : m.components()) c->weightMatrix();
+
+  edm::HRTimeType s = edm::hrRealTime();
+  for (auto const& m : mixtures) resGeneric.push_back(generic.merge(m));
+  edm::HRTimeType e = edm::hrRealTime();
+  std::cout << "generic merge " << double(e-s)/nMixtures << " per mixture" << std::endl;
+
+  s = edm::hrRealTime();
+  for (auto const& m : mixtures) resSoA.push_back(soa.merge(m));
+  e = edm::hrRealTime();
+  std::cout << "SoA merge     " << double(e-s)/nMixtures << " per mixture" << std::endl;
+
+  double maxDiff = 0;
+  for (int i=0; i<nMixtures; ++i) {
+    assert(resSoA[i].components().size()==12);
+    maxDiff = std::max(maxDiff, compare(resGeneric[i],resSoA[i]));
+  }
+  std::cout << "max difference of the collapsed states " << maxDiff << std::endl;
+  assert(maxDiff<1.e-6);
+
+  return 0;
+}